@@ -0,0 +1,573 @@
+/**
+ * @file logging_deferred.c
+ * @author Nicklas Börjesson (<nicklasb at gmail dot com>)
+ * @brief Deferred logging, recording the arguments of log lines and formatting them later
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @copyright 
+ * Copyright (c) 2026, Nicklas Börjesson <nicklasb at gmail dot com>
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, 
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE 
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * Formatting a log line costs more than many of the things that are logged, like sending a message.
+ * Deferred log lines are instead recorded as the pointer to their format string and the raw words
+ * of their arguments, into a lock-free ring. A low-priority task takes them from the ring and formats them.
+ * On ESP-IDF that is the logging task in logging_esp-idf.c, elsewhere they are formatted before the next
+ * log line that is written immediately, or by calling rob_log_deferred_drain().
+ *
+ * Strings are copied into the entry, as they may not live until the line is formatted.
+ * Format strings and tags must be string literals or otherwise live forever.
+ */
+#include <robusto_logging.h>
+#if defined(CONFIG_ROBUSTO_LOG_DEFERRED) && (ROB_LOG_LOCAL_LEVEL > ROB_LOG_NONE)
+
+#include <stdatomic.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#define DEFERRED_SLOTS CONFIG_ROBUSTO_LOG_DEFERRED_SLOTS
+#define DEFERRED_MASK (DEFERRED_SLOTS - 1U)
+#define DEFERRED_WORDS CONFIG_ROBUSTO_LOG_DEFERRED_WORDS
+#define DEFERRED_STRING_BYTES CONFIG_ROBUSTO_LOG_DEFERRED_STRING_BYTES
+#define DEFERRED_LINE_LEN 256
+#define DEFERRED_SPEC_LEN 24
+/* Recorded instead of a string that did not fit */
+#define DEFERRED_NO_STRING UINT32_MAX
+
+#if (DEFERRED_SLOTS & DEFERRED_MASK) != 0
+#error "CONFIG_ROBUSTO_LOG_DEFERRED_SLOTS must be a power of two."
+#endif
+
+typedef enum
+{
+    arg_int,
+    arg_long,
+    arg_long_long,
+    arg_size,
+    arg_pointer,
+    arg_double,
+    arg_string,
+    arg_none,
+} arg_type_t;
+
+/* A conversion specification in a format string */
+typedef struct
+{
+    /* The specification, from the % up to and including the conversion character */
+    const char *start;
+    uint8_t length;
+    char conversion;
+    arg_type_t type;
+    /* The number of * in the width and precision, that take int arguments */
+    uint8_t stars;
+} conversion_t;
+
+typedef struct
+{
+    /*
+     * Sequence number of the ring, offset by the index of the slot so that zero-initialised slots are free.
+     * See the bounded MPMC queue of Dmitry Vyukov, that this follows.
+     */
+    _Atomic uint32_t sequence;
+    rob_log_level_t level;
+    /* False if the arguments did not fit */
+    bool complete;
+    uint8_t word_count;
+    uint8_t string_bytes;
+    const char *tag;
+    const char *format;
+    uint32_t words[DEFERRED_WORDS];
+    char strings[DEFERRED_STRING_BYTES];
+} deferred_entry_t;
+
+static deferred_entry_t ring[DEFERRED_SLOTS];
+static _Atomic uint32_t enqueue_position = 0;
+static _Atomic uint32_t dequeue_position = 0;
+static _Atomic uint32_t dropped = 0;
+
+/**
+ * @brief Find the next conversion in a format string
+ *
+ * @return const char* Where to continue after it, NULL if there are no more conversions
+ */
+static const char *next_conversion(const char *format, conversion_t *conversion)
+{
+    const char *p = format;
+    while (*p != '\0')
+    {
+        if (*p++ != '%')
+        {
+            continue;
+        }
+        if (*p == '%')
+        {
+            p++;
+            continue;
+        }
+        conversion->start = p - 1;
+        conversion->stars = 0;
+        while (*p != '\0' && strchr("-+ #0", *p) != NULL)
+        {
+            p++;
+        }
+        for (int precision = 0; precision < 2; precision++)
+        {
+            if (*p == '*')
+            {
+                conversion->stars++;
+                p++;
+            }
+            while (*p >= '0' && *p <= '9')
+            {
+                p++;
+            }
+            if (precision == 0 && *p == '.')
+            {
+                p++;
+            }
+            else
+            {
+                break;
+            }
+        }
+        arg_type_t integer = arg_int;
+        if (*p == 'h')
+        {
+            p += p[1] == 'h' ? 2 : 1;
+        }
+        else if (*p == 'l')
+        {
+            integer = p[1] == 'l' ? arg_long_long : arg_long;
+            p += p[1] == 'l' ? 2 : 1;
+        }
+        else if (*p == 'j')
+        {
+            integer = arg_long_long;
+            p++;
+        }
+        else if (*p == 'z' || *p == 't')
+        {
+            integer = arg_size;
+            p++;
+        }
+        else if (*p == 'L')
+        {
+            p++;
+        }
+        conversion->conversion = *p;
+        switch (*p)
+        {
+        case 'd':
+        case 'i':
+        case 'u':
+        case 'o':
+        case 'x':
+        case 'X':
+            conversion->type = integer;
+            break;
+        case 'c':
+            conversion->type = arg_int;
+            break;
+        case 'p':
+            conversion->type = arg_pointer;
+            break;
+        case 's':
+            conversion->type = arg_string;
+            break;
+        case 'f':
+        case 'F':
+        case 'e':
+        case 'E':
+        case 'g':
+        case 'G':
+        case 'a':
+        case 'A':
+            conversion->type = arg_double;
+            break;
+        default:
+            // %n and anything unknown, neither recorded nor formatted
+            conversion->type = arg_none;
+            break;
+        }
+        if (*p == '\0' || p + 1 - conversion->start >= DEFERRED_SPEC_LEN)
+        {
+            return NULL;
+        }
+        conversion->length = p + 1 - conversion->start;
+        return p + 1;
+    }
+    return NULL;
+}
+
+static uint8_t type_words(arg_type_t type)
+{
+    switch (type)
+    {
+    case arg_long:
+        return (sizeof(long) + 3) / 4;
+    case arg_long_long:
+        return (sizeof(long long) + 3) / 4;
+    case arg_size:
+        return (sizeof(size_t) + 3) / 4;
+    case arg_pointer:
+        return (sizeof(void *) + 3) / 4;
+    case arg_double:
+        return (sizeof(double) + 3) / 4;
+    case arg_none:
+        return 0;
+    default:
+        return 1;
+    }
+}
+
+static bool push_words(deferred_entry_t *entry, const void *value, arg_type_t type)
+{
+    uint8_t count = type_words(type);
+    if (entry->word_count + count > DEFERRED_WORDS)
+    {
+        return false;
+    }
+    memcpy(&entry->words[entry->word_count], value, count * 4);
+    entry->word_count += count;
+    return true;
+}
+
+static bool record_argument(deferred_entry_t *entry, arg_type_t type, va_list *args)
+{
+    switch (type)
+    {
+    case arg_long:
+    {
+        long value = va_arg(*args, long);
+        return push_words(entry, &value, type);
+    }
+    case arg_long_long:
+    {
+        long long value = va_arg(*args, long long);
+        return push_words(entry, &value, type);
+    }
+    case arg_size:
+    {
+        size_t value = va_arg(*args, size_t);
+        return push_words(entry, &value, type);
+    }
+    case arg_pointer:
+    {
+        void *value = va_arg(*args, void *);
+        return push_words(entry, &value, type);
+    }
+    case arg_double:
+    {
+        double value = va_arg(*args, double);
+        return push_words(entry, &value, type);
+    }
+    case arg_string:
+    {
+        const char *value = va_arg(*args, const char *);
+        if (value == NULL)
+        {
+            value = "(null)";
+        }
+        uint32_t offset = DEFERRED_NO_STRING;
+        size_t length = strlen(value) + 1;
+        if (entry->string_bytes + length <= DEFERRED_STRING_BYTES)
+        {
+            offset = entry->string_bytes;
+            memcpy(&entry->strings[offset], value, length);
+            entry->string_bytes += length;
+        }
+        return push_words(entry, &offset, type);
+    }
+    default:
+    {
+        int value = va_arg(*args, int);
+        return push_words(entry, &value, type);
+    }
+    }
+}
+
+static void record(deferred_entry_t *entry, const char *format, va_list args)
+{
+    va_list list;
+    va_copy(list, args);
+    conversion_t conversion;
+    entry->complete = true;
+    for (const char *p = next_conversion(format, &conversion); p != NULL && entry->complete; p = next_conversion(p, &conversion))
+    {
+        for (uint8_t i = 0; i < conversion.stars && entry->complete; i++)
+        {
+            entry->complete = record_argument(entry, arg_int, &list);
+        }
+        if (conversion.type == arg_none)
+        {
+            if (conversion.conversion == 'n')
+            {
+                (void)va_arg(list, void *);
+            }
+            continue;
+        }
+        if (entry->complete)
+        {
+            entry->complete = record_argument(entry, conversion.type, &list);
+        }
+    }
+    va_end(list);
+}
+
+bool rob_log_deferred(rob_log_level_t level, const char *tag, const char *format, ...)
+{
+    uint32_t position = atomic_load_explicit(&enqueue_position, memory_order_relaxed);
+    deferred_entry_t *entry;
+    while (true)
+    {
+        entry = &ring[position & DEFERRED_MASK];
+        int32_t difference = (int32_t)(atomic_load_explicit(&entry->sequence, memory_order_acquire) + (position & DEFERRED_MASK) - position);
+        if (difference == 0)
+        {
+            if (atomic_compare_exchange_weak_explicit(&enqueue_position, &position, position + 1, memory_order_relaxed, memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (difference < 0)
+        {
+            // Full, dropping the line rather than waiting
+            atomic_fetch_add(&dropped, 1);
+            return false;
+        }
+        else
+        {
+            position = atomic_load_explicit(&enqueue_position, memory_order_relaxed);
+        }
+    }
+    entry->level = level;
+    entry->tag = tag;
+    entry->format = format;
+    entry->word_count = 0;
+    entry->string_bytes = 0;
+    va_list args;
+    va_start(args, format);
+    record(entry, format, args);
+    va_end(args);
+    atomic_store_explicit(&entry->sequence, position + 1 - (position & DEFERRED_MASK), memory_order_release);
+    return true;
+}
+
+static bool pull_words(const deferred_entry_t *entry, uint8_t *word_index, void *value, arg_type_t type)
+{
+    uint8_t count = type_words(type);
+    if (*word_index + count > entry->word_count)
+    {
+        return false;
+    }
+    memcpy(value, &entry->words[*word_index], count * 4);
+    *word_index += count;
+    return true;
+}
+
+/**
+ * @brief Format one conversion using its recorded words
+ *
+ * @return int The number of characters that snprintf would have written, negative when out of words
+ */
+static int render_conversion(const deferred_entry_t *entry, const conversion_t *conversion, uint8_t *word_index, char *out, size_t size)
+{
+    char spec[DEFERRED_SPEC_LEN + 24];
+    size_t spec_length = 0;
+    // Replace * with the recorded width and precision, so snprintf only needs the value
+    for (const char *p = conversion->start; p < conversion->start + conversion->length; p++)
+    {
+        if (*p == '*')
+        {
+            int star;
+            if (!pull_words(entry, word_index, &star, arg_int))
+            {
+                return -1;
+            }
+            spec_length += snprintf(spec + spec_length, sizeof(spec) - spec_length, "%i", star);
+        }
+        else
+        {
+            spec[spec_length++] = *p;
+        }
+    }
+    spec[spec_length] = '\0';
+
+    switch (conversion->type)
+    {
+    case arg_long:
+    {
+        long value;
+        return pull_words(entry, word_index, &value, conversion->type) ? snprintf(out, size, spec, value) : -1;
+    }
+    case arg_long_long:
+    {
+        long long value;
+        return pull_words(entry, word_index, &value, conversion->type) ? snprintf(out, size, spec, value) : -1;
+    }
+    case arg_size:
+    {
+        size_t value;
+        return pull_words(entry, word_index, &value, conversion->type) ? snprintf(out, size, spec, value) : -1;
+    }
+    case arg_pointer:
+    {
+        void *value;
+        return pull_words(entry, word_index, &value, conversion->type) ? snprintf(out, size, spec, value) : -1;
+    }
+    case arg_double:
+    {
+        double value;
+        if (!pull_words(entry, word_index, &value, conversion->type))
+        {
+            return -1;
+        }
+        if (conversion->start[conversion->length - 2] == 'L')
+        {
+            return snprintf(out, size, spec, (long double)value);
+        }
+        return snprintf(out, size, spec, value);
+    }
+    case arg_string:
+    {
+        uint32_t offset;
+        if (!pull_words(entry, word_index, &offset, conversion->type))
+        {
+            return -1;
+        }
+        return snprintf(out, size, spec, offset == DEFERRED_NO_STRING ? "(..)" : &entry->strings[offset]);
+    }
+    case arg_none:
+        return 0;
+    default:
+    {
+        int value;
+        return pull_words(entry, word_index, &value, conversion->type) ? snprintf(out, size, spec, value) : -1;
+    }
+    }
+}
+
+/* Append the text between conversions, unescaping %%, as the line is written with a "%s" format */
+static void append_literal(char *out, size_t size, size_t *written, const char *text, const char *end)
+{
+    for (const char *p = text; (end == NULL || p < end) && *p != '\0' && *written + 1 < size; p++)
+    {
+        out[(*written)++] = *p;
+        if (p[0] == '%' && p[1] == '%')
+        {
+            p++;
+        }
+    }
+    out[*written] = '\0';
+}
+
+static void render(const deferred_entry_t *entry, char *out, size_t size)
+{
+    size_t written = 0;
+    uint8_t word_index = 0;
+    const char *literal = entry->format;
+    conversion_t conversion;
+    out[0] = '\0';
+    for (const char *p = next_conversion(literal, &conversion); p != NULL; p = next_conversion(p, &conversion))
+    {
+        append_literal(out, size, &written, literal, conversion.start);
+        literal = p;
+        if (written + 1 >= size)
+        {
+            return;
+        }
+        int length = render_conversion(entry, &conversion, &word_index, out + written, size - written);
+        if (length < 0)
+        {
+            // The rest of the arguments were not recorded
+            append_literal(out, size, &written, "(..)", NULL);
+            return;
+        }
+        written += (size_t)length < size - written ? (size_t)length : size - 1 - written;
+    }
+    append_literal(out, size, &written, literal, NULL);
+}
+
+bool rob_log_deferred_take(rob_log_level_t *level, const char **tag, char *line, size_t size)
+{
+    uint32_t position = atomic_load_explicit(&dequeue_position, memory_order_relaxed);
+    deferred_entry_t *entry;
+    while (true)
+    {
+        entry = &ring[position & DEFERRED_MASK];
+        int32_t difference = (int32_t)(atomic_load_explicit(&entry->sequence, memory_order_acquire) + (position & DEFERRED_MASK) - (position + 1));
+        if (difference == 0)
+        {
+            if (atomic_compare_exchange_weak_explicit(&dequeue_position, &position, position + 1, memory_order_relaxed, memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (difference < 0)
+        {
+            // Empty, or the next line is still being recorded
+            return false;
+        }
+        else
+        {
+            position = atomic_load_explicit(&dequeue_position, memory_order_relaxed);
+        }
+    }
+    *level = entry->level;
+    *tag = entry->tag;
+    render(entry, line, size);
+    atomic_store_explicit(&entry->sequence, position + DEFERRED_SLOTS - (position & DEFERRED_MASK), memory_order_release);
+    return true;
+}
+
+static void write_line(rob_log_level_t level, const char *tag, const char *format, ...)
+{
+    va_list list;
+    va_start(list, format);
+    compat_rob_log_writev(level, tag, format, list);
+    va_end(list);
+}
+
+uint32_t rob_log_deferred_drain(void)
+{
+    char line[DEFERRED_LINE_LEN];
+    rob_log_level_t level;
+    const char *tag;
+    uint32_t count = 0;
+    while (rob_log_deferred_take(&level, &tag, line, sizeof(line)))
+    {
+        write_line(level, tag, "%s", line);
+        count++;
+    }
+    return count;
+}
+
+uint32_t rob_log_deferred_dropped(void)
+{
+    return atomic_load(&dropped);
+}
+
+#endif
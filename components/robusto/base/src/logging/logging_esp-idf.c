@@ -181,8 +181,20 @@ static size_t isr_vsnprintf(char *out, size_t size, const char *fmt, va_list ap)
 #endif
 
 #ifndef ROB_LOG_ISR_TASK_STACK_WORDS
+#ifdef CONFIG_ROBUSTO_LOG_DEFERRED
+// Formatting deferred lines uses the full printf
+#define ROB_LOG_ISR_TASK_STACK_WORDS (configMINIMAL_STACK_SIZE * 6)
+#else
 #define ROB_LOG_ISR_TASK_STACK_WORDS (configMINIMAL_STACK_SIZE * 3)
 #endif
+#endif
+
+#ifdef CONFIG_ROBUSTO_LOG_DEFERRED
+// How often the task formats the deferred lines, unless woken by an ISR line
+#define ROB_LOG_DEFERRED_DRAIN_TICKS pdMS_TO_TICKS(50)
+#else
+#define ROB_LOG_DEFERRED_DRAIN_TICKS portMAX_DELAY
+#endif
 
 #ifndef ROB_LOG_ISR_TASK_PRIORITY
 #define ROB_LOG_ISR_TASK_PRIORITY (tskIDLE_PRIORITY + 1)
@@ -209,7 +221,7 @@ static void rob_log_isr_drain_task(void *arg)
     rob_log_isr_msg_t msg;
     while (true)
     {
-        if (xQueueReceive(rob_log_isr_queue, &msg, portMAX_DELAY) == pdTRUE)
+        if (xQueueReceive(rob_log_isr_queue, &msg, ROB_LOG_DEFERRED_DRAIN_TICKS) == pdTRUE)
         {
 #if ROB_LOG_ISR_OUTPUT
             esp_rom_printf("ISR[%s]: %s\n", msg.tag ? msg.tag : "?", msg.message);
@@ -217,6 +229,9 @@ static void rob_log_isr_drain_task(void *arg)
             (void)msg; // Drop silently to avoid UART work.
 #endif
         }
+#ifdef CONFIG_ROBUSTO_LOG_DEFERRED
+        rob_log_deferred_drain();
+#endif
     }
 }
 
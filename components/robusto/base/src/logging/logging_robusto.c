@@ -43,6 +43,10 @@ void rob_log_write(rob_log_level_t level,
                    const char *tag,
                    const char *format, ...)
 {
+#if defined(CONFIG_ROBUSTO_LOG_DEFERRED) && !defined(USE_ESPIDF)
+    // Without a logging task, write the deferred lines first to keep the order
+    rob_log_deferred_drain();
+#endif
     va_list list;
     va_start(list, format);
     compat_rob_log_writev(level, tag, format, list);
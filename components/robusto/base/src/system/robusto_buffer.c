@@ -0,0 +1,99 @@
+/**
+ * @file robusto_buffer.c
+ * @author Nicklas Börjesson (<nicklasb at gmail dot com>)
+ * @brief Reference counted buffers, that can be shared by many senders without copying
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @copyright 
+ * Copyright (c) 2026, Nicklas Börjesson <nicklasb at gmail dot com>
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, 
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE 
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/**
+ * A buffer is allocated once, and then shared by reference, typically by sending the same message
+ * to many peers. The creator owns the first reference, each queued send takes another, and the
+ * memory is freed when the last one is released.
+ * 
+ * The contents must not be changed after it has been shared. The exception is the ROBUSTO_PREFIX_BYTES
+ * at the start of a message, that medias may use for addressing when sending, as each media
+ * worker only sends one message at a time.
+ * 
+ * The header with the reference count is always in internal RAM, as atomics may not work in SPI RAM.
+ */
+#include <robusto_system.h>
+
+#include <stdatomic.h>
+
+struct robusto_buffer
+{
+    _Atomic uint16_t references;
+    uint32_t length;
+    uint8_t *data;
+};
+
+robusto_buffer_t *robusto_buffer_create(uint32_t length, bool prefer_spiram)
+{
+    robusto_buffer_t *buffer = robusto_malloc(sizeof(robusto_buffer_t));
+    if (buffer == NULL)
+    {
+        return NULL;
+    }
+    buffer->data = prefer_spiram ? robusto_spi_malloc(length) : robusto_malloc(length);
+    if (buffer->data == NULL)
+    {
+        robusto_free(buffer);
+        return NULL;
+    }
+    buffer->length = length;
+    atomic_init(&buffer->references, 1);
+    return buffer;
+}
+
+uint8_t *robusto_buffer_get_data(robusto_buffer_t *buffer)
+{
+    return buffer->data;
+}
+
+uint32_t robusto_buffer_get_length(robusto_buffer_t *buffer)
+{
+    return buffer->length;
+}
+
+void robusto_buffer_retain(robusto_buffer_t *buffer)
+{
+    atomic_fetch_add(&buffer->references, 1);
+}
+
+void robusto_buffer_release(robusto_buffer_t *buffer)
+{
+    if (buffer == NULL)
+    {
+        return;
+    }
+    if (atomic_fetch_sub(&buffer->references, 1) == 1)
+    {
+        robusto_free(buffer->data);
+        robusto_free(buffer);
+    }
+}
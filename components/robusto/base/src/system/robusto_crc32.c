@@ -0,0 +1,200 @@
+/**
+ * @file robusto_crc32.c
+ * @author Nicklas Börjesson (<nicklasb at gmail dot com>)
+ * @brief Table driven CRC32, eight bytes at a time
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @copyright 
+ * Copyright (c) 2026, Nicklas Börjesson <nicklasb at gmail dot com>
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, 
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE 
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/**
+ * Both CRC32 variants use the same polynomial, the messaging one most significant bit first without
+ * inversions, and the proxy one reflected with inversions. They share the slicing-by-8 method:
+ * xor four bytes into the remainder and look up all eight bytes in separate tables, where table k
+ * holds the effect of a byte followed by k zero bytes. So one table lookup per byte instead of a
+ * dependency chain per byte, and the bytes are read one by one so alignment and byte order doesn't matter.
+ *
+ * The tables are generated by development/gen_crc32_tables.py and live in flash.
+ * Setting ROBUSTO_CRC32_SLICES to 1 only keeps the first table of each, going byte by byte, to save 14 KB.
+ *
+ * This file does not include robconfig.h, as the proxy is built without the Robusto configuration.
+ */
+
+#ifdef ESP_PLATFORM
+#include <sdkconfig.h>
+#endif
+
+#ifndef ROBUSTO_CRC32_SLICES
+#if defined(ESP_PLATFORM) && !defined(CONFIG_ROBUSTO_CRC32_SLICE_BY_8)
+#define ROBUSTO_CRC32_SLICES 1
+#else
+#define ROBUSTO_CRC32_SLICES 8
+#endif
+#endif
+
+#if ROBUSTO_CRC32_SLICES != 1 && ROBUSTO_CRC32_SLICES != 8
+#error ROBUSTO_CRC32_SLICES must be 1 or 8
+#endif
+
+#include "robusto_crc32.h"
+#include "robusto_crc32_tables.h"
+
+#if defined(ESP_PLATFORM) && defined(CONFIG_ROBUSTO_CRC32_USE_ROM)
+#include <stdbool.h>
+#include <esp_rom_crc.h>
+#define ROBUSTO_CRC32_ROM
+/* 1 when the ROM functions have been checked to give the same result as the tables, -1 if they didn't */
+static int rom_verified = 0;
+
+static bool rom_usable(void)
+{
+    if (rom_verified == 0)
+    {
+        static const uint8_t check[] = "123456789";
+        uint32_t msb_first = 0;
+        for (size_t i = 0; i < sizeof(check) - 1; i++)
+        {
+            msb_first = (msb_first << 8) ^ crc32_msb_first_tables[0][(msb_first >> 24) ^ check[i]];
+        }
+        // The ROM functions invert before and after, like zlib
+        rom_verified = (esp_rom_crc32_le(0, check, sizeof(check) - 1) == 0xcbf43926U &&
+                        ~esp_rom_crc32_be(~0U, check, sizeof(check) - 1) == msb_first)
+                           ? 1
+                           : -1;
+    }
+    return rom_verified > 0;
+}
+#endif
+
+static uint32_t crc32_msb_first(uint32_t crc, const uint8_t *buf, size_t len)
+{
+#if ROBUSTO_CRC32_SLICES == 8
+    const uint32_t(*t)[256] = crc32_msb_first_tables;
+    while (len >= 8)
+    {
+        crc ^= ((uint32_t)buf[0] << 24) | ((uint32_t)buf[1] << 16) | ((uint32_t)buf[2] << 8) | buf[3];
+        crc = t[7][crc >> 24] ^ t[6][(crc >> 16) & 0xff] ^ t[5][(crc >> 8) & 0xff] ^ t[4][crc & 0xff] ^
+              t[3][buf[4]] ^ t[2][buf[5]] ^ t[1][buf[6]] ^ t[0][buf[7]];
+        buf += 8;
+        len -= 8;
+    }
+#endif
+    while (len--)
+    {
+        crc = (crc << 8) ^ crc32_msb_first_tables[0][(crc >> 24) ^ *buf++];
+    }
+    return crc;
+}
+
+static uint32_t crc32_lsb_first(uint32_t crc, const uint8_t *buf, size_t len)
+{
+#if ROBUSTO_CRC32_SLICES == 8
+    const uint32_t(*t)[256] = crc32_lsb_first_tables;
+    while (len >= 8)
+    {
+        crc ^= (uint32_t)buf[0] | ((uint32_t)buf[1] << 8) | ((uint32_t)buf[2] << 16) | ((uint32_t)buf[3] << 24);
+        crc = t[7][crc & 0xff] ^ t[6][(crc >> 8) & 0xff] ^ t[5][(crc >> 16) & 0xff] ^ t[4][crc >> 24] ^
+              t[3][buf[4]] ^ t[2][buf[5]] ^ t[1][buf[6]] ^ t[0][buf[7]];
+        buf += 8;
+        len -= 8;
+    }
+#endif
+    while (len--)
+    {
+        crc = (crc >> 8) ^ crc32_lsb_first_tables[0][(crc ^ *buf++) & 0xff];
+    }
+    return crc;
+}
+
+uint32_t robusto_crc32(uint32_t crc, const uint8_t *buf, size_t len)
+{
+#ifdef ROBUSTO_CRC32_ROM
+    if (len <= UINT32_MAX && rom_usable())
+    {
+        return ~esp_rom_crc32_be(~crc, buf, (uint32_t)len);
+    }
+#endif
+    return crc32_msb_first(crc, buf, len);
+}
+
+/*
+ * Combining uses that a CRC without inversions is the remainder of the data as a polynomial, so
+ * the CRC of a part followed by another is the CRC of the first, shifted by the length of the second,
+ * xor the CRC of the second. Shifting by n bytes is multiplying by x^(8n) modulo the polynomial.
+ */
+
+/* Multiply a and b modulo the polynomial, most significant bit is x^31 */
+static uint32_t crc32_multiply(uint32_t a, uint32_t b)
+{
+    uint32_t product = 0;
+    for (uint32_t bit = 0x80000000U; bit != 0; bit >>= 1)
+    {
+        product = (product & 0x80000000U) ? (product << 1) ^ 0x04c11db7U : product << 1;
+        if (a & bit)
+        {
+            product ^= b;
+        }
+    }
+    return product;
+}
+
+uint32_t robusto_crc32_combine_gen(size_t len2)
+{
+    // x^(8 * len2), by squaring x^8
+    uint32_t op = 1;
+    uint32_t square = 0x100;
+    while (len2 > 0)
+    {
+        if (len2 & 1)
+        {
+            op = crc32_multiply(op, square);
+        }
+        square = crc32_multiply(square, square);
+        len2 >>= 1;
+    }
+    return op;
+}
+
+uint32_t robusto_crc32_combine_op(uint32_t crc1, uint32_t crc2, uint32_t op)
+{
+    return crc32_multiply(crc1, op) ^ crc2;
+}
+
+uint32_t robusto_crc32_combine(uint32_t crc1, uint32_t crc2, size_t len2)
+{
+    return robusto_crc32_combine_op(crc1, crc2, robusto_crc32_combine_gen(len2));
+}
+
+uint32_t robusto_crc32_iso_hdlc(uint32_t crc, const uint8_t *buf, size_t len)
+{
+#ifdef ROBUSTO_CRC32_ROM
+    if (len <= UINT32_MAX && rom_usable())
+    {
+        return esp_rom_crc32_le(crc, buf, (uint32_t)len);
+    }
+#endif
+    return ~crc32_lsb_first(~crc, buf, len);
+}
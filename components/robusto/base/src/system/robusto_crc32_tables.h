@@ -0,0 +1,736 @@
+/* Generated by development/gen_crc32_tables.py, do not edit. */
+#pragma once
+
+#include <stdint.h>
+
+/* CRC32 polynomial 0x04c11db7, most significant bit first. Table k advances a byte k bytes from the end. */
+static const uint32_t crc32_msb_first_tables[ROBUSTO_CRC32_SLICES][256] = {
+    {
+        0x00000000U, 0x04c11db7U, 0x09823b6eU, 0x0d4326d9U, 0x130476dcU, 0x17c56b6bU,
+        0x1a864db2U, 0x1e475005U, 0x2608edb8U, 0x22c9f00fU, 0x2f8ad6d6U, 0x2b4bcb61U,
+        0x350c9b64U, 0x31cd86d3U, 0x3c8ea00aU, 0x384fbdbdU, 0x4c11db70U, 0x48d0c6c7U,
+        0x4593e01eU, 0x4152fda9U, 0x5f15adacU, 0x5bd4b01bU, 0x569796c2U, 0x52568b75U,
+        0x6a1936c8U, 0x6ed82b7fU, 0x639b0da6U, 0x675a1011U, 0x791d4014U, 0x7ddc5da3U,
+        0x709f7b7aU, 0x745e66cdU, 0x9823b6e0U, 0x9ce2ab57U, 0x91a18d8eU, 0x95609039U,
+        0x8b27c03cU, 0x8fe6dd8bU, 0x82a5fb52U, 0x8664e6e5U, 0xbe2b5b58U, 0xbaea46efU,
+        0xb7a96036U, 0xb3687d81U, 0xad2f2d84U, 0xa9ee3033U, 0xa4ad16eaU, 0xa06c0b5dU,
+        0xd4326d90U, 0xd0f37027U, 0xddb056feU, 0xd9714b49U, 0xc7361b4cU, 0xc3f706fbU,
+        0xceb42022U, 0xca753d95U, 0xf23a8028U, 0xf6fb9d9fU, 0xfbb8bb46U, 0xff79a6f1U,
+        0xe13ef6f4U, 0xe5ffeb43U, 0xe8bccd9aU, 0xec7dd02dU, 0x34867077U, 0x30476dc0U,
+        0x3d044b19U, 0x39c556aeU, 0x278206abU, 0x23431b1cU, 0x2e003dc5U, 0x2ac12072U,
+        0x128e9dcfU, 0x164f8078U, 0x1b0ca6a1U, 0x1fcdbb16U, 0x018aeb13U, 0x054bf6a4U,
+        0x0808d07dU, 0x0cc9cdcaU, 0x7897ab07U, 0x7c56b6b0U, 0x71159069U, 0x75d48ddeU,
+        0x6b93dddbU, 0x6f52c06cU, 0x6211e6b5U, 0x66d0fb02U, 0x5e9f46bfU, 0x5a5e5b08U,
+        0x571d7dd1U, 0x53dc6066U, 0x4d9b3063U, 0x495a2dd4U, 0x44190b0dU, 0x40d816baU,
+        0xaca5c697U, 0xa864db20U, 0xa527fdf9U, 0xa1e6e04eU, 0xbfa1b04bU, 0xbb60adfcU,
+        0xb6238b25U, 0xb2e29692U, 0x8aad2b2fU, 0x8e6c3698U, 0x832f1041U, 0x87ee0df6U,
+        0x99a95df3U, 0x9d684044U, 0x902b669dU, 0x94ea7b2aU, 0xe0b41de7U, 0xe4750050U,
+        0xe9362689U, 0xedf73b3eU, 0xf3b06b3bU, 0xf771768cU, 0xfa325055U, 0xfef34de2U,
+        0xc6bcf05fU, 0xc27dede8U, 0xcf3ecb31U, 0xcbffd686U, 0xd5b88683U, 0xd1799b34U,
+        0xdc3abdedU, 0xd8fba05aU, 0x690ce0eeU, 0x6dcdfd59U, 0x608edb80U, 0x644fc637U,
+        0x7a089632U, 0x7ec98b85U, 0x738aad5cU, 0x774bb0ebU, 0x4f040d56U, 0x4bc510e1U,
+        0x46863638U, 0x42472b8fU, 0x5c007b8aU, 0x58c1663dU, 0x558240e4U, 0x51435d53U,
+        0x251d3b9eU, 0x21dc2629U, 0x2c9f00f0U, 0x285e1d47U, 0x36194d42U, 0x32d850f5U,
+        0x3f9b762cU, 0x3b5a6b9bU, 0x0315d626U, 0x07d4cb91U, 0x0a97ed48U, 0x0e56f0ffU,
+        0x1011a0faU, 0x14d0bd4dU, 0x19939b94U, 0x1d528623U, 0xf12f560eU, 0xf5ee4bb9U,
+        0xf8ad6d60U, 0xfc6c70d7U, 0xe22b20d2U, 0xe6ea3d65U, 0xeba91bbcU, 0xef68060bU,
+        0xd727bbb6U, 0xd3e6a601U, 0xdea580d8U, 0xda649d6fU, 0xc423cd6aU, 0xc0e2d0ddU,
+        0xcda1f604U, 0xc960ebb3U, 0xbd3e8d7eU, 0xb9ff90c9U, 0xb4bcb610U, 0xb07daba7U,
+        0xae3afba2U, 0xaafbe615U, 0xa7b8c0ccU, 0xa379dd7bU, 0x9b3660c6U, 0x9ff77d71U,
+        0x92b45ba8U, 0x9675461fU, 0x8832161aU, 0x8cf30badU, 0x81b02d74U, 0x857130c3U,
+        0x5d8a9099U, 0x594b8d2eU, 0x5408abf7U, 0x50c9b640U, 0x4e8ee645U, 0x4a4ffbf2U,
+        0x470cdd2bU, 0x43cdc09cU, 0x7b827d21U, 0x7f436096U, 0x7200464fU, 0x76c15bf8U,
+        0x68860bfdU, 0x6c47164aU, 0x61043093U, 0x65c52d24U, 0x119b4be9U, 0x155a565eU,
+        0x18197087U, 0x1cd86d30U, 0x029f3d35U, 0x065e2082U, 0x0b1d065bU, 0x0fdc1becU,
+        0x3793a651U, 0x3352bbe6U, 0x3e119d3fU, 0x3ad08088U, 0x2497d08dU, 0x2056cd3aU,
+        0x2d15ebe3U, 0x29d4f654U, 0xc5a92679U, 0xc1683bceU, 0xcc2b1d17U, 0xc8ea00a0U,
+        0xd6ad50a5U, 0xd26c4d12U, 0xdf2f6bcbU, 0xdbee767cU, 0xe3a1cbc1U, 0xe760d676U,
+        0xea23f0afU, 0xeee2ed18U, 0xf0a5bd1dU, 0xf464a0aaU, 0xf9278673U, 0xfde69bc4U,
+        0x89b8fd09U, 0x8d79e0beU, 0x803ac667U, 0x84fbdbd0U, 0x9abc8bd5U, 0x9e7d9662U,
+        0x933eb0bbU, 0x97ffad0cU, 0xafb010b1U, 0xab710d06U, 0xa6322bdfU, 0xa2f33668U,
+        0xbcb4666dU, 0xb8757bdaU, 0xb5365d03U, 0xb1f740b4U,
+    },
+#if ROBUSTO_CRC32_SLICES > 1
+    {
+        0x00000000U, 0xd219c1dcU, 0xa0f29e0fU, 0x72eb5fd3U, 0x452421a9U, 0x973de075U,
+        0xe5d6bfa6U, 0x37cf7e7aU, 0x8a484352U, 0x5851828eU, 0x2abadd5dU, 0xf8a31c81U,
+        0xcf6c62fbU, 0x1d75a327U, 0x6f9efcf4U, 0xbd873d28U, 0x10519b13U, 0xc2485acfU,
+        0xb0a3051cU, 0x62bac4c0U, 0x5575babaU, 0x876c7b66U, 0xf58724b5U, 0x279ee569U,
+        0x9a19d841U, 0x4800199dU, 0x3aeb464eU, 0xe8f28792U, 0xdf3df9e8U, 0x0d243834U,
+        0x7fcf67e7U, 0xadd6a63bU, 0x20a33626U, 0xf2baf7faU, 0x8051a829U, 0x524869f5U,
+        0x6587178fU, 0xb79ed653U, 0xc5758980U, 0x176c485cU, 0xaaeb7574U, 0x78f2b4a8U,
+        0x0a19eb7bU, 0xd8002aa7U, 0xefcf54ddU, 0x3dd69501U, 0x4f3dcad2U, 0x9d240b0eU,
+        0x30f2ad35U, 0xe2eb6ce9U, 0x9000333aU, 0x4219f2e6U, 0x75d68c9cU, 0xa7cf4d40U,
+        0xd5241293U, 0x073dd34fU, 0xbabaee67U, 0x68a32fbbU, 0x1a487068U, 0xc851b1b4U,
+        0xff9ecfceU, 0x2d870e12U, 0x5f6c51c1U, 0x8d75901dU, 0x41466c4cU, 0x935fad90U,
+        0xe1b4f243U, 0x33ad339fU, 0x04624de5U, 0xd67b8c39U, 0xa490d3eaU, 0x76891236U,
+        0xcb0e2f1eU, 0x1917eec2U, 0x6bfcb111U, 0xb9e570cdU, 0x8e2a0eb7U, 0x5c33cf6bU,
+        0x2ed890b8U, 0xfcc15164U, 0x5117f75fU, 0x830e3683U, 0xf1e56950U, 0x23fca88cU,
+        0x1433d6f6U, 0xc62a172aU, 0xb4c148f9U, 0x66d88925U, 0xdb5fb40dU, 0x094675d1U,
+        0x7bad2a02U, 0xa9b4ebdeU, 0x9e7b95a4U, 0x4c625478U, 0x3e890babU, 0xec90ca77U,
+        0x61e55a6aU, 0xb3fc9bb6U, 0xc117c465U, 0x130e05b9U, 0x24c17bc3U, 0xf6d8ba1fU,
+        0x8433e5ccU, 0x562a2410U, 0xebad1938U, 0x39b4d8e4U, 0x4b5f8737U, 0x994646ebU,
+        0xae893891U, 0x7c90f94dU, 0x0e7ba69eU, 0xdc626742U, 0x71b4c179U, 0xa3ad00a5U,
+        0xd1465f76U, 0x035f9eaaU, 0x3490e0d0U, 0xe689210cU, 0x94627edfU, 0x467bbf03U,
+        0xfbfc822bU, 0x29e543f7U, 0x5b0e1c24U, 0x8917ddf8U, 0xbed8a382U, 0x6cc1625eU,
+        0x1e2a3d8dU, 0xcc33fc51U, 0x828cd898U, 0x50951944U, 0x227e4697U, 0xf067874bU,
+        0xc7a8f931U, 0x15b138edU, 0x675a673eU, 0xb543a6e2U, 0x08c49bcaU, 0xdadd5a16U,
+        0xa83605c5U, 0x7a2fc419U, 0x4de0ba63U, 0x9ff97bbfU, 0xed12246cU, 0x3f0be5b0U,
+        0x92dd438bU, 0x40c48257U, 0x322fdd84U, 0xe0361c58U, 0xd7f96222U, 0x05e0a3feU,
+        0x770bfc2dU, 0xa5123df1U, 0x189500d9U, 0xca8cc105U, 0xb8679ed6U, 0x6a7e5f0aU,
+        0x5db12170U, 0x8fa8e0acU, 0xfd43bf7fU, 0x2f5a7ea3U, 0xa22feebeU, 0x70362f62U,
+        0x02dd70b1U, 0xd0c4b16dU, 0xe70bcf17U, 0x35120ecbU, 0x47f95118U, 0x95e090c4U,
+        0x2867adecU, 0xfa7e6c30U, 0x889533e3U, 0x5a8cf23fU, 0x6d438c45U, 0xbf5a4d99U,
+        0xcdb1124aU, 0x1fa8d396U, 0xb27e75adU, 0x6067b471U, 0x128ceba2U, 0xc0952a7eU,
+        0xf75a5404U, 0x254395d8U, 0x57a8ca0bU, 0x85b10bd7U, 0x383636ffU, 0xea2ff723U,
+        0x98c4a8f0U, 0x4add692cU, 0x7d121756U, 0xaf0bd68aU, 0xdde08959U, 0x0ff94885U,
+        0xc3cab4d4U, 0x11d37508U, 0x63382adbU, 0xb121eb07U, 0x86ee957dU, 0x54f754a1U,
+        0x261c0b72U, 0xf405caaeU, 0x4982f786U, 0x9b9b365aU, 0xe9706989U, 0x3b69a855U,
+        0x0ca6d62fU, 0xdebf17f3U, 0xac544820U, 0x7e4d89fcU, 0xd39b2fc7U, 0x0182ee1bU,
+        0x7369b1c8U, 0xa1707014U, 0x96bf0e6eU, 0x44a6cfb2U, 0x364d9061U, 0xe45451bdU,
+        0x59d36c95U, 0x8bcaad49U, 0xf921f29aU, 0x2b383346U, 0x1cf74d3cU, 0xceee8ce0U,
+        0xbc05d333U, 0x6e1c12efU, 0xe36982f2U, 0x3170432eU, 0x439b1cfdU, 0x9182dd21U,
+        0xa64da35bU, 0x74546287U, 0x06bf3d54U, 0xd4a6fc88U, 0x6921c1a0U, 0xbb38007cU,
+        0xc9d35fafU, 0x1bca9e73U, 0x2c05e009U, 0xfe1c21d5U, 0x8cf77e06U, 0x5eeebfdaU,
+        0xf33819e1U, 0x2121d83dU, 0x53ca87eeU, 0x81d34632U, 0xb61c3848U, 0x6405f994U,
+        0x16eea647U, 0xc4f7679bU, 0x79705ab3U, 0xab699b6fU, 0xd982c4bcU, 0x0b9b0560U,
+        0x3c547b1aU, 0xee4dbac6U, 0x9ca6e515U, 0x4ebf24c9U,
+    },
+    {
+        0x00000000U, 0x01d8ac87U, 0x03b1590eU, 0x0269f589U, 0x0762b21cU, 0x06ba1e9bU,
+        0x04d3eb12U, 0x050b4795U, 0x0ec56438U, 0x0f1dc8bfU, 0x0d743d36U, 0x0cac91b1U,
+        0x09a7d624U, 0x087f7aa3U, 0x0a168f2aU, 0x0bce23adU, 0x1d8ac870U, 0x1c5264f7U,
+        0x1e3b917eU, 0x1fe33df9U, 0x1ae87a6cU, 0x1b30d6ebU, 0x19592362U, 0x18818fe5U,
+        0x134fac48U, 0x129700cfU, 0x10fef546U, 0x112659c1U, 0x142d1e54U, 0x15f5b2d3U,
+        0x179c475aU, 0x1644ebddU, 0x3b1590e0U, 0x3acd3c67U, 0x38a4c9eeU, 0x397c6569U,
+        0x3c7722fcU, 0x3daf8e7bU, 0x3fc67bf2U, 0x3e1ed775U, 0x35d0f4d8U, 0x3408585fU,
+        0x3661add6U, 0x37b90151U, 0x32b246c4U, 0x336aea43U, 0x31031fcaU, 0x30dbb34dU,
+        0x269f5890U, 0x2747f417U, 0x252e019eU, 0x24f6ad19U, 0x21fdea8cU, 0x2025460bU,
+        0x224cb382U, 0x23941f05U, 0x285a3ca8U, 0x2982902fU, 0x2beb65a6U, 0x2a33c921U,
+        0x2f388eb4U, 0x2ee02233U, 0x2c89d7baU, 0x2d517b3dU, 0x762b21c0U, 0x77f38d47U,
+        0x759a78ceU, 0x7442d449U, 0x714993dcU, 0x70913f5bU, 0x72f8cad2U, 0x73206655U,
+        0x78ee45f8U, 0x7936e97fU, 0x7b5f1cf6U, 0x7a87b071U, 0x7f8cf7e4U, 0x7e545b63U,
+        0x7c3daeeaU, 0x7de5026dU, 0x6ba1e9b0U, 0x6a794537U, 0x6810b0beU, 0x69c81c39U,
+        0x6cc35bacU, 0x6d1bf72bU, 0x6f7202a2U, 0x6eaaae25U, 0x65648d88U, 0x64bc210fU,
+        0x66d5d486U, 0x670d7801U, 0x62063f94U, 0x63de9313U, 0x61b7669aU, 0x606fca1dU,
+        0x4d3eb120U, 0x4ce61da7U, 0x4e8fe82eU, 0x4f5744a9U, 0x4a5c033cU, 0x4b84afbbU,
+        0x49ed5a32U, 0x4835f6b5U, 0x43fbd518U, 0x4223799fU, 0x404a8c16U, 0x41922091U,
+        0x44996704U, 0x4541cb83U, 0x47283e0aU, 0x46f0928dU, 0x50b47950U, 0x516cd5d7U,
+        0x5305205eU, 0x52dd8cd9U, 0x57d6cb4cU, 0x560e67cbU, 0x54679242U, 0x55bf3ec5U,
+        0x5e711d68U, 0x5fa9b1efU, 0x5dc04466U, 0x5c18e8e1U, 0x5913af74U, 0x58cb03f3U,
+        0x5aa2f67aU, 0x5b7a5afdU, 0xec564380U, 0xed8eef07U, 0xefe71a8eU, 0xee3fb609U,
+        0xeb34f19cU, 0xeaec5d1bU, 0xe885a892U, 0xe95d0415U, 0xe29327b8U, 0xe34b8b3fU,
+        0xe1227eb6U, 0xe0fad231U, 0xe5f195a4U, 0xe4293923U, 0xe640ccaaU, 0xe798602dU,
+        0xf1dc8bf0U, 0xf0042777U, 0xf26dd2feU, 0xf3b57e79U, 0xf6be39ecU, 0xf766956bU,
+        0xf50f60e2U, 0xf4d7cc65U, 0xff19efc8U, 0xfec1434fU, 0xfca8b6c6U, 0xfd701a41U,
+        0xf87b5dd4U, 0xf9a3f153U, 0xfbca04daU, 0xfa12a85dU, 0xd743d360U, 0xd69b7fe7U,
+        0xd4f28a6eU, 0xd52a26e9U, 0xd021617cU, 0xd1f9cdfbU, 0xd3903872U, 0xd24894f5U,
+        0xd986b758U, 0xd85e1bdfU, 0xda37ee56U, 0xdbef42d1U, 0xdee40544U, 0xdf3ca9c3U,
+        0xdd555c4aU, 0xdc8df0cdU, 0xcac91b10U, 0xcb11b797U, 0xc978421eU, 0xc8a0ee99U,
+        0xcdaba90cU, 0xcc73058bU, 0xce1af002U, 0xcfc25c85U, 0xc40c7f28U, 0xc5d4d3afU,
+        0xc7bd2626U, 0xc6658aa1U, 0xc36ecd34U, 0xc2b661b3U, 0xc0df943aU, 0xc10738bdU,
+        0x9a7d6240U, 0x9ba5cec7U, 0x99cc3b4eU, 0x981497c9U, 0x9d1fd05cU, 0x9cc77cdbU,
+        0x9eae8952U, 0x9f7625d5U, 0x94b80678U, 0x9560aaffU, 0x97095f76U, 0x96d1f3f1U,
+        0x93dab464U, 0x920218e3U, 0x906bed6aU, 0x91b341edU, 0x87f7aa30U, 0x862f06b7U,
+        0x8446f33eU, 0x859e5fb9U, 0x8095182cU, 0x814db4abU, 0x83244122U, 0x82fceda5U,
+        0x8932ce08U, 0x88ea628fU, 0x8a839706U, 0x8b5b3b81U, 0x8e507c14U, 0x8f88d093U,
+        0x8de1251aU, 0x8c39899dU, 0xa168f2a0U, 0xa0b05e27U, 0xa2d9abaeU, 0xa3010729U,
+        0xa60a40bcU, 0xa7d2ec3bU, 0xa5bb19b2U, 0xa463b535U, 0xafad9698U, 0xae753a1fU,
+        0xac1ccf96U, 0xadc46311U, 0xa8cf2484U, 0xa9178803U, 0xab7e7d8aU, 0xaaa6d10dU,
+        0xbce23ad0U, 0xbd3a9657U, 0xbf5363deU, 0xbe8bcf59U, 0xbb8088ccU, 0xba58244bU,
+        0xb831d1c2U, 0xb9e97d45U, 0xb2275ee8U, 0xb3fff26fU, 0xb19607e6U, 0xb04eab61U,
+        0xb545ecf4U, 0xb49d4073U, 0xb6f4b5faU, 0xb72c197dU,
+    },
+    {
+        0x00000000U, 0xdc6d9ab7U, 0xbc1a28d9U, 0x6077b26eU, 0x7cf54c05U, 0xa098d6b2U,
+        0xc0ef64dcU, 0x1c82fe6bU, 0xf9ea980aU, 0x258702bdU, 0x45f0b0d3U, 0x999d2a64U,
+        0x851fd40fU, 0x59724eb8U, 0x3905fcd6U, 0xe5686661U, 0xf7142da3U, 0x2b79b714U,
+        0x4b0e057aU, 0x97639fcdU, 0x8be161a6U, 0x578cfb11U, 0x37fb497fU, 0xeb96d3c8U,
+        0x0efeb5a9U, 0xd2932f1eU, 0xb2e49d70U, 0x6e8907c7U, 0x720bf9acU, 0xae66631bU,
+        0xce11d175U, 0x127c4bc2U, 0xeae946f1U, 0x3684dc46U, 0x56f36e28U, 0x8a9ef49fU,
+        0x961c0af4U, 0x4a719043U, 0x2a06222dU, 0xf66bb89aU, 0x1303defbU, 0xcf6e444cU,
+        0xaf19f622U, 0x73746c95U, 0x6ff692feU, 0xb39b0849U, 0xd3ecba27U, 0x0f812090U,
+        0x1dfd6b52U, 0xc190f1e5U, 0xa1e7438bU, 0x7d8ad93cU, 0x61082757U, 0xbd65bde0U,
+        0xdd120f8eU, 0x017f9539U, 0xe417f358U, 0x387a69efU, 0x580ddb81U, 0x84604136U,
+        0x98e2bf5dU, 0x448f25eaU, 0x24f89784U, 0xf8950d33U, 0xd1139055U, 0x0d7e0ae2U,
+        0x6d09b88cU, 0xb164223bU, 0xade6dc50U, 0x718b46e7U, 0x11fcf489U, 0xcd916e3eU,
+        0x28f9085fU, 0xf49492e8U, 0x94e32086U, 0x488eba31U, 0x540c445aU, 0x8861deedU,
+        0xe8166c83U, 0x347bf634U, 0x2607bdf6U, 0xfa6a2741U, 0x9a1d952fU, 0x46700f98U,
+        0x5af2f1f3U, 0x869f6b44U, 0xe6e8d92aU, 0x3a85439dU, 0xdfed25fcU, 0x0380bf4bU,
+        0x63f70d25U, 0xbf9a9792U, 0xa31869f9U, 0x7f75f34eU, 0x1f024120U, 0xc36fdb97U,
+        0x3bfad6a4U, 0xe7974c13U, 0x87e0fe7dU, 0x5b8d64caU, 0x470f9aa1U, 0x9b620016U,
+        0xfb15b278U, 0x277828cfU, 0xc2104eaeU, 0x1e7dd419U, 0x7e0a6677U, 0xa267fcc0U,
+        0xbee502abU, 0x6288981cU, 0x02ff2a72U, 0xde92b0c5U, 0xcceefb07U, 0x108361b0U,
+        0x70f4d3deU, 0xac994969U, 0xb01bb702U, 0x6c762db5U, 0x0c019fdbU, 0xd06c056cU,
+        0x3504630dU, 0xe969f9baU, 0x891e4bd4U, 0x5573d163U, 0x49f12f08U, 0x959cb5bfU,
+        0xf5eb07d1U, 0x29869d66U, 0xa6e63d1dU, 0x7a8ba7aaU, 0x1afc15c4U, 0xc6918f73U,
+        0xda137118U, 0x067eebafU, 0x660959c1U, 0xba64c376U, 0x5f0ca517U, 0x83613fa0U,
+        0xe3168dceU, 0x3f7b1779U, 0x23f9e912U, 0xff9473a5U, 0x9fe3c1cbU, 0x438e5b7cU,
+        0x51f210beU, 0x8d9f8a09U, 0xede83867U, 0x3185a2d0U, 0x2d075cbbU, 0xf16ac60cU,
+        0x911d7462U, 0x4d70eed5U, 0xa81888b4U, 0x74751203U, 0x1402a06dU, 0xc86f3adaU,
+        0xd4edc4b1U, 0x08805e06U, 0x68f7ec68U, 0xb49a76dfU, 0x4c0f7becU, 0x9062e15bU,
+        0xf0155335U, 0x2c78c982U, 0x30fa37e9U, 0xec97ad5eU, 0x8ce01f30U, 0x508d8587U,
+        0xb5e5e3e6U, 0x69887951U, 0x09ffcb3fU, 0xd5925188U, 0xc910afe3U, 0x157d3554U,
+        0x750a873aU, 0xa9671d8dU, 0xbb1b564fU, 0x6776ccf8U, 0x07017e96U, 0xdb6ce421U,
+        0xc7ee1a4aU, 0x1b8380fdU, 0x7bf43293U, 0xa799a824U, 0x42f1ce45U, 0x9e9c54f2U,
+        0xfeebe69cU, 0x22867c2bU, 0x3e048240U, 0xe26918f7U, 0x821eaa99U, 0x5e73302eU,
+        0x77f5ad48U, 0xab9837ffU, 0xcbef8591U, 0x17821f26U, 0x0b00e14dU, 0xd76d7bfaU,
+        0xb71ac994U, 0x6b775323U, 0x8e1f3542U, 0x5272aff5U, 0x32051d9bU, 0xee68872cU,
+        0xf2ea7947U, 0x2e87e3f0U, 0x4ef0519eU, 0x929dcb29U, 0x80e180ebU, 0x5c8c1a5cU,
+        0x3cfba832U, 0xe0963285U, 0xfc14cceeU, 0x20795659U, 0x400ee437U, 0x9c637e80U,
+        0x790b18e1U, 0xa5668256U, 0xc5113038U, 0x197caa8fU, 0x05fe54e4U, 0xd993ce53U,
+        0xb9e47c3dU, 0x6589e68aU, 0x9d1cebb9U, 0x4171710eU, 0x2106c360U, 0xfd6b59d7U,
+        0xe1e9a7bcU, 0x3d843d0bU, 0x5df38f65U, 0x819e15d2U, 0x64f673b3U, 0xb89be904U,
+        0xd8ec5b6aU, 0x0481c1ddU, 0x18033fb6U, 0xc46ea501U, 0xa419176fU, 0x78748dd8U,
+        0x6a08c61aU, 0xb6655cadU, 0xd612eec3U, 0x0a7f7474U, 0x16fd8a1fU, 0xca9010a8U,
+        0xaae7a2c6U, 0x768a3871U, 0x93e25e10U, 0x4f8fc4a7U, 0x2ff876c9U, 0xf395ec7eU,
+        0xef171215U, 0x337a88a2U, 0x530d3accU, 0x8f60a07bU,
+    },
+    {
+        0x00000000U, 0x490d678dU, 0x921acf1aU, 0xdb17a897U, 0x20f48383U, 0x69f9e40eU,
+        0xb2ee4c99U, 0xfbe32b14U, 0x41e90706U, 0x08e4608bU, 0xd3f3c81cU, 0x9afeaf91U,
+        0x611d8485U, 0x2810e308U, 0xf3074b9fU, 0xba0a2c12U, 0x83d20e0cU, 0xcadf6981U,
+        0x11c8c116U, 0x58c5a69bU, 0xa3268d8fU, 0xea2bea02U, 0x313c4295U, 0x78312518U,
+        0xc23b090aU, 0x8b366e87U, 0x5021c610U, 0x192ca19dU, 0xe2cf8a89U, 0xabc2ed04U,
+        0x70d54593U, 0x39d8221eU, 0x036501afU, 0x4a686622U, 0x917fceb5U, 0xd872a938U,
+        0x2391822cU, 0x6a9ce5a1U, 0xb18b4d36U, 0xf8862abbU, 0x428c06a9U, 0x0b816124U,
+        0xd096c9b3U, 0x999bae3eU, 0x6278852aU, 0x2b75e2a7U, 0xf0624a30U, 0xb96f2dbdU,
+        0x80b70fa3U, 0xc9ba682eU, 0x12adc0b9U, 0x5ba0a734U, 0xa0438c20U, 0xe94eebadU,
+        0x3259433aU, 0x7b5424b7U, 0xc15e08a5U, 0x88536f28U, 0x5344c7bfU, 0x1a49a032U,
+        0xe1aa8b26U, 0xa8a7ecabU, 0x73b0443cU, 0x3abd23b1U, 0x06ca035eU, 0x4fc764d3U,
+        0x94d0cc44U, 0xddddabc9U, 0x263e80ddU, 0x6f33e750U, 0xb4244fc7U, 0xfd29284aU,
+        0x47230458U, 0x0e2e63d5U, 0xd539cb42U, 0x9c34accfU, 0x67d787dbU, 0x2edae056U,
+        0xf5cd48c1U, 0xbcc02f4cU, 0x85180d52U, 0xcc156adfU, 0x1702c248U, 0x5e0fa5c5U,
+        0xa5ec8ed1U, 0xece1e95cU, 0x37f641cbU, 0x7efb2646U, 0xc4f10a54U, 0x8dfc6dd9U,
+        0x56ebc54eU, 0x1fe6a2c3U, 0xe40589d7U, 0xad08ee5aU, 0x761f46cdU, 0x3f122140U,
+        0x05af02f1U, 0x4ca2657cU, 0x97b5cdebU, 0xdeb8aa66U, 0x255b8172U, 0x6c56e6ffU,
+        0xb7414e68U, 0xfe4c29e5U, 0x444605f7U, 0x0d4b627aU, 0xd65ccaedU, 0x9f51ad60U,
+        0x64b28674U, 0x2dbfe1f9U, 0xf6a8496eU, 0xbfa52ee3U, 0x867d0cfdU, 0xcf706b70U,
+        0x1467c3e7U, 0x5d6aa46aU, 0xa6898f7eU, 0xef84e8f3U, 0x34934064U, 0x7d9e27e9U,
+        0xc7940bfbU, 0x8e996c76U, 0x558ec4e1U, 0x1c83a36cU, 0xe7608878U, 0xae6deff5U,
+        0x757a4762U, 0x3c7720efU, 0x0d9406bcU, 0x44996131U, 0x9f8ec9a6U, 0xd683ae2bU,
+        0x2d60853fU, 0x646de2b2U, 0xbf7a4a25U, 0xf6772da8U, 0x4c7d01baU, 0x05706637U,
+        0xde67cea0U, 0x976aa92dU, 0x6c898239U, 0x2584e5b4U, 0xfe934d23U, 0xb79e2aaeU,
+        0x8e4608b0U, 0xc74b6f3dU, 0x1c5cc7aaU, 0x5551a027U, 0xaeb28b33U, 0xe7bfecbeU,
+        0x3ca84429U, 0x75a523a4U, 0xcfaf0fb6U, 0x86a2683bU, 0x5db5c0acU, 0x14b8a721U,
+        0xef5b8c35U, 0xa656ebb8U, 0x7d41432fU, 0x344c24a2U, 0x0ef10713U, 0x47fc609eU,
+        0x9cebc809U, 0xd5e6af84U, 0x2e058490U, 0x6708e31dU, 0xbc1f4b8aU, 0xf5122c07U,
+        0x4f180015U, 0x06156798U, 0xdd02cf0fU, 0x940fa882U, 0x6fec8396U, 0x26e1e41bU,
+        0xfdf64c8cU, 0xb4fb2b01U, 0x8d23091fU, 0xc42e6e92U, 0x1f39c605U, 0x5634a188U,
+        0xadd78a9cU, 0xe4daed11U, 0x3fcd4586U, 0x76c0220bU, 0xccca0e19U, 0x85c76994U,
+        0x5ed0c103U, 0x17dda68eU, 0xec3e8d9aU, 0xa533ea17U, 0x7e244280U, 0x3729250dU,
+        0x0b5e05e2U, 0x4253626fU, 0x9944caf8U, 0xd049ad75U, 0x2baa8661U, 0x62a7e1ecU,
+        0xb9b0497bU, 0xf0bd2ef6U, 0x4ab702e4U, 0x03ba6569U, 0xd8adcdfeU, 0x91a0aa73U,
+        0x6a438167U, 0x234ee6eaU, 0xf8594e7dU, 0xb15429f0U, 0x888c0beeU, 0xc1816c63U,
+        0x1a96c4f4U, 0x539ba379U, 0xa878886dU, 0xe175efe0U, 0x3a624777U, 0x736f20faU,
+        0xc9650ce8U, 0x80686b65U, 0x5b7fc3f2U, 0x1272a47fU, 0xe9918f6bU, 0xa09ce8e6U,
+        0x7b8b4071U, 0x328627fcU, 0x083b044dU, 0x413663c0U, 0x9a21cb57U, 0xd32cacdaU,
+        0x28cf87ceU, 0x61c2e043U, 0xbad548d4U, 0xf3d82f59U, 0x49d2034bU, 0x00df64c6U,
+        0xdbc8cc51U, 0x92c5abdcU, 0x692680c8U, 0x202be745U, 0xfb3c4fd2U, 0xb231285fU,
+        0x8be90a41U, 0xc2e46dccU, 0x19f3c55bU, 0x50fea2d6U, 0xab1d89c2U, 0xe210ee4fU,
+        0x390746d8U, 0x700a2155U, 0xca000d47U, 0x830d6acaU, 0x581ac25dU, 0x1117a5d0U,
+        0xeaf48ec4U, 0xa3f9e949U, 0x78ee41deU, 0x31e32653U,
+    },
+    {
+        0x00000000U, 0x1b280d78U, 0x36501af0U, 0x2d781788U, 0x6ca035e0U, 0x77883898U,
+        0x5af02f10U, 0x41d82268U, 0xd9406bc0U, 0xc26866b8U, 0xef107130U, 0xf4387c48U,
+        0xb5e05e20U, 0xaec85358U, 0x83b044d0U, 0x989849a8U, 0xb641ca37U, 0xad69c74fU,
+        0x8011d0c7U, 0x9b39ddbfU, 0xdae1ffd7U, 0xc1c9f2afU, 0xecb1e527U, 0xf799e85fU,
+        0x6f01a1f7U, 0x7429ac8fU, 0x5951bb07U, 0x4279b67fU, 0x03a19417U, 0x1889996fU,
+        0x35f18ee7U, 0x2ed9839fU, 0x684289d9U, 0x736a84a1U, 0x5e129329U, 0x453a9e51U,
+        0x04e2bc39U, 0x1fcab141U, 0x32b2a6c9U, 0x299aabb1U, 0xb102e219U, 0xaa2aef61U,
+        0x8752f8e9U, 0x9c7af591U, 0xdda2d7f9U, 0xc68ada81U, 0xebf2cd09U, 0xf0dac071U,
+        0xde0343eeU, 0xc52b4e96U, 0xe853591eU, 0xf37b5466U, 0xb2a3760eU, 0xa98b7b76U,
+        0x84f36cfeU, 0x9fdb6186U, 0x0743282eU, 0x1c6b2556U, 0x311332deU, 0x2a3b3fa6U,
+        0x6be31dceU, 0x70cb10b6U, 0x5db3073eU, 0x469b0a46U, 0xd08513b2U, 0xcbad1ecaU,
+        0xe6d50942U, 0xfdfd043aU, 0xbc252652U, 0xa70d2b2aU, 0x8a753ca2U, 0x915d31daU,
+        0x09c57872U, 0x12ed750aU, 0x3f956282U, 0x24bd6ffaU, 0x65654d92U, 0x7e4d40eaU,
+        0x53355762U, 0x481d5a1aU, 0x66c4d985U, 0x7decd4fdU, 0x5094c375U, 0x4bbcce0dU,
+        0x0a64ec65U, 0x114ce11dU, 0x3c34f695U, 0x271cfbedU, 0xbf84b245U, 0xa4acbf3dU,
+        0x89d4a8b5U, 0x92fca5cdU, 0xd32487a5U, 0xc80c8addU, 0xe5749d55U, 0xfe5c902dU,
+        0xb8c79a6bU, 0xa3ef9713U, 0x8e97809bU, 0x95bf8de3U, 0xd467af8bU, 0xcf4fa2f3U,
+        0xe237b57bU, 0xf91fb803U, 0x6187f1abU, 0x7aaffcd3U, 0x57d7eb5bU, 0x4cffe623U,
+        0x0d27c44bU, 0x160fc933U, 0x3b77debbU, 0x205fd3c3U, 0x0e86505cU, 0x15ae5d24U,
+        0x38d64aacU, 0x23fe47d4U, 0x622665bcU, 0x790e68c4U, 0x54767f4cU, 0x4f5e7234U,
+        0xd7c63b9cU, 0xccee36e4U, 0xe196216cU, 0xfabe2c14U, 0xbb660e7cU, 0xa04e0304U,
+        0x8d36148cU, 0x961e19f4U, 0xa5cb3ad3U, 0xbee337abU, 0x939b2023U, 0x88b32d5bU,
+        0xc96b0f33U, 0xd243024bU, 0xff3b15c3U, 0xe41318bbU, 0x7c8b5113U, 0x67a35c6bU,
+        0x4adb4be3U, 0x51f3469bU, 0x102b64f3U, 0x0b03698bU, 0x267b7e03U, 0x3d53737bU,
+        0x138af0e4U, 0x08a2fd9cU, 0x25daea14U, 0x3ef2e76cU, 0x7f2ac504U, 0x6402c87cU,
+        0x497adff4U, 0x5252d28cU, 0xcaca9b24U, 0xd1e2965cU, 0xfc9a81d4U, 0xe7b28cacU,
+        0xa66aaec4U, 0xbd42a3bcU, 0x903ab434U, 0x8b12b94cU, 0xcd89b30aU, 0xd6a1be72U,
+        0xfbd9a9faU, 0xe0f1a482U, 0xa12986eaU, 0xba018b92U, 0x97799c1aU, 0x8c519162U,
+        0x14c9d8caU, 0x0fe1d5b2U, 0x2299c23aU, 0x39b1cf42U, 0x7869ed2aU, 0x6341e052U,
+        0x4e39f7daU, 0x5511faa2U, 0x7bc8793dU, 0x60e07445U, 0x4d9863cdU, 0x56b06eb5U,
+        0x17684cddU, 0x0c4041a5U, 0x2138562dU, 0x3a105b55U, 0xa28812fdU, 0xb9a01f85U,
+        0x94d8080dU, 0x8ff00575U, 0xce28271dU, 0xd5002a65U, 0xf8783dedU, 0xe3503095U,
+        0x754e2961U, 0x6e662419U, 0x431e3391U, 0x58363ee9U, 0x19ee1c81U, 0x02c611f9U,
+        0x2fbe0671U, 0x34960b09U, 0xac0e42a1U, 0xb7264fd9U, 0x9a5e5851U, 0x81765529U,
+        0xc0ae7741U, 0xdb867a39U, 0xf6fe6db1U, 0xedd660c9U, 0xc30fe356U, 0xd827ee2eU,
+        0xf55ff9a6U, 0xee77f4deU, 0xafafd6b6U, 0xb487dbceU, 0x99ffcc46U, 0x82d7c13eU,
+        0x1a4f8896U, 0x016785eeU, 0x2c1f9266U, 0x37379f1eU, 0x76efbd76U, 0x6dc7b00eU,
+        0x40bfa786U, 0x5b97aafeU, 0x1d0ca0b8U, 0x0624adc0U, 0x2b5cba48U, 0x3074b730U,
+        0x71ac9558U, 0x6a849820U, 0x47fc8fa8U, 0x5cd482d0U, 0xc44ccb78U, 0xdf64c600U,
+        0xf21cd188U, 0xe934dcf0U, 0xa8ecfe98U, 0xb3c4f3e0U, 0x9ebce468U, 0x8594e910U,
+        0xab4d6a8fU, 0xb06567f7U, 0x9d1d707fU, 0x86357d07U, 0xc7ed5f6fU, 0xdcc55217U,
+        0xf1bd459fU, 0xea9548e7U, 0x720d014fU, 0x69250c37U, 0x445d1bbfU, 0x5f7516c7U,
+        0x1ead34afU, 0x058539d7U, 0x28fd2e5fU, 0x33d52327U,
+    },
+    {
+        0x00000000U, 0x4f576811U, 0x9eaed022U, 0xd1f9b833U, 0x399cbdf3U, 0x76cbd5e2U,
+        0xa7326dd1U, 0xe86505c0U, 0x73397be6U, 0x3c6e13f7U, 0xed97abc4U, 0xa2c0c3d5U,
+        0x4aa5c615U, 0x05f2ae04U, 0xd40b1637U, 0x9b5c7e26U, 0xe672f7ccU, 0xa9259fddU,
+        0x78dc27eeU, 0x378b4fffU, 0xdfee4a3fU, 0x90b9222eU, 0x41409a1dU, 0x0e17f20cU,
+        0x954b8c2aU, 0xda1ce43bU, 0x0be55c08U, 0x44b23419U, 0xacd731d9U, 0xe38059c8U,
+        0x3279e1fbU, 0x7d2e89eaU, 0xc824f22fU, 0x87739a3eU, 0x568a220dU, 0x19dd4a1cU,
+        0xf1b84fdcU, 0xbeef27cdU, 0x6f169ffeU, 0x2041f7efU, 0xbb1d89c9U, 0xf44ae1d8U,
+        0x25b359ebU, 0x6ae431faU, 0x8281343aU, 0xcdd65c2bU, 0x1c2fe418U, 0x53788c09U,
+        0x2e5605e3U, 0x61016df2U, 0xb0f8d5c1U, 0xffafbdd0U, 0x17cab810U, 0x589dd001U,
+        0x89646832U, 0xc6330023U, 0x5d6f7e05U, 0x12381614U, 0xc3c1ae27U, 0x8c96c636U,
+        0x64f3c3f6U, 0x2ba4abe7U, 0xfa5d13d4U, 0xb50a7bc5U, 0x9488f9e9U, 0xdbdf91f8U,
+        0x0a2629cbU, 0x457141daU, 0xad14441aU, 0xe2432c0bU, 0x33ba9438U, 0x7cedfc29U,
+        0xe7b1820fU, 0xa8e6ea1eU, 0x791f522dU, 0x36483a3cU, 0xde2d3ffcU, 0x917a57edU,
+        0x4083efdeU, 0x0fd487cfU, 0x72fa0e25U, 0x3dad6634U, 0xec54de07U, 0xa303b616U,
+        0x4b66b3d6U, 0x0431dbc7U, 0xd5c863f4U, 0x9a9f0be5U, 0x01c375c3U, 0x4e941dd2U,
+        0x9f6da5e1U, 0xd03acdf0U, 0x385fc830U, 0x7708a021U, 0xa6f11812U, 0xe9a67003U,
+        0x5cac0bc6U, 0x13fb63d7U, 0xc202dbe4U, 0x8d55b3f5U, 0x6530b635U, 0x2a67de24U,
+        0xfb9e6617U, 0xb4c90e06U, 0x2f957020U, 0x60c21831U, 0xb13ba002U, 0xfe6cc813U,
+        0x1609cdd3U, 0x595ea5c2U, 0x88a71df1U, 0xc7f075e0U, 0xbadefc0aU, 0xf589941bU,
+        0x24702c28U, 0x6b274439U, 0x834241f9U, 0xcc1529e8U, 0x1dec91dbU, 0x52bbf9caU,
+        0xc9e787ecU, 0x86b0effdU, 0x574957ceU, 0x181e3fdfU, 0xf07b3a1fU, 0xbf2c520eU,
+        0x6ed5ea3dU, 0x2182822cU, 0x2dd0ee65U, 0x62878674U, 0xb37e3e47U, 0xfc295656U,
+        0x144c5396U, 0x5b1b3b87U, 0x8ae283b4U, 0xc5b5eba5U, 0x5ee99583U, 0x11befd92U,
+        0xc04745a1U, 0x8f102db0U, 0x67752870U, 0x28224061U, 0xf9dbf852U, 0xb68c9043U,
+        0xcba219a9U, 0x84f571b8U, 0x550cc98bU, 0x1a5ba19aU, 0xf23ea45aU, 0xbd69cc4bU,
+        0x6c907478U, 0x23c71c69U, 0xb89b624fU, 0xf7cc0a5eU, 0x2635b26dU, 0x6962da7cU,
+        0x8107dfbcU, 0xce50b7adU, 0x1fa90f9eU, 0x50fe678fU, 0xe5f41c4aU, 0xaaa3745bU,
+        0x7b5acc68U, 0x340da479U, 0xdc68a1b9U, 0x933fc9a8U, 0x42c6719bU, 0x0d91198aU,
+        0x96cd67acU, 0xd99a0fbdU, 0x0863b78eU, 0x4734df9fU, 0xaf51da5fU, 0xe006b24eU,
+        0x31ff0a7dU, 0x7ea8626cU, 0x0386eb86U, 0x4cd18397U, 0x9d283ba4U, 0xd27f53b5U,
+        0x3a1a5675U, 0x754d3e64U, 0xa4b48657U, 0xebe3ee46U, 0x70bf9060U, 0x3fe8f871U,
+        0xee114042U, 0xa1462853U, 0x49232d93U, 0x06744582U, 0xd78dfdb1U, 0x98da95a0U,
+        0xb958178cU, 0xf60f7f9dU, 0x27f6c7aeU, 0x68a1afbfU, 0x80c4aa7fU, 0xcf93c26eU,
+        0x1e6a7a5dU, 0x513d124cU, 0xca616c6aU, 0x8536047bU, 0x54cfbc48U, 0x1b98d459U,
+        0xf3fdd199U, 0xbcaab988U, 0x6d5301bbU, 0x220469aaU, 0x5f2ae040U, 0x107d8851U,
+        0xc1843062U, 0x8ed35873U, 0x66b65db3U, 0x29e135a2U, 0xf8188d91U, 0xb74fe580U,
+        0x2c139ba6U, 0x6344f3b7U, 0xb2bd4b84U, 0xfdea2395U, 0x158f2655U, 0x5ad84e44U,
+        0x8b21f677U, 0xc4769e66U, 0x717ce5a3U, 0x3e2b8db2U, 0xefd23581U, 0xa0855d90U,
+        0x48e05850U, 0x07b73041U, 0xd64e8872U, 0x9919e063U, 0x02459e45U, 0x4d12f654U,
+        0x9ceb4e67U, 0xd3bc2676U, 0x3bd923b6U, 0x748e4ba7U, 0xa577f394U, 0xea209b85U,
+        0x970e126fU, 0xd8597a7eU, 0x09a0c24dU, 0x46f7aa5cU, 0xae92af9cU, 0xe1c5c78dU,
+        0x303c7fbeU, 0x7f6b17afU, 0xe4376989U, 0xab600198U, 0x7a99b9abU, 0x35ced1baU,
+        0xddabd47aU, 0x92fcbc6bU, 0x43050458U, 0x0c526c49U,
+    },
+    {
+        0x00000000U, 0x5ba1dccaU, 0xb743b994U, 0xece2655eU, 0x6a466e9fU, 0x31e7b255U,
+        0xdd05d70bU, 0x86a40bc1U, 0xd48cdd3eU, 0x8f2d01f4U, 0x63cf64aaU, 0x386eb860U,
+        0xbecab3a1U, 0xe56b6f6bU, 0x09890a35U, 0x5228d6ffU, 0xadd8a7cbU, 0xf6797b01U,
+        0x1a9b1e5fU, 0x413ac295U, 0xc79ec954U, 0x9c3f159eU, 0x70dd70c0U, 0x2b7cac0aU,
+        0x79547af5U, 0x22f5a63fU, 0xce17c361U, 0x95b61fabU, 0x1312146aU, 0x48b3c8a0U,
+        0xa451adfeU, 0xfff07134U, 0x5f705221U, 0x04d18eebU, 0xe833ebb5U, 0xb392377fU,
+        0x35363cbeU, 0x6e97e074U, 0x8275852aU, 0xd9d459e0U, 0x8bfc8f1fU, 0xd05d53d5U,
+        0x3cbf368bU, 0x671eea41U, 0xe1bae180U, 0xba1b3d4aU, 0x56f95814U, 0x0d5884deU,
+        0xf2a8f5eaU, 0xa9092920U, 0x45eb4c7eU, 0x1e4a90b4U, 0x98ee9b75U, 0xc34f47bfU,
+        0x2fad22e1U, 0x740cfe2bU, 0x262428d4U, 0x7d85f41eU, 0x91679140U, 0xcac64d8aU,
+        0x4c62464bU, 0x17c39a81U, 0xfb21ffdfU, 0xa0802315U, 0xbee0a442U, 0xe5417888U,
+        0x09a31dd6U, 0x5202c11cU, 0xd4a6caddU, 0x8f071617U, 0x63e57349U, 0x3844af83U,
+        0x6a6c797cU, 0x31cda5b6U, 0xdd2fc0e8U, 0x868e1c22U, 0x002a17e3U, 0x5b8bcb29U,
+        0xb769ae77U, 0xecc872bdU, 0x13380389U, 0x4899df43U, 0xa47bba1dU, 0xffda66d7U,
+        0x797e6d16U, 0x22dfb1dcU, 0xce3dd482U, 0x959c0848U, 0xc7b4deb7U, 0x9c15027dU,
+        0x70f76723U, 0x2b56bbe9U, 0xadf2b028U, 0xf6536ce2U, 0x1ab109bcU, 0x4110d576U,
+        0xe190f663U, 0xba312aa9U, 0x56d34ff7U, 0x0d72933dU, 0x8bd698fcU, 0xd0774436U,
+        0x3c952168U, 0x6734fda2U, 0x351c2b5dU, 0x6ebdf797U, 0x825f92c9U, 0xd9fe4e03U,
+        0x5f5a45c2U, 0x04fb9908U, 0xe819fc56U, 0xb3b8209cU, 0x4c4851a8U, 0x17e98d62U,
+        0xfb0be83cU, 0xa0aa34f6U, 0x260e3f37U, 0x7dafe3fdU, 0x914d86a3U, 0xcaec5a69U,
+        0x98c48c96U, 0xc365505cU, 0x2f873502U, 0x7426e9c8U, 0xf282e209U, 0xa9233ec3U,
+        0x45c15b9dU, 0x1e608757U, 0x79005533U, 0x22a189f9U, 0xce43eca7U, 0x95e2306dU,
+        0x13463bacU, 0x48e7e766U, 0xa4058238U, 0xffa45ef2U, 0xad8c880dU, 0xf62d54c7U,
+        0x1acf3199U, 0x416eed53U, 0xc7cae692U, 0x9c6b3a58U, 0x70895f06U, 0x2b2883ccU,
+        0xd4d8f2f8U, 0x8f792e32U, 0x639b4b6cU, 0x383a97a6U, 0xbe9e9c67U, 0xe53f40adU,
+        0x09dd25f3U, 0x527cf939U, 0x00542fc6U, 0x5bf5f30cU, 0xb7179652U, 0xecb64a98U,
+        0x6a124159U, 0x31b39d93U, 0xdd51f8cdU, 0x86f02407U, 0x26700712U, 0x7dd1dbd8U,
+        0x9133be86U, 0xca92624cU, 0x4c36698dU, 0x1797b547U, 0xfb75d019U, 0xa0d40cd3U,
+        0xf2fcda2cU, 0xa95d06e6U, 0x45bf63b8U, 0x1e1ebf72U, 0x98bab4b3U, 0xc31b6879U,
+        0x2ff90d27U, 0x7458d1edU, 0x8ba8a0d9U, 0xd0097c13U, 0x3ceb194dU, 0x674ac587U,
+        0xe1eece46U, 0xba4f128cU, 0x56ad77d2U, 0x0d0cab18U, 0x5f247de7U, 0x0485a12dU,
+        0xe867c473U, 0xb3c618b9U, 0x35621378U, 0x6ec3cfb2U, 0x8221aaecU, 0xd9807626U,
+        0xc7e0f171U, 0x9c412dbbU, 0x70a348e5U, 0x2b02942fU, 0xada69feeU, 0xf6074324U,
+        0x1ae5267aU, 0x4144fab0U, 0x136c2c4fU, 0x48cdf085U, 0xa42f95dbU, 0xff8e4911U,
+        0x792a42d0U, 0x228b9e1aU, 0xce69fb44U, 0x95c8278eU, 0x6a3856baU, 0x31998a70U,
+        0xdd7bef2eU, 0x86da33e4U, 0x007e3825U, 0x5bdfe4efU, 0xb73d81b1U, 0xec9c5d7bU,
+        0xbeb48b84U, 0xe515574eU, 0x09f73210U, 0x5256eedaU, 0xd4f2e51bU, 0x8f5339d1U,
+        0x63b15c8fU, 0x38108045U, 0x9890a350U, 0xc3317f9aU, 0x2fd31ac4U, 0x7472c60eU,
+        0xf2d6cdcfU, 0xa9771105U, 0x4595745bU, 0x1e34a891U, 0x4c1c7e6eU, 0x17bda2a4U,
+        0xfb5fc7faU, 0xa0fe1b30U, 0x265a10f1U, 0x7dfbcc3bU, 0x9119a965U, 0xcab875afU,
+        0x3548049bU, 0x6ee9d851U, 0x820bbd0fU, 0xd9aa61c5U, 0x5f0e6a04U, 0x04afb6ceU,
+        0xe84dd390U, 0xb3ec0f5aU, 0xe1c4d9a5U, 0xba65056fU, 0x56876031U, 0x0d26bcfbU,
+        0x8b82b73aU, 0xd0236bf0U, 0x3cc10eaeU, 0x6760d264U,
+    },
+#endif
+};
+
+/* CRC32 polynomial 0x04c11db7 reflected (0xedb88320), least significant bit first. */
+static const uint32_t crc32_lsb_first_tables[ROBUSTO_CRC32_SLICES][256] = {
+    {
+        0x00000000U, 0x77073096U, 0xee0e612cU, 0x990951baU, 0x076dc419U, 0x706af48fU,
+        0xe963a535U, 0x9e6495a3U, 0x0edb8832U, 0x79dcb8a4U, 0xe0d5e91eU, 0x97d2d988U,
+        0x09b64c2bU, 0x7eb17cbdU, 0xe7b82d07U, 0x90bf1d91U, 0x1db71064U, 0x6ab020f2U,
+        0xf3b97148U, 0x84be41deU, 0x1adad47dU, 0x6ddde4ebU, 0xf4d4b551U, 0x83d385c7U,
+        0x136c9856U, 0x646ba8c0U, 0xfd62f97aU, 0x8a65c9ecU, 0x14015c4fU, 0x63066cd9U,
+        0xfa0f3d63U, 0x8d080df5U, 0x3b6e20c8U, 0x4c69105eU, 0xd56041e4U, 0xa2677172U,
+        0x3c03e4d1U, 0x4b04d447U, 0xd20d85fdU, 0xa50ab56bU, 0x35b5a8faU, 0x42b2986cU,
+        0xdbbbc9d6U, 0xacbcf940U, 0x32d86ce3U, 0x45df5c75U, 0xdcd60dcfU, 0xabd13d59U,
+        0x26d930acU, 0x51de003aU, 0xc8d75180U, 0xbfd06116U, 0x21b4f4b5U, 0x56b3c423U,
+        0xcfba9599U, 0xb8bda50fU, 0x2802b89eU, 0x5f058808U, 0xc60cd9b2U, 0xb10be924U,
+        0x2f6f7c87U, 0x58684c11U, 0xc1611dabU, 0xb6662d3dU, 0x76dc4190U, 0x01db7106U,
+        0x98d220bcU, 0xefd5102aU, 0x71b18589U, 0x06b6b51fU, 0x9fbfe4a5U, 0xe8b8d433U,
+        0x7807c9a2U, 0x0f00f934U, 0x9609a88eU, 0xe10e9818U, 0x7f6a0dbbU, 0x086d3d2dU,
+        0x91646c97U, 0xe6635c01U, 0x6b6b51f4U, 0x1c6c6162U, 0x856530d8U, 0xf262004eU,
+        0x6c0695edU, 0x1b01a57bU, 0x8208f4c1U, 0xf50fc457U, 0x65b0d9c6U, 0x12b7e950U,
+        0x8bbeb8eaU, 0xfcb9887cU, 0x62dd1ddfU, 0x15da2d49U, 0x8cd37cf3U, 0xfbd44c65U,
+        0x4db26158U, 0x3ab551ceU, 0xa3bc0074U, 0xd4bb30e2U, 0x4adfa541U, 0x3dd895d7U,
+        0xa4d1c46dU, 0xd3d6f4fbU, 0x4369e96aU, 0x346ed9fcU, 0xad678846U, 0xda60b8d0U,
+        0x44042d73U, 0x33031de5U, 0xaa0a4c5fU, 0xdd0d7cc9U, 0x5005713cU, 0x270241aaU,
+        0xbe0b1010U, 0xc90c2086U, 0x5768b525U, 0x206f85b3U, 0xb966d409U, 0xce61e49fU,
+        0x5edef90eU, 0x29d9c998U, 0xb0d09822U, 0xc7d7a8b4U, 0x59b33d17U, 0x2eb40d81U,
+        0xb7bd5c3bU, 0xc0ba6cadU, 0xedb88320U, 0x9abfb3b6U, 0x03b6e20cU, 0x74b1d29aU,
+        0xead54739U, 0x9dd277afU, 0x04db2615U, 0x73dc1683U, 0xe3630b12U, 0x94643b84U,
+        0x0d6d6a3eU, 0x7a6a5aa8U, 0xe40ecf0bU, 0x9309ff9dU, 0x0a00ae27U, 0x7d079eb1U,
+        0xf00f9344U, 0x8708a3d2U, 0x1e01f268U, 0x6906c2feU, 0xf762575dU, 0x806567cbU,
+        0x196c3671U, 0x6e6b06e7U, 0xfed41b76U, 0x89d32be0U, 0x10da7a5aU, 0x67dd4accU,
+        0xf9b9df6fU, 0x8ebeeff9U, 0x17b7be43U, 0x60b08ed5U, 0xd6d6a3e8U, 0xa1d1937eU,
+        0x38d8c2c4U, 0x4fdff252U, 0xd1bb67f1U, 0xa6bc5767U, 0x3fb506ddU, 0x48b2364bU,
+        0xd80d2bdaU, 0xaf0a1b4cU, 0x36034af6U, 0x41047a60U, 0xdf60efc3U, 0xa867df55U,
+        0x316e8eefU, 0x4669be79U, 0xcb61b38cU, 0xbc66831aU, 0x256fd2a0U, 0x5268e236U,
+        0xcc0c7795U, 0xbb0b4703U, 0x220216b9U, 0x5505262fU, 0xc5ba3bbeU, 0xb2bd0b28U,
+        0x2bb45a92U, 0x5cb36a04U, 0xc2d7ffa7U, 0xb5d0cf31U, 0x2cd99e8bU, 0x5bdeae1dU,
+        0x9b64c2b0U, 0xec63f226U, 0x756aa39cU, 0x026d930aU, 0x9c0906a9U, 0xeb0e363fU,
+        0x72076785U, 0x05005713U, 0x95bf4a82U, 0xe2b87a14U, 0x7bb12baeU, 0x0cb61b38U,
+        0x92d28e9bU, 0xe5d5be0dU, 0x7cdcefb7U, 0x0bdbdf21U, 0x86d3d2d4U, 0xf1d4e242U,
+        0x68ddb3f8U, 0x1fda836eU, 0x81be16cdU, 0xf6b9265bU, 0x6fb077e1U, 0x18b74777U,
+        0x88085ae6U, 0xff0f6a70U, 0x66063bcaU, 0x11010b5cU, 0x8f659effU, 0xf862ae69U,
+        0x616bffd3U, 0x166ccf45U, 0xa00ae278U, 0xd70dd2eeU, 0x4e048354U, 0x3903b3c2U,
+        0xa7672661U, 0xd06016f7U, 0x4969474dU, 0x3e6e77dbU, 0xaed16a4aU, 0xd9d65adcU,
+        0x40df0b66U, 0x37d83bf0U, 0xa9bcae53U, 0xdebb9ec5U, 0x47b2cf7fU, 0x30b5ffe9U,
+        0xbdbdf21cU, 0xcabac28aU, 0x53b39330U, 0x24b4a3a6U, 0xbad03605U, 0xcdd70693U,
+        0x54de5729U, 0x23d967bfU, 0xb3667a2eU, 0xc4614ab8U, 0x5d681b02U, 0x2a6f2b94U,
+        0xb40bbe37U, 0xc30c8ea1U, 0x5a05df1bU, 0x2d02ef8dU,
+    },
+#if ROBUSTO_CRC32_SLICES > 1
+    {
+        0x00000000U, 0x191b3141U, 0x32366282U, 0x2b2d53c3U, 0x646cc504U, 0x7d77f445U,
+        0x565aa786U, 0x4f4196c7U, 0xc8d98a08U, 0xd1c2bb49U, 0xfaefe88aU, 0xe3f4d9cbU,
+        0xacb54f0cU, 0xb5ae7e4dU, 0x9e832d8eU, 0x87981ccfU, 0x4ac21251U, 0x53d92310U,
+        0x78f470d3U, 0x61ef4192U, 0x2eaed755U, 0x37b5e614U, 0x1c98b5d7U, 0x05838496U,
+        0x821b9859U, 0x9b00a918U, 0xb02dfadbU, 0xa936cb9aU, 0xe6775d5dU, 0xff6c6c1cU,
+        0xd4413fdfU, 0xcd5a0e9eU, 0x958424a2U, 0x8c9f15e3U, 0xa7b24620U, 0xbea97761U,
+        0xf1e8e1a6U, 0xe8f3d0e7U, 0xc3de8324U, 0xdac5b265U, 0x5d5daeaaU, 0x44469febU,
+        0x6f6bcc28U, 0x7670fd69U, 0x39316baeU, 0x202a5aefU, 0x0b07092cU, 0x121c386dU,
+        0xdf4636f3U, 0xc65d07b2U, 0xed705471U, 0xf46b6530U, 0xbb2af3f7U, 0xa231c2b6U,
+        0x891c9175U, 0x9007a034U, 0x179fbcfbU, 0x0e848dbaU, 0x25a9de79U, 0x3cb2ef38U,
+        0x73f379ffU, 0x6ae848beU, 0x41c51b7dU, 0x58de2a3cU, 0xf0794f05U, 0xe9627e44U,
+        0xc24f2d87U, 0xdb541cc6U, 0x94158a01U, 0x8d0ebb40U, 0xa623e883U, 0xbf38d9c2U,
+        0x38a0c50dU, 0x21bbf44cU, 0x0a96a78fU, 0x138d96ceU, 0x5ccc0009U, 0x45d73148U,
+        0x6efa628bU, 0x77e153caU, 0xbabb5d54U, 0xa3a06c15U, 0x888d3fd6U, 0x91960e97U,
+        0xded79850U, 0xc7cca911U, 0xece1fad2U, 0xf5facb93U, 0x7262d75cU, 0x6b79e61dU,
+        0x4054b5deU, 0x594f849fU, 0x160e1258U, 0x0f152319U, 0x243870daU, 0x3d23419bU,
+        0x65fd6ba7U, 0x7ce65ae6U, 0x57cb0925U, 0x4ed03864U, 0x0191aea3U, 0x188a9fe2U,
+        0x33a7cc21U, 0x2abcfd60U, 0xad24e1afU, 0xb43fd0eeU, 0x9f12832dU, 0x8609b26cU,
+        0xc94824abU, 0xd05315eaU, 0xfb7e4629U, 0xe2657768U, 0x2f3f79f6U, 0x362448b7U,
+        0x1d091b74U, 0x04122a35U, 0x4b53bcf2U, 0x52488db3U, 0x7965de70U, 0x607eef31U,
+        0xe7e6f3feU, 0xfefdc2bfU, 0xd5d0917cU, 0xcccba03dU, 0x838a36faU, 0x9a9107bbU,
+        0xb1bc5478U, 0xa8a76539U, 0x3b83984bU, 0x2298a90aU, 0x09b5fac9U, 0x10aecb88U,
+        0x5fef5d4fU, 0x46f46c0eU, 0x6dd93fcdU, 0x74c20e8cU, 0xf35a1243U, 0xea412302U,
+        0xc16c70c1U, 0xd8774180U, 0x9736d747U, 0x8e2de606U, 0xa500b5c5U, 0xbc1b8484U,
+        0x71418a1aU, 0x685abb5bU, 0x4377e898U, 0x5a6cd9d9U, 0x152d4f1eU, 0x0c367e5fU,
+        0x271b2d9cU, 0x3e001cddU, 0xb9980012U, 0xa0833153U, 0x8bae6290U, 0x92b553d1U,
+        0xddf4c516U, 0xc4eff457U, 0xefc2a794U, 0xf6d996d5U, 0xae07bce9U, 0xb71c8da8U,
+        0x9c31de6bU, 0x852aef2aU, 0xca6b79edU, 0xd37048acU, 0xf85d1b6fU, 0xe1462a2eU,
+        0x66de36e1U, 0x7fc507a0U, 0x54e85463U, 0x4df36522U, 0x02b2f3e5U, 0x1ba9c2a4U,
+        0x30849167U, 0x299fa026U, 0xe4c5aeb8U, 0xfdde9ff9U, 0xd6f3cc3aU, 0xcfe8fd7bU,
+        0x80a96bbcU, 0x99b25afdU, 0xb29f093eU, 0xab84387fU, 0x2c1c24b0U, 0x350715f1U,
+        0x1e2a4632U, 0x07317773U, 0x4870e1b4U, 0x516bd0f5U, 0x7a468336U, 0x635db277U,
+        0xcbfad74eU, 0xd2e1e60fU, 0xf9ccb5ccU, 0xe0d7848dU, 0xaf96124aU, 0xb68d230bU,
+        0x9da070c8U, 0x84bb4189U, 0x03235d46U, 0x1a386c07U, 0x31153fc4U, 0x280e0e85U,
+        0x674f9842U, 0x7e54a903U, 0x5579fac0U, 0x4c62cb81U, 0x8138c51fU, 0x9823f45eU,
+        0xb30ea79dU, 0xaa1596dcU, 0xe554001bU, 0xfc4f315aU, 0xd7626299U, 0xce7953d8U,
+        0x49e14f17U, 0x50fa7e56U, 0x7bd72d95U, 0x62cc1cd4U, 0x2d8d8a13U, 0x3496bb52U,
+        0x1fbbe891U, 0x06a0d9d0U, 0x5e7ef3ecU, 0x4765c2adU, 0x6c48916eU, 0x7553a02fU,
+        0x3a1236e8U, 0x230907a9U, 0x0824546aU, 0x113f652bU, 0x96a779e4U, 0x8fbc48a5U,
+        0xa4911b66U, 0xbd8a2a27U, 0xf2cbbce0U, 0xebd08da1U, 0xc0fdde62U, 0xd9e6ef23U,
+        0x14bce1bdU, 0x0da7d0fcU, 0x268a833fU, 0x3f91b27eU, 0x70d024b9U, 0x69cb15f8U,
+        0x42e6463bU, 0x5bfd777aU, 0xdc656bb5U, 0xc57e5af4U, 0xee530937U, 0xf7483876U,
+        0xb809aeb1U, 0xa1129ff0U, 0x8a3fcc33U, 0x9324fd72U,
+    },
+    {
+        0x00000000U, 0x01c26a37U, 0x0384d46eU, 0x0246be59U, 0x0709a8dcU, 0x06cbc2ebU,
+        0x048d7cb2U, 0x054f1685U, 0x0e1351b8U, 0x0fd13b8fU, 0x0d9785d6U, 0x0c55efe1U,
+        0x091af964U, 0x08d89353U, 0x0a9e2d0aU, 0x0b5c473dU, 0x1c26a370U, 0x1de4c947U,
+        0x1fa2771eU, 0x1e601d29U, 0x1b2f0bacU, 0x1aed619bU, 0x18abdfc2U, 0x1969b5f5U,
+        0x1235f2c8U, 0x13f798ffU, 0x11b126a6U, 0x10734c91U, 0x153c5a14U, 0x14fe3023U,
+        0x16b88e7aU, 0x177ae44dU, 0x384d46e0U, 0x398f2cd7U, 0x3bc9928eU, 0x3a0bf8b9U,
+        0x3f44ee3cU, 0x3e86840bU, 0x3cc03a52U, 0x3d025065U, 0x365e1758U, 0x379c7d6fU,
+        0x35dac336U, 0x3418a901U, 0x3157bf84U, 0x3095d5b3U, 0x32d36beaU, 0x331101ddU,
+        0x246be590U, 0x25a98fa7U, 0x27ef31feU, 0x262d5bc9U, 0x23624d4cU, 0x22a0277bU,
+        0x20e69922U, 0x2124f315U, 0x2a78b428U, 0x2bbade1fU, 0x29fc6046U, 0x283e0a71U,
+        0x2d711cf4U, 0x2cb376c3U, 0x2ef5c89aU, 0x2f37a2adU, 0x709a8dc0U, 0x7158e7f7U,
+        0x731e59aeU, 0x72dc3399U, 0x7793251cU, 0x76514f2bU, 0x7417f172U, 0x75d59b45U,
+        0x7e89dc78U, 0x7f4bb64fU, 0x7d0d0816U, 0x7ccf6221U, 0x798074a4U, 0x78421e93U,
+        0x7a04a0caU, 0x7bc6cafdU, 0x6cbc2eb0U, 0x6d7e4487U, 0x6f38fadeU, 0x6efa90e9U,
+        0x6bb5866cU, 0x6a77ec5bU, 0x68315202U, 0x69f33835U, 0x62af7f08U, 0x636d153fU,
+        0x612bab66U, 0x60e9c151U, 0x65a6d7d4U, 0x6464bde3U, 0x662203baU, 0x67e0698dU,
+        0x48d7cb20U, 0x4915a117U, 0x4b531f4eU, 0x4a917579U, 0x4fde63fcU, 0x4e1c09cbU,
+        0x4c5ab792U, 0x4d98dda5U, 0x46c49a98U, 0x4706f0afU, 0x45404ef6U, 0x448224c1U,
+        0x41cd3244U, 0x400f5873U, 0x4249e62aU, 0x438b8c1dU, 0x54f16850U, 0x55330267U,
+        0x5775bc3eU, 0x56b7d609U, 0x53f8c08cU, 0x523aaabbU, 0x507c14e2U, 0x51be7ed5U,
+        0x5ae239e8U, 0x5b2053dfU, 0x5966ed86U, 0x58a487b1U, 0x5deb9134U, 0x5c29fb03U,
+        0x5e6f455aU, 0x5fad2f6dU, 0xe1351b80U, 0xe0f771b7U, 0xe2b1cfeeU, 0xe373a5d9U,
+        0xe63cb35cU, 0xe7fed96bU, 0xe5b86732U, 0xe47a0d05U, 0xef264a38U, 0xeee4200fU,
+        0xeca29e56U, 0xed60f461U, 0xe82fe2e4U, 0xe9ed88d3U, 0xebab368aU, 0xea695cbdU,
+        0xfd13b8f0U, 0xfcd1d2c7U, 0xfe976c9eU, 0xff5506a9U, 0xfa1a102cU, 0xfbd87a1bU,
+        0xf99ec442U, 0xf85cae75U, 0xf300e948U, 0xf2c2837fU, 0xf0843d26U, 0xf1465711U,
+        0xf4094194U, 0xf5cb2ba3U, 0xf78d95faU, 0xf64fffcdU, 0xd9785d60U, 0xd8ba3757U,
+        0xdafc890eU, 0xdb3ee339U, 0xde71f5bcU, 0xdfb39f8bU, 0xddf521d2U, 0xdc374be5U,
+        0xd76b0cd8U, 0xd6a966efU, 0xd4efd8b6U, 0xd52db281U, 0xd062a404U, 0xd1a0ce33U,
+        0xd3e6706aU, 0xd2241a5dU, 0xc55efe10U, 0xc49c9427U, 0xc6da2a7eU, 0xc7184049U,
+        0xc25756ccU, 0xc3953cfbU, 0xc1d382a2U, 0xc011e895U, 0xcb4dafa8U, 0xca8fc59fU,
+        0xc8c97bc6U, 0xc90b11f1U, 0xcc440774U, 0xcd866d43U, 0xcfc0d31aU, 0xce02b92dU,
+        0x91af9640U, 0x906dfc77U, 0x922b422eU, 0x93e92819U, 0x96a63e9cU, 0x976454abU,
+        0x9522eaf2U, 0x94e080c5U, 0x9fbcc7f8U, 0x9e7eadcfU, 0x9c381396U, 0x9dfa79a1U,
+        0x98b56f24U, 0x99770513U, 0x9b31bb4aU, 0x9af3d17dU, 0x8d893530U, 0x8c4b5f07U,
+        0x8e0de15eU, 0x8fcf8b69U, 0x8a809decU, 0x8b42f7dbU, 0x89044982U, 0x88c623b5U,
+        0x839a6488U, 0x82580ebfU, 0x801eb0e6U, 0x81dcdad1U, 0x8493cc54U, 0x8551a663U,
+        0x8717183aU, 0x86d5720dU, 0xa9e2d0a0U, 0xa820ba97U, 0xaa6604ceU, 0xaba46ef9U,
+        0xaeeb787cU, 0xaf29124bU, 0xad6fac12U, 0xacadc625U, 0xa7f18118U, 0xa633eb2fU,
+        0xa4755576U, 0xa5b73f41U, 0xa0f829c4U, 0xa13a43f3U, 0xa37cfdaaU, 0xa2be979dU,
+        0xb5c473d0U, 0xb40619e7U, 0xb640a7beU, 0xb782cd89U, 0xb2cddb0cU, 0xb30fb13bU,
+        0xb1490f62U, 0xb08b6555U, 0xbbd72268U, 0xba15485fU, 0xb853f606U, 0xb9919c31U,
+        0xbcde8ab4U, 0xbd1ce083U, 0xbf5a5edaU, 0xbe9834edU,
+    },
+    {
+        0x00000000U, 0xb8bc6765U, 0xaa09c88bU, 0x12b5afeeU, 0x8f629757U, 0x37def032U,
+        0x256b5fdcU, 0x9dd738b9U, 0xc5b428efU, 0x7d084f8aU, 0x6fbde064U, 0xd7018701U,
+        0x4ad6bfb8U, 0xf26ad8ddU, 0xe0df7733U, 0x58631056U, 0x5019579fU, 0xe8a530faU,
+        0xfa109f14U, 0x42acf871U, 0xdf7bc0c8U, 0x67c7a7adU, 0x75720843U, 0xcdce6f26U,
+        0x95ad7f70U, 0x2d111815U, 0x3fa4b7fbU, 0x8718d09eU, 0x1acfe827U, 0xa2738f42U,
+        0xb0c620acU, 0x087a47c9U, 0xa032af3eU, 0x188ec85bU, 0x0a3b67b5U, 0xb28700d0U,
+        0x2f503869U, 0x97ec5f0cU, 0x8559f0e2U, 0x3de59787U, 0x658687d1U, 0xdd3ae0b4U,
+        0xcf8f4f5aU, 0x7733283fU, 0xeae41086U, 0x525877e3U, 0x40edd80dU, 0xf851bf68U,
+        0xf02bf8a1U, 0x48979fc4U, 0x5a22302aU, 0xe29e574fU, 0x7f496ff6U, 0xc7f50893U,
+        0xd540a77dU, 0x6dfcc018U, 0x359fd04eU, 0x8d23b72bU, 0x9f9618c5U, 0x272a7fa0U,
+        0xbafd4719U, 0x0241207cU, 0x10f48f92U, 0xa848e8f7U, 0x9b14583dU, 0x23a83f58U,
+        0x311d90b6U, 0x89a1f7d3U, 0x1476cf6aU, 0xaccaa80fU, 0xbe7f07e1U, 0x06c36084U,
+        0x5ea070d2U, 0xe61c17b7U, 0xf4a9b859U, 0x4c15df3cU, 0xd1c2e785U, 0x697e80e0U,
+        0x7bcb2f0eU, 0xc377486bU, 0xcb0d0fa2U, 0x73b168c7U, 0x6104c729U, 0xd9b8a04cU,
+        0x446f98f5U, 0xfcd3ff90U, 0xee66507eU, 0x56da371bU, 0x0eb9274dU, 0xb6054028U,
+        0xa4b0efc6U, 0x1c0c88a3U, 0x81dbb01aU, 0x3967d77fU, 0x2bd27891U, 0x936e1ff4U,
+        0x3b26f703U, 0x839a9066U, 0x912f3f88U, 0x299358edU, 0xb4446054U, 0x0cf80731U,
+        0x1e4da8dfU, 0xa6f1cfbaU, 0xfe92dfecU, 0x462eb889U, 0x549b1767U, 0xec277002U,
+        0x71f048bbU, 0xc94c2fdeU, 0xdbf98030U, 0x6345e755U, 0x6b3fa09cU, 0xd383c7f9U,
+        0xc1366817U, 0x798a0f72U, 0xe45d37cbU, 0x5ce150aeU, 0x4e54ff40U, 0xf6e89825U,
+        0xae8b8873U, 0x1637ef16U, 0x048240f8U, 0xbc3e279dU, 0x21e91f24U, 0x99557841U,
+        0x8be0d7afU, 0x335cb0caU, 0xed59b63bU, 0x55e5d15eU, 0x47507eb0U, 0xffec19d5U,
+        0x623b216cU, 0xda874609U, 0xc832e9e7U, 0x708e8e82U, 0x28ed9ed4U, 0x9051f9b1U,
+        0x82e4565fU, 0x3a58313aU, 0xa78f0983U, 0x1f336ee6U, 0x0d86c108U, 0xb53aa66dU,
+        0xbd40e1a4U, 0x05fc86c1U, 0x1749292fU, 0xaff54e4aU, 0x322276f3U, 0x8a9e1196U,
+        0x982bbe78U, 0x2097d91dU, 0x78f4c94bU, 0xc048ae2eU, 0xd2fd01c0U, 0x6a4166a5U,
+        0xf7965e1cU, 0x4f2a3979U, 0x5d9f9697U, 0xe523f1f2U, 0x4d6b1905U, 0xf5d77e60U,
+        0xe762d18eU, 0x5fdeb6ebU, 0xc2098e52U, 0x7ab5e937U, 0x680046d9U, 0xd0bc21bcU,
+        0x88df31eaU, 0x3063568fU, 0x22d6f961U, 0x9a6a9e04U, 0x07bda6bdU, 0xbf01c1d8U,
+        0xadb46e36U, 0x15080953U, 0x1d724e9aU, 0xa5ce29ffU, 0xb77b8611U, 0x0fc7e174U,
+        0x9210d9cdU, 0x2aacbea8U, 0x38191146U, 0x80a57623U, 0xd8c66675U, 0x607a0110U,
+        0x72cfaefeU, 0xca73c99bU, 0x57a4f122U, 0xef189647U, 0xfdad39a9U, 0x45115eccU,
+        0x764dee06U, 0xcef18963U, 0xdc44268dU, 0x64f841e8U, 0xf92f7951U, 0x41931e34U,
+        0x5326b1daU, 0xeb9ad6bfU, 0xb3f9c6e9U, 0x0b45a18cU, 0x19f00e62U, 0xa14c6907U,
+        0x3c9b51beU, 0x842736dbU, 0x96929935U, 0x2e2efe50U, 0x2654b999U, 0x9ee8defcU,
+        0x8c5d7112U, 0x34e11677U, 0xa9362eceU, 0x118a49abU, 0x033fe645U, 0xbb838120U,
+        0xe3e09176U, 0x5b5cf613U, 0x49e959fdU, 0xf1553e98U, 0x6c820621U, 0xd43e6144U,
+        0xc68bceaaU, 0x7e37a9cfU, 0xd67f4138U, 0x6ec3265dU, 0x7c7689b3U, 0xc4caeed6U,
+        0x591dd66fU, 0xe1a1b10aU, 0xf3141ee4U, 0x4ba87981U, 0x13cb69d7U, 0xab770eb2U,
+        0xb9c2a15cU, 0x017ec639U, 0x9ca9fe80U, 0x241599e5U, 0x36a0360bU, 0x8e1c516eU,
+        0x866616a7U, 0x3eda71c2U, 0x2c6fde2cU, 0x94d3b949U, 0x090481f0U, 0xb1b8e695U,
+        0xa30d497bU, 0x1bb12e1eU, 0x43d23e48U, 0xfb6e592dU, 0xe9dbf6c3U, 0x516791a6U,
+        0xccb0a91fU, 0x740cce7aU, 0x66b96194U, 0xde0506f1U,
+    },
+    {
+        0x00000000U, 0x3d6029b0U, 0x7ac05360U, 0x47a07ad0U, 0xf580a6c0U, 0xc8e08f70U,
+        0x8f40f5a0U, 0xb220dc10U, 0x30704bc1U, 0x0d106271U, 0x4ab018a1U, 0x77d03111U,
+        0xc5f0ed01U, 0xf890c4b1U, 0xbf30be61U, 0x825097d1U, 0x60e09782U, 0x5d80be32U,
+        0x1a20c4e2U, 0x2740ed52U, 0x95603142U, 0xa80018f2U, 0xefa06222U, 0xd2c04b92U,
+        0x5090dc43U, 0x6df0f5f3U, 0x2a508f23U, 0x1730a693U, 0xa5107a83U, 0x98705333U,
+        0xdfd029e3U, 0xe2b00053U, 0xc1c12f04U, 0xfca106b4U, 0xbb017c64U, 0x866155d4U,
+        0x344189c4U, 0x0921a074U, 0x4e81daa4U, 0x73e1f314U, 0xf1b164c5U, 0xccd14d75U,
+        0x8b7137a5U, 0xb6111e15U, 0x0431c205U, 0x3951ebb5U, 0x7ef19165U, 0x4391b8d5U,
+        0xa121b886U, 0x9c419136U, 0xdbe1ebe6U, 0xe681c256U, 0x54a11e46U, 0x69c137f6U,
+        0x2e614d26U, 0x13016496U, 0x9151f347U, 0xac31daf7U, 0xeb91a027U, 0xd6f18997U,
+        0x64d15587U, 0x59b17c37U, 0x1e1106e7U, 0x23712f57U, 0x58f35849U, 0x659371f9U,
+        0x22330b29U, 0x1f532299U, 0xad73fe89U, 0x9013d739U, 0xd7b3ade9U, 0xead38459U,
+        0x68831388U, 0x55e33a38U, 0x124340e8U, 0x2f236958U, 0x9d03b548U, 0xa0639cf8U,
+        0xe7c3e628U, 0xdaa3cf98U, 0x3813cfcbU, 0x0573e67bU, 0x42d39cabU, 0x7fb3b51bU,
+        0xcd93690bU, 0xf0f340bbU, 0xb7533a6bU, 0x8a3313dbU, 0x0863840aU, 0x3503adbaU,
+        0x72a3d76aU, 0x4fc3fedaU, 0xfde322caU, 0xc0830b7aU, 0x872371aaU, 0xba43581aU,
+        0x9932774dU, 0xa4525efdU, 0xe3f2242dU, 0xde920d9dU, 0x6cb2d18dU, 0x51d2f83dU,
+        0x167282edU, 0x2b12ab5dU, 0xa9423c8cU, 0x9422153cU, 0xd3826fecU, 0xeee2465cU,
+        0x5cc29a4cU, 0x61a2b3fcU, 0x2602c92cU, 0x1b62e09cU, 0xf9d2e0cfU, 0xc4b2c97fU,
+        0x8312b3afU, 0xbe729a1fU, 0x0c52460fU, 0x31326fbfU, 0x7692156fU, 0x4bf23cdfU,
+        0xc9a2ab0eU, 0xf4c282beU, 0xb362f86eU, 0x8e02d1deU, 0x3c220dceU, 0x0142247eU,
+        0x46e25eaeU, 0x7b82771eU, 0xb1e6b092U, 0x8c869922U, 0xcb26e3f2U, 0xf646ca42U,
+        0x44661652U, 0x79063fe2U, 0x3ea64532U, 0x03c66c82U, 0x8196fb53U, 0xbcf6d2e3U,
+        0xfb56a833U, 0xc6368183U, 0x74165d93U, 0x49767423U, 0x0ed60ef3U, 0x33b62743U,
+        0xd1062710U, 0xec660ea0U, 0xabc67470U, 0x96a65dc0U, 0x248681d0U, 0x19e6a860U,
+        0x5e46d2b0U, 0x6326fb00U, 0xe1766cd1U, 0xdc164561U, 0x9bb63fb1U, 0xa6d61601U,
+        0x14f6ca11U, 0x2996e3a1U, 0x6e369971U, 0x5356b0c1U, 0x70279f96U, 0x4d47b626U,
+        0x0ae7ccf6U, 0x3787e546U, 0x85a73956U, 0xb8c710e6U, 0xff676a36U, 0xc2074386U,
+        0x4057d457U, 0x7d37fde7U, 0x3a978737U, 0x07f7ae87U, 0xb5d77297U, 0x88b75b27U,
+        0xcf1721f7U, 0xf2770847U, 0x10c70814U, 0x2da721a4U, 0x6a075b74U, 0x576772c4U,
+        0xe547aed4U, 0xd8278764U, 0x9f87fdb4U, 0xa2e7d404U, 0x20b743d5U, 0x1dd76a65U,
+        0x5a7710b5U, 0x67173905U, 0xd537e515U, 0xe857cca5U, 0xaff7b675U, 0x92979fc5U,
+        0xe915e8dbU, 0xd475c16bU, 0x93d5bbbbU, 0xaeb5920bU, 0x1c954e1bU, 0x21f567abU,
+        0x66551d7bU, 0x5b3534cbU, 0xd965a31aU, 0xe4058aaaU, 0xa3a5f07aU, 0x9ec5d9caU,
+        0x2ce505daU, 0x11852c6aU, 0x562556baU, 0x6b457f0aU, 0x89f57f59U, 0xb49556e9U,
+        0xf3352c39U, 0xce550589U, 0x7c75d999U, 0x4115f029U, 0x06b58af9U, 0x3bd5a349U,
+        0xb9853498U, 0x84e51d28U, 0xc34567f8U, 0xfe254e48U, 0x4c059258U, 0x7165bbe8U,
+        0x36c5c138U, 0x0ba5e888U, 0x28d4c7dfU, 0x15b4ee6fU, 0x521494bfU, 0x6f74bd0fU,
+        0xdd54611fU, 0xe03448afU, 0xa794327fU, 0x9af41bcfU, 0x18a48c1eU, 0x25c4a5aeU,
+        0x6264df7eU, 0x5f04f6ceU, 0xed242adeU, 0xd044036eU, 0x97e479beU, 0xaa84500eU,
+        0x4834505dU, 0x755479edU, 0x32f4033dU, 0x0f942a8dU, 0xbdb4f69dU, 0x80d4df2dU,
+        0xc774a5fdU, 0xfa148c4dU, 0x78441b9cU, 0x4524322cU, 0x028448fcU, 0x3fe4614cU,
+        0x8dc4bd5cU, 0xb0a494ecU, 0xf704ee3cU, 0xca64c78cU,
+    },
+    {
+        0x00000000U, 0xcb5cd3a5U, 0x4dc8a10bU, 0x869472aeU, 0x9b914216U, 0x50cd91b3U,
+        0xd659e31dU, 0x1d0530b8U, 0xec53826dU, 0x270f51c8U, 0xa19b2366U, 0x6ac7f0c3U,
+        0x77c2c07bU, 0xbc9e13deU, 0x3a0a6170U, 0xf156b2d5U, 0x03d6029bU, 0xc88ad13eU,
+        0x4e1ea390U, 0x85427035U, 0x9847408dU, 0x531b9328U, 0xd58fe186U, 0x1ed33223U,
+        0xef8580f6U, 0x24d95353U, 0xa24d21fdU, 0x6911f258U, 0x7414c2e0U, 0xbf481145U,
+        0x39dc63ebU, 0xf280b04eU, 0x07ac0536U, 0xccf0d693U, 0x4a64a43dU, 0x81387798U,
+        0x9c3d4720U, 0x57619485U, 0xd1f5e62bU, 0x1aa9358eU, 0xebff875bU, 0x20a354feU,
+        0xa6372650U, 0x6d6bf5f5U, 0x706ec54dU, 0xbb3216e8U, 0x3da66446U, 0xf6fab7e3U,
+        0x047a07adU, 0xcf26d408U, 0x49b2a6a6U, 0x82ee7503U, 0x9feb45bbU, 0x54b7961eU,
+        0xd223e4b0U, 0x197f3715U, 0xe82985c0U, 0x23755665U, 0xa5e124cbU, 0x6ebdf76eU,
+        0x73b8c7d6U, 0xb8e41473U, 0x3e7066ddU, 0xf52cb578U, 0x0f580a6cU, 0xc404d9c9U,
+        0x4290ab67U, 0x89cc78c2U, 0x94c9487aU, 0x5f959bdfU, 0xd901e971U, 0x125d3ad4U,
+        0xe30b8801U, 0x28575ba4U, 0xaec3290aU, 0x659ffaafU, 0x789aca17U, 0xb3c619b2U,
+        0x35526b1cU, 0xfe0eb8b9U, 0x0c8e08f7U, 0xc7d2db52U, 0x4146a9fcU, 0x8a1a7a59U,
+        0x971f4ae1U, 0x5c439944U, 0xdad7ebeaU, 0x118b384fU, 0xe0dd8a9aU, 0x2b81593fU,
+        0xad152b91U, 0x6649f834U, 0x7b4cc88cU, 0xb0101b29U, 0x36846987U, 0xfdd8ba22U,
+        0x08f40f5aU, 0xc3a8dcffU, 0x453cae51U, 0x8e607df4U, 0x93654d4cU, 0x58399ee9U,
+        0xdeadec47U, 0x15f13fe2U, 0xe4a78d37U, 0x2ffb5e92U, 0xa96f2c3cU, 0x6233ff99U,
+        0x7f36cf21U, 0xb46a1c84U, 0x32fe6e2aU, 0xf9a2bd8fU, 0x0b220dc1U, 0xc07ede64U,
+        0x46eaaccaU, 0x8db67f6fU, 0x90b34fd7U, 0x5bef9c72U, 0xdd7beedcU, 0x16273d79U,
+        0xe7718facU, 0x2c2d5c09U, 0xaab92ea7U, 0x61e5fd02U, 0x7ce0cdbaU, 0xb7bc1e1fU,
+        0x31286cb1U, 0xfa74bf14U, 0x1eb014d8U, 0xd5ecc77dU, 0x5378b5d3U, 0x98246676U,
+        0x852156ceU, 0x4e7d856bU, 0xc8e9f7c5U, 0x03b52460U, 0xf2e396b5U, 0x39bf4510U,
+        0xbf2b37beU, 0x7477e41bU, 0x6972d4a3U, 0xa22e0706U, 0x24ba75a8U, 0xefe6a60dU,
+        0x1d661643U, 0xd63ac5e6U, 0x50aeb748U, 0x9bf264edU, 0x86f75455U, 0x4dab87f0U,
+        0xcb3ff55eU, 0x006326fbU, 0xf135942eU, 0x3a69478bU, 0xbcfd3525U, 0x77a1e680U,
+        0x6aa4d638U, 0xa1f8059dU, 0x276c7733U, 0xec30a496U, 0x191c11eeU, 0xd240c24bU,
+        0x54d4b0e5U, 0x9f886340U, 0x828d53f8U, 0x49d1805dU, 0xcf45f2f3U, 0x04192156U,
+        0xf54f9383U, 0x3e134026U, 0xb8873288U, 0x73dbe12dU, 0x6eded195U, 0xa5820230U,
+        0x2316709eU, 0xe84aa33bU, 0x1aca1375U, 0xd196c0d0U, 0x5702b27eU, 0x9c5e61dbU,
+        0x815b5163U, 0x4a0782c6U, 0xcc93f068U, 0x07cf23cdU, 0xf6999118U, 0x3dc542bdU,
+        0xbb513013U, 0x700de3b6U, 0x6d08d30eU, 0xa65400abU, 0x20c07205U, 0xeb9ca1a0U,
+        0x11e81eb4U, 0xdab4cd11U, 0x5c20bfbfU, 0x977c6c1aU, 0x8a795ca2U, 0x41258f07U,
+        0xc7b1fda9U, 0x0ced2e0cU, 0xfdbb9cd9U, 0x36e74f7cU, 0xb0733dd2U, 0x7b2fee77U,
+        0x662adecfU, 0xad760d6aU, 0x2be27fc4U, 0xe0beac61U, 0x123e1c2fU, 0xd962cf8aU,
+        0x5ff6bd24U, 0x94aa6e81U, 0x89af5e39U, 0x42f38d9cU, 0xc467ff32U, 0x0f3b2c97U,
+        0xfe6d9e42U, 0x35314de7U, 0xb3a53f49U, 0x78f9ececU, 0x65fcdc54U, 0xaea00ff1U,
+        0x28347d5fU, 0xe368aefaU, 0x16441b82U, 0xdd18c827U, 0x5b8cba89U, 0x90d0692cU,
+        0x8dd55994U, 0x46898a31U, 0xc01df89fU, 0x0b412b3aU, 0xfa1799efU, 0x314b4a4aU,
+        0xb7df38e4U, 0x7c83eb41U, 0x6186dbf9U, 0xaada085cU, 0x2c4e7af2U, 0xe712a957U,
+        0x15921919U, 0xdececabcU, 0x585ab812U, 0x93066bb7U, 0x8e035b0fU, 0x455f88aaU,
+        0xc3cbfa04U, 0x089729a1U, 0xf9c19b74U, 0x329d48d1U, 0xb4093a7fU, 0x7f55e9daU,
+        0x6250d962U, 0xa90c0ac7U, 0x2f987869U, 0xe4c4abccU,
+    },
+    {
+        0x00000000U, 0xa6770bb4U, 0x979f1129U, 0x31e81a9dU, 0xf44f2413U, 0x52382fa7U,
+        0x63d0353aU, 0xc5a73e8eU, 0x33ef4e67U, 0x959845d3U, 0xa4705f4eU, 0x020754faU,
+        0xc7a06a74U, 0x61d761c0U, 0x503f7b5dU, 0xf64870e9U, 0x67de9cceU, 0xc1a9977aU,
+        0xf0418de7U, 0x56368653U, 0x9391b8ddU, 0x35e6b369U, 0x040ea9f4U, 0xa279a240U,
+        0x5431d2a9U, 0xf246d91dU, 0xc3aec380U, 0x65d9c834U, 0xa07ef6baU, 0x0609fd0eU,
+        0x37e1e793U, 0x9196ec27U, 0xcfbd399cU, 0x69ca3228U, 0x582228b5U, 0xfe552301U,
+        0x3bf21d8fU, 0x9d85163bU, 0xac6d0ca6U, 0x0a1a0712U, 0xfc5277fbU, 0x5a257c4fU,
+        0x6bcd66d2U, 0xcdba6d66U, 0x081d53e8U, 0xae6a585cU, 0x9f8242c1U, 0x39f54975U,
+        0xa863a552U, 0x0e14aee6U, 0x3ffcb47bU, 0x998bbfcfU, 0x5c2c8141U, 0xfa5b8af5U,
+        0xcbb39068U, 0x6dc49bdcU, 0x9b8ceb35U, 0x3dfbe081U, 0x0c13fa1cU, 0xaa64f1a8U,
+        0x6fc3cf26U, 0xc9b4c492U, 0xf85cde0fU, 0x5e2bd5bbU, 0x440b7579U, 0xe27c7ecdU,
+        0xd3946450U, 0x75e36fe4U, 0xb044516aU, 0x16335adeU, 0x27db4043U, 0x81ac4bf7U,
+        0x77e43b1eU, 0xd19330aaU, 0xe07b2a37U, 0x460c2183U, 0x83ab1f0dU, 0x25dc14b9U,
+        0x14340e24U, 0xb2430590U, 0x23d5e9b7U, 0x85a2e203U, 0xb44af89eU, 0x123df32aU,
+        0xd79acda4U, 0x71edc610U, 0x4005dc8dU, 0xe672d739U, 0x103aa7d0U, 0xb64dac64U,
+        0x87a5b6f9U, 0x21d2bd4dU, 0xe47583c3U, 0x42028877U, 0x73ea92eaU, 0xd59d995eU,
+        0x8bb64ce5U, 0x2dc14751U, 0x1c295dccU, 0xba5e5678U, 0x7ff968f6U, 0xd98e6342U,
+        0xe86679dfU, 0x4e11726bU, 0xb8590282U, 0x1e2e0936U, 0x2fc613abU, 0x89b1181fU,
+        0x4c162691U, 0xea612d25U, 0xdb8937b8U, 0x7dfe3c0cU, 0xec68d02bU, 0x4a1fdb9fU,
+        0x7bf7c102U, 0xdd80cab6U, 0x1827f438U, 0xbe50ff8cU, 0x8fb8e511U, 0x29cfeea5U,
+        0xdf879e4cU, 0x79f095f8U, 0x48188f65U, 0xee6f84d1U, 0x2bc8ba5fU, 0x8dbfb1ebU,
+        0xbc57ab76U, 0x1a20a0c2U, 0x8816eaf2U, 0x2e61e146U, 0x1f89fbdbU, 0xb9fef06fU,
+        0x7c59cee1U, 0xda2ec555U, 0xebc6dfc8U, 0x4db1d47cU, 0xbbf9a495U, 0x1d8eaf21U,
+        0x2c66b5bcU, 0x8a11be08U, 0x4fb68086U, 0xe9c18b32U, 0xd82991afU, 0x7e5e9a1bU,
+        0xefc8763cU, 0x49bf7d88U, 0x78576715U, 0xde206ca1U, 0x1b87522fU, 0xbdf0599bU,
+        0x8c184306U, 0x2a6f48b2U, 0xdc27385bU, 0x7a5033efU, 0x4bb82972U, 0xedcf22c6U,
+        0x28681c48U, 0x8e1f17fcU, 0xbff70d61U, 0x198006d5U, 0x47abd36eU, 0xe1dcd8daU,
+        0xd034c247U, 0x7643c9f3U, 0xb3e4f77dU, 0x1593fcc9U, 0x247be654U, 0x820cede0U,
+        0x74449d09U, 0xd23396bdU, 0xe3db8c20U, 0x45ac8794U, 0x800bb91aU, 0x267cb2aeU,
+        0x1794a833U, 0xb1e3a387U, 0x20754fa0U, 0x86024414U, 0xb7ea5e89U, 0x119d553dU,
+        0xd43a6bb3U, 0x724d6007U, 0x43a57a9aU, 0xe5d2712eU, 0x139a01c7U, 0xb5ed0a73U,
+        0x840510eeU, 0x22721b5aU, 0xe7d525d4U, 0x41a22e60U, 0x704a34fdU, 0xd63d3f49U,
+        0xcc1d9f8bU, 0x6a6a943fU, 0x5b828ea2U, 0xfdf58516U, 0x3852bb98U, 0x9e25b02cU,
+        0xafcdaab1U, 0x09baa105U, 0xfff2d1ecU, 0x5985da58U, 0x686dc0c5U, 0xce1acb71U,
+        0x0bbdf5ffU, 0xadcafe4bU, 0x9c22e4d6U, 0x3a55ef62U, 0xabc30345U, 0x0db408f1U,
+        0x3c5c126cU, 0x9a2b19d8U, 0x5f8c2756U, 0xf9fb2ce2U, 0xc813367fU, 0x6e643dcbU,
+        0x982c4d22U, 0x3e5b4696U, 0x0fb35c0bU, 0xa9c457bfU, 0x6c636931U, 0xca146285U,
+        0xfbfc7818U, 0x5d8b73acU, 0x03a0a617U, 0xa5d7ada3U, 0x943fb73eU, 0x3248bc8aU,
+        0xf7ef8204U, 0x519889b0U, 0x6070932dU, 0xc6079899U, 0x304fe870U, 0x9638e3c4U,
+        0xa7d0f959U, 0x01a7f2edU, 0xc400cc63U, 0x6277c7d7U, 0x539fdd4aU, 0xf5e8d6feU,
+        0x647e3ad9U, 0xc209316dU, 0xf3e12bf0U, 0x55962044U, 0x90311ecaU, 0x3646157eU,
+        0x07ae0fe3U, 0xa1d90457U, 0x579174beU, 0xf1e67f0aU, 0xc00e6597U, 0x66796e23U,
+        0xa3de50adU, 0x05a95b19U, 0x34414184U, 0x92364a30U,
+    },
+    {
+        0x00000000U, 0xccaa009eU, 0x4225077dU, 0x8e8f07e3U, 0x844a0efaU, 0x48e00e64U,
+        0xc66f0987U, 0x0ac50919U, 0xd3e51bb5U, 0x1f4f1b2bU, 0x91c01cc8U, 0x5d6a1c56U,
+        0x57af154fU, 0x9b0515d1U, 0x158a1232U, 0xd92012acU, 0x7cbb312bU, 0xb01131b5U,
+        0x3e9e3656U, 0xf23436c8U, 0xf8f13fd1U, 0x345b3f4fU, 0xbad438acU, 0x767e3832U,
+        0xaf5e2a9eU, 0x63f42a00U, 0xed7b2de3U, 0x21d12d7dU, 0x2b142464U, 0xe7be24faU,
+        0x69312319U, 0xa59b2387U, 0xf9766256U, 0x35dc62c8U, 0xbb53652bU, 0x77f965b5U,
+        0x7d3c6cacU, 0xb1966c32U, 0x3f196bd1U, 0xf3b36b4fU, 0x2a9379e3U, 0xe639797dU,
+        0x68b67e9eU, 0xa41c7e00U, 0xaed97719U, 0x62737787U, 0xecfc7064U, 0x205670faU,
+        0x85cd537dU, 0x496753e3U, 0xc7e85400U, 0x0b42549eU, 0x01875d87U, 0xcd2d5d19U,
+        0x43a25afaU, 0x8f085a64U, 0x562848c8U, 0x9a824856U, 0x140d4fb5U, 0xd8a74f2bU,
+        0xd2624632U, 0x1ec846acU, 0x9047414fU, 0x5ced41d1U, 0x299dc2edU, 0xe537c273U,
+        0x6bb8c590U, 0xa712c50eU, 0xadd7cc17U, 0x617dcc89U, 0xeff2cb6aU, 0x2358cbf4U,
+        0xfa78d958U, 0x36d2d9c6U, 0xb85dde25U, 0x74f7debbU, 0x7e32d7a2U, 0xb298d73cU,
+        0x3c17d0dfU, 0xf0bdd041U, 0x5526f3c6U, 0x998cf358U, 0x1703f4bbU, 0xdba9f425U,
+        0xd16cfd3cU, 0x1dc6fda2U, 0x9349fa41U, 0x5fe3fadfU, 0x86c3e873U, 0x4a69e8edU,
+        0xc4e6ef0eU, 0x084cef90U, 0x0289e689U, 0xce23e617U, 0x40ace1f4U, 0x8c06e16aU,
+        0xd0eba0bbU, 0x1c41a025U, 0x92cea7c6U, 0x5e64a758U, 0x54a1ae41U, 0x980baedfU,
+        0x1684a93cU, 0xda2ea9a2U, 0x030ebb0eU, 0xcfa4bb90U, 0x412bbc73U, 0x8d81bcedU,
+        0x8744b5f4U, 0x4beeb56aU, 0xc561b289U, 0x09cbb217U, 0xac509190U, 0x60fa910eU,
+        0xee7596edU, 0x22df9673U, 0x281a9f6aU, 0xe4b09ff4U, 0x6a3f9817U, 0xa6959889U,
+        0x7fb58a25U, 0xb31f8abbU, 0x3d908d58U, 0xf13a8dc6U, 0xfbff84dfU, 0x37558441U,
+        0xb9da83a2U, 0x7570833cU, 0x533b85daU, 0x9f918544U, 0x111e82a7U, 0xddb48239U,
+        0xd7718b20U, 0x1bdb8bbeU, 0x95548c5dU, 0x59fe8cc3U, 0x80de9e6fU, 0x4c749ef1U,
+        0xc2fb9912U, 0x0e51998cU, 0x04949095U, 0xc83e900bU, 0x46b197e8U, 0x8a1b9776U,
+        0x2f80b4f1U, 0xe32ab46fU, 0x6da5b38cU, 0xa10fb312U, 0xabcaba0bU, 0x6760ba95U,
+        0xe9efbd76U, 0x2545bde8U, 0xfc65af44U, 0x30cfafdaU, 0xbe40a839U, 0x72eaa8a7U,
+        0x782fa1beU, 0xb485a120U, 0x3a0aa6c3U, 0xf6a0a65dU, 0xaa4de78cU, 0x66e7e712U,
+        0xe868e0f1U, 0x24c2e06fU, 0x2e07e976U, 0xe2ade9e8U, 0x6c22ee0bU, 0xa088ee95U,
+        0x79a8fc39U, 0xb502fca7U, 0x3b8dfb44U, 0xf727fbdaU, 0xfde2f2c3U, 0x3148f25dU,
+        0xbfc7f5beU, 0x736df520U, 0xd6f6d6a7U, 0x1a5cd639U, 0x94d3d1daU, 0x5879d144U,
+        0x52bcd85dU, 0x9e16d8c3U, 0x1099df20U, 0xdc33dfbeU, 0x0513cd12U, 0xc9b9cd8cU,
+        0x4736ca6fU, 0x8b9ccaf1U, 0x8159c3e8U, 0x4df3c376U, 0xc37cc495U, 0x0fd6c40bU,
+        0x7aa64737U, 0xb60c47a9U, 0x3883404aU, 0xf42940d4U, 0xfeec49cdU, 0x32464953U,
+        0xbcc94eb0U, 0x70634e2eU, 0xa9435c82U, 0x65e95c1cU, 0xeb665bffU, 0x27cc5b61U,
+        0x2d095278U, 0xe1a352e6U, 0x6f2c5505U, 0xa386559bU, 0x061d761cU, 0xcab77682U,
+        0x44387161U, 0x889271ffU, 0x825778e6U, 0x4efd7878U, 0xc0727f9bU, 0x0cd87f05U,
+        0xd5f86da9U, 0x19526d37U, 0x97dd6ad4U, 0x5b776a4aU, 0x51b26353U, 0x9d1863cdU,
+        0x1397642eU, 0xdf3d64b0U, 0x83d02561U, 0x4f7a25ffU, 0xc1f5221cU, 0x0d5f2282U,
+        0x079a2b9bU, 0xcb302b05U, 0x45bf2ce6U, 0x89152c78U, 0x50353ed4U, 0x9c9f3e4aU,
+        0x121039a9U, 0xdeba3937U, 0xd47f302eU, 0x18d530b0U, 0x965a3753U, 0x5af037cdU,
+        0xff6b144aU, 0x33c114d4U, 0xbd4e1337U, 0x71e413a9U, 0x7b211ab0U, 0xb78b1a2eU,
+        0x39041dcdU, 0xf5ae1d53U, 0x2c8e0fffU, 0xe0240f61U, 0x6eab0882U, 0xa201081cU,
+        0xa8c40105U, 0x646e019bU, 0xeae10678U, 0x264b06e6U,
+    },
+#endif
+};
@@ -0,0 +1,249 @@
+/**
+ * @file robusto_pool.c
+ * @author Nicklas Börjesson (<nicklasb at gmail dot com>)
+ * @brief Fixed size slot pools, for allocating without using the heap
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @copyright 
+ * Copyright (c) 2026, Nicklas Börjesson <nicklasb at gmail dot com>
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, 
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE 
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * A pool is a number of equally sized slots, allocated once, when it is created. Taking and giving
+ * back slots does not use the heap, so hot paths that use pools do not fragment it over time.
+ * 
+ * Which slots are taken is kept in a bitmap of atomic words, so slots can be taken and given back
+ * from any task without locking. When all slots are taken, the caller falls back to the heap.
+ *
+ * The size classes are pools of increasing slot sizes, that robusto_pool_malloc() allocates from,
+ * and that robusto_free() gives back to. All pools keep statistics on how many slots are in use,
+ * the most that have been, and how often they have run out, that the memory monitor reports.
+ */
+#include <robusto_system.h>
+
+#include <stdatomic.h>
+#include <string.h>
+
+#define POOL_WORD_BITS 32U
+#define POOL_REGISTRY_SIZE 8
+
+struct robusto_pool
+{
+    const char *name;
+    uint8_t *slots;
+    uint32_t slot_size;
+    uint16_t slot_count;
+    uint16_t word_count;
+    _Atomic uint16_t in_use;
+    _Atomic uint16_t high_water;
+    _Atomic uint32_t exhausted;
+    _Atomic uint32_t taken[];
+};
+
+/* All pools, for reporting */
+static robusto_pool_t *_Atomic registry[POOL_REGISTRY_SIZE];
+static _Atomic uint8_t registry_count = 0;
+
+/* The size classes, smallest first */
+static robusto_pool_t *size_classes[3] = {NULL, NULL, NULL};
+
+robusto_pool_t *robusto_pool_create(const char *name, uint32_t slot_size, uint16_t slot_count)
+{
+    uint16_t word_count = (slot_count + POOL_WORD_BITS - 1) / POOL_WORD_BITS;
+    // Keep the slots aligned for any type
+    slot_size = (slot_size + sizeof(void *) - 1) & ~(uint32_t)(sizeof(void *) - 1);
+    robusto_pool_t *pool = robusto_malloc(sizeof(robusto_pool_t) + word_count * sizeof(_Atomic uint32_t));
+    if (pool == NULL)
+    {
+        return NULL;
+    }
+    pool->slots = robusto_malloc(slot_size * slot_count);
+    if (pool->slots == NULL)
+    {
+        robusto_free(pool);
+        return NULL;
+    }
+    pool->name = name;
+    pool->slot_size = slot_size;
+    pool->slot_count = slot_count;
+    pool->word_count = word_count;
+    atomic_init(&pool->in_use, 0);
+    atomic_init(&pool->high_water, 0);
+    atomic_init(&pool->exhausted, 0);
+    for (uint16_t i = 0; i < word_count; i++)
+    {
+        // Bits past the last slot are always taken
+        uint32_t slots_in_word = slot_count - i * POOL_WORD_BITS;
+        atomic_init(&pool->taken[i], slots_in_word >= POOL_WORD_BITS ? 0U : ~(((uint32_t)1 << slots_in_word) - 1U));
+    }
+    uint8_t index = atomic_fetch_add(&registry_count, 1);
+    if (index < POOL_REGISTRY_SIZE)
+    {
+        atomic_store(&registry[index], pool);
+    }
+    else
+    {
+        // The pool works, it is just not reported
+        atomic_store(&registry_count, POOL_REGISTRY_SIZE);
+    }
+    return pool;
+}
+
+void *robusto_pool_take(robusto_pool_t *pool)
+{
+    if (pool == NULL)
+    {
+        return NULL;
+    }
+    for (uint16_t i = 0; i < pool->word_count; i++)
+    {
+        uint32_t taken = atomic_load(&pool->taken[i]);
+        while (taken != UINT32_MAX)
+        {
+            uint32_t bit = __builtin_ctzl(~taken);
+            if (atomic_compare_exchange_weak(&pool->taken[i], &taken, taken | ((uint32_t)1 << bit)))
+            {
+                uint16_t in_use = atomic_fetch_add(&pool->in_use, 1) + 1;
+                uint16_t high_water = atomic_load(&pool->high_water);
+                while (in_use > high_water && !atomic_compare_exchange_weak(&pool->high_water, &high_water, in_use))
+                {
+                }
+                return pool->slots + (i * POOL_WORD_BITS + bit) * pool->slot_size;
+            }
+        }
+    }
+    atomic_fetch_add(&pool->exhausted, 1);
+    return NULL;
+}
+
+bool robusto_pool_owns(robusto_pool_t *pool, const void *slot)
+{
+    return pool != NULL && (const uint8_t *)slot >= pool->slots &&
+           (const uint8_t *)slot < pool->slots + pool->slot_size * pool->slot_count;
+}
+
+bool robusto_pool_give(robusto_pool_t *pool, void *slot)
+{
+    if (!robusto_pool_owns(pool, slot))
+    {
+        return false;
+    }
+    uint32_t index = ((uint8_t *)slot - pool->slots) / pool->slot_size;
+    atomic_fetch_and(&pool->taken[index / POOL_WORD_BITS], ~((uint32_t)1 << (index % POOL_WORD_BITS)));
+    atomic_fetch_sub(&pool->in_use, 1);
+    return true;
+}
+
+uint16_t robusto_pool_available(robusto_pool_t *pool)
+{
+    uint16_t available = 0;
+    for (uint16_t i = 0; pool != NULL && i < pool->word_count; i++)
+    {
+        available += __builtin_popcountl(~atomic_load(&pool->taken[i]));
+    }
+    return available;
+}
+
+bool robusto_pool_get_stats(uint8_t index, robusto_pool_stats_t *stats)
+{
+    if (index >= atomic_load(&registry_count))
+    {
+        return false;
+    }
+    robusto_pool_t *pool = atomic_load(&registry[index]);
+    if (pool == NULL)
+    {
+        // Still being registered
+        return false;
+    }
+    stats->name = pool->name;
+    stats->slot_size = pool->slot_size;
+    stats->slot_count = pool->slot_count;
+    stats->in_use = atomic_load(&pool->in_use);
+    stats->high_water = atomic_load(&pool->high_water);
+    stats->exhausted = atomic_load(&pool->exhausted);
+    return true;
+}
+
+void *robusto_pool_malloc(size_t size)
+{
+    // If a class is exhausted, try the larger ones before going to the heap
+    for (uint8_t i = 0; i < 3; i++)
+    {
+        if (size_classes[i] != NULL && size <= size_classes[i]->slot_size)
+        {
+            void *slot = robusto_pool_take(size_classes[i]);
+            if (slot != NULL)
+            {
+                return slot;
+            }
+        }
+    }
+    return robusto_malloc(size);
+}
+
+uint32_t robusto_pool_size_of(const void *ptr)
+{
+    for (uint8_t i = 0; i < 3; i++)
+    {
+        if (robusto_pool_owns(size_classes[i], ptr))
+        {
+            return size_classes[i]->slot_size;
+        }
+    }
+    return 0;
+}
+
+bool robusto_pool_free(void *ptr)
+{
+    for (uint8_t i = 0; i < 3; i++)
+    {
+        if (robusto_pool_give(size_classes[i], ptr))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+static robusto_pool_t *create_size_class(const char *name, uint32_t slot_size, uint16_t slot_count)
+{
+    if (slot_size == 0 || slot_count == 0)
+    {
+        return NULL;
+    }
+    return robusto_pool_create(name, slot_size, slot_count);
+}
+
+void robusto_pool_init(void)
+{
+    // Initialising again must not orphan slots in use
+    if (size_classes[0] != NULL || size_classes[1] != NULL || size_classes[2] != NULL)
+    {
+        return;
+    }
+    size_classes[0] = create_size_class("small", CONFIG_ROBUSTO_POOL_SMALL_SIZE, CONFIG_ROBUSTO_POOL_SMALL_SLOTS);
+    size_classes[1] = create_size_class("medium", CONFIG_ROBUSTO_POOL_MEDIUM_SIZE, CONFIG_ROBUSTO_POOL_MEDIUM_SLOTS);
+    size_classes[2] = create_size_class("large", CONFIG_ROBUSTO_POOL_LARGE_SIZE, CONFIG_ROBUSTO_POOL_LARGE_SLOTS);
+}
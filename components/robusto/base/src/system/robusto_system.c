@@ -37,6 +37,7 @@
 #if !(defined(USE_ARDUINO) || defined(USE_ESPIDF))
 #include "stdlib.h"
 #include "stdio.h"
+#include <string.h>
 #include <sys/cdefs.h>
 
 #if defined(__APPLE__) 
@@ -62,7 +63,6 @@
 
 
 
-#include "compat_crc32.h"
 
 #if defined(ARDUINO_ARCH_MBED)
 #include "compat_mbed.hpp"
@@ -117,6 +117,18 @@ void *robusto_spi_malloc(size_t size)
 
 void *robusto_realloc(void *ptr, size_t size)
 {
+    uint32_t slot_size = robusto_pool_size_of(ptr);
+    if (slot_size > 0)
+    {
+        // Memory from a size class is moved to a new allocation and the slot given back
+        void *new_ptr = robusto_pool_malloc(size);
+        if (new_ptr != NULL)
+        {
+            memcpy(new_ptr, ptr, slot_size < size ? slot_size : size);
+            robusto_pool_free(ptr);
+        }
+        return new_ptr;
+    }
 #ifdef USE_ESPIDF
     return heap_caps_realloc(ptr, size, MALLOC_CAP_8BIT);
 #else
@@ -145,7 +157,9 @@ void *robusto_spi_realloc(void *ptr, size_t size)
 void robusto_free(void *ptr)
 {
     if (ptr != NULL) {
-        free(ptr);
+        if (!robusto_pool_free(ptr)) {
+            free(ptr);
+        }
     } else {
         ROB_LOGW(system_log_prefix, "robusto_free called with NULL pointer.");
     }
@@ -162,11 +176,6 @@ void robusto_checksum16(uint8_t *data, int count, uint16_t *dest)
    }
 }
 
-uint32_t robusto_crc32(uint32_t crc, const uint8_t *buf, size_t len)
-{
-    // return crc32_le(crc, buf, len);
-    return crc32_be_compat(crc, buf, len);
-}
 /* TODO: robusto_gpio_set_direction is probably not the best way to do this,
 * Both stm32, mbed and arduino does this as a part of the initialization of a gpio, 
 * it is likely better to do it like that and call the esp32 gpio_set_direction as part of that instead.
@@ -331,8 +340,8 @@ uint64_t get_free_mem_spi(void) {
 void robusto_system_init(char *_log_prefix)
 {
     system_log_prefix = _log_prefix;
+    robusto_pool_init();
 
-    init_crc32();
     #if CONFIG_ROB_BLINK_GPIO > -1
     robusto_gpio_set_level(CONFIG_ROB_BLINK_GPIO, 0);
     #endif
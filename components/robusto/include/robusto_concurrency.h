@@ -51,6 +51,7 @@
 #if defined(USE_ESPIDF) || defined(USE_ARDUINO)
     typedef TaskHandle_t rob_task_handle_t;
     typedef SemaphoreHandle_t mutex_ref_t;
+    typedef SemaphoreHandle_t semaphore_ref_t;
 #else
 
 #include <semaphore.h>
@@ -62,6 +63,8 @@
     #include <windows.h>
     typedef HANDLE mutex_ref_t;
 #endif
+    /* A binary semaphore; a condition variable guarded by a mutex, see robusto_concurrency_native.c */
+    typedef struct robusto_native_semaphore *semaphore_ref_t;
 
 #endif
 
@@ -139,6 +142,48 @@ extern "C"
      */
     rob_ret_val_t robusto_mutex_give(mutex_ref_t mutex);
 
+    /**
+     * @brief Initiate a new binary semaphore, used to signal a waiting task
+     * @note The semaphore starts out taken, so the first take will block until someone gives it.
+     *
+     * @return semaphore_ref_t A reference to the semaphore, NULL if failed
+     */
+    semaphore_ref_t robusto_semaphore_init();
+
+    /**
+     * @brief Deinitialize and free a semaphore
+     *
+     * @param semaphore The semaphore
+     */
+    void robusto_semaphore_deinit(semaphore_ref_t semaphore);
+
+    /**
+     * @brief Wait for the semaphore to be given, blocking the current task without using any CPU
+     *
+     * @param semaphore The semaphore
+     * @param timeout_ms How long to wait until giving up
+     * @return rob_ret_val_t Returns ROB_OK if the semaphore was given, ROB_ERR_TIMEOUT otherwise
+     */
+    rob_ret_val_t robusto_semaphore_take(semaphore_ref_t semaphore, uint32_t timeout_ms);
+
+    /**
+     * @brief Give the semaphore, waking up a task waiting for it
+     * @note Giving an already given semaphore has no effect, the signal is not counted.
+     *
+     * @param semaphore The semaphore
+     * @return rob_ret_val_t Returns ROB_OK if successful
+     */
+    rob_ret_val_t robusto_semaphore_give(semaphore_ref_t semaphore);
+
+    /**
+     * @brief Give the semaphore from an interrupt handler, waking up a task waiting for it
+     * @note On FreeRTOS, the woken task is switched to when the interrupt returns, if it has a higher priority.
+     *
+     * @param semaphore The semaphore
+     * @return rob_ret_val_t Returns ROB_OK if successful
+     */
+    rob_ret_val_t robusto_semaphore_give_from_isr(semaphore_ref_t semaphore);
+
     /**
      * @brief Set the watchdog timeout
      * @note This only applies to freeRTOS platforms
@@ -0,0 +1,94 @@
+/**
+ * @file robusto_crc32.h
+ * @author Nicklas Börjesson (<nicklasb at gmail dot com>)
+ * @brief The CRC32 calculations used by messaging and the proxy
+ * @note Only depends on the C library, so that the proxy can use it without the rest of Robusto
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @copyright 
+ * Copyright (c) 2026, Nicklas Börjesson <nicklasb at gmail dot com>
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, 
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE 
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * @brief Calculate bitwise big-endian Ethernet AUTODIN II CRC32
+ * @note There is no initial or final inversion, so a message can be calculated in parts 
+ * by passing the result of the previous part as the seed of the next.
+ * 
+ * @param crc Seed value for computation.  ~0 for Ethernet, sometimes 0 for
+ *        other uses, or the previous crc32 value if computing incrementally.
+ * @param buf Pointer to buffer over which CRC is run
+ * @param len Length of buffer
+ * @return uint32_t The CRC32 value
+ */
+uint32_t robusto_crc32(uint32_t crc, const uint8_t *buf, size_t len);
+
+/**
+ * @brief Get the CRC32 of two consecutive parts from the CRC32s of each, without going through the data again
+ * @note If the same length is combined many times, use robusto_crc32_combine_gen and robusto_crc32_combine_op instead
+ *
+ * @param crc1 The robusto_crc32 of the first part, with any seed
+ * @param crc2 The robusto_crc32 of the second part, with the seed 0
+ * @param len2 The length of the second part
+ * @return uint32_t The robusto_crc32 of both parts, as if calculated in one go with the seed of the first
+ */
+uint32_t robusto_crc32_combine(uint32_t crc1, uint32_t crc2, size_t len2);
+
+/**
+ * @brief Generate the operator that robusto_crc32_combine_op uses to combine with parts of a length
+ *
+ * @param len2 The length of the second parts
+ * @return uint32_t The operator
+ */
+uint32_t robusto_crc32_combine_gen(size_t len2);
+
+/**
+ * @brief Like robusto_crc32_combine, using an operator from robusto_crc32_combine_gen for the length of the second part
+ */
+uint32_t robusto_crc32_combine_op(uint32_t crc1, uint32_t crc2, uint32_t op);
+
+/**
+ * @brief Calculate the standard CRC32 (ISO-HDLC, as in zlib and Ethernet frames)
+ * @note The inversions are done inside, so a message can be calculated in parts
+ * by passing the result of the previous part as the seed of the next.
+ *
+ * @param crc 0 for the first part, otherwise the result of the previous part
+ * @param buf Pointer to buffer over which CRC is run
+ * @param len Length of buffer
+ * @return uint32_t The CRC32 value
+ */
+uint32_t robusto_crc32_iso_hdlc(uint32_t crc, const uint8_t *buf, size_t len);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
@@ -38,6 +38,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
 
 #define ROB_LOG_LOCAL_LEVEL CONFIG_ROB_LOG_MAXIMUM_LEVEL
 
@@ -89,6 +90,44 @@ static inline void rob_log_isr_init(void) {}
 
 void r_init_logging();
 
+#ifdef CONFIG_ROBUSTO_LOG_DEFERRED
+/**
+ * @brief Record a log line to be formatted later, see logging_deferred.c
+ * @note Use the ROB_LOGx_DEFERRED macros instead, they add the prefix and check the level.
+ *
+ * @return bool False if the line was dropped as the ring is full
+ */
+bool rob_log_deferred(rob_log_level_t level, const char *tag, const char *format, ...) __attribute__((format(printf, 3, 4)));
+
+/**
+ * @brief Take the oldest recorded line and format it
+ *
+ * @return bool False if there are no recorded lines
+ */
+bool rob_log_deferred_take(rob_log_level_t *level, const char **tag, char *line, size_t size);
+
+/**
+ * @brief Format and write all recorded lines
+ *
+ * @return uint32_t The number of lines written
+ */
+uint32_t rob_log_deferred_drain(void);
+
+/**
+ * @brief The number of lines dropped since start, as the ring was full
+ */
+uint32_t rob_log_deferred_dropped(void);
+
+#define ROB_LOG_DEFERRED(level, letter, tag, format, ...)                                                                  \
+    do                                                                                                                     \
+    {                                                                                                                      \
+        if (ROB_LOG_LOCAL_LEVEL >= level)                                                                                  \
+            rob_log_deferred(level, tag, ROB_LOG_FORMAT(letter, format), ROB_LOG_TIME_SRC, tag, ##__VA_ARGS__);            \
+    } while (0)
+#else
+#define ROB_LOG_DEFERRED(level, letter, tag, format, ...) ROB_LOG_LEVEL_LOCAL(level, tag, format, ##__VA_ARGS__)
+#endif
+
 
 
 /* Selection of colors from robusto_logging.h*/
@@ -170,6 +209,13 @@ void r_init_logging();
 // Print a stack trace of the current call stack
 #define ROB_LOG_STACK_TRACE(levels) compat_rob_log_stack_trace(levels)
 
+/* Log lines on hot paths, their formatting is deferred if CONFIG_ROBUSTO_LOG_DEFERRED is set */
+#define ROB_LOGE_DEFERRED(tag, format, ...) ROB_LOG_DEFERRED(ROB_LOG_ERROR, E, tag, format, ##__VA_ARGS__)
+#define ROB_LOGW_DEFERRED(tag, format, ...) ROB_LOG_DEFERRED(ROB_LOG_WARN, W, tag, format, ##__VA_ARGS__)
+#define ROB_LOGI_DEFERRED(tag, format, ...) ROB_LOG_DEFERRED(ROB_LOG_INFO, I, tag, format, ##__VA_ARGS__)
+#define ROB_LOGD_DEFERRED(tag, format, ...) ROB_LOG_DEFERRED(ROB_LOG_DEBUG, D, tag, format, ##__VA_ARGS__)
+#define ROB_LOGV_DEFERRED(tag, format, ...) ROB_LOG_DEFERRED(ROB_LOG_VERBOSE, V, tag, format, ##__VA_ARGS__)
+
 #define ROB_LOGE_ISR(tag, format, ...) rob_log_isr_enqueue(ROB_LOG_ERROR, tag, format, ##__VA_ARGS__)
 #define ROB_LOGW_ISR(tag, format, ...) rob_log_isr_enqueue(ROB_LOG_WARN, tag, format, ##__VA_ARGS__)
 #define ROB_LOGI_ISR(tag, format, ...) rob_log_isr_enqueue(ROB_LOG_INFO, tag, format, ##__VA_ARGS__)
@@ -182,6 +228,11 @@ void r_init_logging();
 #define ROB_LOGD(tag, format, ...) do {} while (0)
 #define ROB_LOGV(tag, format, ...) do {} while (0)
 #define ROB_LOG_STACK_TRACE(levels) do {} while (0)
+#define ROB_LOGE_DEFERRED(tag, format, ...) do {} while (0)
+#define ROB_LOGW_DEFERRED(tag, format, ...) do {} while (0)
+#define ROB_LOGI_DEFERRED(tag, format, ...) do {} while (0)
+#define ROB_LOGD_DEFERRED(tag, format, ...) do {} while (0)
+#define ROB_LOGV_DEFERRED(tag, format, ...) do {} while (0)
 #define rob_log_isr_enqueue(level, tag, format, ...) (false)
 #define rob_log_isr_init() do {} while (0)
 #define ROB_LOGE_ISR(tag, format, ...) do {} while (0)
@@ -36,6 +36,7 @@
 
 #include <robusto_retval.h>
 #include <robusto_queue.h>
+#include <robusto_system.h>
 
 #ifdef __cplusplus
 extern "C"
@@ -193,12 +194,18 @@ extern "C"
     {
         /* The data */
         uint8_t *data;
+        /* If set, the data belongs to this shared buffer, and the item holds a reference to it instead of owning the data */
+        robusto_buffer_t *buffer;
+        /* If set, the message is in these segments, and data is only set if a media needs it contiguous */
+        struct robusto_message_segments *segments;
         /* The length of the data in bytes */
         uint32_t data_length;
         /* The peer */
         struct robusto_peer *peer;
         /* The queue item state */
         queue_state *state;
+        /* Optional completion, signalled with the result. The item holds a reference to it. */
+        robusto_completion_t *completion;
         /* The queue item type. */
         e_media_queue_item_type queue_item_type;
         /* Media types to exclude */
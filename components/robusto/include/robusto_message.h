@@ -93,6 +93,16 @@ rob_ret_val_t send_message_binary(robusto_peer_t *peer, uint16_t service_id, uin
  */
 rob_ret_val_t send_message_multi(robusto_peer_t *peer, uint16_t service_id, uint16_t conversation_id,
                             uint8_t *strings_data, uint32_t strings_length, uint8_t *binary_data, uint32_t binary_length, queue_state *state, e_media_type force_media_type);
+/**
+ * @brief Like send_message_multi, but the binary data is in a shared buffer that the message references instead of copying.
+ * The message is kept as segments, that medias that can gather send from directly, and others make contiguous once when sending.
+ * @note The buffer must not change after sending, the message takes a reference to it, the caller keeps its own.
+ *
+ * @param binary The binary data, NULL if none
+ * @return rob_ret_val_t Return ROB_OK if the message was successfully put on the appropriate media send queue.
+ */
+rob_ret_val_t send_message_multi_buffer(robusto_peer_t *peer, uint16_t service_id, uint16_t conversation_id,
+                                        uint8_t *strings_data, uint32_t strings_length, robusto_buffer_t *binary, queue_state *state, e_media_type force_media_type);
 /**
  * @brief Put a raw message to a specified peer on a specified media send queue. Mostly for internal use. 
  * 
@@ -105,6 +115,22 @@ rob_ret_val_t send_message_multi(robusto_peer_t *peer, uint16_t service_id, uint
  * @return rob_ret_val_t Was the message successfully built and put on the queue for sending?
  */
 rob_ret_val_t send_message_raw(robusto_peer_t *peer, e_media_type media_type,  uint8_t *data, uint32_t data_length, queue_state *state, bool receipt);
+/**
+ * @brief Like send_message_raw, but the message is in a shared buffer, so that the same message can be sent to many 
+ * peers without copying it. The queue item takes a reference to the buffer, the caller keeps its own.
+ * @note The buffer must include the ROBUSTO_PREFIX_BYTES, and its contents must not change after sending.
+ * 
+ * @return rob_ret_val_t Was the message successfully put on the queue for sending?
+ */
+rob_ret_val_t send_message_raw_buffer(robusto_peer_t *peer, e_media_type media_type, robusto_buffer_t *buffer, queue_state *state, bool receipt);
+/**
+ * @brief Like send_message_raw, but signals a completion with the result instead of setting a queue state.
+ * 
+ * @param completion The completion, a reference is taken for the queued message, the caller keeps its own.
+ *  If the message could not be queued, the completion is signalled with the error.
+ * @return rob_ret_val_t Was the message successfully put on the queue for sending?
+ */
+rob_ret_val_t send_message_raw_completion(robusto_peer_t *peer, e_media_type media_type,  uint8_t *data, uint32_t data_length, robusto_completion_t *completion, bool receipt);
 bool robusto_send_queue_accepts_large_message(e_media_type media_type);
 /**
  * @brief For internal use, like send_message_raw but takes more parameters for recursion and heartbeats
@@ -112,11 +138,14 @@ bool robusto_send_queue_accepts_large_message(e_media_type media_type);
  * @param heartbeat This is used internally when sending heart beats. Disables retrying and other things. (TODO: Should this be something else?)
  * @param depth Recursion depth 
  * @param exclude_media_types What media types to exclude when retrying
+ * @param completion Optional completion, if the message is queued, the queue item takes a reference to it and signals it when done
 
  */
-rob_ret_val_t send_message_raw_internal(robusto_peer_t *peer, e_media_type media_type, uint8_t *data, uint32_t data_length, queue_state *state, bool receipt, e_media_queue_item_type queue_item_type, uint8_t depth, uint8_t exclude_media_types, bool important);
+rob_ret_val_t send_message_raw_internal(robusto_peer_t *peer, e_media_type media_type, uint8_t *data, uint32_t data_length, queue_state *state, bool receipt, e_media_queue_item_type queue_item_type, uint8_t depth, uint8_t exclude_media_types, bool important, robusto_completion_t *completion);
 
 typedef rob_ret_val_t (send_callback_cb)(robusto_peer_t *peer, uint8_t *data, uint32_t data_length, bool receipt);
+/* A media send function that gathers the message from its segments itself */
+typedef rob_ret_val_t (send_segments_callback_cb)(robusto_peer_t *peer, robusto_message_segments_t *segments, bool receipt);
 
 typedef void(poll_callback_cb)(queue_context_t * queue_context);
 /**
@@ -128,7 +157,31 @@ typedef void(poll_callback_cb)(queue_context_t * queue_context);
  * @param poll_callback Callback to the media listen function
  * @param queue_context The queue context
  */
+/**
+ * @brief Free the data of a media queue item, or release its reference if it is a shared buffer.
+ * 
+ * @param queue_item The queue item
+ */
+void robusto_free_media_queue_item_data(media_queue_item_t *queue_item);
+
+/**
+ * @brief Set the result of a media queue item, both its queue state and its completion, if any.
+ * The item releases its reference to the completion.
+ * 
+ * @param queue_item The queue item
+ * @param result The result
+ */
+void robusto_set_media_queue_item_result(media_queue_item_t *queue_item, rob_ret_val_t result);
+
 void send_work_item(media_queue_item_t * queue_item, robusto_media_t *info, e_media_type media_type, send_callback_cb *send_callback, poll_callback_cb *poll_callback, queue_context_t *queue_context);
+/**
+ * @brief Like send_work_item, but with a media send function for messages in segments.
+ * Without it, a message in segments is made contiguous once, before the first attempt.
+ *
+ * @param send_segments_callback Callback to the media send function for messages in segments, may be NULL
+ */
+void send_work_item_segments(media_queue_item_t *queue_item, robusto_media_t *info, e_media_type media_type, send_callback_cb *send_callback,
+                             send_segments_callback_cb *send_segments_callback, poll_callback_cb *poll_callback, queue_context_t *queue_context);
 
 typedef void (on_send_activity_t)(media_queue_item_t * queue_item, e_media_type media_type);
 
@@ -153,6 +206,54 @@ int robusto_make_multi_message_internal(e_msg_type_t message_type, uint16_t serv
                                uint8_t *strings_data, uint32_t strings_length,
                                uint8_t *binary_data, uint32_t binary_length, uint8_t **dest_message);
 
+/**
+ * @brief Describe a multi message as segments, without copying the strings or binary data.
+ * Fills in the header, with the CRC computed across the segments.
+ *
+ * @param strings_data The strings, referenced by the segments
+ * @param binary_data The binary data, referenced by the segments
+ * @param dest The segments to fill in
+ * @return int The length of the message
+ */
+int robusto_make_multi_message_segments(e_msg_type_t message_type, uint16_t service_id, uint16_t conversation_id,
+                                        uint8_t *strings_data, uint32_t strings_length,
+                                        uint8_t *binary_data, uint32_t binary_length, robusto_message_segments_t *dest);
+
+/**
+ * @brief Allocate message segments that own a copy of the strings and a reference to the binary buffer
+ *
+ * @param binary Buffer with the binary data, NULL if none
+ * @return robusto_message_segments_t* The segments, NULL if out of memory. Free using robusto_message_segments_free.
+ */
+robusto_message_segments_t *robusto_message_segments_create(e_msg_type_t message_type, uint16_t service_id, uint16_t conversation_id,
+                                                            uint8_t *strings_data, uint32_t strings_length, robusto_buffer_t *binary);
+
+/**
+ * @brief Free segments from robusto_message_segments_create, releasing the binary buffer
+ */
+void robusto_message_segments_free(robusto_message_segments_t *segments);
+
+/**
+ * @brief Copy a range of the message out of its segments
+ *
+ * @param offset Where in the message to start
+ * @param dest Destination, at least length bytes
+ * @param length The number of bytes to copy
+ */
+void robusto_message_segments_copy(const robusto_message_segments_t *segments, uint32_t offset, uint8_t *dest, uint32_t length);
+
+/**
+ * @brief Continue a robusto_crc32 over a range of the message in the segments
+ */
+uint32_t robusto_message_segments_crc32(uint32_t crc, const robusto_message_segments_t *segments, uint32_t offset, uint32_t length);
+
+/**
+ * @brief Copy the segments into one newly allocated message, for medias that need it contiguous
+ *
+ * @return uint8_t* The message, segments->length long, NULL if out of memory
+ */
+uint8_t *robusto_message_segments_linearise(const robusto_message_segments_t *segments);
+
 
 // TODO: Centralize fragmented handling for all medias (will a stream be similar?) This is the specific fragmented case
 typedef struct fragmented_message
@@ -163,6 +264,9 @@ typedef struct fragmented_message
     // 1. save memory on sender, 2. make testing in the same space possible
     // The data to send
     uint8_t *send_data;
+    // If set instead of send_data, the fragments are gathered from these segments, starting at send_segments_offset
+    const robusto_message_segments_t *send_segments;
+    uint32_t send_segments_offset;
     // The length of the message
     uint32_t send_data_length;
     // The receive buffer
@@ -175,12 +279,30 @@ typedef struct fragmented_message
     // Size of each fragment
     uint32_t fragment_size;
 
-    // A map of all the fragments that has been received (not automatically updated on the sender)
-    uint8_t *received_fragments; // TODO: This should instead be a bitmap to save space.
+    // A bitmap of all the fragments that has been received (not automatically updated on the sender)
+    uint32_t *received_fragments;
+    // The number of bits set in received_fragments
+    uint32_t received_count;
+    /* The robusto_crc32 of each fragment, the hash of the message is these combined */
+    uint32_t *fragment_crcs;
+    /* The fragments carry their CRC after the index, so that a corrupt one can be requested again */
+    bool fragment_crc;
     /* When the frag_msg was created, a non-used element */
     uint32_t start_time;
     /* If not UINT32_MAX, we have requested things to be sent again, and this is the last fragment we requested */
     uint32_t last_requested;
+    /* The sender sends with a window and wants acknowledgements (receiver only) */
+    bool send_acks;
+    /* The sender understands FRAG_RESEND_RANGES, it sent the flags byte in its request (receiver only) */
+    bool resend_ranges;
+    /* The first missing fragment in the latest acknowledgement (receiver only) */
+    uint32_t last_ack_base;
+    /* All fragments below this are acknowledged (sender only) */
+    uint32_t acked_base;
+    /* One past the highest acknowledged fragment (sender only) */
+    uint32_t acked_end;
+    /* Number of acknowledgements received (sender only) */
+    uint32_t ack_count;
     /* The state of the fragment */
     e_rob_state_t state;
     /* Abort the transmission (wait 1000ms before removing structure) */
@@ -230,6 +352,15 @@ typedef struct robusto_fragment_stats
     uint32_t invalid_fragment_type;
     uint32_t fragments_sent;
     uint32_t fragments_resent;
+    uint32_t acks_sent;
+    uint32_t acks_received;
+    uint32_t fragment_crc_mismatch;
+    /* The window of the latest fragmented send, in fragments. Not a counter, the delta holds the current value. */
+    uint32_t window_size;
+    /* Resent fragments per 1000 sent, in the delta for the fragments sent since the last read */
+    uint32_t retransmit_permille;
+    /* Payload bytes per second of the latest successful fragmented send. Not a counter, like window_size. */
+    uint32_t goodput_bytes_per_s;
 } robusto_fragment_stats_t;
 
 /**
@@ -296,6 +427,16 @@ bool handle_fragmented(robusto_peer_t *peer, e_media_type media_type, uint8_t *d
  */
 rob_ret_val_t send_message_fragmented(robusto_peer_t *peer, e_media_type media_type, uint8_t *data, uint32_t data_length, uint32_t fragment_size, cb_send_message * send_message);
 
+/**
+ * @brief Like send_message_fragmented, but the fragments are gathered directly from the message segments
+ *
+ * @param segments The message segments
+ * @param offset Where in the message the fragmented data starts, typically ROBUSTO_PREFIX_BYTES
+ * @return rob_ret_val_t 
+ */
+rob_ret_val_t send_message_fragmented_segments(robusto_peer_t *peer, e_media_type media_type, const robusto_message_segments_t *segments, uint32_t offset,
+                                               uint32_t fragment_size, cb_send_message *send_message);
+
 /**
  * @brief A simple way to, using format strings, build a message.
  * However; as the result will have to be null-terminated, and we cannot put nulls in that string.
@@ -328,6 +469,26 @@ int build_strings_data(uint8_t **message, const char *format, ...);
  */
 rob_ret_val_t robusto_network_parse_message(uint8_t *data, uint32_t data_len, robusto_peer_t *peer, robusto_message_t **msg, int prefix_bytes);
 
+/**
+ * @brief Parse a message into a message structure provided by the caller, without allocating.
+ * The message points into data, and the strings array, if any, into strings.
+ * 
+ * @param msg The message to parse into
+ * @param strings Array for pointers to the strings. If NULL, only robusto_message_next_string() reaches them.
+ * @param strings_capacity The length of the strings array, if there are more strings, an array is allocated for them
+ * @return rob_ret_val_t ROB_OK if the message could be parsed
+ */
+rob_ret_val_t robusto_network_parse_message_into(uint8_t *data, uint32_t data_len, robusto_peer_t *peer, robusto_message_t *msg, int prefix_bytes,
+                                                 char **strings, uint16_t strings_capacity);
+
+/**
+ * @brief Walk the strings of a parsed message, without needing its strings array
+ * 
+ * @param previous The previous string, NULL to get the first
+ * @return const char* The next string, NULL when there are no more
+ */
+const char *robusto_message_next_string(const robusto_message_t *message, const char *previous);
+
 /**
  * @brief Check a message against its CRC32 or Fletcher 16 for consistency
  * 
@@ -40,11 +40,17 @@ extern "C"
 {
 #endif
 /* The current protocol version */
-#define ROBUSTO_PROTOCOL_VERSION 0x00
+#define ROBUSTO_PROTOCOL_VERSION 0x02
 
 /* Lowest supported protocol version */
 #define ROBUSTO_PROTOCOL_VERSION_MIN 0x00
 
+/* From this version, peers understand CAN bus frames that carry the beginning of the message in the identifier */
+#define ROBUSTO_PROTOCOL_VERSION_CANBUS_EXTENDED 0x01
+
+/* From this version, peers understand LoRa frames of the MSG_BATCH type */
+#define ROBUSTO_PROTOCOL_VERSION_LORA_BATCH 0x02
+
 /* We always have a byte that contains the context */
 #define ROBUSTO_CONTEXT_BYTE_LEN 1
 
@@ -88,7 +94,7 @@ typedef enum e_msg_type
     MSG_NETWORK     = 2, // Network messages, like presentations. No receipts.
     MSG_HEARTBEAT   = 3, // The heartbeat, sent to peers to check if an idle connection works. No receipt.
     MSG_FRAGMENTED  = 4, // Fragmented messaging
-    MSG_UNUSED_1    = 5,
+    MSG_BATCH       = 5, // Several small messages to the same peer in one frame, with one receipt (LoRa)
     MSG_UNUSED_2    = 6,
     MSG_UNUSED_3    = 7
 } e_msg_type_t;
@@ -118,10 +124,16 @@ typedef enum e_fragment_request
     FRAG_MESSAGE  = 0x01,
     /* Asking the receiver the state of the request (if no result is received before the timeout or if progress is needed) */ 
     FRAG_CHECK   = 0x02,
+    /* Like FRAG_RESEND, but lists the missing fragments as ranges instead of a map of all of them */
+    FRAG_RESEND_RANGES = 0x03,
+    /* The receiver acknowledges the fragments received so far, to let the sender move its window */
+    FRAG_ACK = 0x04,
     /* This is the success message from the receiver */ 
     FRAG_RESEND   = 0x05,
     /* This is the success message from the receiver */ 
     FRAG_RESULT   = 0x06,
+    /* A FRAG_MESSAGE the sender wants acknowledged right away, only sent to receivers that acknowledge */
+    FRAG_MESSAGE_ACK_NOW = 0x07,
 
 } e_fragment_request_t;
 
@@ -168,9 +180,49 @@ typedef struct robusto_message
     e_media_type media_type;
     /* The data */
     uint16_t service_id;
+    /* The strings section in raw_data, that robusto_message_next_string() walks */
+    uint8_t *strings_data;
+    /* The length of the strings section in bytes */
+    uint32_t strings_length;
+    /* The strings array is allocated by itself, and freed with the message */
+    bool strings_allocated;
+    /* If set, the message is a slot of this pool, and is given back to it when freed */
+    robusto_pool_t *pool;
 
 } robusto_message_t;
 
+/* The longest message header: prefix, CRC, context, service id, conversation id and strings length */
+#define ROBUSTO_MESSAGE_HEADER_MAX_LEN (ROBUSTO_PREFIX_BYTES + ROBUSTO_CRC_LENGTH + ROBUSTO_CONTEXT_BYTE_LEN + 6)
+/* A message has at most a header, a strings and a binary segment */
+#define ROBUSTO_MESSAGE_SEGMENT_MAX 3
+
+/* A contiguous part of a message, referenced, not owned */
+typedef struct robusto_message_segment
+{
+    /* The data */
+    const uint8_t *data;
+    /* The length of the data in bytes */
+    uint32_t length;
+} robusto_message_segment_t;
+
+/**
+ * A message described as the segments it consists of, instead of copied into one buffer.
+ * Put together, the segments are exactly what robusto_make_multi_message_internal() builds.
+ */
+typedef struct robusto_message_segments
+{
+    /* The prefix headroom, CRC, context byte, service id, conversation id and strings length */
+    uint8_t header[ROBUSTO_MESSAGE_HEADER_MAX_LEN];
+    /* The header, strings and binary segments, in message order */
+    robusto_message_segment_t segments[ROBUSTO_MESSAGE_SEGMENT_MAX];
+    /* The number of segments used */
+    uint8_t segment_count;
+    /* The length of the whole message in bytes, including the prefix */
+    uint32_t length;
+    /* If set, the binary segment is in this buffer, and the segments hold a reference to it */
+    robusto_buffer_t *buffer;
+} robusto_message_segments_t;
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
\ No newline at end of file
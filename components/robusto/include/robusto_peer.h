@@ -82,10 +82,11 @@ extern "C"
      *
      * @param peer
      * @param media_type
+     * @param message The message with its prefix, at least its headers, NULL if it is not made yet
      * @param data_length
      * @return float
      */
-    float score_peer(robusto_peer_t *peer, e_media_type media_type, int data_length);
+    float score_peer(robusto_peer_t *peer, e_media_type media_type, const uint8_t *message, int data_length);
     /**
      * @brief Find a suitable media for the proposed message base on its length
      *
@@ -96,6 +97,17 @@ extern "C"
      * @return rob_ret_val_t Returns ROB_OK if successful
      */
     rob_ret_val_t set_suitable_media(robusto_peer_t *peer, uint16_t data_length, e_media_type exclude, e_media_type *result);
+    /**
+     * @brief Find a suitable media for a message that is already made, some medias can fit more of certain messages in a frame
+     *
+     * @param peer The peer to send to
+     * @param message The message with its prefix, at least its headers
+     * @param data_length The length of the whole message, with its prefix
+     * @param exclude Do not chose any of these medias
+     * @param result A pointer to an e_media_type that receives the result
+     * @return rob_ret_val_t Returns ROB_OK if successful
+     */
+    rob_ret_val_t set_suitable_media_for_message(robusto_peer_t *peer, const uint8_t *message, uint32_t data_length, e_media_type exclude, e_media_type *result);
 
     /**
      * @brief Reset a media's statistics
@@ -51,8 +51,11 @@ typedef rob_ret_val_t (pubsub_server_subscriber_callback)(uint8_t *data, uint32_
 typedef rob_ret_val_t (pubsub_server_subscriber_context_callback)(void *context, uint8_t *data, uint32_t data_length);
 
 typedef struct pubsub_server_subscriber pubsub_server_subscriber_t;
+typedef struct pubsub_server_topic pubsub_server_topic_t;
+/* An immutable, reference counted copy of the subscribers of a topic that publishing works from */
+typedef struct pubsub_subscriber_snapshot pubsub_subscriber_snapshot_t;
 
-/* A subscriber, forms a linked list */
+/* A subscriber, forms a linked list per topic and, for peers, one per peer */
 struct pubsub_server_subscriber {
     /* If set, send data to peer */
     robusto_peer_t * peer;
@@ -62,12 +65,20 @@ struct pubsub_server_subscriber {
     pubsub_server_subscriber_context_callback * local_context_callback;
     /* Context passed to local_context_callback */
     void *local_context;
+    /* The topic subscribed to */
+    pubsub_server_topic_t * topic;
     /* Next subscriber */
     pubsub_server_subscriber_t * next;
+    /* Previous subscriber */
+    pubsub_server_subscriber_t * previous;
+    /* The relation id of the peer when subscribing, the key of the peer subscription index */
+    uint32_t relation_id;
+    /* Next subscription of the same peer (peer subscribers only) */
+    pubsub_server_subscriber_t * next_of_peer;
+    /* Previous subscription of the same peer (peer subscribers only) */
+    pubsub_server_subscriber_t * previous_of_peer;
 };
 
-typedef struct pubsub_server_topic pubsub_server_topic_t;
-
 /* A topic, forms a linked list */
 struct pubsub_server_topic {
     /* The name of the topic, typically dot separated a.c.1, like nmea.pgn.1223423 */
@@ -82,6 +93,8 @@ struct pubsub_server_topic {
     pubsub_server_subscriber_t *first_subscriber;
     /* Last of the linked list of subscribers */
     pubsub_server_subscriber_t *last_subscriber;
+    /* The subscribers as of the last publish, NULL when they have changed since */
+    pubsub_subscriber_snapshot_t *snapshot;
     /* The next topic */
     pubsub_server_topic_t *next;
 };
@@ -111,6 +124,7 @@ uint32_t robusto_pubsub_server_subscribe_with_context(pubsub_server_subscriber_c
 
 /**
  * @brief Unregister a subscription
+ * @note Waits for publishes already delivering to the subscriber, unless called from a subscriber callback
  * 
  * @param peer The peer wishing to unsubscribe
  * @param topic The hash of the topic to unsubcribe from
@@ -120,6 +134,8 @@ uint32_t robusto_pubsub_server_unsubscribe(robusto_peer_t *peer, pubsub_server_s
 
 /**
  * @brief Unregister a context-aware local subscription
+ * @note When this returns, the callback will not be called with the context anymore, so it can be freed.
+ * Unless unsubscribing from within a subscriber callback, then publishes in progress may still deliver.
  *
  * @param local_cb Callback used when subscribing
  * @param context Context used when subscribing
@@ -132,6 +148,7 @@ uint32_t robusto_pubsub_server_unsubscribe_with_context(pubsub_server_subscriber
 
 /**
  * @brief Unregister all topic subscriptions owned by a peer
+ * @note Waits for publishes already delivering to the peer, so the peer can be deleted afterwards
  *
  * @param peer The peer being removed or replaced
  * @return uint32_t Number of subscriptions removed
@@ -148,6 +165,7 @@ pubsub_server_topic_t * robusto_pubsub_server_find_or_create_topic(char * name);
 
 /**
  * @brief Publish data
+ * @note The subscribers are called without holding the pubsub lock, so they may subscribe and publish
  * 
  * @param topic_hash The topic hash
  * @param data The payload
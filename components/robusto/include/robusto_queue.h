@@ -140,6 +140,9 @@ extern "C"
 
     typedef struct queue_context queue_context_t;
 
+    /* A lock-free ring buffer holding queue items, see robusto_ring.c */
+    typedef struct robusto_ring robusto_ring_t;
+
     typedef void *(first_queueitem)(queue_context_t *q_context);
     typedef void *(next_queueitem)(void *item);
     typedef void(remove_first_queueitem)(queue_context_t *q_context);
@@ -151,6 +154,22 @@ extern "C"
 
     typedef void(poll_callback)(void *q_context);
 
+    /* A worker in the pool of a multitasking queue, see robusto_worker.c */
+    typedef struct queue_pool_worker queue_pool_worker_t;
+
+    /**
+     * @brief Statistics for a pool worker, to be able to size pools from real data
+     */
+    typedef struct queue_worker_stats
+    {
+        /* The number of items the worker has handled */
+        uint32_t items_handled;
+        /* The total time the worker has spent handling items */
+        uint32_t busy_ms;
+        /* If the worker is currently handling an item */
+        bool busy;
+    } queue_worker_stats_t;
+
     typedef struct queue_context
     {
         /* Queue management callbacks, needed because of the difficulties in passing queues as pointers */
@@ -169,20 +188,26 @@ extern "C"
         /* Optional callback that is called each poll period by the worker.
         Note: This is run in the queue task, and might conflict with multitasking. */
         poll_callback *on_poll_cb;
-        /* Max number of concurrent tasks. (0 = unlimited) */
+        /* Max number of concurrent tasks, the size of the worker pool if multitasking. (0 = CONFIG_ROBUSTO_WORKER_POOL_SIZE) */
         uint8_t max_task_count;
         /* Current number of running tasks */
         uint8_t task_count;
-        /* Create separate tasks for each work.
+        /* Handle work in a pool of separate tasks, created when the queue is initialized.
         Do not do this if the functionality isn't thread safe.
         Also, what is gained in isolation, might be lost in performance. */
         bool multitasking;
+        /* The pool workers, if multitasking */
+        queue_pool_worker_t *pool;
+        /* The number of pool workers */
+        uint8_t pool_size;
         /* Worker task */
         rob_task_handle_t worker_task_handle;
         /* Worker task name*/
         char worker_task_name[50];
 
         void *work_queue;
+        /* If set, items are kept in this ring instead of using the queue management callbacks (see init_work_queue_ring) */
+        robusto_ring_t *ring;
 
         /* The current number of items */
         uint8_t count;
@@ -203,14 +228,101 @@ extern "C"
         /* Mutexes for thread safety*/
         mutex_ref_t __x_queue_mutex;      // Thread-safe the queue
         mutex_ref_t __x_task_state_mutex; // Thread-safe the tasks
+        /* Given when there is something for the worker to do, so it doesn't have to spin */
+        semaphore_ref_t __x_work_semaphore;
     } queue_context_t;
 
     rob_ret_val_t safe_add_work_queue(queue_context_t *q_context, void *new_item, bool important);
 
     rob_ret_val_t init_work_queue(queue_context_t *q_context, const char *_log_prefix, const char *queue_name);
 
+#ifdef CONFIG_ROBUSTO_QUEUE_RING
+    /**
+     * @brief Initialize a work queue that is backed by a lock-free ring instead of the queue management callbacks.
+     * Adding and taking items then takes neither the queue mutex nor allocates memory.
+     * @note As items cannot be removed from the middle of the ring, item_drop_cb is not used, the queue only drops new items.
+     *
+     * @param q_context The queue context, the queue management callbacks need not be set
+     * @param _log_prefix The log prefix
+     * @param queue_name The name of the queue
+     * @param capacity The number of items the ring can hold, rounded up to a power of two
+     * @return rob_ret_val_t ROB_OK if successful
+     */
+    rob_ret_val_t init_work_queue_ring(queue_context_t *q_context, const char *_log_prefix, const char *queue_name, uint16_t capacity);
+
+    /**
+     * @brief Create a ring. 
+     * Any number of tasks may push concurrently, but only one task (the queue worker) should pop.
+     *
+     * @param capacity Number of items, rounded up to a power of two
+     * @return robusto_ring_t* The ring, NULL if out of memory
+     */
+    robusto_ring_t *robusto_ring_create(uint16_t capacity);
+
+    /**
+     * @brief Free a ring, the items in it are not freed.
+     */
+    void robusto_ring_free(robusto_ring_t *ring);
+
+    /**
+     * @brief Add an item to the end of the ring
+     *
+     * @return true If added, false if the ring is full
+     */
+    bool robusto_ring_push(robusto_ring_t *ring, void *item);
+
+    /**
+     * @brief Take the first item from the ring
+     *
+     * @return void* The item, NULL if the ring is empty
+     */
+    void *robusto_ring_pop(robusto_ring_t *ring);
+
+    /**
+     * @brief The number of items in the ring (approximate if others are pushing or popping at the same time)
+     */
+    uint32_t robusto_ring_count(robusto_ring_t *ring);
+#endif
+
     void set_queue_blocked(queue_context_t *q_context, bool blocked);
 
+    /**
+     * @brief Take the first item of a queue.
+     * @note Only for the work callback of a single-task queue, that wants to handle the following items together with the current one.
+     *
+     * @param q_context The queue context
+     * @return void* The item, NULL if the queue is empty
+     */
+    void *safe_get_head_work_item(queue_context_t *q_context);
+
+    /**
+     * @brief Wake the worker of a queue, so that it re-checks its state without waiting for its timeout.
+     *
+     * @param q_context The queue context
+     */
+    void wake_queue_worker(queue_context_t *q_context);
+
+    /**
+     * @brief Get the statistics of the pool workers of a multitasking queue
+     *
+     * @param q_context The queue context
+     * @param stats An array to fill with the statistics, one per worker
+     * @param max_count The size of the array
+     * @return uint8_t The number of workers filled in, 0 if the queue has no pool
+     */
+    uint8_t get_queue_worker_stats(queue_context_t *q_context, queue_worker_stats_t *stats, uint8_t max_count);
+
+    /**
+     * @brief Log the statistics of the pool workers of a multitasking queue
+     *
+     * @param q_context The queue context
+     */
+    void log_queue_worker_stats(queue_context_t *q_context);
+
+    /**
+     * @brief Previously had to be called by multitasking work callbacks when done.
+     * @note Pool workers keep track of this themselves, so this does nothing and need not be called.
+     */
     void cleanup_queue_task(queue_context_t *q_context);
 
     /**
@@ -265,6 +377,7 @@ extern "C"
      * @param return_value
      * @return true
      * @return false
+     * @note This polls the state, a completion (see robusto_completion_create) can be waited for without polling.
      */
     bool robusto_waitfor_queue_state(queue_state *state, uint32_t timeout_ms, rob_ret_val_t *return_value);
     /**
@@ -275,6 +388,74 @@ extern "C"
      */
     queue_state *robusto_free_queue_state(queue_state *state);
 
+    /**
+     * Completions are a one-shot notification of a result, see robusto_completion.c
+     * Unlike queue states, they can be waited for without polling, or have a callback, and
+     * they are reference counted, so there is no need for marking them as dropped.
+     */
+    typedef struct robusto_completion robusto_completion_t;
+
+    /**
+     * @brief Called once when a completion is signalled, in the task that signals it.
+     */
+    typedef void(robusto_completion_cb)(robusto_completion_t *completion, rob_ret_val_t result, void *user_data);
+
+    /**
+     * @brief Create a completion, the caller owns one reference and must release it when done.
+     *
+     * @return robusto_completion_t* The completion, NULL if out of memory
+     */
+    robusto_completion_t *robusto_completion_create();
+
+    /**
+     * @brief Take a reference to a completion, typically when passing it to something that will signal it
+     */
+    void robusto_completion_retain(robusto_completion_t *completion);
+
+    /**
+     * @brief Release a reference, the completion is freed when the last reference is released
+     */
+    void robusto_completion_release(robusto_completion_t *completion);
+
+    /**
+     * @brief Set the result and wake any waiters. Only the first signal counts.
+     *
+     * @param completion The completion
+     * @param result The result
+     * @return true If this was the first signal
+     */
+    bool robusto_completion_signal(robusto_completion_t *completion, rob_ret_val_t result);
+
+    /**
+     * @brief Wait for a completion to be signalled, without using any CPU
+     *
+     * @param completion The completion
+     * @param timeout_ms How long to wait
+     * @param result Set to the result if signalled, may be NULL
+     * @return rob_ret_val_t ROB_OK if signalled, ROB_ERR_TIMEOUT otherwise
+     */
+    rob_ret_val_t robusto_completion_wait(robusto_completion_t *completion, uint32_t timeout_ms, rob_ret_val_t *result);
+
+    /**
+     * @brief Set a callback to be called when the completion is signalled. 
+     * If it is already signalled, the callback is called immidiately.
+     *
+     * @param completion The completion
+     * @param callback The callback
+     * @param user_data Passed to the callback
+     */
+    void robusto_completion_on_done(robusto_completion_t *completion, robusto_completion_cb *callback, void *user_data);
+
+    /**
+     * @brief Check if a completion has been signalled
+     */
+    bool robusto_completion_is_done(robusto_completion_t *completion);
+
+    /**
+     * @brief Get the queue state of a completion, for following its progress
+     */
+    queue_state *robusto_completion_get_state(robusto_completion_t *completion);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
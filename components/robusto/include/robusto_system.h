@@ -37,6 +37,7 @@
 #include <stdarg.h>
 #include <stdbool.h>
 #include <robusto_retval.h>
+#include <robusto_crc32.h>
 
 #ifdef __cplusplus
 extern "C"
@@ -102,6 +103,124 @@ void *robusto_spi_realloc(void *ptr, size_t size);
  */
 void robusto_free(void *ptr);
 
+/* A reference counted buffer that can be shared by many senders without copying, see robusto_buffer.c */
+typedef struct robusto_buffer robusto_buffer_t;
+
+/**
+ * @brief Allocate a shared buffer, the caller owns one reference and must release it when done.
+ * 
+ * @param length Number of bytes 
+ * @param prefer_spiram Put the data in SPI RAM if available
+ * @return robusto_buffer_t* The buffer, NULL if out of memory
+ */
+robusto_buffer_t *robusto_buffer_create(uint32_t length, bool prefer_spiram);
+
+/**
+ * @brief Get the data of a shared buffer
+ */
+uint8_t *robusto_buffer_get_data(robusto_buffer_t *buffer);
+
+/**
+ * @brief Get the length of a shared buffer
+ */
+uint32_t robusto_buffer_get_length(robusto_buffer_t *buffer);
+
+/**
+ * @brief Take a reference to a shared buffer
+ */
+void robusto_buffer_retain(robusto_buffer_t *buffer);
+
+/**
+ * @brief Release a reference to a shared buffer, it is freed when the last reference is released
+ */
+void robusto_buffer_release(robusto_buffer_t *buffer);
+
+/* A pool of fixed size slots, that are taken and given back without using the heap, see robusto_pool.c */
+typedef struct robusto_pool robusto_pool_t;
+
+/* The usage of a pool, as reported by the memory monitor */
+typedef struct robusto_pool_stats
+{
+    /* The name of the pool */
+    const char *name;
+    /* The size of each slot in bytes */
+    uint32_t slot_size;
+    /* The number of slots */
+    uint16_t slot_count;
+    /* Slots currently taken */
+    uint16_t in_use;
+    /* The most slots that have been taken at the same time */
+    uint16_t high_water;
+    /* How many times a slot was asked for when all were taken */
+    uint32_t exhausted;
+} robusto_pool_stats_t;
+
+/**
+ * @brief Create a pool, allocating all its slots at once
+ * 
+ * @param name The name of the pool when reported, must outlive it
+ * @param slot_size The size of each slot in bytes
+ * @param slot_count The number of slots
+ * @return robusto_pool_t* The pool, NULL if out of memory
+ */
+robusto_pool_t *robusto_pool_create(const char *name, uint32_t slot_size, uint16_t slot_count);
+
+/**
+ * @brief Take a free slot from a pool, safe to call from any task
+ * 
+ * @return void* The slot, NULL if all are taken or there is no pool
+ */
+void *robusto_pool_take(robusto_pool_t *pool);
+
+/**
+ * @brief Give a slot back to the pool it was taken from
+ * 
+ * @return bool False if the slot is not from the pool, then the caller should free it as usual
+ */
+bool robusto_pool_give(robusto_pool_t *pool, void *slot);
+
+/**
+ * @brief Is the memory a slot of this pool?
+ */
+bool robusto_pool_owns(robusto_pool_t *pool, const void *slot);
+
+/**
+ * @brief The number of free slots in the pool
+ */
+uint16_t robusto_pool_available(robusto_pool_t *pool);
+
+/**
+ * @brief Get the usage of a pool, in the order they were created
+ * 
+ * @param index The index of the pool, start at zero and increase until false is returned
+ * @param stats Set to the usage of the pool
+ * @return bool False if there is no pool at the index
+ */
+bool robusto_pool_get_stats(uint8_t index, robusto_pool_stats_t *stats);
+
+/**
+ * @brief Allocate memory from the smallest size class it fits in, from the heap if it does not fit or they are all taken
+ * @note Free it using robusto_free(), which gives the slot back to its size class
+ */
+void *robusto_pool_malloc(size_t size);
+
+/**
+ * @brief Give memory back to its size class
+ * 
+ * @return bool False if it was not allocated from a size class
+ */
+bool robusto_pool_free(void *ptr);
+
+/**
+ * @brief The slot size of memory allocated from a size class, zero if it was allocated from the heap
+ */
+uint32_t robusto_pool_size_of(const void *ptr);
+
+/**
+ * @brief Create the size classes, as configured by ROBUSTO_POOL_*
+ */
+void robusto_pool_init(void);
+
 /**
  * @brief Calculate checksum according to the Fletcher16-algorithm.
  * 
@@ -111,17 +230,6 @@ void robusto_free(void *ptr);
  */
 void robusto_checksum16(uint8_t *data, int count, uint16_t *dest);
 
-/**
- * @brief Calculate bitwise big-endian Ethernet AUTODIN II CRC32
- * 
- * @param crc Seed value for computation.  ~0 for Ethernet, sometimes 0 for
- *        other uses, or the previous crc32 value if computing incrementally.
- * @param buf Pointer to buffer over which CRC is run
- * @param len Length of buffer
- * @return uint32_t The CRC32 value
- */
-uint32_t robusto_crc32(uint32_t crc, const uint8_t *buf, size_t len);
-
 
 /**
  * @brief 
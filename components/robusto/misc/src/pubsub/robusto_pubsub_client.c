@@ -310,11 +310,20 @@ rob_ret_val_t robusto_pubsub_client_publish(subscribed_topic_t *topic, uint8_t *
 
     if ((topic->peer != NULL) && (topic->peer->state != PEER_UNKNOWN))
     {
-        uint8_t *request = robusto_malloc(data_length + 5);
+        // The message references the request instead of copying it again
+        robusto_buffer_t *buffer = robusto_buffer_create(data_length + 5, false);
+        if (buffer == NULL)
+        {
+            ROB_LOGE(pubsub_client_log_prefix, "Could not publish %s to %s, out of memory.", topic->topic_name, topic->peer->name);
+            set_topic_state(topic, TOPIC_STATE_PROBLEM);
+            return ROB_ERR_OUT_OF_MEMORY;
+        }
+        uint8_t *request = robusto_buffer_get_data(buffer);
         request[0] = PUBSUB_PUBLISH;
         memcpy(request + 1, &topic->topic_hash, sizeof(topic->topic_hash));
         memcpy(request + 5, data, data_length);
-        rob_ret_val_t ret_msg = send_message_binary(topic->peer, PUBSUB_SERVER_ID, 0, request, data_length + 5, NULL);
+        rob_ret_val_t ret_msg = send_message_multi_buffer(topic->peer, PUBSUB_SERVER_ID, 0, NULL, 0, buffer, NULL, robusto_mt_none);
+        robusto_buffer_release(buffer);
         if (ret_msg != ROB_OK) {
             set_topic_state(topic, TOPIC_STATE_PROBLEM);    
         } else {
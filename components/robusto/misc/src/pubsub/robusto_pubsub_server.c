@@ -7,7 +7,9 @@
 #include <robusto_peer.h>
 #include <robusto_system.h>
 #include <robusto_concurrency.h>
+#include <robusto_time.h>
 #include <string.h>
+#include <stdatomic.h>
 
 #ifdef ESP_PLATFORM
 #include "esp_heap_caps.h"
@@ -95,7 +97,10 @@ static void log_large_publish_snapshot(const char *phase,
 #endif
 }
 
-static uint8_t *build_peer_publish_message(uint32_t topic_hash,
+/**
+ * @brief Build the publish message once, in a shared buffer that all peer subscribers send
+ */
+static robusto_buffer_t *build_peer_publish_message(uint32_t topic_hash,
                                            uint8_t *data,
                                            uint32_t data_length,
                                            bool prefer_spiram,
@@ -114,18 +119,18 @@ static uint8_t *build_peer_publish_message(uint32_t topic_hash,
         .has_strings = false,
         .has_binary = true,
     };
-    uint8_t *message = (payload_length > 500U && prefer_spiram)
-                           ? robusto_spi_malloc(message_length)
-                           : robusto_malloc(message_length);
+    robusto_buffer_t *buffer = robusto_buffer_create(message_length, payload_length > 500U && prefer_spiram);
+    uint8_t *message;
     uint16_t service_id = PUBSUB_CLIENT_ID;
     uint8_t *payload;
     uint32_t crc32;
 
     *message_length_out = message_length;
 
-    if (message == NULL) {
+    if (buffer == NULL) {
         return NULL;
     }
+    message = robusto_buffer_get_data(buffer);
 
     memset(message, 0, ROBUSTO_PREFIX_BYTES);
     message[ROBUSTO_PREFIX_BYTES + ROBUSTO_CRC_LENGTH] = robusto_encode_message_context(&context);
@@ -144,7 +149,7 @@ static uint8_t *build_peer_publish_message(uint32_t topic_hash,
                           message_length - ROBUSTO_PREFIX_BYTES - ROBUSTO_CRC_LENGTH);
     memcpy(message + ROBUSTO_PREFIX_BYTES, &crc32, ROBUSTO_CRC_LENGTH);
 
-    return message;
+    return buffer;
 }
 
 static rob_ret_val_t prepare_peer_publish(robusto_peer_t *peer,
@@ -220,6 +225,46 @@ pubsub_server_topic_t *first_topic = NULL;
 /* Last topic in the list */
 pubsub_server_topic_t *last_topic = NULL;
 
+/* The hash indexes are open addressing tables with linear probing, their sizes are always powers of two */
+#define PUBSUB_INDEX_INITIAL_SIZE 16U
+
+/* Topics by hash, topics are never removed */
+static pubsub_server_topic_t **s_topic_index = NULL;
+static uint32_t s_topic_index_size = 0U;
+static uint32_t s_topic_index_count = 0U;
+
+/* A peer and the first of its subscriptions */
+typedef struct pubsub_peer_index_entry {
+    uint32_t relation_id;
+    /* NULL if the slot is free */
+    pubsub_server_subscriber_t *first;
+} pubsub_peer_index_entry_t;
+
+/* Peer subscriptions by relation id, makes removing all subscriptions of a peer independent of the topic count */
+static pubsub_peer_index_entry_t *s_peer_index = NULL;
+static uint32_t s_peer_index_size = 0U;
+static uint32_t s_peer_index_count = 0U;
+
+/* What a publish needs of a subscriber */
+typedef struct pubsub_snapshot_entry {
+    robusto_peer_t *peer;
+    pubsub_server_subscriber_callback *local_callback;
+    pubsub_server_subscriber_context_callback *local_context_callback;
+    void *local_context;
+} pubsub_snapshot_entry_t;
+
+struct pubsub_subscriber_snapshot {
+    /* The topic holds one reference, each publish in progress one */
+    atomic_uint references;
+    /* Links snapshots replaced by an unsubscribe that has to wait for them */
+    pubsub_subscriber_snapshot_t *retired_next;
+    uint32_t count;
+    pubsub_snapshot_entry_t entries[];
+};
+
+/* Publishes delivering on this task, an unsubscribe from a callback can't wait for its own publish */
+static _Thread_local uint32_t s_dispatch_depth = 0U;
+
 static bool pubsub_lock(void)
 {
     if (s_pubsub_mutex == NULL) {
@@ -242,30 +287,265 @@ static void pubsub_unlock(void)
     }
 }
 
+/* Spread the key over the table, relation ids and topic hashes may share low bits */
+static inline uint32_t pubsub_index_slot(uint32_t key, uint32_t size) {
+    return (key * 2654435761U) & (size - 1U);
+}
+
+/* Grow when more than three quarters full, keeps the probe sequences short */
+static inline bool pubsub_index_needs_growth(uint32_t count, uint32_t size) {
+    return size == 0U || (count + 1U) * 4U > size * 3U;
+}
+
+static void topic_index_place(pubsub_server_topic_t **index, uint32_t size, pubsub_server_topic_t *topic) {
+    uint32_t slot = pubsub_index_slot(topic->hash, size);
+    while (index[slot]) {
+        slot = (slot + 1U) & (size - 1U);
+    }
+    index[slot] = topic;
+}
+
+static bool topic_index_add(pubsub_server_topic_t *topic) {
+    if (pubsub_index_needs_growth(s_topic_index_count, s_topic_index_size)) {
+        uint32_t new_size = s_topic_index_size ? s_topic_index_size * 2U : PUBSUB_INDEX_INITIAL_SIZE;
+        pubsub_server_topic_t **new_index = robusto_malloc(new_size * sizeof(pubsub_server_topic_t *));
+        if (!new_index) {
+            return false;
+        }
+        memset(new_index, 0, new_size * sizeof(pubsub_server_topic_t *));
+        for (uint32_t i = 0; i < s_topic_index_size; i++) {
+            if (s_topic_index[i]) {
+                topic_index_place(new_index, new_size, s_topic_index[i]);
+            }
+        }
+        robusto_free(s_topic_index);
+        s_topic_index = new_index;
+        s_topic_index_size = new_size;
+    }
+    topic_index_place(s_topic_index, s_topic_index_size, topic);
+    s_topic_index_count++;
+    return true;
+}
+
 pubsub_server_topic_t * find_topic_by_name(char * topic_name) {
 
-    pubsub_server_topic_t * curr_topic = first_topic;
-    while (curr_topic) {
-        if (strcmp(curr_topic->name, topic_name) == 0) {
-            return curr_topic;
+    if (s_topic_index_size == 0U) {
+        return NULL;
+    }
+    uint32_t hash = robusto_crc32(0, (uint8_t *)topic_name, strlen(topic_name));
+    uint32_t slot = pubsub_index_slot(hash, s_topic_index_size);
+    while (s_topic_index[slot]) {
+        if (s_topic_index[slot]->hash == hash && strcmp(s_topic_index[slot]->name, topic_name) == 0) {
+            return s_topic_index[slot];
         }
-        curr_topic = curr_topic->next;
+        slot = (slot + 1U) & (s_topic_index_size - 1U);
     }
     return NULL;
 }
 
 pubsub_server_topic_t * find_topic_by_hash(uint32_t hash) {
 
-    pubsub_server_topic_t * curr_topic = first_topic;
-    while (curr_topic) {
-        if (curr_topic->hash == hash) {
-            return curr_topic;
+    if (s_topic_index_size == 0U) {
+        return NULL;
+    }
+    uint32_t slot = pubsub_index_slot(hash, s_topic_index_size);
+    while (s_topic_index[slot]) {
+        if (s_topic_index[slot]->hash == hash) {
+            return s_topic_index[slot];
+        }
+        slot = (slot + 1U) & (s_topic_index_size - 1U);
+    }
+    return NULL;
+}
+
+static pubsub_peer_index_entry_t *peer_index_find(uint32_t relation_id) {
+    if (s_peer_index_size == 0U) {
+        return NULL;
+    }
+    uint32_t slot = pubsub_index_slot(relation_id, s_peer_index_size);
+    while (s_peer_index[slot].first) {
+        if (s_peer_index[slot].relation_id == relation_id) {
+            return &s_peer_index[slot];
         }
-        curr_topic = curr_topic->next;
+        slot = (slot + 1U) & (s_peer_index_size - 1U);
     }
     return NULL;
 }
 
+static pubsub_peer_index_entry_t *peer_index_place(pubsub_peer_index_entry_t *index, uint32_t size,
+                                                   uint32_t relation_id, pubsub_server_subscriber_t *first) {
+    uint32_t slot = pubsub_index_slot(relation_id, size);
+    while (index[slot].first) {
+        slot = (slot + 1U) & (size - 1U);
+    }
+    index[slot].relation_id = relation_id;
+    index[slot].first = first;
+    return &index[slot];
+}
+
+/* Put a peer subscription first in the list of its peer */
+static bool peer_index_add(pubsub_server_subscriber_t *subscriber) {
+    uint32_t relation_id = subscriber->relation_id;
+    pubsub_peer_index_entry_t *entry = peer_index_find(relation_id);
+
+    if (entry) {
+        subscriber->next_of_peer = entry->first;
+        entry->first->previous_of_peer = subscriber;
+        entry->first = subscriber;
+        return true;
+    }
+    if (pubsub_index_needs_growth(s_peer_index_count, s_peer_index_size)) {
+        uint32_t new_size = s_peer_index_size ? s_peer_index_size * 2U : PUBSUB_INDEX_INITIAL_SIZE;
+        pubsub_peer_index_entry_t *new_index = robusto_malloc(new_size * sizeof(pubsub_peer_index_entry_t));
+        if (!new_index) {
+            return false;
+        }
+        memset(new_index, 0, new_size * sizeof(pubsub_peer_index_entry_t));
+        for (uint32_t i = 0; i < s_peer_index_size; i++) {
+            if (s_peer_index[i].first) {
+                peer_index_place(new_index, new_size, s_peer_index[i].relation_id, s_peer_index[i].first);
+            }
+        }
+        robusto_free(s_peer_index);
+        s_peer_index = new_index;
+        s_peer_index_size = new_size;
+    }
+    peer_index_place(s_peer_index, s_peer_index_size, relation_id, subscriber);
+    s_peer_index_count++;
+    return true;
+}
+
+/* Free a slot, moving later entries of the probe sequence back so that no tombstones are needed */
+static void peer_index_remove_entry(pubsub_peer_index_entry_t *entry) {
+    uint32_t mask = s_peer_index_size - 1U;
+    uint32_t hole = (uint32_t)(entry - s_peer_index);
+    uint32_t slot = (hole + 1U) & mask;
+
+    while (s_peer_index[slot].first) {
+        uint32_t home = pubsub_index_slot(s_peer_index[slot].relation_id, s_peer_index_size);
+        // Move the entry into the hole unless its home lies cyclically in (hole, slot]
+        if (((slot - home) & mask) >= ((slot - hole) & mask)) {
+            s_peer_index[hole] = s_peer_index[slot];
+            hole = slot;
+        }
+        slot = (slot + 1U) & mask;
+    }
+    s_peer_index[hole].first = NULL;
+    s_peer_index[hole].relation_id = 0U;
+    s_peer_index_count--;
+}
+
+static void peer_index_unlink(pubsub_server_subscriber_t *subscriber) {
+    if (subscriber->previous_of_peer) {
+        subscriber->previous_of_peer->next_of_peer = subscriber->next_of_peer;
+    } else {
+        pubsub_peer_index_entry_t *entry = peer_index_find(subscriber->relation_id);
+        if (!entry) {
+            ROB_LOGE(pubsub_log_prefix, "Internal error: peer %s missing from the subscription index", subscriber->peer->name);
+            return;
+        }
+        if (subscriber->next_of_peer) {
+            entry->first = subscriber->next_of_peer;
+        } else {
+            peer_index_remove_entry(entry);
+        }
+    }
+    if (subscriber->next_of_peer) {
+        subscriber->next_of_peer->previous_of_peer = subscriber->previous_of_peer;
+    }
+}
+
+static void snapshot_release(pubsub_subscriber_snapshot_t *snapshot) {
+    if (snapshot && atomic_fetch_sub(&snapshot->references, 1) == 1) {
+        robusto_free(snapshot);
+    }
+}
+
+/* Copy the current subscribers of a topic, the caller gets the reference */
+static pubsub_subscriber_snapshot_t *snapshot_create_locked(pubsub_server_topic_t *topic) {
+    uint32_t count = 0U;
+    for (pubsub_server_subscriber_t *curr = topic->first_subscriber; curr; curr = curr->next) {
+        count++;
+    }
+    pubsub_subscriber_snapshot_t *snapshot = robusto_malloc(sizeof(pubsub_subscriber_snapshot_t) +
+                                                            count * sizeof(pubsub_snapshot_entry_t));
+    if (!snapshot) {
+        return NULL;
+    }
+    atomic_init(&snapshot->references, 1);
+    snapshot->retired_next = NULL;
+    snapshot->count = count;
+    pubsub_snapshot_entry_t *entry = snapshot->entries;
+    for (pubsub_server_subscriber_t *curr = topic->first_subscriber; curr; curr = curr->next, entry++) {
+        entry->peer = curr->peer;
+        entry->local_callback = curr->local_callback;
+        entry->local_context_callback = curr->local_context_callback;
+        entry->local_context = curr->local_context;
+    }
+    return snapshot;
+}
+
+/**
+ * @brief Drop the snapshot of a topic after its subscribers changed, the next publish makes a new one
+ *
+ * @param retired If set, the snapshot is handed over here instead of released, to wait for it to be unused.
+ */
+static void snapshot_retire_locked(pubsub_server_topic_t *topic, pubsub_subscriber_snapshot_t **retired) {
+    pubsub_subscriber_snapshot_t *snapshot = topic->snapshot;
+    if (!snapshot) {
+        return;
+    }
+    topic->snapshot = NULL;
+    if (retired) {
+        snapshot->retired_next = *retired;
+        *retired = snapshot;
+    } else {
+        snapshot_release(snapshot);
+    }
+}
+
+/* Wait until no publish uses the retired snapshots anymore and release them, call without the lock */
+static void snapshot_wait_retired(pubsub_subscriber_snapshot_t *retired) {
+    if (retired && s_dispatch_depth > 0U) {
+        ROB_LOGD(pubsub_log_prefix, "Unsubscribing from a subscriber callback, publishes in progress may still deliver");
+    }
+    while (retired) {
+        pubsub_subscriber_snapshot_t *next = retired->retired_next;
+        if (s_dispatch_depth == 0U) {
+            while (atomic_load(&retired->references) > 1U) {
+                r_delay(1);
+            }
+        }
+        snapshot_release(retired);
+        retired = next;
+    }
+}
+
+/* Unlink a subscriber from its topic and peer, and free it */
+static void remove_subscriber_locked(pubsub_server_subscriber_t *subscriber, pubsub_subscriber_snapshot_t **retired) {
+    pubsub_server_topic_t *topic = subscriber->topic;
+
+    snapshot_retire_locked(topic, retired);
+
+    if (subscriber->previous) {
+        subscriber->previous->next = subscriber->next;
+    } else {
+        topic->first_subscriber = subscriber->next;
+    }
+    if (subscriber->next) {
+        subscriber->next->previous = subscriber->previous;
+    } else {
+        topic->last_subscriber = subscriber->previous;
+    }
+    if (topic->subscriber_count > 0U) {
+        topic->subscriber_count--;
+    }
+    if (subscriber->peer) {
+        peer_index_unlink(subscriber);
+    }
+    robusto_free(subscriber);
+}
+
 static pubsub_server_topic_t *find_or_create_topic_locked(char *name) {
     if (!name || name[0] == '\0') {
         return NULL;
@@ -288,8 +568,14 @@ static pubsub_server_topic_t *find_or_create_topic_locked(char *name) {
         new_topic->subscriber_count = 0;
         new_topic->first_subscriber = NULL;
         new_topic->last_subscriber = NULL;
+        new_topic->snapshot = NULL;
         new_topic->next = NULL;
         new_topic->hash = robusto_crc32(0, (uint8_t *)name, name_len);
+        if (!topic_index_add(new_topic)) {
+            robusto_free(new_topic->name);
+            robusto_free(new_topic);
+            return NULL;
+        }
         if (!first_topic) {
             first_topic = new_topic;
         } else {
@@ -316,6 +602,7 @@ pubsub_server_topic_t * robusto_pubsub_server_find_or_create_topic(char * name)
 }
 /**
  * @brief Find out if a peer already has a subscription to a topic
+ * @note Peer subscriptions are looked up among the subscriptions of the peer, local ones among those of the topic
  * 
  * @param topic 
  * @param peer 
@@ -327,11 +614,20 @@ pubsub_server_subscriber_t * find_subscription(pubsub_server_topic_t *topic,
                                                pubsub_server_subscriber_context_callback *local_context_cb,
                                                void *local_context) {
 
+    if (peer) {
+        pubsub_peer_index_entry_t *entry = peer_index_find(peer->relation_id_incoming);
+        pubsub_server_subscriber_t *curr_subscription = entry ? entry->first : NULL;
+        while (curr_subscription) {
+            if (curr_subscription->topic == topic) {
+                return curr_subscription;
+            }
+            curr_subscription = curr_subscription->next_of_peer;
+        }
+        return NULL;
+    }
     pubsub_server_subscriber_t * curr_subscriber = topic->first_subscriber;
     while (curr_subscriber) {
-        if ((peer && curr_subscriber->peer &&
-             curr_subscriber->peer->relation_id_incoming == peer->relation_id_incoming) ||
-            (local_cb && !curr_subscriber->peer &&
+        if ((local_cb && !curr_subscriber->peer &&
              curr_subscriber->local_callback == local_cb) ||
             (local_context_cb && !curr_subscriber->peer &&
              curr_subscriber->local_context_callback == local_context_cb &&
@@ -368,7 +664,18 @@ uint32_t robusto_pubsub_add_subscriber(pubsub_server_topic_t *topic,
     new_subscriber->local_callback = local_cb;
     new_subscriber->local_context_callback = local_context_cb;
     new_subscriber->local_context = local_context;
+    new_subscriber->topic = topic;
     new_subscriber->next = NULL;
+    new_subscriber->previous = topic->last_subscriber;
+    new_subscriber->relation_id = peer ? peer->relation_id_incoming : 0U;
+    new_subscriber->next_of_peer = NULL;
+    new_subscriber->previous_of_peer = NULL;
+    if (peer && !peer_index_add(new_subscriber)) {
+        robusto_free(new_subscriber);
+        return 0;
+    }
+    // Publishes in progress may keep the old snapshot, they just don't deliver to the new subscriber
+    snapshot_retire_locked(topic, NULL);
     if (!topic->first_subscriber) {
         topic->first_subscriber = new_subscriber;
     } else {
@@ -424,39 +731,23 @@ uint32_t robusto_pubsub_server_unsubscribe(robusto_peer_t *peer, pubsub_server_s
         return 0;
     }
     pubsub_server_topic_t *curr_topic = find_topic_by_hash(topic);
-    pubsub_server_subscriber_t *previous = NULL;
     pubsub_server_subscriber_t *subscriber;
+    pubsub_subscriber_snapshot_t *retired = NULL;
 
     if (!curr_topic || (!peer && !local_cb) || (peer && local_cb)) {
         pubsub_unlock();
         return 0;
     }
 
-    subscriber = curr_topic->first_subscriber;
-    while (subscriber) {
-        bool matches = (peer && subscriber->peer &&
-                        subscriber->peer->relation_id_incoming == peer->relation_id_incoming) ||
-                       (local_cb && !subscriber->peer &&
-                        subscriber->local_callback == local_cb);
-        if (matches) {
-            if (previous) {
-                previous->next = subscriber->next;
-            } else {
-                curr_topic->first_subscriber = subscriber->next;
-            }
-            if (curr_topic->last_subscriber == subscriber) {
-                curr_topic->last_subscriber = previous;
-            }
-            curr_topic->subscriber_count--;
-            robusto_free(subscriber);
-            pubsub_unlock();
-            return curr_topic->hash;
-        }
-        previous = subscriber;
-        subscriber = subscriber->next;
+    subscriber = find_subscription(curr_topic, peer, local_cb, NULL, NULL);
+    if (!subscriber) {
+        pubsub_unlock();
+        return 0;
     }
+    remove_subscriber_locked(subscriber, &retired);
     pubsub_unlock();
-    return 0;
+    snapshot_wait_retired(retired);
+    return curr_topic->hash;
 }
 
 uint32_t robusto_pubsub_server_unsubscribe_with_context(pubsub_server_subscriber_context_callback *local_cb,
@@ -466,40 +757,29 @@ uint32_t robusto_pubsub_server_unsubscribe_with_context(pubsub_server_subscriber
         return 0;
     }
     pubsub_server_topic_t *curr_topic = find_topic_by_hash(topic);
-    pubsub_server_subscriber_t *previous = NULL;
     pubsub_server_subscriber_t *subscriber;
+    pubsub_subscriber_snapshot_t *retired = NULL;
 
     if (!curr_topic || !local_cb) {
         pubsub_unlock();
         return 0;
     }
 
-    subscriber = curr_topic->first_subscriber;
-    while (subscriber) {
-        if (!subscriber->peer && subscriber->local_context_callback == local_cb &&
-            subscriber->local_context == context) {
-            if (previous) {
-                previous->next = subscriber->next;
-            } else {
-                curr_topic->first_subscriber = subscriber->next;
-            }
-            if (curr_topic->last_subscriber == subscriber) {
-                curr_topic->last_subscriber = previous;
-            }
-            curr_topic->subscriber_count--;
-            robusto_free(subscriber);
-            pubsub_unlock();
-            return curr_topic->hash;
-        }
-        previous = subscriber;
-        subscriber = subscriber->next;
+    subscriber = find_subscription(curr_topic, NULL, NULL, local_cb, context);
+    if (!subscriber) {
+        pubsub_unlock();
+        return 0;
     }
+    remove_subscriber_locked(subscriber, &retired);
     pubsub_unlock();
-    return 0;
+    snapshot_wait_retired(retired);
+    return curr_topic->hash;
 }
 
 uint32_t robusto_pubsub_server_unsubscribe_peer_from_all(robusto_peer_t *peer) {
     uint32_t removed = 0;
+    pubsub_peer_index_entry_t *entry;
+    pubsub_subscriber_snapshot_t *retired = NULL;
 
     if (!peer) {
         return 0;
@@ -507,46 +787,25 @@ uint32_t robusto_pubsub_server_unsubscribe_peer_from_all(robusto_peer_t *peer) {
     if (!pubsub_lock()) {
         return 0;
     }
-
-    pubsub_server_topic_t *curr_topic = first_topic;
-    while (curr_topic) {
-        pubsub_server_subscriber_t *previous = NULL;
-        pubsub_server_subscriber_t *subscriber = curr_topic->first_subscriber;
-
-        while (subscriber) {
-            if (subscriber->peer &&
-                subscriber->peer->relation_id_incoming == peer->relation_id_incoming) {
-                pubsub_server_subscriber_t *next = subscriber->next;
-
-                if (previous) {
-                    previous->next = next;
-                } else {
-                    curr_topic->first_subscriber = next;
-                }
-                if (curr_topic->last_subscriber == subscriber) {
-                    curr_topic->last_subscriber = previous;
-                }
-                if (curr_topic->subscriber_count > 0U) {
-                    curr_topic->subscriber_count--;
-                }
-                robusto_free(subscriber);
-                removed++;
-                subscriber = next;
-                continue;
-            }
-
-            previous = subscriber;
-            subscriber = subscriber->next;
-        }
-
-        curr_topic = curr_topic->next;
+    // The entry is freed (and others may move) when the last subscription is removed, so look it up each time.
+    while ((entry = peer_index_find(peer->relation_id_incoming)) != NULL) {
+        remove_subscriber_locked(entry->first, &retired);
+        removed++;
     }
 
     pubsub_unlock();
+    // Publishes in progress may still send to the peer
+    snapshot_wait_retired(retired);
     return removed;
 }
 
-rob_ret_val_t publish_topic(pubsub_server_topic_t * topic, pubsub_server_subscriber_t *subscriber, uint8_t* data, uint32_t data_length) {
+/**
+ * @brief Publish to a subscriber
+ * 
+ * @param shared_message The message to peers, built by the first peer subscriber and then shared by the rest. 
+ *  The caller releases it when done.
+ */
+rob_ret_val_t publish_topic(pubsub_server_topic_t * topic, pubsub_snapshot_entry_t *subscriber, uint8_t* data, uint32_t data_length, robusto_buffer_t **shared_message) {
     if (subscriber->local_callback) {
         ROB_LOGD(pubsub_log_prefix, "Publishing %s to callback", topic->name);
         return  subscriber->local_callback(data, data_length);
@@ -564,30 +823,29 @@ rob_ret_val_t publish_topic(pubsub_server_topic_t * topic, pubsub_server_subscri
         }
 
         ROB_LOGD(pubsub_log_prefix, "Publishing %s to peer %s.", topic->name, subscriber->peer->name);
-        uint8_t *msg = build_peer_publish_message(topic->hash,
-                                                  data,
-                                                  data_length,
-                                                  prefer_spiram,
-                                                  &message_length);
-        if (!msg) {
-            ROB_LOGE(pubsub_log_prefix, "Failed allocating memory to publish %s to peer %s.", topic->name, subscriber->peer->name);
-            log_peer_publish_alloc_failure(topic->name,
-                                           subscriber->peer->name,
-                                           data_length,
-                                           message_length,
-                                           prefer_spiram);
-            return ROB_ERR_OUT_OF_MEMORY;
+        if (*shared_message == NULL) {
+            *shared_message = build_peer_publish_message(topic->hash,
+                                                         data,
+                                                         data_length,
+                                                         prefer_spiram,
+                                                         &message_length);
+            if (*shared_message == NULL) {
+                ROB_LOGE(pubsub_log_prefix, "Failed allocating memory to publish %s to peer %s.", topic->name, subscriber->peer->name);
+                log_peer_publish_alloc_failure(topic->name,
+                                               subscriber->peer->name,
+                                               data_length,
+                                               message_length,
+                                               prefer_spiram);
+                return ROB_ERR_OUT_OF_MEMORY;
+            }
         }
 
-        rob_ret_val_t pubretval = send_message_raw(subscriber->peer,
-                                                   media_type,
-                                                   msg,
-                                                   message_length,
-                                                   NULL,
-                                                   true);
-        if (pubretval != ROB_OK) {
-            robusto_free(msg);
-        }
+        // The queue takes its own reference to the message, so there is nothing to free if it fails.
+        rob_ret_val_t pubretval = send_message_raw_buffer(subscriber->peer,
+                                                          media_type,
+                                                          *shared_message,
+                                                          NULL,
+                                                          true);
         if (pubretval != ROB_OK) {
             ROB_LOGW(pubsub_log_prefix, "Failed publishing %s to peer %s, retval: %i.", topic->name, subscriber->peer->name, pubretval);
         }
@@ -613,48 +871,68 @@ rob_ret_val_t robusto_pubsub_server_publish(uint32_t topic_hash, uint8_t *data,
         pubsub_unlock();
         return ROB_ERR_INVALID_ID;
     }
-    curr_topic->count++;
+    // Only take a snapshot of the subscribers under the lock, delivering may be slow
+    if (!curr_topic->snapshot && curr_topic->first_subscriber) {
+        curr_topic->snapshot = snapshot_create_locked(curr_topic);
+        if (!curr_topic->snapshot) {
+            ROB_LOGE(pubsub_log_prefix, "Failed allocating the subscribers of %s.", curr_topic->name);
+            pubsub_unlock();
+            return ROB_ERR_OUT_OF_MEMORY;
+        }
+    }
+    pubsub_subscriber_snapshot_t *snapshot = curr_topic->snapshot;
+    if (snapshot) {
+        atomic_fetch_add(&snapshot->references, 1);
+    }
+    uint32_t subscriber_count = snapshot ? snapshot->count : 0U;
+    uint32_t publish_count = ++curr_topic->count;
+    pubsub_unlock();
+
+    // Topics are never freed, so the name and hash can be used without the lock
     large_publish = data_length > 8192U;
     if (large_publish &&
-        (curr_topic->count <= 2U || ((uint32_t)curr_topic->count % 16U) == 0U)) {
+        (publish_count <= 2U || (publish_count % 16U) == 0U)) {
         log_large_publish_snapshot("begin",
                                    curr_topic->name,
                                    data_length,
-                                   curr_topic->count,
-                                   curr_topic->subscriber_count,
+                                   publish_count,
+                                   subscriber_count,
                                    0U);
     }
     int pub_count = 0;
     int fail_count = 0;
-    pubsub_server_subscriber_t *curr_subscriber = curr_topic->first_subscriber;
-    while (curr_subscriber) {
-        if (publish_topic(curr_topic, curr_subscriber, data, data_length) != ROB_OK) {
+    robusto_buffer_t *shared_message = NULL;
+    s_dispatch_depth++;
+    for (uint32_t i = 0; i < subscriber_count; i++) {
+        if (publish_topic(curr_topic, &snapshot->entries[i], data, data_length, &shared_message) != ROB_OK) {
             fail_count++;
         }
         pub_count++;
-        curr_subscriber = curr_subscriber->next;
     }
+    s_dispatch_depth--;
+    snapshot_release(snapshot);
+    // The queued sends keep the message until they are done
+    robusto_buffer_release(shared_message);
     if (fail_count > 0) {
         if (large_publish) {
             log_large_publish_snapshot("end_fail",
                                        curr_topic->name,
                                        data_length,
-                                       curr_topic->count,
-                                       curr_topic->subscriber_count,
+                                       publish_count,
+                                       subscriber_count,
                                        (uint32_t)fail_count);
         }
         ROB_LOGW(pubsub_log_prefix, "Published to the %i subscribers of %s, failed in %i cases.", pub_count, curr_topic->name, fail_count);
     } else if (large_publish &&
-               curr_topic->subscriber_count == 0U &&
-               (curr_topic->count <= 2U || ((uint32_t)curr_topic->count % 16U) == 0U)) {
+               subscriber_count == 0U &&
+               (publish_count <= 2U || (publish_count % 16U) == 0U)) {
         log_large_publish_snapshot("end_zero_subscribers",
                                    curr_topic->name,
                                    data_length,
-                                   curr_topic->count,
-                                   curr_topic->subscriber_count,
+                                   publish_count,
+                                   subscriber_count,
                                    0U);
     } 
-    pubsub_unlock();
     return fail_count == 0 ? ROB_OK : ROB_ERR_SEND_SOME_FAIL;
 }
 
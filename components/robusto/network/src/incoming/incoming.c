@@ -52,6 +52,17 @@ static char *incoming_log_prefix;
 
 static incoming_callback_cb *incoming_callback = NULL;
 
+/* A message and its queue item, taken together from the incoming pool, so that small messages need no heap */
+typedef struct incoming_slot
+{
+    /* Must be first, the message is given back to the pool as the slot */
+    robusto_message_t message;
+    incoming_queue_item_t queue_item;
+    char *strings[CONFIG_ROBUSTO_INCOMING_POOL_STRINGS];
+} incoming_slot_t;
+
+static robusto_pool_t *incoming_pool = NULL;
+
 static bool is_large_pubsub_publish(const robusto_message_t *message)
 {
 #if !ROBUSTO_TRACE_PUBSUB_MESSAGES
@@ -98,11 +109,31 @@ rob_ret_val_t robusto_handle_incoming(uint8_t *data, uint32_t data_length, robus
     // rob_log_bit_mesh(ROB_LOG_WARN, incoming_log_prefix, data + offset, data_length - offset);
     ROB_LOGD(incoming_log_prefix, "In robusto_handle_incoming.");
     robusto_message_t *message;
+    incoming_queue_item_t *queue_item = NULL;
 // Parse and check the message
 #ifdef CONFIG_HEAP_TRACING_STANDALONE
     ESP_ERROR_CHECK(heap_trace_start(HEAP_TRACE_LEAKS));
 #endif
-    rob_ret_val_t parse_retval = robusto_network_parse_message(data, data_length, peer, &message, offset);
+    rob_ret_val_t parse_retval;
+    incoming_slot_t *slot = robusto_pool_take(incoming_pool);
+    if (slot != NULL)
+    {
+        message = &slot->message;
+        parse_retval = robusto_network_parse_message_into(data, data_length, peer, message, offset, slot->strings, CONFIG_ROBUSTO_INCOMING_POOL_STRINGS);
+        if (parse_retval == ROB_OK)
+        {
+            message->pool = incoming_pool;
+            queue_item = &slot->queue_item;
+        }
+        else
+        {
+            robusto_pool_give(incoming_pool, slot);
+        }
+    }
+    else
+    {
+        parse_retval = robusto_network_parse_message(data, data_length, peer, &message, offset);
+    }
 
 #ifdef CONFIG_HEAP_TRACING_STANDALONE
     ESP_ERROR_CHECK(heap_trace_stop());
@@ -122,7 +153,10 @@ rob_ret_val_t robusto_handle_incoming(uint8_t *data, uint32_t data_length, robus
     log_large_pubsub_message("parsed", message);
 
     // Add it to the work queue
-    incoming_queue_item_t *queue_item = robusto_malloc(sizeof(incoming_queue_item_t));
+    if (queue_item == NULL)
+    {
+        queue_item = robusto_malloc(sizeof(incoming_queue_item_t));
+    }
     if (queue_item == NULL)
     {
         ROB_LOGE(incoming_log_prefix, "Failed allocating incoming queue item.");
@@ -141,8 +175,11 @@ rob_ret_val_t robusto_handle_incoming(uint8_t *data, uint32_t data_length, robus
                  peer->name,
                  media_type,
                  (unsigned long)data_length);
+        if (message->pool == NULL)
+        {
+            robusto_free(queue_item);
+        }
         robusto_message_free(message);
-        robusto_free(queue_item);
         return queue_retval;
     }
     log_large_pubsub_message("queued", message);
@@ -181,6 +218,8 @@ void incoming_do_on_incoming_cb(incoming_queue_item_t *queue_item)
         }
     }
     log_large_pubsub_message("worker_end", queue_item->message);
+    // A pooled queue item is part of the slot of its message, and goes with it
+    bool pooled = queue_item->message->pool != NULL;
     if (!queue_item->recipient_frees_message)
     {
         if (strcmp(queue_item->message->peer->name, "") == 0)
@@ -196,7 +235,10 @@ void incoming_do_on_incoming_cb(incoming_queue_item_t *queue_item)
         robusto_message_free(queue_item->message);
     }
 
-    robusto_free(queue_item);
+    if (!pooled)
+    {
+        robusto_free(queue_item);
+    }
 }
 void incoming_do_on_poll_cb(queue_context_t *q_context)
 {
@@ -226,6 +268,14 @@ void robusto_incoming_init(char *_log_prefix)
 {
 
     incoming_log_prefix = _log_prefix;
+    if (incoming_pool == NULL && CONFIG_ROBUSTO_INCOMING_POOL_SIZE > 0)
+    {
+        incoming_pool = robusto_pool_create("incoming", sizeof(incoming_slot_t), CONFIG_ROBUSTO_INCOMING_POOL_SIZE);
+        if (incoming_pool == NULL)
+        {
+            ROB_LOGW(incoming_log_prefix, "Could not allocate the incoming message pool, messages will be allocated one by one.");
+        }
+    }
     robusto_network_service_init(_log_prefix);
     robusto_incoming_network_init(_log_prefix);
 }
\ No newline at end of file
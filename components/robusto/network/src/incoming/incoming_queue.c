@@ -120,6 +120,10 @@ rob_ret_val_t incoming_init_worker(incoming_callback_cb work_cb, char *_log_pref
     incoming_queue_context->log_prefix = _log_prefix;
     incoming_queue_context->work_queue = &incoming_work_q;
 
-    return init_work_queue(incoming_queue_context, _log_prefix, "Incoming queue");      
+#ifdef CONFIG_ROBUSTO_QUEUE_RING
+    return init_work_queue_ring(incoming_queue_context, _log_prefix, "Incoming queue", CONFIG_ROBUSTO_QUEUE_RING_CAPACITY);
+#else
+    return init_work_queue(incoming_queue_context, _log_prefix, "Incoming queue");
+#endif
 }
 
@@ -61,8 +61,8 @@ void ble_do_on_poll_cb(queue_context_t *q_context) {
 void ble_do_on_work_cb(media_queue_item_t *work_item) {
     
     ROB_LOGD(ble_init_log_prefix, ">> In BLE work callback.");
-    send_work_item(work_item, &(work_item->peer->ble_info), robusto_mt_ble, 
-        &ble_send_message, &ble_do_on_poll_cb, ble_get_queue_context());
+    send_work_item_segments(work_item, &(work_item->peer->ble_info), robusto_mt_ble, 
+        &ble_send_message, &ble_send_message_segments, &ble_do_on_poll_cb, ble_get_queue_context());
 }
 
 
@@ -276,6 +276,36 @@ rob_ret_val_t ble_send_message(robusto_peer_t *peer, uint8_t *data, uint32_t dat
     return ble_send_message_raw(peer, data + ROBUSTO_PREFIX_BYTES, data_length - ROBUSTO_PREFIX_BYTES, receipt);
 }
 
+/**
+ * @brief Sends a message in segments through BLE, large messages are fragmented directly from the segments.
+ */
+rob_ret_val_t ble_send_message_segments(robusto_peer_t *peer, robusto_message_segments_t *segments, bool receipt)
+{
+    if (segments->length > (CONFIG_NIMBLE_ATT_PREFERRED_MTU + ROBUSTO_PREFIX_BYTES - 10))
+    {
+#if CONFIG_ROB_NETWORK_TEST_BLE_KILL_SWITCH > -1
+        if (robusto_gpio_get_level(CONFIG_ROB_NETWORK_TEST_BLE_KILL_SWITCH) == true)
+        {
+            ROB_LOGE("BLE", "BLE KILL SWITCH ON - Failing sending");
+            r_delay(100);
+            return ROB_FAIL;
+        }
+#endif
+        ROB_LOGI(ble_global_log_prefix, "Data length %lu is more than cutoff at %i bytes, sending fragmented", segments->length, CONFIG_NIMBLE_ATT_PREFERRED_MTU - 10);
+        return send_message_fragmented_segments(peer, robusto_mt_ble, segments, ROBUSTO_PREFIX_BYTES,
+             CONFIG_NIMBLE_ATT_PREFERRED_MTU - 20, ble_send_message_raw);
+    }
+    // It fits in one write, put it together
+    uint8_t *data = robusto_message_segments_linearise(segments);
+    if (data == NULL)
+    {
+        return ROB_ERR_OUT_OF_MEMORY;
+    }
+    rob_ret_val_t rc = ble_send_message(peer, data, segments->length, receipt);
+    robusto_free(data);
+    return rc;
+}
+
 void ble_global_init(char *_log_prefix)
 {
     ble_global_log_prefix = _log_prefix;
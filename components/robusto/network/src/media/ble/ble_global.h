@@ -9,6 +9,7 @@
 
 #include "ble_spp.h"
 #include <robusto_peer.h>
+#include <robusto_message_def.h>
 
 /*********************
  *      DEFINES
@@ -31,6 +32,7 @@ void report_ble_connection_error(int conn_handle, int code);
  */
 rob_ret_val_t ble_send_message_raw(robusto_peer_t *peer, uint8_t *data, uint32_t data_length, bool receipt);
 rob_ret_val_t ble_send_message(robusto_peer_t *peer, uint8_t *data, uint32_t data_length, bool receipt);
+rob_ret_val_t ble_send_message_segments(robusto_peer_t *peer, robusto_message_segments_t *segments, bool receipt);
 /**
  * @brief BLE addresses are presented in reverse and has an offset (+2) against the base MAC
  * 
@@ -0,0 +1,110 @@
+/**
+ * @file canbus_frame.c
+ * @author Nicklas Börjesson (<nicklasb at gmail dot com>)
+ * @brief The CAN bus identifier, and the extended single-frame encodings that use its reserved bit
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @copyright 
+ * Copyright (c) 2026, Nicklas Börjesson <nicklasb at gmail dot com>
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, 
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE 
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "canbus_frame.h"
+#if defined(CONFIG_ROBUSTO_SUPPORTS_CANBUS) || defined(CONFIG_ROBUSTO_NETWORK_MOCK_TESTING)
+
+#include <robusto_message_def.h>
+#include <string.h>
+
+uint8_t canbus_single_frame_length(uint8_t protocol_version)
+{
+#ifdef CONFIG_ROBUSTO_CANBUS_EXTENDED_PAYLOAD
+    if (protocol_version >= ROBUSTO_PROTOCOL_VERSION_CANBUS_EXTENDED)
+    {
+        return CANBUS_FRAME_LENGTH + 1;
+    }
+#endif
+    return CANBUS_FRAME_LENGTH;
+}
+
+bool canbus_fits_single_frame(robusto_peer_t *peer, const uint8_t *message, uint32_t message_length)
+{
+    uint8_t single_frame_length = canbus_single_frame_length(peer->protocol_version);
+    if ((message_length <= CANBUS_FRAME_LENGTH) || (single_frame_length == CANBUS_FRAME_LENGTH))
+    {
+        return message_length <= CANBUS_FRAME_LENGTH;
+    }
+    if (message == NULL)
+    {
+        return message_length <= single_frame_length;
+    }
+    uint32_t identifier;
+    return canbus_encode_extended(message, message_length, CANBUS_FRAME_LENGTH, 0, 0, &identifier) > 0;
+}
+
+uint32_t canbus_make_identifier(uint8_t source, uint8_t dest, bool first, uint16_t count_index)
+{
+    uint32_t identifier = ((uint32_t)(count_index & CANBUS_ID_COUNT_MASK) << 16) | ((uint32_t)source << 8) | dest;
+    return first ? identifier | CANBUS_ID_FIRST : identifier;
+}
+
+uint8_t canbus_encode_extended(const uint8_t *message, uint32_t message_length, uint8_t frame_length,
+                               uint8_t source, uint8_t dest, uint32_t *identifier)
+{
+    uint32_t base = CANBUS_ID_FIRST | CANBUS_ID_EXTENDED | ((uint32_t)source << 8) | dest;
+    if ((message_length > CANBUS_COMPACT_CALL_HEADER_LENGTH) && (message_length <= frame_length + CANBUS_COMPACT_CALL_HEADER_LENGTH) &&
+        (message[0] == CANBUS_COMPACT_CALL_CONTEXT))
+    {
+        uint16_t service_id;
+        memcpy(&service_id, message + 1, sizeof(service_id));
+        if (service_id <= CANBUS_COMPACT_CALL_MAX_SERVICE_ID)
+        {
+            *identifier = base | CANBUS_ID_COMPACT_CALL | ((uint32_t)service_id << 16);
+            return CANBUS_COMPACT_CALL_HEADER_LENGTH;
+        }
+    }
+    if ((message_length > 1) && (message_length <= frame_length + 1))
+    {
+        *identifier = base | ((uint32_t)message[0] << 16);
+        return 1;
+    }
+    return 0;
+}
+
+uint8_t canbus_decode_extended(uint32_t identifier, uint8_t *header)
+{
+    if ((identifier & (CANBUS_ID_FIRST | CANBUS_ID_EXTENDED)) != (CANBUS_ID_FIRST | CANBUS_ID_EXTENDED))
+    {
+        return 0;
+    }
+    if (identifier & CANBUS_ID_COMPACT_CALL)
+    {
+        uint16_t service_id = (identifier >> 16) & CANBUS_COMPACT_CALL_MAX_SERVICE_ID;
+        header[0] = CANBUS_COMPACT_CALL_CONTEXT;
+        memcpy(header + 1, &service_id, sizeof(service_id));
+        return CANBUS_COMPACT_CALL_HEADER_LENGTH;
+    }
+    header[0] = (uint8_t)(identifier >> 16);
+    return 1;
+}
+
+#endif
@@ -0,0 +1,129 @@
+/**
+ * @file canbus_frame.h
+ * @author Nicklas Börjesson (<nicklasb at gmail dot com>)
+ * @brief The CAN bus identifier, and the extended single-frame encodings that use its reserved bit
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @copyright 
+ * Copyright (c) 2026, Nicklas Börjesson <nicklasb at gmail dot com>
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, 
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE 
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+#include <robconfig.h>
+#if defined(CONFIG_ROBUSTO_SUPPORTS_CANBUS) || defined(CONFIG_ROBUSTO_NETWORK_MOCK_TESTING)
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <robusto_peer_def.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * The 29-bit identifier:
+ * Bit 28 is set on the first frame of a message.
+ * Bit 27 is set on extended frames, that carry a whole message in one frame and use the packet count for data.
+ * Bits 16-26 hold the number of frames of the message if it is the first frame, and the index of the frame if it is not.
+ * Bits 8-15 hold the source address and bits 0-7 the destination address (we filter on these).
+ *
+ * An extended frame is one of:
+ * - An extra byte: bits 16-23 hold the first byte of the message, which makes room for 9 bytes in one frame,
+ *   for example the context byte and two uint32s.
+ * - A compact service call: bit 26 is set, and bits 16-25 hold the service id of a service call that has only binary data.
+ *   The context byte and the service id are left out of the frame, so it has room for 8 bytes of binary data.
+ */
+#define CANBUS_ID_FIRST (1UL << 28)
+#define CANBUS_ID_EXTENDED (1UL << 27)
+#define CANBUS_ID_COMPACT_CALL (1UL << 26)
+#define CANBUS_ID_COUNT_MASK 0x7FF
+
+/* The data length of a classic CAN frame */
+#define CANBUS_FRAME_LENGTH 8
+
+/* The context byte of a service call with only binary data */
+#define CANBUS_COMPACT_CALL_CONTEXT 0x48
+#define CANBUS_COMPACT_CALL_MAX_SERVICE_ID 0x3FF
+/* The context byte and the service id */
+#define CANBUS_COMPACT_CALL_HEADER_LENGTH 3
+/* The most bytes of a message an extended frame can leave out of its data */
+#define CANBUS_EXTENDED_HEADER_MAX_LENGTH CANBUS_COMPACT_CALL_HEADER_LENGTH
+
+/**
+ * @brief How many bytes of a message (without prefix and CRC) fit in one frame to a peer
+ *
+ * @param protocol_version The protocol version the peer presented
+ * @return uint8_t One more than a frame holds if we and the peer both use extended frames
+ */
+uint8_t canbus_single_frame_length(uint8_t protocol_version);
+
+/**
+ * @brief If a message goes in one frame to a peer, in an extended frame if the peer takes them, like canbus_send_message sends it
+ *
+ * @param peer The peer
+ * @param message The message from the context byte, without prefix and CRC. If NULL, only the length is considered.
+ * @param message_length The length of the message
+ */
+bool canbus_fits_single_frame(robusto_peer_t *peer, const uint8_t *message, uint32_t message_length);
+
+/**
+ * @brief Make the identifier of a normal frame
+ *
+ * @param source The CAN bus address of the sender
+ * @param dest The CAN bus address of the receiver
+ * @param first If it is the first frame of a message
+ * @param count_index The number of frames if it is the first frame, otherwise the index of the frame
+ */
+uint32_t canbus_make_identifier(uint8_t source, uint8_t dest, bool first, uint16_t count_index);
+
+/**
+ * @brief Try to fit a whole message in one extended frame
+ *
+ * @param message The message, beginning with the context byte
+ * @param message_length The length of the message
+ * @param frame_length The data length of a full frame
+ * @param source The CAN bus address of the sender
+ * @param dest The CAN bus address of the receiver
+ * @param identifier Set to the identifier of the frame
+ * @return uint8_t How many bytes from the beginning of the message the identifier carries, the rest is the data of the frame.
+ * 0 if the message does not fit in an extended frame.
+ */
+uint8_t canbus_encode_extended(const uint8_t *message, uint32_t message_length, uint8_t frame_length,
+                               uint8_t source, uint8_t dest, uint32_t *identifier);
+
+/**
+ * @brief Get the beginning of the message that an extended frame carries in its identifier
+ *
+ * @param identifier The identifier of the frame
+ * @param header Set to the beginning of the message, at least CANBUS_EXTENDED_HEADER_MAX_LENGTH bytes
+ * @return uint8_t The number of bytes set, that the data of the frame follows. 0 if it is not an extended frame.
+ */
+uint8_t canbus_decode_extended(uint32_t identifier, uint8_t *header);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif
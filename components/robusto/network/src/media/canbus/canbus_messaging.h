@@ -38,6 +38,7 @@
 #include <robusto_retval.h>
 #include <robusto_message.h>
 #include "canbus_queue.h"
+#include "canbus_reassembly.h"
 
 
 #ifdef CONFIG_ROBUSTO_SIM
@@ -57,7 +58,6 @@ extern "C"
 
 #define CANBUS_MESSAGE_OFFSET (ROBUSTO_CRC_LENGTH + ROBUSTO_PREFIX_BYTES)
 #define CANBUS_TIMEOUT_MS 200
-#define CANBUS_MAX_PACKETS 2048 // Makes the maximum message length 16 384 bytes
 
 /**
  * @brief CAN bus mode setting initialization
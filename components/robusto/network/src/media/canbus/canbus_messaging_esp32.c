@@ -1,6 +1,7 @@
 #include "canbus_messaging.h"
 #ifdef CONFIG_ROBUSTO_SUPPORTS_CANBUS
 #ifdef USE_ESPIDF
+#include "canbus_frame.h"
 
 #include <robusto_retval.h>
 #include <robusto_qos.h>
@@ -15,12 +16,10 @@
 #include <robusto_time.h>
 
 #define CANBUS_ADDR_LEN 1
-#define CANBUS_MAX_IN_FLIGHT 5
-#define ERR_INVALID_PACKAGE_INDEX -0xFFFFFF
-#define ERR_INFLIGHT_NOT_INITIALIZED -0xFFFFFE
-#define ERR_INFLIGHT_NONE_AVAILABLE -1
-#define ERR_INFLIGHT_TOO_MANY_PACKAGES -2
-#define ERR_INFLIGHT_ALLOCATION_FAILED -3
+/* The number of received frames waiting to be read */
+#define CANBUS_RX_FRAMES (CANBUS_MAX_IN_FLIGHT * 2)
+/* Losses are reported at most this often */
+#define CANBUS_DROP_REPORT_INTERVAL_MS 10000
 
 static char *canbus_messaging_log_prefix;
 
@@ -38,26 +37,22 @@ typedef struct canbus_twai_frame
     uint8_t data[TWAI_FRAME_MAX_DLC];
 } canbus_twai_frame_t;
 
-typedef struct in_flight
-{
-    /* The source address of the sender*/
-    uint8_t address;
-    /* The number of frames*/
-    uint16_t count;
-    /* The data received*/
-    uint8_t *data;
-    /* Final length of data, will be 0 until last transmission done*/
-    uint32_t data_length;
-    /* Last updated position*/
-    uint16_t last_package_index;
-    /* This in-flight is taken */
-    bool taken;
-} in_flight_t;
+/* The ISR receives frames straight into this ring and only queues their index, the reader hands them back in the same order */
+static canbus_twai_frame_t canbus_rx_frames[CANBUS_RX_FRAMES];
+/* Frames are received here and dropped if the ring is full, so that the controller is still emptied */
+static canbus_twai_frame_t canbus_rx_overflow;
+/* Only advanced by the ISR */
+static volatile uint32_t canbus_rx_head;
+/* Only advanced by the reader */
+static volatile uint32_t canbus_rx_tail;
+static volatile uint32_t canbus_rx_dropped;
+/* What had been dropped at the last report */
+static uint32_t canbus_reported_rx_dropped;
+static uint32_t canbus_reported_reassembly_dropped;
+static uint32_t canbus_last_drop_report;
 
 void canbus_twai_install();
 
-in_flight_t in_flights[CANBUS_MAX_IN_FLIGHT];
-
 static uint32_t canbus_twai_bitrate(void)
 {
 #ifdef CONFIG_ROBUSTO_CANBUS_BIT_RATE_1MBITS
@@ -92,28 +87,32 @@ static bool canbus_twai_rx_done_cb(twai_node_handle_t handle, const twai_rx_done
     (void)edata;
     QueueHandle_t rx_queue = (QueueHandle_t)user_ctx;
     BaseType_t higher_priority_task_woken = pdFALSE;
-    uint8_t rx_data[TWAI_FRAME_MAX_DLC] = {0};
     twai_frame_t rx_frame = {0};
-    rx_frame.buffer = rx_data;
-    rx_frame.buffer_len = sizeof(rx_data);
 
-    while (twai_node_receive_from_isr(handle, &rx_frame) == ESP_OK)
+    for (;;)
     {
-        canbus_twai_frame_t queue_frame = {0};
-        queue_frame.identifier = rx_frame.header.id;
-        queue_frame.data_length_code = twaifd_dlc2len(rx_frame.header.dlc);
-        if (queue_frame.data_length_code > TWAI_FRAME_MAX_DLC)
+        bool has_room = (rx_queue != NULL) && (canbus_rx_head - canbus_rx_tail < CANBUS_RX_FRAMES);
+        uint8_t frame_index = canbus_rx_head % CANBUS_RX_FRAMES;
+        canbus_twai_frame_t *frame = has_room ? &canbus_rx_frames[frame_index] : &canbus_rx_overflow;
+        rx_frame.buffer = frame->data;
+        rx_frame.buffer_len = sizeof(frame->data);
+        if (twai_node_receive_from_isr(handle, &rx_frame) != ESP_OK)
         {
-            queue_frame.data_length_code = TWAI_FRAME_MAX_DLC;
+            break;
         }
-        memcpy(queue_frame.data, rx_data, queue_frame.data_length_code);
-        if (rx_queue != NULL)
+        if (!has_room)
         {
-            xQueueSendFromISR(rx_queue, &queue_frame, &higher_priority_task_woken);
+            canbus_rx_dropped++;
+            continue;
         }
-        memset(rx_data, 0, sizeof(rx_data));
-        rx_frame.buffer = rx_data;
-        rx_frame.buffer_len = sizeof(rx_data);
+        frame->identifier = rx_frame.header.id;
+        frame->data_length_code = twaifd_dlc2len(rx_frame.header.dlc);
+        if (frame->data_length_code > TWAI_FRAME_MAX_DLC)
+        {
+            frame->data_length_code = TWAI_FRAME_MAX_DLC;
+        }
+        canbus_rx_head++;
+        xQueueSendFromISR(rx_queue, &frame_index, &higher_priority_task_woken);
     }
 
     return higher_priority_task_woken == pdTRUE;
@@ -149,88 +148,6 @@ static esp_err_t canbus_twai_transmit(uint32_t identifier, const uint8_t *data,
     return transmit_result;
 }
 
-/**
- * @brief Start a new in-flight
- *
- * @param address The CAN bus address
- * @param count The current package_index
- * @param data The data to save
- * @param data_length The length of the data
- * @return int If positive, the inflight, if negative, if was the last, if -0xFFFFFF, count out-of-bounds
- */
-int start_in_flight(uint8_t address, uint16_t count, uint8_t *data, uint8_t data_length)
-{
-    // Find a free in-flight
-    for (uint8_t curr_inflight = 0; curr_inflight < CANBUS_MAX_IN_FLIGHT; curr_inflight++)
-    {
-        if (!in_flights[curr_inflight].taken)
-        {
-            in_flights[curr_inflight].taken = true;
-            in_flights[curr_inflight].last_package_index = 0;
-            in_flights[curr_inflight].address = address;
-            if (count > CANBUS_MAX_PACKETS)
-            {
-                ROB_LOGE(canbus_messaging_log_prefix, "CANBUS: Internal error, too many packages indicated.");
-                return ERR_INFLIGHT_TOO_MANY_PACKAGES;
-            }
-
-            in_flights[curr_inflight].count = count;
-            in_flights[curr_inflight].data = robusto_malloc(count * TWAI_FRAME_MAX_DLC);
-            if (!in_flights[curr_inflight].data)
-            {
-                ROB_LOGE(canbus_messaging_log_prefix, "CANBUS: Failed to allocate %i bytes for CAN bus in-flight.", count * TWAI_FRAME_MAX_DLC);
-                return ERR_INFLIGHT_ALLOCATION_FAILED;
-            }
-            memcpy(in_flights[curr_inflight].data, data, data_length);
-            return curr_inflight;
-        }
-    }
-    ROB_LOGE(canbus_messaging_log_prefix, "CANBUS: Failed to find a free in_flight for bytes for CAN bus transmission from address %hu.", address);
-    return ERR_INFLIGHT_NONE_AVAILABLE;
-}
-/**
- * @brief Add data to an in-flight
- *
- * @param address The CAN bus address
- * @param package_index The current package_index
- * @param data The data to save
- * @param data_length The length of the data
- * @return int If positive, the inflight, if negative, if was the last. Also -0xFFFFFF = count out-of-bounds, -0xFFFFFE = Invalid address
- */
-int add_to_in_flight(uint8_t address, uint16_t package_index, uint8_t *data, uint8_t data_length)
-{
-    // Find a free in-flight
-    for (uint8_t curr_inflight = 0; curr_inflight < CANBUS_MAX_IN_FLIGHT; curr_inflight++)
-    {
-        if (in_flights[curr_inflight].address == address)
-        {
-            if (package_index != in_flights[curr_inflight].last_package_index + 1)
-            {
-                ROB_LOGE(canbus_messaging_log_prefix, "CANBUS: Package index from %hu is not the next one. Was %u, should have been %u, invalidating in-flight.",
-                         address, package_index, in_flights[curr_inflight].last_package_index + 1);
-                // We invalidate the package, this should never happen.
-                in_flights[curr_inflight].taken = false;
-                in_flights[curr_inflight].address = 0;
-                
-                return ERR_INVALID_PACKAGE_INDEX;
-            }
-            in_flights[curr_inflight].last_package_index = package_index;
-            memcpy(in_flights[curr_inflight].data + (package_index * TWAI_FRAME_MAX_DLC), data, data_length);
-            if (package_index == in_flights[curr_inflight].count - 1)
-            {
-                ROB_LOGI(canbus_messaging_log_prefix, "CANBUS: We are at the last in flight from %hu.", address);
-                in_flights[curr_inflight].data_length = (package_index * TWAI_FRAME_MAX_DLC) + data_length;
-                return -curr_inflight;
-            }
-            else
-            {
-                return (package_index * TWAI_FRAME_MAX_DLC) + data_length;
-            }
-        }
-    }
-    return ERR_INFLIGHT_NOT_INITIALIZED;
-}
-
 /*     ------------------------------              Outgoing           ----------------------------                                       ------------------------------------------*/
 
 void handle_twai_error(esp_err_t tr_result)
@@ -289,17 +206,17 @@ rob_ret_val_t canbus_send_message(robusto_peer_t *peer, uint8_t *data, uint32_t
     // Stats: The Robusto CAN bus implementation can send up to 16 384 bytes in one message(beyond that, fragmentation must be used).
     // CAN has a 29-bit arbitration/addressing field. Robusto uses this in the following way:
     // 1 bit, that if set indicates if it is the first packet of a transmission
-    // 1 bit is reserved, will probably be used to help use the arbitration field to send an extra byte in one packet, which might be quite useful.
+    // 1 bit, that if set indicates an extended frame, which carries the whole message in one packet (see canbus_frame.h)
     // 11 bits will hold the number of packets of the transmission if it is the first, and the index of the packet if it is not.
+    //    In an extended frame, they instead hold the first byte of the message, or the service id of a service call.
     // 8 bits will hold the destination address byte (we will filter on these bits)
     // 8 bits will hold the source address byte
 
     // As the first bits are more significant for arbitration this means that the first packets alway gets prioritized, which improves throughput with an emphasis on shorter messages.
     // And then, among multipart messages, long messages, or messages that already has gotten far will get prioritized
 
-    // TOOD: There is a possibility to cram one more byte into the address field, which would make it possible to have 9 bytes of data in one packet.
-    // This might be significant for very fast updates as that would enable the context byte + 2 uint32s in one frame, context byte + or a 16 bit serviceid + uint16_t an uint32_t.
-    // If we don't want this, we'll just use that bit to double the possible message length
+    // The extended frames make room for 9 bytes of data in one packet, which is significant for very fast updates as that
+    // enables the context byte + 2 uint32s in one frame, or a service call with a uint32_t and a uint16_t.
 
     if (canbus_twai_node == NULL || !canbus_twai_running)
     {
@@ -331,13 +248,25 @@ rob_ret_val_t canbus_send_message(robusto_peer_t *peer, uint8_t *data, uint32_t
     rob_log_bit_mesh(ROB_LOG_DEBUG, canbus_messaging_log_prefix, offset_data, offset_data_length);
 
     uint32_t identifier = 0;
-    identifier |= number_of_packets << 16;
-    identifier |= get_host_peer()->canbus_address << 8;
-    identifier |= peer->canbus_address;
-    identifier |= 1 << 28;    // Set bit 29, first message
-    identifier &= ~(1 << 27); // Unset bit 28, reserved
-
     uint32_t bytes_sent = 0;
+    if (canbus_single_frame_length(peer->protocol_version) > TWAI_FRAME_MAX_DLC)
+    {
+        // Messages that would need two packets, and compact service calls, can be sent in one extended frame.
+        // The identifier carries the start of the message, so we skip it in the data.
+        uint8_t header_length = canbus_encode_extended(offset_data, offset_data_length, TWAI_FRAME_MAX_DLC,
+                                                       get_host_peer()->canbus_address, peer->canbus_address, &identifier);
+        if ((header_length > 0) && ((number_of_packets > 1) || (header_length > 1)))
+        {
+            ROB_LOGD(canbus_messaging_log_prefix, "Sending extended packet, %hu bytes in the identifier", header_length);
+            bytes_sent = header_length;
+            number_of_packets = 1;
+        }
+    }
+    if (bytes_sent == 0)
+    {
+        identifier = canbus_make_identifier(get_host_peer()->canbus_address, peer->canbus_address, true, number_of_packets);
+    }
+
     uint32_t package_index = 0;
     while (offset_data_length - bytes_sent > TWAI_FRAME_MAX_DLC)
     {
@@ -356,11 +285,8 @@ rob_ret_val_t canbus_send_message(robusto_peer_t *peer, uint8_t *data, uint32_t
             return ROB_FAIL;
         }
         package_index++;
-        identifier = 0;
-        identifier |= package_index << 16;
-        identifier |= get_host_peer()->canbus_address << 8;
-        identifier |= peer->canbus_address;
-        identifier &= ~(1 << 28); // Unset bit 29. Not the first packet from now on. Faster to do than check, probably.
+        // Not the first packet from now on
+        identifier = canbus_make_identifier(get_host_peer()->canbus_address, peer->canbus_address, false, package_index);
         bytes_sent += TWAI_FRAME_MAX_DLC;
     }
 
@@ -388,102 +314,120 @@ rob_ret_val_t canbus_send_message(robusto_peer_t *peer, uint8_t *data, uint32_t
 
 /*     ------------------------------              Incoming           ----------------------------                                       ------------------------------------------*/
 
+/**
+ * @brief Warn if frames were dropped because the receive ring was full, or messages because they were broken off
+ * or there was no free in-flight, since the last report
+ */
+static void canbus_report_drops(void)
+{
+    if (r_millis() - canbus_last_drop_report < CANBUS_DROP_REPORT_INTERVAL_MS)
+    {
+        return;
+    }
+    canbus_reassembly_stats_t stats;
+    canbus_reassembly_get_stats(&stats);
+    uint32_t rx_dropped = canbus_rx_dropped;
+    if ((rx_dropped != canbus_reported_rx_dropped) || (stats.dropped != canbus_reported_reassembly_dropped))
+    {
+        ROB_LOGW(canbus_messaging_log_prefix, "CAN bus dropped %lu frames with a full receive ring and %lu messages in reassembly (totals, %lu messages completed, %lu from the heap).",
+                 rx_dropped, stats.dropped, stats.completed, stats.heap_allocations);
+        canbus_reported_rx_dropped = rx_dropped;
+        canbus_reported_reassembly_dropped = stats.dropped;
+    }
+    canbus_last_drop_report = r_millis();
+}
+
 int canbus_read_data(uint8_t **rcv_data, robusto_peer_t **peer, uint8_t *prefix_bytes)
 {
 
-    // TODO: Treat all data lengths shorter than 8 bytes as single messages. Heart beats would be one variant.
     // TODO: Stop sending and receiving CRC (add parameter to ), it is included in CAN bus and
-    canbus_twai_frame_t message;
+    uint8_t frame_index;
     if (canbus_rx_queue == NULL)
     {
         ROB_LOGE(canbus_messaging_log_prefix, "CAN bus RX queue is not initialized.");
         return ROB_FAIL;
     }
-    if (xQueueReceive(canbus_rx_queue, &message, pdMS_TO_TICKS(CANBUS_TIMEOUT_MS)) != pdTRUE)
+    canbus_report_drops();
+    if (xQueueReceive(canbus_rx_queue, &frame_index, pdMS_TO_TICKS(CANBUS_TIMEOUT_MS)) != pdTRUE)
     {
         ROB_LOGD(canbus_messaging_log_prefix, "Timed out waiting");
         return ROB_FAIL;
     }
-    uint8_t dest = (uint8_t)(message.identifier);
-    if (dest != get_host_peer()->canbus_address)
-    {
-        return ROB_OK;
-    }
-
-    uint8_t source = (uint8_t)(message.identifier >> 8);
+    canbus_twai_frame_t *message = &canbus_rx_frames[frame_index];
+    uint8_t dest = (uint8_t)(message->identifier);
+    uint8_t source = (uint8_t)(message->identifier >> 8);
     /*
     ROB_LOGE(canbus_messaging_log_prefix, "Source: %hu, Dest: %hu", source, dest);
-    ROB_LOGE(canbus_messaging_log_prefix, "Identifier (%" PRIx32 "): ", message.identifier);
-    rob_log_bit_mesh(ROB_LOG_WARN, canbus_messaging_log_prefix, &message.identifier, 4);
-    ROB_LOGE(canbus_messaging_log_prefix, "Data (length: %hu): ", message.data_length_code);
-    rob_log_bit_mesh(ROB_LOG_WARN, canbus_messaging_log_prefix, message.data, message.data_length_code);
+    ROB_LOGE(canbus_messaging_log_prefix, "Identifier (%" PRIx32 "): ", message->identifier);
+    rob_log_bit_mesh(ROB_LOG_WARN, canbus_messaging_log_prefix, &message->identifier, 4);
+    ROB_LOGE(canbus_messaging_log_prefix, "Data (length: %hu): ", message->data_length_code);
+    rob_log_bit_mesh(ROB_LOG_WARN, canbus_messaging_log_prefix, message->data, message->data_length_code);
 */
     uint8_t *data = NULL;
     uint32_t data_length = 0;
-    // How many packets are there? It is a 12-bit value, so move the data 16 bits to the right and zero out bit 12-16.
-    uint16_t packet_count_index = (message.identifier >> 16) & ~(0xF << 12);
-    ROB_LOGD(canbus_messaging_log_prefix, "Parsed packet count %u", packet_count_index);
-    // It is the first package? Is the 29th bit set?
-    bool first_packet = (message.identifier & 1 << 28);
-
-    if (first_packet)
-    {
-        if (packet_count_index > 1)
+    rob_ret_val_t retval = ROB_OK;
+    if (dest == get_host_peer()->canbus_address)
+    {
+        // How many packets are there? It is an 11-bit value, so move the data 16 bits to the right and mask it.
+        uint16_t packet_count_index = (message->identifier >> 16) & CANBUS_ID_COUNT_MASK;
+        ROB_LOGD(canbus_messaging_log_prefix, "Parsed packet count %u", packet_count_index);
+        // It is the first package? Is the 29th bit set?
+        bool first_packet = (message->identifier & CANBUS_ID_FIRST);
+        // An extended frame carries the start of the message in the identifier instead of the count
+        uint8_t header[CANBUS_EXTENDED_HEADER_MAX_LENGTH];
+        uint8_t header_length = canbus_decode_extended(message->identifier, header);
+
+        if (header_length > 0)
         {
-            // if there is more than one packet, add the data to a new in-flight and return
-            int res_start = start_in_flight(source, packet_count_index, message.data, message.data_length_code);
-            if (res_start > 0)
+            data_length = header_length + message->data_length_code;
+            data = robusto_pool_malloc(data_length);
+            if (data == NULL)
             {
-                return ROB_OK;
+                retval = ROB_ERR_OUT_OF_MEMORY;
             }
             else
             {
-                return ROB_FAIL;
+                memcpy(data, header, header_length);
+                memcpy(data + header_length, message->data, message->data_length_code);
             }
         }
-        else
+        else if (first_packet && (packet_count_index > 1))
         {
-            // if not, we move on.
-            // NOTE: We might gain an extra byte by using the package index field if it is a single by using bit 28. Worth it?
-            data_length = message.data_length_code;
-            data = robusto_malloc(data_length);
-            memcpy(data, message.data, data_length);
+            // if there is more than one packet, the message is built in an in-flight of the source
+            retval = canbus_reassembly_start(source, packet_count_index, message->data, message->data_length_code);
         }
-    }
-    else
-    {
-
-        ROB_LOGD(canbus_messaging_log_prefix, "Parsed packet index %u", packet_count_index);
-
-        int res_add = add_to_in_flight(source, packet_count_index, message.data, message.data_length_code);
-        if (res_add == ERR_INVALID_PACKAGE_INDEX)
-        {
-            return ROB_FAIL;
-        }
-        else if (res_add == ERR_INFLIGHT_NOT_INITIALIZED)
-        {
-            return ROB_FAIL;
-        }
-        else if (res_add <= 0) // Neither invalid or unitialized, then it is the reference to the in flight.
+        else if (first_packet)
         {
-            data = robusto_malloc(in_flights[-res_add].data_length);
-            memcpy(data, in_flights[-res_add].data, in_flights[-res_add].data_length);
-
-            robusto_free(in_flights[-res_add].data);
-            in_flights[-res_add].data = NULL;
-            data_length = in_flights[-res_add].data_length;
-            in_flights[-res_add].data_length = 0;
-            in_flights[-res_add].taken = false;
-            ROB_LOGD(canbus_messaging_log_prefix, "Full data (length: %lu): ", data_length);
-            rob_log_bit_mesh(ROB_LOG_DEBUG, canbus_messaging_log_prefix, data, data_length);
-            // We have a full message, continuings. Not that all other cases must return.
+            data_length = message->data_length_code;
+            data = robusto_pool_malloc(data_length);
+            if (data == NULL)
+            {
+                retval = ROB_ERR_OUT_OF_MEMORY;
+            }
+            else
+            {
+                memcpy(data, message->data, data_length);
+            }
         }
         else
         {
-            ROB_LOGD(canbus_messaging_log_prefix, "Data so far from %hu: %i bytes", source, res_add);
-            return ROB_OK;
+            ROB_LOGD(canbus_messaging_log_prefix, "Parsed packet index %u", packet_count_index);
+            // When the last frame is added, the in-flight hands us its buffer
+            retval = canbus_reassembly_add(source, packet_count_index, message->data, message->data_length_code, &data, &data_length);
+            if (data != NULL)
+            {
+                ROB_LOGD(canbus_messaging_log_prefix, "Full data (length: %lu): ", data_length);
+                rob_log_bit_mesh(ROB_LOG_DEBUG, canbus_messaging_log_prefix, data, data_length);
+            }
         }
     }
+    // The frame is copied to where it belongs, the ISR may reuse it
+    canbus_rx_tail++;
+    if (data == NULL)
+    {
+        // Not for us, or not a full message yet
+        return retval == ROB_OK ? ROB_OK : ROB_FAIL;
+    }
 
     *peer = robusto_peers_find_peer_by_canbus_address(source);
     if (*peer == NULL)
@@ -561,6 +505,7 @@ void canbus_compat_messaging_start(void)
     if (canbus_rx_queue != NULL)
     {
         xQueueReset(canbus_rx_queue);
+        canbus_rx_tail = canbus_rx_head;
     }
     esp_err_t ret_start = twai_node_enable(canbus_twai_node);
     if (ret_start == ESP_OK)
@@ -583,7 +528,7 @@ void canbus_twai_install()
     }
     if (canbus_rx_queue == NULL)
     {
-        canbus_rx_queue = xQueueCreate(CANBUS_MAX_IN_FLIGHT * 2, sizeof(canbus_twai_frame_t));
+        canbus_rx_queue = xQueueCreate(CANBUS_RX_FRAMES, sizeof(uint8_t));
         if (canbus_rx_queue == NULL)
         {
             ROB_LOGE(canbus_messaging_log_prefix, "CAN bus failed to allocate RX queue.");
@@ -626,6 +571,7 @@ void canbus_twai_install()
 void canbus_compat_messaging_init(char *_log_prefix)
 {
     canbus_messaging_log_prefix = _log_prefix;
+    canbus_reassembly_init(TWAI_FRAME_MAX_DLC, _log_prefix);
 
     canbus_twai_install();
 };
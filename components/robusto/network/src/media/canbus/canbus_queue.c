@@ -35,6 +35,8 @@
 #include <robusto_sys_queue.h>
 
 #include <robusto_logging.h>
+#include <robusto_message.h>
+#include <robusto_system.h>
 #include <string.h>
 
 // The queue context
@@ -69,8 +71,8 @@ void canbus_cleanup_queue_task(media_queue_item_t *queue_item) {
     if (queue_item != NULL)
     {    
         free(queue_item->peer);
-        free(queue_item->data);
-        free(queue_item);
+        robusto_free_media_queue_item_data(queue_item);
+        robusto_free(queue_item);
     }
     cleanup_queue_task(&canbus_queue_context);
 }
@@ -104,6 +106,10 @@ rob_ret_val_t canbus_init_worker(work_callback work_cb, poll_callback poll_cb, c
     canbus_queue_context.watchdog_timeout = CONFIG_ROB_RECEIPT_TIMEOUT_MS;
     
 
-    return init_work_queue(&canbus_queue_context, _log_prefix, "CAN bus Queue");      
+#ifdef CONFIG_ROBUSTO_QUEUE_RING
+    return init_work_queue_ring(&canbus_queue_context, _log_prefix, "CAN bus Queue", CONFIG_ROBUSTO_QUEUE_RING_CAPACITY);
+#else
+    return init_work_queue(&canbus_queue_context, _log_prefix, "CAN bus Queue");
+#endif
 }
 #endif
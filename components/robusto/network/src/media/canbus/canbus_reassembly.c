@@ -0,0 +1,178 @@
+/**
+ * @file canbus_reassembly.c
+ * @author Nicklas Börjesson (<nicklasb at gmail dot com>)
+ * @brief Reassembly of CAN bus messages that span several frames, in a fixed set of in-flights
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @copyright 
+ * Copyright (c) 2026, Nicklas Börjesson <nicklasb at gmail dot com>
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, 
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE 
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "canbus_reassembly.h"
+#if defined(CONFIG_ROBUSTO_SUPPORTS_CANBUS) || defined(CONFIG_ROBUSTO_NETWORK_MOCK_TESTING)
+
+#include <robusto_system.h>
+#include <robusto_logging.h>
+#include <string.h>
+
+/* The source has no message in flight */
+#define CANBUS_NO_IN_FLIGHT 0xFF
+
+typedef struct in_flight
+{
+    /* The source address of the sender*/
+    uint8_t address;
+    /* The number of frames*/
+    uint16_t count;
+    /* The data received, becomes the message */
+    uint8_t *data;
+    /* Last updated position*/
+    uint16_t last_package_index;
+    /* This in-flight is taken */
+    bool taken;
+} in_flight_t;
+
+static char *canbus_reassembly_log_prefix;
+
+static in_flight_t in_flights[CANBUS_MAX_IN_FLIGHT];
+/* The in-flight of each source address, so that frames find theirs without searching */
+static uint8_t in_flight_by_source[256];
+static uint8_t reassembly_frame_length;
+static canbus_reassembly_stats_t reassembly_stats;
+
+static void release_in_flight(uint8_t curr_inflight)
+{
+    in_flight_t *in_flight = &in_flights[curr_inflight];
+    if (in_flight->data != NULL)
+    {
+        robusto_free(in_flight->data);
+        in_flight->data = NULL;
+    }
+    in_flight_by_source[in_flight->address] = CANBUS_NO_IN_FLIGHT;
+    in_flight->taken = false;
+}
+
+void canbus_reassembly_init(uint8_t frame_length, char *_log_prefix)
+{
+    canbus_reassembly_log_prefix = _log_prefix;
+    for (uint8_t curr_inflight = 0; curr_inflight < CANBUS_MAX_IN_FLIGHT; curr_inflight++)
+    {
+        if (in_flights[curr_inflight].taken)
+        {
+            release_in_flight(curr_inflight);
+        }
+    }
+    memset(in_flight_by_source, CANBUS_NO_IN_FLIGHT, sizeof(in_flight_by_source));
+    memset(&reassembly_stats, 0, sizeof(reassembly_stats));
+    reassembly_frame_length = frame_length;
+}
+
+rob_ret_val_t canbus_reassembly_start(uint8_t source, uint16_t count, const uint8_t *data, uint8_t data_length)
+{
+    if ((count < 2) || (count > CANBUS_MAX_PACKETS) || (data_length != reassembly_frame_length))
+    {
+        ROB_LOGE(canbus_reassembly_log_prefix, "CANBUS: Invalid first frame from %hu, %u frames, %hu bytes.", source, count, data_length);
+        reassembly_stats.dropped++;
+        return ROB_ERR_INVALID_ARG;
+    }
+    if (in_flight_by_source[source] != CANBUS_NO_IN_FLIGHT)
+    {
+        ROB_LOGW(canbus_reassembly_log_prefix, "CANBUS: %hu started over, dropping the message in flight.", source);
+        reassembly_stats.dropped++;
+        release_in_flight(in_flight_by_source[source]);
+    }
+    // Find a free in-flight
+    for (uint8_t curr_inflight = 0; curr_inflight < CANBUS_MAX_IN_FLIGHT; curr_inflight++)
+    {
+        in_flight_t *in_flight = &in_flights[curr_inflight];
+        if (!in_flight->taken)
+        {
+            // The message is built where it will be handled, messages that fit a size class use preallocated memory
+            in_flight->data = robusto_pool_malloc((uint32_t)count * reassembly_frame_length);
+            if (in_flight->data == NULL)
+            {
+                ROB_LOGE(canbus_reassembly_log_prefix, "CANBUS: Failed to allocate %lu bytes for CAN bus in-flight.", (uint32_t)count * reassembly_frame_length);
+                reassembly_stats.dropped++;
+                return ROB_ERR_OUT_OF_MEMORY;
+            }
+            if (robusto_pool_size_of(in_flight->data) == 0)
+            {
+                reassembly_stats.heap_allocations++;
+            }
+            in_flight->taken = true;
+            in_flight->address = source;
+            in_flight->count = count;
+            in_flight->last_package_index = 0;
+            memcpy(in_flight->data, data, data_length);
+            in_flight_by_source[source] = curr_inflight;
+            return ROB_OK;
+        }
+    }
+    ROB_LOGE(canbus_reassembly_log_prefix, "CANBUS: Failed to find a free in_flight for bytes for CAN bus transmission from address %hu.", source);
+    reassembly_stats.dropped++;
+    return ROB_ERR_OUT_OF_MEMORY;
+}
+
+rob_ret_val_t canbus_reassembly_add(uint8_t source, uint16_t index, const uint8_t *data, uint8_t data_length,
+                                    uint8_t **message, uint32_t *message_length)
+{
+    *message = NULL;
+    *message_length = 0;
+    uint8_t curr_inflight = in_flight_by_source[source];
+    if (curr_inflight == CANBUS_NO_IN_FLIGHT)
+    {
+        return ROB_ERR_INVALID_ID;
+    }
+    in_flight_t *in_flight = &in_flights[curr_inflight];
+    bool last = (index == in_flight->count - 1);
+    if ((index != in_flight->last_package_index + 1) || (data_length > reassembly_frame_length) ||
+        (!last && (data_length != reassembly_frame_length)))
+    {
+        ROB_LOGE(canbus_reassembly_log_prefix, "CANBUS: Package index from %hu is not the next one. Was %u, should have been %u, invalidating in-flight.",
+                 source, index, in_flight->last_package_index + 1);
+        // We invalidate the package, this should never happen.
+        reassembly_stats.dropped++;
+        release_in_flight(curr_inflight);
+        return ROB_ERR_PARSING_FAILED;
+    }
+    in_flight->last_package_index = index;
+    memcpy(in_flight->data + ((uint32_t)index * reassembly_frame_length), data, data_length);
+    if (last)
+    {
+        // Hand over the buffer instead of copying it
+        *message = in_flight->data;
+        *message_length = ((uint32_t)index * reassembly_frame_length) + data_length;
+        in_flight->data = NULL;
+        release_in_flight(curr_inflight);
+        reassembly_stats.completed++;
+    }
+    return ROB_OK;
+}
+
+void canbus_reassembly_get_stats(canbus_reassembly_stats_t *stats)
+{
+    *stats = reassembly_stats;
+}
+
+#endif
@@ -0,0 +1,103 @@
+/**
+ * @file canbus_reassembly.h
+ * @author Nicklas Börjesson (<nicklasb at gmail dot com>)
+ * @brief Reassembly of CAN bus messages that span several frames, in a fixed set of in-flights
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @copyright 
+ * Copyright (c) 2026, Nicklas Börjesson <nicklasb at gmail dot com>
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, 
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE 
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+#include <robconfig.h>
+#if defined(CONFIG_ROBUSTO_SUPPORTS_CANBUS) || defined(CONFIG_ROBUSTO_NETWORK_MOCK_TESTING)
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <robusto_retval.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define CANBUS_MAX_PACKETS 2048 // Makes the maximum message length 16 384 bytes
+/* How many senders can have messages in flight at the same time */
+#define CANBUS_MAX_IN_FLIGHT 5
+
+typedef struct canbus_reassembly_stats
+{
+    /* Messages that were completed and handed on */
+    uint32_t completed;
+    /* Messages that were dropped, because they were broken off, out of order or there was no room */
+    uint32_t dropped;
+    /* Messages too large for the memory pools, that had to be allocated from the heap */
+    uint32_t heap_allocations;
+} canbus_reassembly_stats_t;
+
+/**
+ * @brief Initialize the in-flights, dropping any messages in them
+ *
+ * @param frame_length The data length of a full frame, 8 for classic CAN
+ * @param _log_prefix The log prefix
+ */
+void canbus_reassembly_init(uint8_t frame_length, char *_log_prefix);
+
+/**
+ * @brief Start reassembling a message from the first frame.
+ * If the source already has a message in flight, that message is dropped, as the sender has started over.
+ *
+ * @param source The CAN bus address of the sender
+ * @param count The number of frames of the message
+ * @param data The data of the first frame
+ * @param data_length The length of the data, a full frame
+ * @return rob_ret_val_t ROB_OK if started, ROB_ERR_OUT_OF_MEMORY if there is no free in-flight or memory
+ */
+rob_ret_val_t canbus_reassembly_start(uint8_t source, uint16_t count, const uint8_t *data, uint8_t data_length);
+
+/**
+ * @brief Add the next frame to the message in flight from a source
+ *
+ * @param source The CAN bus address of the sender
+ * @param index The index of the frame
+ * @param data The data of the frame
+ * @param data_length The length of the data
+ * @param message If this was the last frame, set to the message, that the caller then owns. Otherwise set to NULL.
+ * @param message_length Set to the length of the message
+ * @return rob_ret_val_t ROB_OK if added, ROB_ERR_INVALID_ID if nothing is in flight from the source,
+ * ROB_ERR_PARSING_FAILED if the frame was not the next one, which drops the message
+ */
+rob_ret_val_t canbus_reassembly_add(uint8_t source, uint16_t index, const uint8_t *data, uint8_t data_length,
+                                    uint8_t **message, uint32_t *message_length);
+
+/**
+ * @brief Get the reassembly statistics
+ */
+void canbus_reassembly_get_stats(canbus_reassembly_stats_t *stats);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif
@@ -35,6 +35,7 @@
 
 #include "espnow_messaging.h"
 #include "espnow_queue.h"
+#include "espnow_transmit.h"
 
 #include <robusto_logging.h>
 #include <robusto_system.h>
@@ -48,23 +49,95 @@
 
 static char *espnow_log_prefix;
 
-#define ESPNOW_FRAGMENT_SIZE (ESP_NOW_MAX_DATA_LEN_V2 - 10)
+// The fragment header, and the fragment CRC when the receiver takes it
+#define ESPNOW_FRAGMENT_SIZE (ESP_NOW_MAX_DATA_LEN_V2 - 10 - 4)
 
 static void espnow_deinit(espnow_send_param_t *send_param);
 
 static volatile bool has_receipt = false;
-static volatile int send_status = -1;
 
-static rob_ret_val_t esp_now_wait_for_send_complete(robusto_peer_t *peer, uint32_t data_length)
+/* How long a send waits for ESP-NOW to have room for the frame */
+#define ESPNOW_TRANSMIT_TIMEOUT_MS 300
+
+/**
+ * @brief Hands a frame to ESP-NOW for the transmit engine
+ * @note Running out of memory is not an error here, the engine waits for outstanding frames and retries.
+ */
+static rob_ret_val_t espnow_radio_send(const uint8_t *mac_address, const uint8_t *data, uint32_t data_length)
 {
-    int32_t wait_time = (data_length / 125) + 30;
-    int32_t start_send = r_millis();
-    while ((send_status < 0) && (r_millis() < start_send + wait_time))
+    int rc = esp_now_send(mac_address, data, data_length);
+    if (rc == ESP_OK)
     {
-        robusto_yield();
+        return ROB_OK;
+    }
+    if (rc == ESP_ERR_ESPNOW_NO_MEM)
+    {
+        return ROB_ERR_OUT_OF_MEMORY;
+    }
+    ROB_LOGE(espnow_log_prefix, "Mac address:");
+    rob_log_bit_mesh(ROB_LOG_INFO, espnow_log_prefix, mac_address, ROBUSTO_MAC_ADDR_LEN);
+    if (rc == ESP_ERR_ESPNOW_NOT_INIT)
+    {
+        ROB_LOGE(espnow_log_prefix, "ESP-NOW error: ESP_ERR_ESPNOW_NOT_INIT");
+    }
+    else if (rc == ESP_ERR_ESPNOW_ARG)
+    {
+        ROB_LOGE(espnow_log_prefix, "ESP-NOW error: ESP_ERR_ESPNOW_ARG");
     }
+    else if (rc == ESP_ERR_ESPNOW_NOT_FOUND)
+    {
+        ROB_LOGE(espnow_log_prefix, "ESP-NOW error: ESP_ERR_ESPNOW_NOT_FOUND");
+    }
+    else if (rc == ESP_ERR_ESPNOW_FULL)
+    {
+        ROB_LOGE(espnow_log_prefix, "ESP-NOW error: ESP_ERR_ESPNOW_FULL");
+    }
+    else if (rc == ESP_ERR_ESPNOW_INTERNAL)
+    {
+        ROB_LOGE(espnow_log_prefix, "ESP-NOW error: ESP_ERR_ESPNOW_INTERNAL");
+    }
+    else if (rc == ESP_ERR_ESPNOW_EXIST)
+    {
+        ROB_LOGE(espnow_log_prefix, "ESP-NOW error: ESP_ERR_ESPNOW_EXIST");
+    }
+    else if (rc == ESP_ERR_ESPNOW_IF)
+    {
+        ROB_LOGE(espnow_log_prefix, "ESP-NOW error: ESP_ERR_ESPNOW_IF");
+    }
+    else
+    {
+        ROB_LOGE(espnow_log_prefix, "ESP-NOW unknown error: %i", rc);
+    }
+    return ROB_ERR_SEND_FAIL;
+}
 
-    if (send_status == ESP_NOW_SEND_FAIL)
+/**
+ * @brief Is called with the outcome of frames that are not waited for
+ */
+static void espnow_frame_done(const uint8_t *mac_address, bool success)
+{
+    if (success)
+    {
+        return;
+    }
+    robusto_peer_t *peer = robusto_peers_find_peer_by_base_mac_address((rob_mac_address *)mac_address);
+    if (peer)
+    {
+        add_to_history(&peer->espnow_info, true, ROB_FAIL);
+    }
+    else
+    {
+        ROB_LOGE_ISR(espnow_log_prefix, "espnow_frame_done() - no peer found matching dest_mac_address.");
+    }
+}
+
+static rob_ret_val_t esp_now_wait_for_send_complete(robusto_peer_t *peer, int ticket, uint32_t data_length)
+{
+    int32_t wait_time = (data_length / 125) + 30;
+    int32_t start_send = r_millis();
+    rob_ret_val_t rc = espnow_transmit_wait(ticket, wait_time);
+
+    if (rc == ROB_FAIL)
     {
         ROB_LOGE(espnow_log_prefix,
                  "ESP-NOW transmission failed completing after %lu ms. Peer: %s Data length: %lu",
@@ -73,7 +146,7 @@ static rob_ret_val_t esp_now_wait_for_send_complete(robusto_peer_t *peer, uint32
                  data_length);
         return ROB_FAIL;
     }
-    if (send_status < 0)
+    if (rc != ROB_OK)
     {
         ROB_LOGE(espnow_log_prefix,
                  "ESP-NOW transmission did not complete within wait time (%lu ms). Peer: %s Data length: %lu",
@@ -96,67 +169,34 @@ rob_ret_val_t esp_now_send_check(robusto_peer_t *peer, uint8_t *data, uint32_t d
     
     ROB_LOGD(espnow_log_prefix, "esp_now_send_check, sending %lu bytes.", data_length);
 
-    send_status = -1;
     has_receipt = false;
 
-    int rc = esp_now_send((uint8_t *)&peer->base_mac_address, data, data_length);
-
-    if (rc != ESP_OK)
+    int ticket = -1;
+    rob_ret_val_t rc = espnow_transmit_send((uint8_t *)&peer->base_mac_address, data, data_length,
+                                           receipt ? &ticket : NULL, ESPNOW_TRANSMIT_TIMEOUT_MS);
+    if (rc != ROB_OK)
     {
-        ROB_LOGE(espnow_log_prefix, "Mac address:");
-        rob_log_bit_mesh(ROB_LOG_INFO, espnow_log_prefix, (uint8_t*)&peer->base_mac_address, ROBUSTO_MAC_ADDR_LEN);
-        if (rc == ESP_ERR_ESPNOW_NOT_INIT)
+        if (rc == ROB_ERR_OUT_OF_MEMORY)
         {
-            ROB_LOGE(espnow_log_prefix, "ESP-NOW error: ESP_ERR_ESPNOW_NOT_INIT");
+            ROB_LOGE(espnow_log_prefix, "ESP-NOW error: ESP_ERR_ESPNOW_NO_MEM - Available memory: %u bytes. Still out of memory after %i ms.",
+                     heap_caps_get_free_size(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT), ESPNOW_TRANSMIT_TIMEOUT_MS);
         }
-        else if (rc == ESP_ERR_ESPNOW_ARG)
+        else if (rc == ROB_ERR_TIMEOUT)
         {
-            ROB_LOGE(espnow_log_prefix, "ESP-NOW error: ESP_ERR_ESPNOW_ARG");
-        }
-        else if (rc == ESP_ERR_ESPNOW_NOT_FOUND)
-        {
-            ROB_LOGE(espnow_log_prefix, "ESP-NOW error: ESP_ERR_ESPNOW_NOT_FOUND");
-        }
-        else if (rc == ESP_ERR_ESPNOW_NO_MEM)
-        {
-            ROB_LOGE(espnow_log_prefix, "ESP-NOW error: ESP_ERR_ESPNOW_NO_MEM - Available memory: %u bytes. Will delay a short while to let it free its memory.", heap_caps_get_free_size(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT));
-            r_delay(300);
-        }
-        else if (rc == ESP_ERR_ESPNOW_FULL)
-        {
-            ROB_LOGE(espnow_log_prefix, "ESP-NOW error: ESP_ERR_ESPNOW_FULL");
-        }
-        else if (rc == ESP_ERR_ESPNOW_INTERNAL)
-        {
-            ROB_LOGE(espnow_log_prefix, "ESP-NOW error: ESP_ERR_ESPNOW_INTERNAL");
-        }
-        else if (rc == ESP_ERR_ESPNOW_EXIST)
-        {
-            ROB_LOGE(espnow_log_prefix, "ESP-NOW error: ESP_ERR_ESPNOW_EXIST");
-        }
-        else if (rc == ESP_ERR_ESPNOW_IF)
-        {
-            ROB_LOGE(espnow_log_prefix, "ESP-NOW error: ESP_ERR_ESPNOW_IF");
-        }
-        else
-        {
-            ROB_LOGE(espnow_log_prefix, "ESP-NOW unknown error: %i", rc);
+            ROB_LOGE(espnow_log_prefix, "ESP-NOW error: No outstanding frame completed within %i ms. Peer: %s",
+                     ESPNOW_TRANSMIT_TIMEOUT_MS, peer->name);
         }
         rc = ROB_ERR_SEND_FAIL;
         add_to_history(&peer->espnow_info, true, rc);
         return rc;
     }
-    else
-    {
-        rc = ROB_OK;
-        add_to_history(&peer->espnow_info, true, rc);
-    }
+    add_to_history(&peer->espnow_info, true, rc);
     if (!receipt)
     {
         return rc;
     }
 
-    rc = esp_now_wait_for_send_complete(peer, data_length);
+    rc = esp_now_wait_for_send_complete(peer, ticket, data_length);
     if (rc != ROB_OK)
     {
         add_to_history(&peer->espnow_info, false, rc);
@@ -176,19 +216,7 @@ rob_ret_val_t esp_now_send_check(robusto_peer_t *peer, uint8_t *data, uint32_t d
     if (has_receipt)
     {
         has_receipt = false;
-
-        rc = (send_status == ESP_NOW_SEND_SUCCESS) ? ROB_OK : ROB_FAIL;
         add_to_history(&peer->espnow_info, false, rc);
-        if (rc == ROB_FAIL)
-        {
-
-            ROB_LOGE(espnow_log_prefix,
-                     "ESP-NOW got a negative receipt. Peer: %s rssi_valid=%u rssi_dbm=%i",
-                     peer->name,
-                     peer->espnow_info.latest_rssi_valid ? 1U : 0U,
-                     (int)peer->espnow_info.latest_rssi_dbm);
-            return ROB_FAIL;
-        }
     }
     else
     {
@@ -203,6 +231,17 @@ rob_ret_val_t esp_now_send_check(robusto_peer_t *peer, uint8_t *data, uint32_t d
     #endif
 }
 
+/**
+ * @brief Sends fragmented messages, where the fragments themselves are not waited for.
+ * The fragmentation acknowledges them selectively, so several can be outstanding at once.
+ */
+static rob_ret_val_t esp_now_send_fragment(robusto_peer_t *peer, uint8_t *data, uint32_t data_length, bool receipt)
+{
+    bool is_fragment = data_length > ROBUSTO_CRC_LENGTH + 1 &&
+                       (data[ROBUSTO_CRC_LENGTH + 1] == FRAG_MESSAGE || data[ROBUSTO_CRC_LENGTH + 1] == FRAG_MESSAGE_ACK_NOW);
+    return esp_now_send_check(peer, data, data_length, receipt && !is_fragment);
+}
+
 /**
  * @brief Is called when ESP-NOW stopped sending to a peer
  *
@@ -219,7 +258,6 @@ void espnow_send_cb(const esp_now_send_info_t *tx_info, esp_now_send_status_t st
         return;
     }
 #endif
-    send_status = status;
     if (status == ESP_NOW_SEND_SUCCESS)
     {
         ROB_LOGD_ISR(espnow_log_prefix, ">> In espnow_send_cb, send success.");
@@ -228,24 +266,16 @@ void espnow_send_cb(const esp_now_send_info_t *tx_info, esp_now_send_status_t st
     if (status == ESP_NOW_SEND_FAIL)
     {
         ROB_LOGW_ISR(espnow_log_prefix,
-                     ">> In espnow_send_cb, send failure, src %02x:%02x:%02x:%02x:%02x:%02x",
-                     tx_info->src_addr[0],
-                     tx_info->src_addr[1],
-                     tx_info->src_addr[2],
-                     tx_info->src_addr[3],
-                     tx_info->src_addr[4],
-                     tx_info->src_addr[5]);
-        robusto_peer_t *peer = robusto_peers_find_peer_by_base_mac_address((rob_mac_address *)tx_info->src_addr);
-        if (peer)
-        {
-            // Yes, this is counted doubly, but this should not happen, we probably have some kind of issue
-            add_to_history(&peer->espnow_info, true, ROB_FAIL);
-        }
-        else
-        {
-            ROB_LOGE_ISR(espnow_log_prefix, "espnow_send_cb() - no peer found matching dest_mac_address.");
-        }
+                     ">> In espnow_send_cb, send failure, dest %02x:%02x:%02x:%02x:%02x:%02x",
+                     tx_info->des_addr[0],
+                     tx_info->des_addr[1],
+                     tx_info->des_addr[2],
+                     tx_info->des_addr[3],
+                     tx_info->des_addr[4],
+                     tx_info->des_addr[5]);
     }
+    // The outcome belongs to the oldest outstanding frame to the destination
+    espnow_transmit_complete(tx_info->des_addr, status == ESP_NOW_SEND_SUCCESS);
 }
 
 static void espnow_recv_cb(const esp_now_recv_info_t *esp_now_info, const uint8_t *data, int len)
@@ -310,9 +340,9 @@ static void espnow_recv_cb(const esp_now_recv_info_t *esp_now_info, const uint8_
     }
     if ((data[ROBUSTO_CRC_LENGTH] & 0b00000111) == MSG_FRAGMENTED)
     {
-        uint8_t *n_data = robusto_malloc(len);
+        uint8_t *n_data = robusto_pool_malloc(len);
         memcpy(n_data, data, len);
-        if (!handle_fragmented(peer, robusto_mt_espnow, n_data, len, ESPNOW_FRAGMENT_SIZE, &esp_now_send_check))
+        if (!handle_fragmented(peer, robusto_mt_espnow, n_data, len, ESPNOW_FRAGMENT_SIZE, &esp_now_send_fragment))
         {
             return;
         }
@@ -342,8 +372,8 @@ static void espnow_recv_cb(const esp_now_recv_info_t *esp_now_info, const uint8_
             uint8_t response[2];
             response[0] = 0xff;
             response[1] = 0x00;
-            // NOTE: We are calling esp_now_send directly here as we are calling it inside of the receive callback
-            if (esp_now_send(&peer->base_mac_address, &response, 2) != ROB_OK) {
+            // NOTE: We are inside of the receive callback, so this does not wait for room
+            if (espnow_transmit_send((uint8_t *)&peer->base_mac_address, response, 2, NULL, 0) != ROB_OK) {
                 ROB_LOGE(espnow_log_prefix, ">> espnow_recv_cb failed to send a receipt to %s.", peer->name);
             }
         }
@@ -351,7 +381,7 @@ static void espnow_recv_cb(const esp_now_recv_info_t *esp_now_info, const uint8_
         if (!handled)
         {
             // Copy data a ESP-NOW frees it
-            uint8_t *n_data = robusto_malloc(len);
+            uint8_t *n_data = robusto_pool_malloc(len);
             memcpy(n_data, data, len);
             add_to_history(&peer->espnow_info, false, robusto_handle_incoming(n_data, len, peer, robusto_mt_espnow, 0));
         }
@@ -375,7 +405,7 @@ rob_ret_val_t esp_now_send_message(robusto_peer_t *peer, uint8_t *data, uint32_t
     if (data_length > (ESP_NOW_MAX_DATA_LEN_V2 - ROBUSTO_PREFIX_BYTES - 10))
     {
         ROB_LOGD(espnow_log_prefix, "Data length %lu is more than cutoff at %i bytes, sending fragmented", data_length, ESP_NOW_MAX_DATA_LEN_V2 - ROBUSTO_PREFIX_BYTES - 10);
-        return send_message_fragmented(peer, robusto_mt_espnow, data + ROBUSTO_PREFIX_BYTES, data_length - ROBUSTO_PREFIX_BYTES, ESPNOW_FRAGMENT_SIZE, &esp_now_send_check);
+        return send_message_fragmented(peer, robusto_mt_espnow, data + ROBUSTO_PREFIX_BYTES, data_length - ROBUSTO_PREFIX_BYTES, ESPNOW_FRAGMENT_SIZE, &esp_now_send_fragment);
     }
 
     has_receipt = false;
@@ -388,6 +418,34 @@ rob_ret_val_t esp_now_send_message(robusto_peer_t *peer, uint8_t *data, uint32_t
     return rc;
 }
 
+/**
+ * @brief Sends a message in segments through ESPNOW, large messages are fragmented directly from the segments.
+ */
+static rob_ret_val_t esp_now_send_message_segments(robusto_peer_t *peer, robusto_message_segments_t *segments, bool receipt)
+{
+    if (segments->length > (ESP_NOW_MAX_DATA_LEN_V2 - ROBUSTO_PREFIX_BYTES - 10))
+    {
+#if CONFIG_ROB_NETWORK_TEST_ESP_NOW_KILL_SWITCH > -1
+        if (robusto_gpio_get_level(CONFIG_ROB_NETWORK_TEST_ESP_NOW_KILL_SWITCH) == true)
+        {
+            ROB_LOGE("ESP-NOW", "ESP-NOW KILL SWITCH ON - Failing sending");
+            r_delay(100);
+            return ROB_FAIL;
+        }
+#endif
+        ROB_LOGD(espnow_log_prefix, "Data length %lu is more than cutoff at %i bytes, sending fragmented", segments->length, ESP_NOW_MAX_DATA_LEN_V2 - ROBUSTO_PREFIX_BYTES - 10);
+        return send_message_fragmented_segments(peer, robusto_mt_espnow, segments, ROBUSTO_PREFIX_BYTES, ESPNOW_FRAGMENT_SIZE, &esp_now_send_fragment);
+    }
+    // It fits in one frame, that ESP-NOW copies anyway
+    uint8_t *data = robusto_message_segments_linearise(segments);
+    if (data == NULL)
+    {
+        return ROB_ERR_OUT_OF_MEMORY;
+    }
+    rob_ret_val_t rc = esp_now_send_message(peer, data, segments->length, receipt);
+    robusto_free(data);
+    return rc;
+}
 
 void espnow_do_on_work_cb(media_queue_item_t *work_item)
 {
@@ -405,7 +463,7 @@ void espnow_do_on_work_cb(media_queue_item_t *work_item)
              queue_context->task_count,
              work_item->peer->espnow_info.latest_rssi_valid ? 1U : 0U,
              (int)work_item->peer->espnow_info.latest_rssi_dbm);
-    send_work_item(work_item, &(work_item->peer->espnow_info), robusto_mt_espnow, &esp_now_send_message, NULL, espnow_get_queue_context());
+    send_work_item_segments(work_item, &(work_item->peer->espnow_info), robusto_mt_espnow, &esp_now_send_message, &esp_now_send_message_segments, NULL, espnow_get_queue_context());
 }
 
 static esp_err_t espnow_init(void)
@@ -440,6 +498,7 @@ void espnow_messaging_init(char *_log_prefix)
 {
     espnow_log_prefix = _log_prefix;
     rob_log_isr_init();
+    espnow_transmit_init(&espnow_radio_send, &espnow_frame_done, _log_prefix);
     espnow_init();
 }
 
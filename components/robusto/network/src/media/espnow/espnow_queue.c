@@ -35,6 +35,7 @@
 #include <robusto_sys_queue.h>
 
 #include <robusto_logging.h>
+#include <robusto_message.h>
 #include <robusto_system.h>
 #include <string.h>
 
@@ -79,10 +80,9 @@ static bool espnow_drop_full_item(void *queued_item)
              item->peer != NULL && item->peer->espnow_info.latest_rssi_valid ? 1U : 0U,
              item->peer != NULL ? (int)item->peer->espnow_info.latest_rssi_dbm : 0);
 
-    robusto_set_queue_state_result(item->state, ROB_ERR_QUEUE_FULL);
+    robusto_set_media_queue_item_result(item, ROB_ERR_QUEUE_FULL);
     if (item->data != NULL) {
-        robusto_free(item->data);
-        item->data = NULL;
+        robusto_free_media_queue_item_data(item);
     }
 
     return true;
@@ -132,8 +132,8 @@ void espnow_cleanup_queue_task(media_queue_item_t *queue_item) {
     if (queue_item != NULL)
     {    
         free(queue_item->peer);
-        free(queue_item->data);
-        free(queue_item);
+        robusto_free_media_queue_item_data(queue_item);
+        robusto_free(queue_item);
     }
     cleanup_queue_task(&espnow_queue_context);
 }
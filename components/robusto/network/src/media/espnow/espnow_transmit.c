@@ -0,0 +1,311 @@
+/**
+ * @file espnow_transmit.c
+ * @author Nicklas Börjesson (<nicklasb at gmail dot com>)
+ * @brief Keeps several ESP-NOW frames outstanding and matches the send callbacks to them
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @copyright 
+ * Copyright (c) 2026, Nicklas Börjesson <nicklasb at gmail dot com>
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, 
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE 
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * A frame has a slot from when it is handed to the radio until the radio reports its outcome.
+ * The radio reports the frames to an address in the order they were sent, so an outcome belongs to
+ * the outstanding frame to that address with the lowest sequence number. Frames are handed to the radio
+ * under a mutex, so that the sequence numbers follow that order. The outcomes are matched without locking,
+ * as they are reported from the Wi-Fi task.
+ *
+ * How many frames may be outstanding is a credit. When the radio runs out of memory, the credit is lowered
+ * to the frames it already has, and the sender waits for one of them to complete instead of sleeping.
+ * Each acknowledged frame raises the credit by one again, up to the number of slots.
+ */
+#include "espnow_transmit.h"
+#if defined(CONFIG_ROBUSTO_SUPPORTS_ESP_NOW) || defined(CONFIG_ROBUSTO_NETWORK_MOCK_TESTING)
+
+#include <robusto_concurrency.h>
+#include <robusto_logging.h>
+#include <robusto_time.h>
+
+#include <stdatomic.h>
+#include <string.h>
+
+/* Frames without an outcome for this long are given up, so that a lost callback does not keep a slot */
+#define ESPNOW_TRANSMIT_STALE_MS 1000
+/* When out of memory with nothing outstanding that could free it, try again after this long */
+#define ESPNOW_TRANSMIT_NO_MEM_RETRY_MS 5
+
+typedef enum
+{
+    SLOT_FREE = 0,
+    SLOT_CLAIMED,
+    SLOT_PENDING,
+    /* Waited for, but the waiter has given up */
+    SLOT_ABANDONED,
+    SLOT_SUCCEEDED,
+    SLOT_FAILED
+} e_transmit_slot_state;
+
+typedef struct transmit_slot
+{
+    _Atomic uint8_t state;
+    bool waited;
+    uint8_t mac_address[ESPNOW_TRANSMIT_MAC_LEN];
+    uint32_t sequence;
+    uint32_t sent_at;
+} transmit_slot_t;
+
+static transmit_slot_t slots[CONFIG_ROBUSTO_ESP_NOW_TX_SLOTS];
+static espnow_transmit_send_cb *send_frame = NULL;
+static espnow_transmit_done_cb *frame_done = NULL;
+static mutex_ref_t send_mutex = NULL;
+static uint32_t next_sequence = 0;
+static _Atomic uint32_t credits = CONFIG_ROBUSTO_ESP_NOW_TX_SLOTS;
+static _Atomic uint32_t outstanding = 0;
+static _Atomic uint32_t completions = 0;
+static _Atomic uint32_t sent_count = 0;
+static _Atomic uint32_t failed_count = 0;
+static _Atomic uint32_t no_mem_count = 0;
+static _Atomic uint32_t max_outstanding = 0;
+
+static char *espnow_transmit_log_prefix;
+
+/* Frees a slot that is outstanding, if it still is in the given state */
+static bool release_outstanding(transmit_slot_t *slot, uint8_t state, uint8_t new_state)
+{
+    if (!atomic_compare_exchange_strong(&slot->state, &state, new_state))
+    {
+        return false;
+    }
+    atomic_fetch_sub(&outstanding, 1);
+    return true;
+}
+
+/* Claims a free slot, giving up outstanding frames that are stale, called with the send mutex */
+static int claim_slot(void)
+{
+    for (int index = 0; index < CONFIG_ROBUSTO_ESP_NOW_TX_SLOTS; index++)
+    {
+        transmit_slot_t *slot = &slots[index];
+        uint8_t state = atomic_load(&slot->state);
+        if ((state == SLOT_PENDING || state == SLOT_ABANDONED) &&
+            (uint32_t)(r_millis() - slot->sent_at) > ESPNOW_TRANSMIT_STALE_MS)
+        {
+            // A waiter still gets an outcome
+            if (release_outstanding(slot, state, state == SLOT_PENDING && slot->waited ? SLOT_FAILED : SLOT_FREE))
+            {
+                atomic_fetch_add(&failed_count, 1);
+            }
+            state = atomic_load(&slot->state);
+        }
+        if (state == SLOT_FREE && atomic_compare_exchange_strong(&slot->state, &state, SLOT_CLAIMED))
+        {
+            return index;
+        }
+    }
+    return -1;
+}
+
+rob_ret_val_t espnow_transmit_send(const uint8_t *mac_address, const uint8_t *data, uint32_t data_length,
+                                   int *ticket, uint32_t timeout_ms)
+{
+    uint32_t start = r_millis();
+
+    if (send_frame == NULL || mac_address == NULL || data == NULL)
+    {
+        return ROB_ERR_INVALID_ARG;
+    }
+    if (robusto_mutex_take(send_mutex, timeout_ms > 0 ? timeout_ms : 1) != ROB_OK)
+    {
+        return ROB_ERR_TIMEOUT;
+    }
+    for (;;)
+    {
+        int index = atomic_load(&outstanding) < atomic_load(&credits) ? claim_slot() : -1;
+        if (index < 0)
+        {
+            if ((uint32_t)(r_millis() - start) >= timeout_ms)
+            {
+                robusto_mutex_give(send_mutex);
+                return ROB_ERR_TIMEOUT;
+            }
+            robusto_yield();
+            continue;
+        }
+        transmit_slot_t *slot = &slots[index];
+        memcpy(slot->mac_address, mac_address, ESPNOW_TRANSMIT_MAC_LEN);
+        slot->waited = ticket != NULL;
+        slot->sequence = next_sequence++;
+        slot->sent_at = r_millis();
+        uint32_t in_flight = atomic_fetch_add(&outstanding, 1) + 1;
+        uint32_t seen_completions = atomic_load(&completions);
+        // Outstanding before it is handed over, as the outcome may be reported before send_frame returns
+        atomic_store(&slot->state, SLOT_PENDING);
+
+        rob_ret_val_t rc = send_frame(mac_address, data, data_length);
+        if (rc == ROB_OK)
+        {
+            atomic_fetch_add(&sent_count, 1);
+            if (in_flight > atomic_load(&max_outstanding))
+            {
+                atomic_store(&max_outstanding, in_flight);
+            }
+            if (ticket != NULL)
+            {
+                *ticket = index;
+            }
+            robusto_mutex_give(send_mutex);
+            return ROB_OK;
+        }
+        // The radio did not take it, so there will be no outcome
+        release_outstanding(slot, SLOT_PENDING, SLOT_FREE);
+        if (rc != ROB_ERR_OUT_OF_MEMORY)
+        {
+            robusto_mutex_give(send_mutex);
+            return rc;
+        }
+        // Only ask for as many as the radio had room for, and wait for one of them instead of sleeping
+        atomic_fetch_add(&no_mem_count, 1);
+        atomic_store(&credits, in_flight > 1 ? in_flight - 1 : 1);
+        ROB_LOGD(espnow_transmit_log_prefix, "ESP-NOW out of memory with %lu outstanding, waiting for one of them.",
+                 (unsigned long)(in_flight - 1));
+        uint32_t failed_at = r_millis();
+        while (atomic_load(&completions) == seen_completions &&
+               !(atomic_load(&outstanding) == 0 && (uint32_t)(r_millis() - failed_at) >= ESPNOW_TRANSMIT_NO_MEM_RETRY_MS))
+        {
+            if ((uint32_t)(r_millis() - start) >= timeout_ms)
+            {
+                robusto_mutex_give(send_mutex);
+                return ROB_ERR_OUT_OF_MEMORY;
+            }
+            robusto_yield();
+        }
+    }
+}
+
+rob_ret_val_t espnow_transmit_wait(int ticket, uint32_t timeout_ms)
+{
+    if (ticket < 0 || ticket >= CONFIG_ROBUSTO_ESP_NOW_TX_SLOTS)
+    {
+        return ROB_ERR_INVALID_ARG;
+    }
+    transmit_slot_t *slot = &slots[ticket];
+    uint32_t start = r_millis();
+    while (atomic_load(&slot->state) == SLOT_PENDING && (uint32_t)(r_millis() - start) < timeout_ms)
+    {
+        robusto_yield();
+    }
+    uint8_t state = SLOT_PENDING;
+    if (atomic_compare_exchange_strong(&slot->state, &state, SLOT_ABANDONED))
+    {
+        // The outcome frees the slot when it comes
+        return ROB_ERR_TIMEOUT;
+    }
+    atomic_store(&slot->state, SLOT_FREE);
+    return state == SLOT_SUCCEEDED ? ROB_OK : ROB_FAIL;
+}
+
+void espnow_transmit_complete(const uint8_t *mac_address, bool success)
+{
+    transmit_slot_t *oldest = NULL;
+    uint8_t oldest_state = SLOT_FREE;
+
+    for (int index = 0; index < CONFIG_ROBUSTO_ESP_NOW_TX_SLOTS; index++)
+    {
+        transmit_slot_t *slot = &slots[index];
+        uint8_t state = atomic_load(&slot->state);
+        if ((state == SLOT_PENDING || state == SLOT_ABANDONED) &&
+            memcmp(slot->mac_address, mac_address, ESPNOW_TRANSMIT_MAC_LEN) == 0 &&
+            (oldest == NULL || (int32_t)(slot->sequence - oldest->sequence) < 0))
+        {
+            oldest = slot;
+            oldest_state = state;
+        }
+    }
+    if (oldest == NULL)
+    {
+        // Given up on as stale
+        return;
+    }
+    bool waited = oldest_state == SLOT_PENDING && oldest->waited;
+    if (!release_outstanding(oldest, oldest_state, waited ? (success ? SLOT_SUCCEEDED : SLOT_FAILED) : SLOT_FREE))
+    {
+        // The waiter gave up just now
+        if (!release_outstanding(oldest, SLOT_ABANDONED, SLOT_FREE))
+        {
+            return;
+        }
+        waited = false;
+    }
+    atomic_fetch_add(&completions, 1);
+    if (success)
+    {
+        uint32_t current = atomic_load(&credits);
+        while (current < CONFIG_ROBUSTO_ESP_NOW_TX_SLOTS &&
+               !atomic_compare_exchange_weak(&credits, &current, current + 1))
+        {
+        }
+    }
+    else
+    {
+        atomic_fetch_add(&failed_count, 1);
+    }
+    if (!waited && frame_done != NULL)
+    {
+        frame_done(mac_address, success);
+    }
+}
+
+void espnow_transmit_get_stats(espnow_transmit_stats_t *stats)
+{
+    stats->sent = atomic_load(&sent_count);
+    stats->failed = atomic_load(&failed_count);
+    stats->no_mem = atomic_load(&no_mem_count);
+    stats->max_outstanding = atomic_load(&max_outstanding);
+    stats->credits = atomic_load(&credits);
+}
+
+void espnow_transmit_init(espnow_transmit_send_cb *send_cb, espnow_transmit_done_cb *done_cb, char *_log_prefix)
+{
+    espnow_transmit_log_prefix = _log_prefix;
+    if (send_mutex == NULL)
+    {
+        send_mutex = robusto_mutex_init();
+    }
+    for (int index = 0; index < CONFIG_ROBUSTO_ESP_NOW_TX_SLOTS; index++)
+    {
+        atomic_store(&slots[index].state, SLOT_FREE);
+    }
+    next_sequence = 0;
+    atomic_store(&credits, CONFIG_ROBUSTO_ESP_NOW_TX_SLOTS);
+    atomic_store(&outstanding, 0);
+    atomic_store(&completions, 0);
+    atomic_store(&sent_count, 0);
+    atomic_store(&failed_count, 0);
+    atomic_store(&no_mem_count, 0);
+    atomic_store(&max_outstanding, 0);
+    send_frame = send_cb;
+    frame_done = done_cb;
+}
+
+#endif
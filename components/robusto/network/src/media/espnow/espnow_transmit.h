@@ -0,0 +1,106 @@
+/**
+ * @file espnow_transmit.h
+ * @author Nicklas Börjesson (<nicklasb at gmail dot com>)
+ * @brief Keeps several ESP-NOW frames outstanding and matches the send callbacks to them
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @copyright 
+ * Copyright (c) 2026, Nicklas Börjesson <nicklasb at gmail dot com>
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, 
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE 
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+#include <robconfig.h>
+#if defined(CONFIG_ROBUSTO_SUPPORTS_ESP_NOW) || defined(CONFIG_ROBUSTO_NETWORK_MOCK_TESTING)
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <robusto_retval.h>
+
+#ifndef CONFIG_ROBUSTO_ESP_NOW_TX_SLOTS
+#define CONFIG_ROBUSTO_ESP_NOW_TX_SLOTS 4
+#endif
+
+#define ESPNOW_TRANSMIT_MAC_LEN 6
+
+/* Hands a frame to the radio, returns ROB_ERR_OUT_OF_MEMORY if it has no room for it right now */
+typedef rob_ret_val_t (espnow_transmit_send_cb)(const uint8_t *mac_address, const uint8_t *data, uint32_t data_length);
+/* Reports the outcome of a frame that nobody waits for */
+typedef void (espnow_transmit_done_cb)(const uint8_t *mac_address, bool success);
+
+typedef struct espnow_transmit_stats
+{
+    /* Frames handed to the radio */
+    uint32_t sent;
+    /* Frames the radio reported as not acknowledged */
+    uint32_t failed;
+    /* Times the radio was out of memory */
+    uint32_t no_mem;
+    /* The most frames that have been outstanding at once */
+    uint32_t max_outstanding;
+    /* How many frames may currently be outstanding */
+    uint32_t credits;
+} espnow_transmit_stats_t;
+
+/**
+ * @brief Initialize the transmit engine
+ *
+ * @param send_cb Hands frames to the radio, esp_now_send() on the ESP32
+ * @param done_cb Called with the outcome of frames that are not waited for, may be NULL
+ * @param _log_prefix
+ */
+void espnow_transmit_init(espnow_transmit_send_cb *send_cb, espnow_transmit_done_cb *done_cb, char *_log_prefix);
+
+/**
+ * @brief Send a frame, while up to CONFIG_ROBUSTO_ESP_NOW_TX_SLOTS others are outstanding
+ * @note Waits for an outstanding frame to complete when there is no credit left, and when
+ * the radio is out of memory, in which case the credits are lowered to what it managed.
+ *
+ * @param mac_address The address to send to
+ * @param data The frame, that the radio copies
+ * @param data_length The length of the frame
+ * @param ticket If set, receives a ticket to wait for the outcome with, otherwise the frame completes on its own
+ * @param timeout_ms How long to wait for credit
+ * @return rob_ret_val_t ROB_OK if handed to the radio, ROB_ERR_TIMEOUT if there was no credit in time
+ */
+rob_ret_val_t espnow_transmit_send(const uint8_t *mac_address, const uint8_t *data, uint32_t data_length,
+                                   int *ticket, uint32_t timeout_ms);
+
+/**
+ * @brief Wait for the outcome of a frame sent with a ticket
+ *
+ * @return rob_ret_val_t ROB_OK if acknowledged, ROB_FAIL if not, ROB_ERR_TIMEOUT if there was no outcome in time
+ */
+rob_ret_val_t espnow_transmit_wait(int ticket, uint32_t timeout_ms);
+
+/**
+ * @brief Report the outcome of the oldest outstanding frame to an address, from the ESP-NOW send callback
+ * @note Does not block or log, the radio reports the frames of an address in the order they were sent.
+ */
+void espnow_transmit_complete(const uint8_t *mac_address, bool success);
+
+/**
+ * @brief Get the statistics of the transmit engine
+ */
+void espnow_transmit_get_stats(espnow_transmit_stats_t *stats);
+
+#endif
@@ -102,7 +102,11 @@ rob_ret_val_t i2c_init_worker(work_callback work_cb, poll_callback poll_cb, char
     i2c_queue_context.multitasking = false;
     i2c_queue_context.watchdog_timeout = 5000;
 
-    return init_work_queue(&i2c_queue_context, _log_prefix, "i2c Queue");      
+#ifdef CONFIG_ROBUSTO_QUEUE_RING
+    return init_work_queue_ring(&i2c_queue_context, _log_prefix, "i2c Queue", CONFIG_ROBUSTO_QUEUE_RING_CAPACITY);
+#else
+    return init_work_queue(&i2c_queue_context, _log_prefix, "i2c Queue");
+#endif
 }
 
 #endif
\ No newline at end of file
@@ -51,6 +51,7 @@
 
 #include "lora_peer.h"
 #include "lora_queue.h"
+#include "lora_schedule.h"
 #include "../radio/RobustoHal.hpp"
 #include "../spi/spi_hal.h"
 #include <RadioLib.h>
@@ -98,13 +99,30 @@ volatile int RXTrigs = 0;
 volatile bool sentFlag = false;
 // disable interrupt when it's not needed
 volatile bool enableInterrupt = true;
+// Given by the DIO interrupt, so that waiting for it blocks instead of polling
+static semaphore_ref_t dio_semaphore = NULL;
 
 int lora_unknown_failures = 0;
 int lora_crc_failures = 0;
 
-#ifdef USE_ESPIDF
-IRAM_ATTR
-#endif
+/* How many frames that arrive while waiting for a receipt are held for the next poll */
+#define LORA_HELD_FRAMES 4
+
+typedef struct lora_held_frame
+{
+    uint8_t *data;
+    int length;
+} lora_held_frame_t;
+
+/* Only used by the LoRa worker */
+static lora_held_frame_t held_frames[LORA_HELD_FRAMES];
+static uint8_t held_first = 0;
+static uint8_t held_count = 0;
+
+/* The time on air and the duty-cycle budget of the radio */
+static lora_schedule_t lora_schedule;
+/* If what is currently sent is important, and may use the reserved part of the budget */
+static bool lora_sending_important = false;
 
 int get_rssi()
 {
@@ -119,6 +137,9 @@ int get_rssi()
     return 0;
 }
 
+#ifdef USE_ESPIDF
+IRAM_ATTR
+#endif
 void setRXFlag(void)
 {
     // check if the interrupt is enabled
@@ -127,6 +148,10 @@ void setRXFlag(void)
         return;
     }
     RXTrigs = RXTrigs + 1;
+    if (dio_semaphore != NULL)
+    {
+        robusto_semaphore_give_from_isr(dio_semaphore);
+    }
 }
 
 #ifdef USE_ESPIDF
@@ -140,6 +165,47 @@ void setTXFlag(void)
         return;
     }
     sentFlag = true;
+    if (dio_semaphore != NULL)
+    {
+        robusto_semaphore_give_from_isr(dio_semaphore);
+    }
+}
+
+/**
+ * @brief Block until the DIO interrupt fires or the time is up, the MCU may sleep meanwhile
+ * @note An interrupt that fired since the flag was checked has already given the semaphore, so it is not missed.
+ */
+static void wait_for_dio(uint32_t timeout_ms)
+{
+    if (dio_semaphore == NULL)
+    {
+        r_delay(1);
+        return;
+    }
+    robusto_semaphore_take(dio_semaphore, timeout_ms);
+}
+
+/**
+ * @brief Hold a frame that arrived while waiting for a receipt, so that it is handled after it
+ */
+static void hold_frame(uint8_t *buf, int length)
+{
+    if (held_count == LORA_HELD_FRAMES)
+    {
+        ROB_LOGW(lora_messaging_log_prefix, "<< LoRa has no room to hold a %i-byte frame, dropping it.", length);
+        return;
+    }
+    uint8_t *data = (uint8_t *)robusto_malloc(length);
+    if (data == NULL)
+    {
+        ROB_LOGE(lora_messaging_log_prefix, "<< LoRa could not allocate %i bytes to hold a frame.", length);
+        return;
+    }
+    memcpy(data, buf, length);
+    lora_held_frame_t *frame = &held_frames[(held_first + held_count) % LORA_HELD_FRAMES];
+    frame->data = data;
+    frame->length = length;
+    held_count++;
 }
 
 rob_ret_val_t startReceive()
@@ -195,10 +261,10 @@ rob_ret_val_t send_message(uint8_t *data, int message_len)
     int curr_wait = 0;
     while ((sentFlag == false) && (curr_wait < 6000))
     {
+        wait_for_dio(6000 - curr_wait);
         curr_wait = r_millis() - starttime;
-        robusto_yield();
     }
-    if (curr_wait > 6000)
+    if (sentFlag == false)
     {
         ROB_LOGE(lora_messaging_log_prefix, ">> LoRa timed out sending, waited 6000 ms.");
         return ROB_ERR_TIMEOUT;
@@ -263,6 +329,26 @@ rob_ret_val_t lora_send_message(robusto_peer_t *peer, uint8_t *data, uint32_t da
 
     // TODO: Make some way of handling longer messages
 
+    {
+        // Regional regulations limit how much of the time the radio may transmit
+        uint32_t airtime_ms = lora_schedule_time_on_air_ms(&lora_schedule, data_length - data_offset);
+        uint32_t wait_ms = 0;
+        rob_ret_val_t admitted = lora_schedule_admit(&lora_schedule, airtime_ms, lora_sending_important, r_millis(), &wait_ms);
+        if ((admitted == ROB_ERR_NOT_READY) && (wait_ms <= CONFIG_ROBUSTO_LORA_DUTY_CYCLE_MAX_WAIT_MS))
+        {
+            ROB_LOGI(lora_messaging_log_prefix, ">> Waiting %" PRIu32 " ms for duty-cycle budget for %" PRIu32 " ms of airtime.", wait_ms, airtime_ms);
+            r_delay(wait_ms);
+            admitted = lora_schedule_admit(&lora_schedule, airtime_ms, lora_sending_important, r_millis(), &wait_ms);
+        }
+        if (admitted != ROB_OK)
+        {
+            ROB_LOGW(lora_messaging_log_prefix, ">> Not sending, %" PRIu32 " ms of airtime is not within the duty-cycle budget (%" PRIu32 " ms left, important: %s).",
+                     airtime_ms, lora_schedule_budget_ms(&lora_schedule, r_millis()), lora_sending_important ? "true" : "false");
+            retval = admitted;
+            goto finish;
+        }
+    }
+
     tx_count++;
 
     ROB_LOGI(lora_messaging_log_prefix, ">> Sending message: \"%.*s\", data is %lu, total %lu bytes...", (int)(data_length - 4), data + 4, data_length - data_offset, data_length);
@@ -291,23 +377,16 @@ rob_ret_val_t lora_send_message(robusto_peer_t *peer, uint8_t *data, uint32_t da
 
     // TODO: Add a check for the CRC response
     starttime = r_millis();
-    do
+    while (r_millis() - starttime < CONFIG_ROB_RECEIPT_TIMEOUT_MS)
     {
-
-        while (RXTrigs == 0)
+        if (RXTrigs == 0)
         {
-            if (r_millis() > starttime + CONFIG_ROB_RECEIPT_TIMEOUT_MS) 
-            {
-                ROB_LOGE(lora_messaging_log_prefix, "<< LoRa timed out waiting for receipt from %s.", peer->name);
-                r_delay(1);
-                peer->lora_info.receive_failures++;
-                retval = ROB_FAIL;
-                goto finish;
-            }
-            r_delay(1);
+            uint32_t waited = r_millis() - starttime;
+            wait_for_dio(waited < CONFIG_ROB_RECEIPT_TIMEOUT_MS ? CONFIG_ROB_RECEIPT_TIMEOUT_MS - waited : 1);
+            continue;
         }
         RXTrigs = 0;
-        /* TODO: Here, the data we got should be put on a receive queue.
+        /* Other frames that arrive meanwhile are held, and handled by the poll after the receipt.
          * Perhaps sending receipts are another "thing"? Sure they should be fast, and they should not have to wait for receiver processing.
          * Especially not when it is about chaining several messages of course, though that perhaps could be another model for that where the receiver gradually can get data.
          * Or there is no point in chaining messages if the receiver wants that..could a receiver say something about what it wants on lower levels or is this up to applications?
@@ -348,7 +427,7 @@ rob_ret_val_t lora_send_message(robusto_peer_t *peer, uint8_t *data, uint32_t da
                 retval = ROB_OK;
                 goto finish;
             }
-            else if (buf[4] == 0xff && buf[4] == 0x00)
+            else if (buf[4] == 0x00 && buf[5] == 0xff)
             {
                 ROB_LOGW(lora_messaging_log_prefix, "<< LoRa bad CRC message from %s.", peer->name);
                 peer->lora_info.send_failures++;
@@ -367,11 +446,11 @@ rob_ret_val_t lora_send_message(robusto_peer_t *peer, uint8_t *data, uint32_t da
         }
         else if (message_length > 0)
         {
-            ROB_LOGW(lora_messaging_log_prefix, "<< LoRa got a %i-byte message to someone else (not %" PRIu32 ", will keep waiting for a response):", message_length, peer->relation_id_outgoing);
-            rob_log_bit_mesh(ROB_LOG_INFO, lora_messaging_log_prefix, (uint8_t *)buf, message_length);
+            ROB_LOGI(lora_messaging_log_prefix, "<< LoRa got a %i-byte frame that is not the receipt (not %" PRIu32 "), holding it and waiting for the receipt.", message_length, peer->relation_id_outgoing);
+            rob_log_bit_mesh(ROB_LOG_DEBUG, lora_messaging_log_prefix, (uint8_t *)buf, message_length);
+            hold_frame(buf, message_length);
         }
-        robusto_yield();
-    } while (r_millis() < starttime + (CONFIG_ROB_RECEIPT_TIMEOUT_MS));
+    }
     ROB_LOGE(lora_messaging_log_prefix, "<< LoRa timed out waiting for a receipt from %s.", peer->name);
 
     peer->lora_info.receive_failures++;
@@ -390,16 +469,26 @@ finish:
 int lora_read_data(uint8_t **rcv_data_out, robusto_peer_t **peer_out, uint8_t *prefix_bytes)
 {
     int retval = ROB_FAIL;
-    if (RXTrigs > 0)
+    uint8_t *data = NULL;
+    int message_length = 0;
+    if (held_count > 0)
+    {
+        // Held while waiting for a receipt, these are older than anything the radio has now
+        data = held_frames[held_first].data;
+        message_length = held_frames[held_first].length;
+        held_first = (held_first + 1) % LORA_HELD_FRAMES;
+        held_count--;
+        ROB_LOGD(lora_messaging_log_prefix, "<< Handling a %i-byte frame held while waiting for a receipt.", message_length);
+    }
+    else if (RXTrigs > 0)
     {
         int currRXTrigs = RXTrigs;
         RXTrigs = 0;
         ROB_LOGD(lora_messaging_log_prefix, "<< Current RXTRigs: %i", currRXTrigs);
 
-        uint8_t *data = (uint8_t *)robusto_malloc(255);
+        data = (uint8_t *)robusto_malloc(255);
 
         ROB_LOGD(lora_messaging_log_prefix, "<< Data pointer address: %lu", (uint32_t)data);
-        int message_length = 0;
     
         int state = radio.readData(data, 0);
         ROB_LOGD(lora_messaging_log_prefix, "<< After read data");
@@ -421,7 +510,9 @@ int lora_read_data(uint8_t **rcv_data_out, robusto_peer_t **peer_out, uint8_t *p
             // some other error occurred
             ROB_LOGW(lora_messaging_log_prefix, " << Lora failed, code %hhu", state);
         }
-
+    }
+    if (data != NULL)
+    {
         if (message_length > 0)
         {
             ROB_LOGI(lora_messaging_log_prefix, "<< In LoRa lora_read_data;lora_received %i bytes.", message_length);
@@ -539,6 +630,8 @@ int lora_read_data(uint8_t **rcv_data_out, robusto_peer_t **peer_out, uint8_t *p
 
                 rob_log_bit_mesh(ROB_LOG_INFO, lora_messaging_log_prefix, (uint8_t *)&response, 6);
 
+                // Receipts cannot wait for the budget, the sender is waiting for them
+                lora_schedule_charge(&lora_schedule, lora_schedule_time_on_air_ms(&lora_schedule, 6), r_millis());
                 if (send_message((uint8_t *)&response, 6) != ROB_OK)
                 {
                     ROB_LOGE(lora_messaging_log_prefix, ">> LoRa failed started sending receipt.");
@@ -570,6 +663,14 @@ int lora_read_data(uint8_t **rcv_data_out, robusto_peer_t **peer_out, uint8_t *p
             ROB_LOGW(lora_messaging_log_prefix, "<< LoRa :We have no peer recognition and retval %i.", retval);
             retval = ROB_INFO_RECV_NO_MESSAGE;
             robusto_free(data);
+        } else if ((retval > 0) && (message_length > data_start + ROBUSTO_CRC_LENGTH) && ((data[data_start + ROBUSTO_CRC_LENGTH] & 0x07) == MSG_BATCH)) {
+            // The receipt has been sent for the whole batch, now handle its messages one by one
+            rob_ret_val_t batch_retval = lora_batch_handle(data + data_start, message_length - data_start, peer, &robusto_handle_incoming);
+            if (batch_retval == ROB_ERR_OUT_OF_MEMORY) {
+                ROB_LOGE(lora_messaging_log_prefix, "<< Failed allocating the messages of a batch.");
+            }
+            add_to_history(&peer->lora_info, false, batch_retval);
+            robusto_free(data);
         } else {
 
             // TODO: Should this thing also work without a queue?
@@ -712,6 +813,11 @@ if (crcret != RADIOLIB_ERR_NONE) {
     ROB_LOGI(lora_messaging_log_prefix, "LoRa disabling CRC failed %i.", crcret);
 }
 */
+    lora_schedule_init(&lora_schedule, sf, (uint32_t)(bw * 1000), cr, 8 /* RadioLib default preamble */,
+                       CONFIG_ROBUSTO_LORA_DUTY_CYCLE_PERMILLE, CONFIG_ROBUSTO_LORA_DUTY_CYCLE_WINDOW_S,
+                       CONFIG_ROBUSTO_LORA_DUTY_CYCLE_RESERVE_PERCENT, r_millis());
+    ROB_LOGI(lora_messaging_log_prefix, "LoRa duty cycle %u permille, a 10-byte frame is %" PRIu32 " ms on air.",
+             CONFIG_ROBUSTO_LORA_DUTY_CYCLE_PERMILLE, lora_schedule_time_on_air_ms(&lora_schedule, 10));
 #if defined(USE_ESPIDF) && defined(CONFIG_LORA_SX127X)
     gpio_install_isr_service(0);
     ROB_LOGI(lora_messaging_log_prefix, "gpio_install_isr_service done");
@@ -729,12 +835,125 @@ void lora_do_on_poll_cb(queue_context_t *q_context)
     lora_read_data(&rcv_data, &peer, &prefix_bytes);
 }
 
+static void lora_send_item(media_queue_item_t *queue_item)
+{
+    lora_sending_important = queue_item->important;
+    send_work_item(queue_item, &(queue_item->peer->lora_info), robusto_mt_lora, &lora_send_message, &lora_do_on_poll_cb, lora_get_queue_context());
+}
+
+#ifdef CONFIG_ROBUSTO_LORA_BATCHING
+static lora_batch_t lora_batch;
+static media_queue_item_t *lora_batch_items[LORA_BATCH_MAX_MESSAGES];
+
+/**
+ * @brief Small messages that want a receipt over an established relation may share a frame,
+ * if the peer presented a protocol version that understands batches
+ */
+static bool lora_is_batchable(media_queue_item_t *queue_item)
+{
+    robusto_peer_t *peer = queue_item->peer;
+    if (!queue_item->receipt || (queue_item->queue_item_type != media_qit_normal) ||
+        (peer->protocol_version < ROBUSTO_PROTOCOL_VERSION_LORA_BATCH) ||
+        (peer->state == PEER_UNKNOWN) || (peer->state == PEER_PRESENTING) ||
+        (peer->lora_info.state == media_state_recovering))
+    {
+        return false;
+    }
+    if ((queue_item->data == NULL) && (queue_item->segments != NULL))
+    {
+        queue_item->data = robusto_message_segments_linearise(queue_item->segments);
+    }
+    // Larger messages leave too little room for others to be worth it
+    return (queue_item->data != NULL) && (queue_item->data_length > ROBUSTO_PREFIX_BYTES) &&
+           (queue_item->data_length - ROBUSTO_PREFIX_BYTES < (LORA_BATCH_MAX_LENGTH - LORA_BATCH_HEADER_LENGTH) / 2);
+}
+
+/**
+ * @brief Send an item together with the small messages to the same peer that are queued after it, with one receipt
+ *
+ * @return media_queue_item_t* An item that was taken from the queue but could not be added, to be sent next
+ */
+static media_queue_item_t *lora_send_batch(media_queue_item_t *queue_item)
+{
+    robusto_peer_t *peer = queue_item->peer;
+    lora_batch_start(&lora_batch);
+    lora_batch_add(&lora_batch, queue_item->data + ROBUSTO_PREFIX_BYTES, queue_item->data_length - ROBUSTO_PREFIX_BYTES);
+    lora_batch_items[0] = queue_item;
+    uint8_t count = 1;
+    bool important = queue_item->important;
+    media_queue_item_t *next_item = NULL;
+    // Only what is already queued is batched, nothing waits for more to arrive
+    while ((count < LORA_BATCH_MAX_MESSAGES) && ((next_item = lora_take_queue_item()) != NULL))
+    {
+        if ((next_item->peer != peer) || !lora_is_batchable(next_item) ||
+            !lora_batch_add(&lora_batch, next_item->data + ROBUSTO_PREFIX_BYTES, next_item->data_length - ROBUSTO_PREFIX_BYTES))
+        {
+            break;
+        }
+        lora_batch_items[count++] = next_item;
+        important = important || next_item->important;
+        next_item = NULL;
+    }
+    if (count == 1)
+    {
+        lora_send_item(queue_item);
+        return next_item;
+    }
+
+    ROB_LOGI(lora_messaging_log_prefix, ">> Sending %hhu messages to %s in one %hu-byte batch.", count, peer->name, lora_batch.length);
+    uint32_t data_length;
+    uint8_t *data = lora_batch_finish(&lora_batch, &data_length);
+    for (uint8_t i = 0; i < count; i++)
+    {
+        robusto_set_queue_state_running(lora_batch_items[i]->state);
+    }
+    lora_sending_important = important;
+    rob_ret_val_t retval = lora_send_message(peer, data, data_length, true);
+    add_to_history(&peer->lora_info, true, retval);
+    for (uint8_t i = 0; i < count; i++)
+    {
+        if (retval == ROB_OK)
+        {
+            robusto_set_media_queue_item_result(lora_batch_items[i], ROB_OK);
+            robusto_free_media_queue_item_data(lora_batch_items[i]);
+            robusto_free(lora_batch_items[i]);
+        }
+        else
+        {
+            // Retried one by one, which also moves them to other medias if LoRa keeps failing.
+            // If it was only the receipt that was lost, the peer gets the messages twice, like when the receipt of a single message is lost.
+            lora_send_item(lora_batch_items[i]);
+        }
+    }
+    return next_item;
+}
+#endif
+
 void lora_do_on_work_cb(media_queue_item_t *queue_item)
 {
     ROB_LOGD(lora_messaging_log_prefix, ">> In LoRa work callback.");
-    send_work_item(queue_item, &(queue_item->peer->lora_info), robusto_mt_lora, &lora_send_message, &lora_do_on_poll_cb,lora_get_queue_context());
-    
-    lora_do_on_poll_cb(lora_get_queue_context());
+#ifdef CONFIG_ROBUSTO_LORA_BATCHING
+    while (queue_item != NULL)
+    {
+        if (lora_is_batchable(queue_item))
+        {
+            queue_item = lora_send_batch(queue_item);
+        }
+        else
+        {
+            lora_send_item(queue_item);
+            queue_item = NULL;
+        }
+    }
+#else
+    lora_send_item(queue_item);
+#endif
+
+    // Frames held while waiting for the receipt are waiting for their own receipts
+    do
+    {
+        lora_do_on_poll_cb(lora_get_queue_context());
+    } while (held_count > 0);
 }
 
 
@@ -742,6 +961,7 @@ void lora_do_on_work_cb(media_queue_item_t *queue_item)
 void lora_messaging_init(char *_log_prefix)
 {
     lora_messaging_log_prefix = _log_prefix;
+    dio_semaphore = robusto_semaphore_init();
 
 }
 
@@ -38,6 +38,8 @@
 #include <robusto_sys_queue.h>
 
 #include <robusto_logging.h>
+#include <robusto_message.h>
+#include <robusto_system.h>
 #include <string.h>
 
 // The queue context
@@ -72,12 +74,16 @@ void lora_cleanup_queue_task(media_queue_item_t *queue_item) {
     if (queue_item != NULL)
     {    
         free(queue_item->peer);
-        free(queue_item->data);
-        free(queue_item);
+        robusto_free_media_queue_item_data(queue_item);
+        robusto_free(queue_item);
     }
     cleanup_queue_task(&lora_queue_context);
 }
 
+media_queue_item_t *lora_take_queue_item() {
+    return (media_queue_item_t *)safe_get_head_work_item(&lora_queue_context);
+}
+
 void lora_set_queue_blocked(bool blocked) {
     set_queue_blocked(&lora_queue_context,blocked);
 }
@@ -107,6 +113,10 @@ rob_ret_val_t lora_init_worker(work_callback work_cb, poll_callback poll_cb, cha
     lora_queue_context.watchdog_timeout = CONFIG_ROB_RECEIPT_TIMEOUT_MS;
     
 
-    return init_work_queue(&lora_queue_context, _log_prefix, "LoRa Queue");      
+#ifdef CONFIG_ROBUSTO_QUEUE_RING
+    return init_work_queue_ring(&lora_queue_context, _log_prefix, "LoRa Queue", CONFIG_ROBUSTO_QUEUE_RING_CAPACITY);
+#else
+    return init_work_queue(&lora_queue_context, _log_prefix, "LoRa Queue");
+#endif
 }
 #endif
@@ -59,6 +59,12 @@ void lora_set_queue_blocked(bool blocked);
 queue_context_t *lora_get_queue_context();
 void lora_shutdown_worker();
 void lora_cleanup_queue_task(media_queue_item_t *queue_item);
+/**
+ * @brief Take the next item from the LoRa queue, so that the work callback can send it together with the current one
+ * 
+ * @return media_queue_item_t* The item, NULL if the queue is empty
+ */
+media_queue_item_t *lora_take_queue_item();
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
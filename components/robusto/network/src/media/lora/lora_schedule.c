@@ -0,0 +1,224 @@
+/**
+ * @file lora_schedule.c
+ * @author Nicklas Börjesson (<nicklasb at gmail dot com>)
+ * @brief LoRa time-on-air, duty-cycle budget and batching of small messages into one packet
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @copyright 
+ * Copyright (c) 2026, Nicklas Börjesson <nicklasb at gmail dot com>
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, 
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE 
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "lora_schedule.h"
+#if defined(CONFIG_ROBUSTO_SUPPORTS_LORA) || defined(CONFIG_ROBUSTO_NETWORK_MOCK_TESTING)
+
+#include <robusto_crc32.h>
+#include <string.h>
+
+/* Symbols longer than this need the low data rate optimization */
+#define LORA_LOW_DATA_RATE_SYMBOL_NS 16000000ULL
+
+void lora_schedule_init(lora_schedule_t *schedule, uint8_t spreading_factor, uint32_t bandwidth_hz, uint8_t coding_rate,
+                        uint16_t preamble_length, uint16_t duty_cycle_permille, uint32_t window_s, uint8_t reserve_percent,
+                        uint32_t now_ms)
+{
+    schedule->spreading_factor = spreading_factor;
+    schedule->bandwidth_hz = bandwidth_hz;
+    schedule->coding_rate = coding_rate;
+    schedule->preamble_length = preamble_length;
+    schedule->duty_cycle_permille = duty_cycle_permille;
+    // The budget is kept in thousandths of milliseconds of airtime, so that each millisecond refills it with the permille
+    schedule->budget_capacity = (uint64_t)window_s * 1000 * duty_cycle_permille;
+    schedule->budget_reserve = schedule->budget_capacity * reserve_percent / 100;
+    schedule->budget = schedule->budget_capacity;
+    schedule->budget_updated_ms = now_ms;
+    schedule->airtime_ms = 0;
+    schedule->deferred = 0;
+}
+
+uint32_t lora_schedule_time_on_air_ms(const lora_schedule_t *schedule, uint16_t payload_length)
+{
+    if (schedule->bandwidth_hz == 0)
+    {
+        // Not initialized
+        return 0;
+    }
+    // See the Semtech SX1276 datasheet, 4.1.1.7. Explicit header and CRC on.
+    uint64_t symbol_ns = ((uint64_t)1000000000 << schedule->spreading_factor) / schedule->bandwidth_hz;
+    int32_t low_data_rate = symbol_ns >= LORA_LOW_DATA_RATE_SYMBOL_NS ? 1 : 0;
+    int32_t numerator = 8 * payload_length - 4 * schedule->spreading_factor + 28 + 16;
+    int32_t denominator = 4 * (schedule->spreading_factor - 2 * low_data_rate);
+    uint32_t payload_symbols = 8;
+    if (numerator > 0)
+    {
+        payload_symbols += ((numerator + denominator - 1) / denominator) * schedule->coding_rate;
+    }
+    // The preamble is followed by 4.25 symbols of sync word
+    uint64_t airtime_ns = ((4 * (uint64_t)schedule->preamble_length + 17) * symbol_ns) / 4 + payload_symbols * symbol_ns;
+    return (uint32_t)((airtime_ns + 999999) / 1000000);
+}
+
+static void refill(lora_schedule_t *schedule, uint32_t now_ms)
+{
+    uint32_t elapsed_ms = now_ms - schedule->budget_updated_ms;
+    schedule->budget_updated_ms = now_ms;
+    uint64_t refill = (uint64_t)elapsed_ms * schedule->duty_cycle_permille;
+    schedule->budget = (schedule->budget_capacity - schedule->budget) > refill ? schedule->budget + refill : schedule->budget_capacity;
+}
+
+rob_ret_val_t lora_schedule_admit(lora_schedule_t *schedule, uint32_t airtime_ms, bool important, uint32_t now_ms, uint32_t *wait_ms)
+{
+    *wait_ms = 0;
+    if (schedule->duty_cycle_permille >= 1000)
+    {
+        // Not limited
+        schedule->airtime_ms += airtime_ms;
+        return ROB_OK;
+    }
+    refill(schedule, now_ms);
+    uint64_t cost = (uint64_t)airtime_ms * 1000;
+    uint64_t needed = important ? cost : cost + schedule->budget_reserve;
+    if (needed > schedule->budget_capacity)
+    {
+        return ROB_ERR_MESSAGE_TOO_LONG;
+    }
+    if (schedule->budget < needed)
+    {
+        *wait_ms = (uint32_t)((needed - schedule->budget + schedule->duty_cycle_permille - 1) / schedule->duty_cycle_permille);
+        schedule->deferred++;
+        return ROB_ERR_NOT_READY;
+    }
+    schedule->budget -= cost;
+    schedule->airtime_ms += airtime_ms;
+    return ROB_OK;
+}
+
+void lora_schedule_charge(lora_schedule_t *schedule, uint32_t airtime_ms, uint32_t now_ms)
+{
+    schedule->airtime_ms += airtime_ms;
+    if (schedule->duty_cycle_permille >= 1000)
+    {
+        return;
+    }
+    refill(schedule, now_ms);
+    uint64_t cost = (uint64_t)airtime_ms * 1000;
+    schedule->budget = schedule->budget > cost ? schedule->budget - cost : 0;
+}
+
+uint32_t lora_schedule_budget_ms(lora_schedule_t *schedule, uint32_t now_ms)
+{
+    if (schedule->duty_cycle_permille >= 1000)
+    {
+        return UINT32_MAX;
+    }
+    refill(schedule, now_ms);
+    return (uint32_t)(schedule->budget / 1000);
+}
+
+void lora_batch_start(lora_batch_t *batch)
+{
+    batch->data[ROBUSTO_PREFIX_BYTES + ROBUSTO_CRC_LENGTH] = MSG_BATCH;
+    batch->length = LORA_BATCH_HEADER_LENGTH;
+    batch->count = 0;
+}
+
+bool lora_batch_fits(const lora_batch_t *batch, uint32_t message_length)
+{
+    // Each message is preceded by a length byte
+    return (message_length > 0) && (batch->length + 1 + message_length <= LORA_BATCH_MAX_LENGTH) && (batch->count < UINT8_MAX);
+}
+
+bool lora_batch_add(lora_batch_t *batch, const uint8_t *message, uint32_t message_length)
+{
+    if (!lora_batch_fits(batch, message_length))
+    {
+        return false;
+    }
+    uint8_t *dest = batch->data + ROBUSTO_PREFIX_BYTES + batch->length;
+    dest[0] = (uint8_t)message_length;
+    memcpy(dest + 1, message, message_length);
+    batch->length += 1 + message_length;
+    batch->count++;
+    return true;
+}
+
+uint8_t *lora_batch_finish(lora_batch_t *batch, uint32_t *data_length)
+{
+    uint8_t *batch_start = batch->data + ROBUSTO_PREFIX_BYTES;
+    batch_start[ROBUSTO_CRC_LENGTH + ROBUSTO_CONTEXT_BYTE_LEN] = batch->count;
+    uint32_t crc = robusto_crc32(0, batch_start + ROBUSTO_CRC_LENGTH, batch->length - ROBUSTO_CRC_LENGTH);
+    memcpy(batch_start, &crc, ROBUSTO_CRC_LENGTH);
+    *data_length = ROBUSTO_PREFIX_BYTES + batch->length;
+    return batch->data;
+}
+
+bool lora_batch_next(const uint8_t *batch, uint32_t batch_length, uint32_t *offset, const uint8_t **message, uint32_t *message_length)
+{
+    if ((batch_length < LORA_BATCH_HEADER_LENGTH) || ((batch[ROBUSTO_CRC_LENGTH] & 0x07) != MSG_BATCH))
+    {
+        return false;
+    }
+    if (*offset < LORA_BATCH_HEADER_LENGTH)
+    {
+        *offset = LORA_BATCH_HEADER_LENGTH;
+    }
+    if (*offset + 1 > batch_length)
+    {
+        return false;
+    }
+    uint32_t length = batch[*offset];
+    if ((length == 0) || (*offset + 1 + length > batch_length))
+    {
+        return false;
+    }
+    *message = batch + *offset + 1;
+    *message_length = length;
+    *offset += 1 + length;
+    return true;
+}
+
+rob_ret_val_t lora_batch_handle(const uint8_t *batch, uint32_t batch_length, robusto_peer_t *peer, lora_batch_message_cb *handle_message)
+{
+    rob_ret_val_t retval = ROB_OK;
+    uint32_t offset = 0;
+    const uint8_t *message;
+    uint32_t message_length;
+    while (lora_batch_next(batch, batch_length, &offset, &message, &message_length))
+    {
+        // Handling takes ownership of the data, so each message needs its own
+        uint8_t *message_data = robusto_malloc(message_length);
+        if (message_data == NULL)
+        {
+            return ROB_ERR_OUT_OF_MEMORY;
+        }
+        memcpy(message_data, message, message_length);
+        rob_ret_val_t message_retval = handle_message(message_data, message_length, peer, robusto_mt_lora, 0);
+        if (message_retval != ROB_OK)
+        {
+            retval = message_retval;
+        }
+    }
+    return retval;
+}
+
+#endif
@@ -0,0 +1,216 @@
+/**
+ * @file lora_schedule.h
+ * @author Nicklas Börjesson (<nicklasb at gmail dot com>)
+ * @brief LoRa time-on-air, duty-cycle budget and batching of small messages into one packet
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @copyright 
+ * Copyright (c) 2026, Nicklas Börjesson <nicklasb at gmail dot com>
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice, 
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE 
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR 
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+#include <robconfig.h>
+#if defined(CONFIG_ROBUSTO_SUPPORTS_LORA) || defined(CONFIG_ROBUSTO_NETWORK_MOCK_TESTING)
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <robusto_retval.h>
+#include <robusto_system.h>
+#include <robusto_message_def.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#ifndef CONFIG_ROBUSTO_LORA_DUTY_CYCLE_PERMILLE
+#define CONFIG_ROBUSTO_LORA_DUTY_CYCLE_PERMILLE 10
+#endif
+
+#ifndef CONFIG_ROBUSTO_LORA_DUTY_CYCLE_WINDOW_S
+#define CONFIG_ROBUSTO_LORA_DUTY_CYCLE_WINDOW_S 3600
+#endif
+
+#ifndef CONFIG_ROBUSTO_LORA_DUTY_CYCLE_RESERVE_PERCENT
+#define CONFIG_ROBUSTO_LORA_DUTY_CYCLE_RESERVE_PERCENT 20
+#endif
+
+#ifndef CONFIG_ROBUSTO_LORA_DUTY_CYCLE_MAX_WAIT_MS
+#define CONFIG_ROBUSTO_LORA_DUTY_CYCLE_MAX_WAIT_MS 1000
+#endif
+
+/* The largest LoRa payload */
+#define LORA_MAX_PAYLOAD 255
+/* A batch is sent using the relation id, so this is what remains of the payload */
+#define LORA_BATCH_MAX_LENGTH (LORA_MAX_PAYLOAD - sizeof(uint32_t))
+/* The CRC, the context byte and the message count */
+#define LORA_BATCH_HEADER_LENGTH (ROBUSTO_CRC_LENGTH + 2)
+/* Even the smallest messages have a CRC and a context byte */
+#define LORA_BATCH_MAX_MESSAGES ((LORA_BATCH_MAX_LENGTH - LORA_BATCH_HEADER_LENGTH) / (1 + ROBUSTO_CRC_LENGTH + ROBUSTO_CONTEXT_BYTE_LEN))
+
+typedef struct lora_schedule
+{
+    /* The radio settings that decide the time on air */
+    uint8_t spreading_factor;
+    uint32_t bandwidth_hz;
+    /* The denominator of the coding rate, 5 to 8 for 4/5 to 4/8 */
+    uint8_t coding_rate;
+    uint16_t preamble_length;
+    /* The share of the time the radio may transmit, in permille */
+    uint16_t duty_cycle_permille;
+    /* The budget is what the duty cycle allows during a window, it is refilled continuously */
+    uint64_t budget_capacity;
+    /* Normal messages leave this much of the budget for important ones */
+    uint64_t budget_reserve;
+    /* The remaining budget, in milliseconds of airtime times 1000 */
+    uint64_t budget;
+    uint32_t budget_updated_ms;
+    /* Statistics */
+    uint32_t airtime_ms;
+    uint32_t deferred;
+} lora_schedule_t;
+
+/**
+ * @brief Initialize a schedule, with a full budget
+ *
+ * @param schedule The schedule
+ * @param spreading_factor 7 to 12
+ * @param bandwidth_hz For example 125000
+ * @param coding_rate The denominator of the coding rate, 5 to 8
+ * @param preamble_length In symbols, usually 8
+ * @param duty_cycle_permille The share of the time the radio may transmit, 1000 to not limit it
+ * @param window_s The period over which the duty cycle is kept, an hour in most regions
+ * @param reserve_percent How much of the budget only important messages may use
+ * @param now_ms The current time
+ */
+void lora_schedule_init(lora_schedule_t *schedule, uint8_t spreading_factor, uint32_t bandwidth_hz, uint8_t coding_rate,
+                        uint16_t preamble_length, uint16_t duty_cycle_permille, uint32_t window_s, uint8_t reserve_percent,
+                        uint32_t now_ms);
+
+/**
+ * @brief Calculate the time on air of a packet, with an explicit header and a CRC
+ *
+ * @param schedule The schedule, for the radio settings
+ * @param payload_length The length of the packet
+ * @return uint32_t The time on air in milliseconds, rounded up
+ */
+uint32_t lora_schedule_time_on_air_ms(const lora_schedule_t *schedule, uint16_t payload_length);
+
+/**
+ * @brief Admit a packet if the duty-cycle budget allows it, and charge its airtime.
+ * @note Important packets may use all of the budget, normal ones leave the reserve.
+ *
+ * @param schedule The schedule
+ * @param airtime_ms The time on air of the packet
+ * @param important If it is important
+ * @param now_ms The current time
+ * @param wait_ms If not admitted, how long until it would be
+ * @return rob_ret_val_t ROB_OK if admitted, ROB_ERR_NOT_READY if it has to wait,
+ * ROB_ERR_MESSAGE_TOO_LONG if it would never be admitted
+ */
+rob_ret_val_t lora_schedule_admit(lora_schedule_t *schedule, uint32_t airtime_ms, bool important, uint32_t now_ms, uint32_t *wait_ms);
+
+/**
+ * @brief Charge airtime that was used regardless of the budget, like receipts
+ */
+void lora_schedule_charge(lora_schedule_t *schedule, uint32_t airtime_ms, uint32_t now_ms);
+
+/**
+ * @brief The remaining budget in milliseconds of airtime
+ */
+uint32_t lora_schedule_budget_ms(lora_schedule_t *schedule, uint32_t now_ms);
+
+/**
+ * @brief Several small messages to the same peer in one packet, that gets one receipt.
+ * The packet is a Robusto message of the MSG_BATCH type, where each message is preceded by its length.
+ */
+typedef struct lora_batch
+{
+    /* Room for the prefix, so that it can be sent like any message */
+    uint8_t data[ROBUSTO_PREFIX_BYTES + LORA_BATCH_MAX_LENGTH];
+    /* The length of the batch, after the prefix */
+    uint16_t length;
+    uint8_t count;
+} lora_batch_t;
+
+/**
+ * @brief Start an empty batch
+ */
+void lora_batch_start(lora_batch_t *batch);
+
+/**
+ * @brief If a message would fit in the batch
+ *
+ * @param message_length The length of the message, without the prefix
+ */
+bool lora_batch_fits(const lora_batch_t *batch, uint32_t message_length);
+
+/**
+ * @brief Add a message to the batch
+ *
+ * @param message The message, without the prefix
+ * @param message_length The length of the message
+ * @return true If added, false if it did not fit
+ */
+bool lora_batch_add(lora_batch_t *batch, const uint8_t *message, uint32_t message_length);
+
+/**
+ * @brief Calculate the CRC of the batch
+ *
+ * @param data_length Set to the length of the batch including the prefix, to be sent like any message
+ * @return uint8_t* The batch including the prefix
+ */
+uint8_t *lora_batch_finish(lora_batch_t *batch, uint32_t *data_length);
+
+/**
+ * @brief Get the next message of a received batch, that has already passed its CRC check
+ *
+ * @param batch The batch, beginning with its CRC
+ * @param batch_length The length of the batch
+ * @param offset Where the next message is, start with 0
+ * @param message Set to the message
+ * @param message_length Set to the length of the message
+ * @return true If there was a message, false if there are no more or the batch is malformed
+ */
+bool lora_batch_next(const uint8_t *batch, uint32_t batch_length, uint32_t *offset, const uint8_t **message, uint32_t *message_length);
+
+/* Handles a message of a batch and takes ownership of it, robusto_handle_incoming when receiving */
+typedef rob_ret_val_t(lora_batch_message_cb)(uint8_t *data, uint32_t data_length, robusto_peer_t *peer, e_media_type media_type, int offset);
+
+/**
+ * @brief Handle the messages of a received batch one by one, the receipt has already been sent for all of them
+ *
+ * @param batch The batch, beginning with its CRC, that has already passed its CRC check
+ * @param batch_length The length of the batch
+ * @param peer The peer that sent the batch
+ * @param handle_message Gets a copy of each message
+ * @return rob_ret_val_t ROB_OK, the last failure of handle_message, or ROB_ERR_OUT_OF_MEMORY
+ */
+rob_ret_val_t lora_batch_handle(const uint8_t *batch, uint32_t batch_length, robusto_peer_t *peer, lora_batch_message_cb *handle_message);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif
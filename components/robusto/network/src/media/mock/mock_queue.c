@@ -41,6 +41,8 @@
 #endif
 
 #include <robusto_logging.h>
+#include <robusto_message.h>
+#include <robusto_system.h>
 
 // The queue context
 queue_context_t *mock_queue_context;
@@ -71,8 +73,8 @@ void mock_insert_tail(queue_context_t * q_context, void *new_item) {
 void mock_cleanup_queue_task(media_queue_item_t *queue_item) {
     if (queue_item != NULL)
     {    
-
-        free(queue_item);
+        robusto_free_media_queue_item_data(queue_item);
+        robusto_free(queue_item);
     }
     cleanup_queue_task(mock_queue_context);
 }
@@ -111,6 +113,10 @@ rob_ret_val_t mock_init_worker(work_callback work_cb, poll_callback poll_cb, cha
     mock_queue_context->shutdown = false;
     mock_queue_context->log_prefix = _log_prefix;
 
-    return init_work_queue(mock_queue_context, _log_prefix, "Mock queue");      
+#ifdef CONFIG_ROBUSTO_QUEUE_RING
+    return init_work_queue_ring(mock_queue_context, _log_prefix, "Mock queue", CONFIG_ROBUSTO_QUEUE_RING_CAPACITY);
+#else
+    return init_work_queue(mock_queue_context, _log_prefix, "Mock queue");
+#endif
 }
 #endif
@@ -35,6 +35,7 @@
 #include <robusto_sys_queue.h>
 
 #include <robusto_logging.h>
+#include <robusto_message.h>
 #include <string.h>
 
 // The queue type definition
@@ -61,8 +62,8 @@ void media_cleanup_queue_task(queue_context_t *q_context, media_queue_item_t *qu
     if (queue_item != NULL)
     {
         free(queue_item->peer);
-        free(queue_item->data);
-        free(queue_item);
+        robusto_free_media_queue_item_data(queue_item);
+        robusto_free(queue_item);
     }
     cleanup_queue_task(q_context);
 }
@@ -92,7 +93,11 @@ queue_context_t *create_media_queue(char *_log_prefix, char *queue_name,
     /* If set, worker will shut down */
     new_queue_context->watchdog_timeout = CONFIG_ROB_RECEIPT_TIMEOUT_MS;
    
+#ifdef CONFIG_ROBUSTO_QUEUE_RING
+    rob_ret_val_t ret_init = init_work_queue_ring(new_queue_context, _log_prefix, queue_name, CONFIG_ROBUSTO_QUEUE_RING_CAPACITY);
+#else
     rob_ret_val_t ret_init = init_work_queue(new_queue_context, _log_prefix, queue_name);
+#endif
     if (ret_init == ROB_OK) {
     
         return new_queue_context;
@@ -37,11 +37,13 @@ static char *message_log_prefix;
 
 void robusto_message_free(robusto_message_t *message) {
     robusto_free(message->raw_data);
-    if (message->string_count > 0) {
+    if (message->strings_allocated) {
         robusto_free(message->strings);
     }
-    robusto_free(message);    
-    
+    // A pooled message is given back instead
+    if (!robusto_pool_give(message->pool, message)) {
+        robusto_free(message);
+    }
 }
 
 void robusto_message_init(char *_log_prefix)
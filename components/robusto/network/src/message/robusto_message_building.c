@@ -85,12 +85,12 @@ uint8_t robusto_encode_message_context(message_context_t *context)
     return res_ctxt;
 }
 
-int robusto_make_multi_message_internal(e_msg_type_t message_type, uint16_t service_id, uint16_t conversation_id,
-                               uint8_t *strings_data, uint32_t strings_length,
-                               uint8_t *binary_data, uint32_t binary_length, uint8_t **dest_message)
+int robusto_make_multi_message_segments(e_msg_type_t message_type, uint16_t service_id, uint16_t conversation_id,
+                                        uint8_t *strings_data, uint32_t strings_length,
+                                        uint8_t *binary_data, uint32_t binary_length, robusto_message_segments_t *dest)
 {
 
-    ROB_LOGD(message_building_log_prefix, "In robusto_make_multi_message. message_type: %hu, service_id: %u, conversation_id: %u, strings_length: %lu, binary_length: %lu.",
+    ROB_LOGD(message_building_log_prefix, "In robusto_make_multi_message_segments. message_type: %hu, service_id: %u, conversation_id: %u, strings_length: %lu, binary_length: %lu.",
      message_type, service_id, conversation_id, strings_length, binary_length);
     /**
      * We always have:
@@ -99,7 +99,7 @@ int robusto_make_multi_message_internal(e_msg_type_t message_type, uint16_t serv
      * 3. A 1-byte message context
      * 4. A 16-byte encryption pad reference (not implemented = 0)
      */
-    uint32_t message_length = ROBUSTO_PREFIX_BYTES + ROBUSTO_CRC_LENGTH + ROBUSTO_CONTEXT_BYTE_LEN + 0;
+    uint32_t header_length = ROBUSTO_PREFIX_BYTES + ROBUSTO_CRC_LENGTH + ROBUSTO_CONTEXT_BYTE_LEN + 0;
     struct message_context context = {
         .message_type = message_type,
         .is_service_call = (service_id > 0),
@@ -108,85 +108,162 @@ int robusto_make_multi_message_internal(e_msg_type_t message_type, uint16_t serv
         .has_binary = (binary_length > 0)
 
     };
-    /* To avoid unnecessary memory allocations, we first add up how long the message data will be. */
-    /* It is a service call, the service_id takes 1 byte. */
-    uint8_t service_offset = 0;
+    memset(dest->header, 0, ROBUSTO_PREFIX_BYTES);
+    dest->header[ROBUSTO_PREFIX_BYTES + ROBUSTO_CRC_LENGTH] = robusto_encode_message_context(&context);
+    ROB_LOGD(message_building_log_prefix, "Context %hu", dest->header[ROBUSTO_PREFIX_BYTES + ROBUSTO_CRC_LENGTH]);
+    /* It is a service call, the service_id takes 2 bytes. */
     if (context.is_service_call)
     {
-        service_offset = sizeof(service_id);
-        message_length += service_offset;
+        memcpy(dest->header + header_length, &service_id, sizeof(service_id));
+        header_length += sizeof(service_id);
     }
-
     // If we have a conversation id, it takes 2 bytes
-    uint8_t conversation_offset = 0;
     if (context.is_conversation)
     {
-        conversation_offset = sizeof(conversation_id);
-        message_length += conversation_offset;
+        memcpy(dest->header + header_length, &conversation_id, sizeof(conversation_id));
+        header_length += sizeof(conversation_id);
+    }
+    // If we have a binary part *and* a strings part we need to add a two-byte length of the strings.
+    if (context.has_strings && context.has_binary)
+    {
+        memcpy(dest->header + header_length, &strings_length, 2);
+        header_length += 2;
     }
 
-    // If we have a string part, add its length
+    dest->segments[0].data = dest->header;
+    dest->segments[0].length = header_length;
+    dest->segment_count = 1;
+    dest->length = header_length;
+    dest->buffer = NULL;
     if (context.has_strings)
     {
-        message_length += strings_length;
+        dest->segments[dest->segment_count].data = strings_data;
+        dest->segments[dest->segment_count].length = strings_length;
+        dest->segment_count++;
+        dest->length += strings_length;
     }
-
-    uint8_t strings_offset = 0;
-    // If we have a binary part, add its length
     if (context.has_binary)
     {
-        message_length += binary_length;
-        // If we have a binary part *and* a strings part we need to add a two-byte length of the strings.
-        if (context.has_strings)
-        {
-            strings_offset = 2;
-            message_length += strings_offset;
-        }
+        // If we have a binary payload, it ends the message.
+        dest->segments[dest->segment_count].data = binary_data;
+        dest->segments[dest->segment_count].length = binary_length;
+        dest->segment_count++;
+        dest->length += binary_length;
     }
-    ROB_LOGD(message_building_log_prefix, "Allocating %lu bytes for message.", message_length);
-    *dest_message = robusto_malloc(message_length);
-    // Check that the allocation worked
-    if (*dest_message == NULL)
+
+    // TODO: Encrypt the message here, before the CRC check (which should NOT be encrypted).
+
+    // Calculate CRC32 across the segments and put after any prefix bytes.
+    uint32_t crc32 = robusto_message_segments_crc32(0, dest, ROBUSTO_PREFIX_BYTES + ROBUSTO_CRC_LENGTH,
+                                                    dest->length - ROBUSTO_CRC_LENGTH - ROBUSTO_PREFIX_BYTES);
+    ROB_LOGD(message_building_log_prefix, "CRC32 dec: %lu", crc32);
+    memcpy(dest->header + ROBUSTO_PREFIX_BYTES, &crc32, ROBUSTO_CRC_LENGTH);
+    return dest->length;
+}
+
+robusto_message_segments_t *robusto_message_segments_create(e_msg_type_t message_type, uint16_t service_id, uint16_t conversation_id,
+                                                            uint8_t *strings_data, uint32_t strings_length, robusto_buffer_t *binary)
+{
+    // The strings are small, they are kept right after the descriptor
+    robusto_message_segments_t *segments = robusto_pool_malloc(sizeof(robusto_message_segments_t) + strings_length);
+    if (segments == NULL)
     {
-        ROB_LOGE(message_building_log_prefix, "robusto_make_multi_message_internal: robusto_malloc of %lu bytes failed.", message_length);
-        return ROB_ERR_OUT_OF_MEMORY;
+        ROB_LOGE(message_building_log_prefix, "robusto_message_segments_create: robusto_pool_malloc of %lu bytes failed.",
+                 (uint32_t)(sizeof(robusto_message_segments_t) + strings_length));
+        return NULL;
     }
-    (*dest_message)[ROBUSTO_PREFIX_BYTES + ROBUSTO_CRC_LENGTH] = robusto_encode_message_context(&context);
-    ROB_LOGD(message_building_log_prefix, "Context %hu", (*dest_message)[ROBUSTO_PREFIX_BYTES + ROBUSTO_CRC_LENGTH]);
-    uint8_t base_offset = ROBUSTO_PREFIX_BYTES + ROBUSTO_CRC_LENGTH + ROBUSTO_CONTEXT_BYTE_LEN;
-    if (context.is_service_call)
+    uint8_t *strings_copy = (uint8_t *)(segments + 1);
+    if (strings_length > 0)
     {
-        memcpy(*dest_message + base_offset, &service_id, sizeof(service_id));
+        memcpy(strings_copy, strings_data, strings_length);
     }
-    if (context.is_conversation)
+    robusto_make_multi_message_segments(message_type, service_id, conversation_id, strings_copy, strings_length,
+                                        binary != NULL ? robusto_buffer_get_data(binary) : NULL,
+                                        binary != NULL ? robusto_buffer_get_length(binary) : 0, segments);
+    if (binary != NULL)
     {
-        memcpy(*dest_message + base_offset + service_offset, &conversation_id, sizeof(conversation_id));
+        segments->buffer = binary;
+        robusto_buffer_retain(binary);
     }
+    return segments;
+}
 
-    if (strings_offset > 0)
+void robusto_message_segments_free(robusto_message_segments_t *segments)
+{
+    if (segments == NULL)
     {
-        // We need to add a length before the strings
-        memcpy(*dest_message + base_offset + service_offset + conversation_offset, &strings_length, sizeof(strings_length));
+        return;
     }
-    if (context.has_strings)
+    if (segments->buffer != NULL)
     {
-        // If we have strings, put them in the message
-        memcpy(*dest_message + base_offset + service_offset + conversation_offset + strings_offset, strings_data, strings_length);
+        robusto_buffer_release(segments->buffer);
     }
+    robusto_free(segments);
+}
 
-    if (context.has_binary)
+void robusto_message_segments_copy(const robusto_message_segments_t *segments, uint32_t offset, uint8_t *dest, uint32_t length)
+{
+    for (uint8_t i = 0; i < segments->segment_count && length > 0; i++)
     {
-        // If we have a binary payload, add it to the end.
-        memcpy(*dest_message + message_length - binary_length, binary_data, binary_length);
+        const robusto_message_segment_t *segment = &segments->segments[i];
+        if (offset >= segment->length)
+        {
+            offset -= segment->length;
+            continue;
+        }
+        uint32_t part = segment->length - offset < length ? segment->length - offset : length;
+        memcpy(dest, segment->data + offset, part);
+        dest += part;
+        length -= part;
+        offset = 0;
     }
+}
 
-    // TODO: Encrypt the message here, before the CRC check (which should NOT be encrypted).
-    
-    // Calculate CRC32 of the finished message and put after any prefix bytes.
-    uint32_t crc32 = robusto_crc32(0, *dest_message + ROBUSTO_PREFIX_BYTES + ROBUSTO_CRC_LENGTH, message_length - ROBUSTO_CRC_LENGTH - ROBUSTO_PREFIX_BYTES);
-    ROB_LOGD(message_building_log_prefix, "CRC32 dec: %lu", crc32);
-    memcpy(*dest_message + ROBUSTO_PREFIX_BYTES, &crc32, ROBUSTO_CRC_LENGTH);
-    return message_length;
+uint32_t robusto_message_segments_crc32(uint32_t crc, const robusto_message_segments_t *segments, uint32_t offset, uint32_t length)
+{
+    for (uint8_t i = 0; i < segments->segment_count && length > 0; i++)
+    {
+        const robusto_message_segment_t *segment = &segments->segments[i];
+        if (offset >= segment->length)
+        {
+            offset -= segment->length;
+            continue;
+        }
+        uint32_t part = segment->length - offset < length ? segment->length - offset : length;
+        crc = robusto_crc32(crc, segment->data + offset, part);
+        length -= part;
+        offset = 0;
+    }
+    return crc;
+}
+
+uint8_t *robusto_message_segments_linearise(const robusto_message_segments_t *segments)
+{
+    uint8_t *message = robusto_pool_malloc(segments->length);
+    if (message == NULL)
+    {
+        ROB_LOGE(message_building_log_prefix, "robusto_message_segments_linearise: robusto_pool_malloc of %lu bytes failed.", segments->length);
+        return NULL;
+    }
+    robusto_message_segments_copy(segments, 0, message, segments->length);
+    return message;
+}
+
+int robusto_make_multi_message_internal(e_msg_type_t message_type, uint16_t service_id, uint16_t conversation_id,
+                               uint8_t *strings_data, uint32_t strings_length,
+                               uint8_t *binary_data, uint32_t binary_length, uint8_t **dest_message)
+{
+    robusto_message_segments_t segments;
+    robusto_make_multi_message_segments(message_type, service_id, conversation_id, strings_data, strings_length,
+                                        binary_data, binary_length, &segments);
+    ROB_LOGD(message_building_log_prefix, "Allocating %lu bytes for message.", segments.length);
+    *dest_message = robusto_message_segments_linearise(&segments);
+    // Check that the allocation worked
+    if (*dest_message == NULL)
+    {
+        return ROB_ERR_OUT_OF_MEMORY;
+    }
+    return segments.length;
 }
 
 int build_strings_data(uint8_t **message, const char *format, ...)
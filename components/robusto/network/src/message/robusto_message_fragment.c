@@ -47,6 +47,8 @@
 
 // Define a short cut. CRC + CONTEXT_BYTE + FRAG_TYPE + Fragment counter  the fragment counter uint32_t bytes.
 #define FRAG_HEADER_LEN (ROBUSTO_CRC_LENGTH + ROBUSTO_CONTEXT_BYTE_LEN + 1 + 4)
+// When the fragments carry their CRC, it follows the fragment counter
+#define FRAG_CRC_LEN 4
 
 #if defined(CONFIG_ROBUSTO_TESTING_SKIP_NTH_FRAGMENT) && (CONFIG_ROBUSTO_TESTING_SKIP_NTH_FRAGMENT > -1)
 #define SKIP_FRAGMENT_TEST curr_fragment != CONFIG_ROBUSTO_TESTING_SKIP_NTH_FRAGMENT || frag_msg->state == ROB_ST_RETRYING
@@ -74,42 +76,148 @@ static robusto_stats_level_t fragment_stats_level = ROBUSTO_STATS_LEVEL_VERBOSE;
 static robusto_fragment_stats_t fragment_stats = {0};
 static robusto_fragment_stats_t fragment_stats_last_read = {0};
 
-static uint32_t fragment_first_missing(const fragmented_message_t *frag_msg)
+/* FRAG_RESEND and FRAG_RESEND_RANGES: hash, message type and fragment type, followed by the map or the ranges */
+#define FRAG_RESEND_HEADER_LEN (ROBUSTO_CRC_LENGTH + 2)
+/* A range is the first missing fragment and the number of missing fragments from there, both uint32_t */
+#define FRAG_RESEND_RANGE_LEN 8U
+/* FRAG_REQUEST, optionally followed by a flags byte that older receivers ignore */
+#define FRAG_REQUEST_LEN (ROBUSTO_CRC_LENGTH + 18)
+#define FRAG_REQUEST_FLAG_WINDOWED 0x01
+/* The sender will put the CRC of each fragment in it if the receiver acknowledges the request */
+#define FRAG_REQUEST_FLAG_FRAGMENT_CRC 0x02
+/* FRAG_ACK: the first missing fragment and a bitmap of the 32 fragments after it, both uint32_t */
+#define FRAG_ACK_LEN (FRAG_RESEND_HEADER_LEN + 8)
+/* The retransmission timeout before the round trip is measured, and its lower bound */
+#define FRAG_INITIAL_RTO_MS (CONFIG_ROB_RECEIPT_TIMEOUT_MS * 5)
+#define FRAG_MIN_RTO_MS CONFIG_ROB_RECEIPT_TIMEOUT_MS
+/* Timeouts in a row without acknowledgements before the window is given up */
+#define FRAG_WINDOW_MAX_TIMEOUTS 5
+
+static inline uint32_t fragment_map_words(uint32_t fragment_count)
 {
-    if (frag_msg == NULL || frag_msg->received_fragments == NULL)
+    return (fragment_count + 31U) / 32U;
+}
+
+static uint32_t *fragment_map_create(uint32_t fragment_count)
+{
+    uint32_t *map = robusto_malloc(fragment_map_words(fragment_count) * sizeof(uint32_t));
+    if (map != NULL)
     {
-        return FRAG_NO_REQUESTED_FRAGMENT;
+        memset(map, 0, fragment_map_words(fragment_count) * sizeof(uint32_t));
     }
+    return map;
+}
 
-    for (uint32_t index = 0; index < frag_msg->fragment_count; ++index)
+static inline bool fragment_is_received(const fragmented_message_t *frag_msg, uint32_t index)
+{
+    return (frag_msg->received_fragments[index / 32U] >> (index % 32U)) & 1U;
+}
+
+/**
+ * @brief Mark a range of fragments as received or missing, a word at a time, keeping received_count up to date
+ */
+static void fragment_mark_range(fragmented_message_t *frag_msg, uint32_t first, uint32_t count, bool received)
+{
+    while (count > 0)
     {
-        if (frag_msg->received_fragments[index] == 0)
+        uint32_t *word = &frag_msg->received_fragments[first / 32U];
+        uint32_t bit = first % 32U;
+        uint32_t bits = 32U - bit < count ? 32U - bit : count;
+        uint32_t mask = bits == 32U ? UINT32_MAX : ((1U << bits) - 1U) << bit;
+        if (received)
+        {
+            frag_msg->received_count += (uint32_t)__builtin_popcount(mask & ~*word);
+            *word |= mask;
+        }
+        else
         {
-            return index;
+            frag_msg->received_count -= (uint32_t)__builtin_popcount(mask & *word);
+            *word &= ~mask;
         }
+        first += bits;
+        count -= bits;
     }
+}
 
-    return FRAG_NO_REQUESTED_FRAGMENT;
+/**
+ * @brief Find the next received or missing fragment
+ *
+ * @param from The fragment to start looking at
+ * @param received Look for a received fragment, otherwise a missing one
+ * @return uint32_t The fragment, FRAG_NO_REQUESTED_FRAGMENT if none
+ */
+static uint32_t fragment_find_next(const fragmented_message_t *frag_msg, uint32_t from, bool received)
+{
+    if (frag_msg == NULL || frag_msg->received_fragments == NULL || from >= frag_msg->fragment_count)
+    {
+        return FRAG_NO_REQUESTED_FRAGMENT;
+    }
+    uint32_t words = fragment_map_words(frag_msg->fragment_count);
+    uint32_t word = from / 32U;
+    uint32_t bits = received ? frag_msg->received_fragments[word] : ~frag_msg->received_fragments[word];
+    bits &= UINT32_MAX << (from % 32U);
+    while (bits == 0)
+    {
+        if (++word >= words)
+        {
+            return FRAG_NO_REQUESTED_FRAGMENT;
+        }
+        bits = received ? frag_msg->received_fragments[word] : ~frag_msg->received_fragments[word];
+    }
+    // The unused bits of the last word are never set, so they look missing
+    uint32_t index = word * 32U + (uint32_t)__builtin_ctz(bits);
+    return index < frag_msg->fragment_count ? index : FRAG_NO_REQUESTED_FRAGMENT;
 }
 
-static uint32_t fragment_missing_count(const fragmented_message_t *frag_msg)
+/* The 32 bits of the map starting at a fragment, fragments past the end read as missing */
+static uint32_t fragment_map_bits(const fragmented_message_t *frag_msg, uint32_t first)
 {
-    uint32_t missing = 0;
+    uint32_t words = fragment_map_words(frag_msg->fragment_count);
+    uint32_t word = first / 32U;
+    uint32_t bit = first % 32U;
+    uint32_t bits = word < words ? frag_msg->received_fragments[word] >> bit : 0;
+    if (bit != 0 && word + 1U < words)
+    {
+        bits |= frag_msg->received_fragments[word + 1U] << (32U - bit);
+    }
+    return bits;
+}
+
+static uint32_t fragment_first_missing(const fragmented_message_t *frag_msg)
+{
+    return fragment_find_next(frag_msg, 0, false);
+}
 
+static uint32_t fragment_last_missing(const fragmented_message_t *frag_msg)
+{
     if (frag_msg == NULL || frag_msg->received_fragments == NULL)
     {
-        return 0;
+        return FRAG_NO_REQUESTED_FRAGMENT;
     }
-
-    for (uint32_t index = 0; index < frag_msg->fragment_count; ++index)
+    uint32_t word = fragment_map_words(frag_msg->fragment_count);
+    while (word-- > 0)
     {
-        if (frag_msg->received_fragments[index] == 0)
+        uint32_t bits = ~frag_msg->received_fragments[word];
+        if (word == fragment_map_words(frag_msg->fragment_count) - 1U && frag_msg->fragment_count % 32U != 0)
         {
-            ++missing;
+            bits &= (1U << (frag_msg->fragment_count % 32U)) - 1U;
+        }
+        if (bits != 0)
+        {
+            return word * 32U + 31U - (uint32_t)__builtin_clz(bits);
         }
     }
+    return FRAG_NO_REQUESTED_FRAGMENT;
+}
 
-    return missing;
+static uint32_t fragment_missing_count(const fragmented_message_t *frag_msg)
+{
+    if (frag_msg == NULL || frag_msg->received_fragments == NULL)
+    {
+        return 0;
+    }
+
+    return frag_msg->fragment_count - frag_msg->received_count;
 }
 
 static void fragment_stats_add(uint32_t *counter, uint32_t amount, robusto_stats_level_t required_level)
@@ -148,6 +256,8 @@ void robusto_fragment_stats_get(robusto_fragment_stats_t *total, robusto_fragmen
     if (total != NULL)
     {
         *total = fragment_stats;
+        total->retransmit_permille = fragment_stats.fragments_sent > 0 ?
+            (uint32_t)(((uint64_t)fragment_stats.fragments_resent * 1000U) / fragment_stats.fragments_sent) : 0;
     }
     if (delta_since_last_read != NULL)
     {
@@ -175,6 +285,13 @@ void robusto_fragment_stats_get(robusto_fragment_stats_t *total, robusto_fragmen
         FRAG_STATS_DELTA_FIELD(invalid_fragment_type);
         FRAG_STATS_DELTA_FIELD(fragments_sent);
         FRAG_STATS_DELTA_FIELD(fragments_resent);
+        FRAG_STATS_DELTA_FIELD(acks_sent);
+        FRAG_STATS_DELTA_FIELD(acks_received);
+        FRAG_STATS_DELTA_FIELD(fragment_crc_mismatch);
+        delta->window_size = fragment_stats.window_size;
+        delta->goodput_bytes_per_s = fragment_stats.goodput_bytes_per_s;
+        delta->retransmit_permille = delta->fragments_sent > 0 ?
+            (uint32_t)(((uint64_t)delta->fragments_resent * 1000U) / delta->fragments_sent) : 0;
     }
 }
 
@@ -200,6 +317,10 @@ void remove_fragmented_message(fragmented_message_t *frag_msg)
         last_frag_msg = NULL;
     }
     robusto_free(frag_msg->received_fragments);
+    if (frag_msg->fragment_crcs != NULL)
+    {
+        robusto_free(frag_msg->fragment_crcs);
+    }
     robusto_free(frag_msg);
 }
 
@@ -245,6 +366,29 @@ void send_result(robusto_peer_t *peer, fragmented_message_t *frag_msg, rob_ret_v
     robusto_free(buffer);
 }
 
+/**
+ * @brief Tell the sender which fragments have been received, lets it move its window and resend lost ones
+ */
+static void send_frag_ack(robusto_peer_t *peer, fragmented_message_t *frag_msg, cb_send_message *send_message)
+{
+    uint8_t ack[FRAG_ACK_LEN];
+    uint32_t base = fragment_first_missing(frag_msg);
+    if (base == FRAG_NO_REQUESTED_FRAGMENT)
+    {
+        base = frag_msg->fragment_count;
+    }
+    uint32_t bits = fragment_map_bits(frag_msg, base + 1U);
+
+    memcpy(ack, &frag_msg->hash, 4);
+    ack[ROBUSTO_CRC_LENGTH] = MSG_FRAGMENTED;
+    ack[ROBUSTO_CRC_LENGTH + 1] = FRAG_ACK;
+    memcpy(ack + FRAG_RESEND_HEADER_LEN, &base, 4);
+    memcpy(ack + FRAG_RESEND_HEADER_LEN + 4, &bits, 4);
+    frag_msg->last_ack_base = base;
+    fragment_stats_add(&fragment_stats.acks_sent, 1U, ROBUSTO_STATS_LEVEL_VERBOSE);
+    send_message(peer, ack, FRAG_ACK_LEN, false);
+}
+
 /**
  * @brief Handle a fragmentated message request
  *
@@ -253,7 +397,7 @@ void send_result(robusto_peer_t *peer, fragmented_message_t *frag_msg, rob_ret_v
  * @param len
  * @param fragment_size
  */
-void handle_frag_request(robusto_peer_t *peer, e_media_type media_type, const uint8_t *data, int len, uint32_t fragment_size)
+void handle_frag_request(robusto_peer_t *peer, e_media_type media_type, const uint8_t *data, int len, uint32_t fragment_size, cb_send_message *send_message)
 {
     robusto_media_t *media = get_media_info(peer, media_type);
     // Manually check CRC32 hash
@@ -278,6 +422,20 @@ void handle_frag_request(robusto_peer_t *peer, e_media_type media_type, const ui
 
     uint32_t hash;
     memcpy(&hash, data + ROBUSTO_CRC_LENGTH + 14, 4);
+    uint32_t receive_buffer_length, fragment_count, request_fragment_size;
+    memcpy(&receive_buffer_length, data + ROBUSTO_CRC_LENGTH + 2, 4);
+    memcpy(&fragment_count, data + ROBUSTO_CRC_LENGTH + 6, 4);
+    memcpy(&request_fragment_size, data + ROBUSTO_CRC_LENGTH + 10, 4);
+    // We allocate by these, so the count has to be what the length and fragment size give
+    if ((receive_buffer_length == 0) || (request_fragment_size == 0) ||
+        (fragment_count != ((uint64_t)receive_buffer_length + request_fragment_size - 1) / request_fragment_size))
+    {
+        fragment_stats_add(&fragment_stats.wrong_fragment_length, 1U, ROBUSTO_STATS_LEVEL_ERRORS);
+        ROB_LOGE(fragmentation_log_prefix, "Fragmented request failed because %lu fragments of %lu bytes does not match %lu bytes.",
+                 fragment_count, request_fragment_size, receive_buffer_length);
+        add_to_history(media, false, ROB_FAIL);
+        return;
+    }
 
     fragmented_message_t *frag_msg = find_fragmented_message(hash);
     if (!frag_msg)
@@ -298,16 +456,55 @@ void handle_frag_request(robusto_peer_t *peer, e_media_type media_type, const ui
     {
         ROB_LOGI(fragmentation_log_prefix, "The fragment transmission is already added, assuming same properties. Might be duplicate try or or testing.");
     }
-    memcpy(&frag_msg->receive_buffer_length, data + ROBUSTO_CRC_LENGTH + 2, 4);
-    memcpy(&frag_msg->fragment_count, data + ROBUSTO_CRC_LENGTH + 6, 4);
-    memcpy(&frag_msg->fragment_size, data + ROBUSTO_CRC_LENGTH + 10, 4);
+    frag_msg->receive_buffer_length = receive_buffer_length;
+    frag_msg->fragment_count = fragment_count;
+    frag_msg->fragment_size = request_fragment_size;
     frag_msg->hash = hash;
     // TODO: How big should we allow before SPIRAM and more?
     frag_msg->receive_buffer = robusto_malloc(frag_msg->receive_buffer_length);
-    frag_msg->received_fragments = robusto_malloc(frag_msg->fragment_count);
+    if (frag_msg->received_fragments != NULL)
+    {
+        robusto_free(frag_msg->received_fragments);
+    }
+    frag_msg->received_fragments = fragment_map_create(frag_msg->fragment_count);
+    frag_msg->received_count = 0;
+    if (frag_msg->fragment_crcs != NULL)
+    {
+        robusto_free(frag_msg->fragment_crcs);
+    }
+    frag_msg->fragment_crcs = robusto_malloc(frag_msg->fragment_count * sizeof(uint32_t));
+    if (frag_msg->receive_buffer == NULL || frag_msg->received_fragments == NULL || frag_msg->fragment_crcs == NULL)
+    {
+        fragment_stats_add(&fragment_stats.fragment_oom, 1U, ROBUSTO_STATS_LEVEL_ERRORS);
+        ROB_LOGE(fragmentation_log_prefix, "Fragmented request failed because the message buffer or received-fragment map allocation failed.");
+        add_to_history(media, false, ROB_ERR_OUT_OF_MEMORY);
+        if (frag_msg->receive_buffer != NULL)
+        {
+            robusto_free(frag_msg->receive_buffer);
+        }
+        if (frag_msg->received_fragments != NULL)
+        {
+            robusto_free(frag_msg->received_fragments);
+        }
+        if (frag_msg->fragment_crcs != NULL)
+        {
+            robusto_free(frag_msg->fragment_crcs);
+        }
+        SLIST_REMOVE(&fragmented_messages_head, frag_msg, fragmented_message, fragmented_messages);
+        if (last_frag_msg == frag_msg)
+        {
+            last_frag_msg = NULL;
+        }
+        robusto_free(frag_msg);
+        return;
+    }
     frag_msg->abort_transmission = false;
     frag_msg->state = ROB_ST_RUNNING;
-    memset(frag_msg->received_fragments, 0, frag_msg->fragment_count);
+    // Senders from before the flags byte only understand FRAG_RESEND
+    frag_msg->resend_ranges = len > FRAG_REQUEST_LEN;
+    frag_msg->send_acks = len > FRAG_REQUEST_LEN && (data[FRAG_REQUEST_LEN] & FRAG_REQUEST_FLAG_WINDOWED);
+    frag_msg->fragment_crc = frag_msg->send_acks && (data[FRAG_REQUEST_LEN] & FRAG_REQUEST_FLAG_FRAGMENT_CRC);
+    frag_msg->last_ack_base = 0;
     ROB_LOGD(fragmentation_log_prefix, "Fragmented initialization received, info:\n \
         data_length: %lu bytes, fragment_count: %lu, fragment_size: %lu, hash: %lu.",
              frag_msg->receive_buffer_length, frag_msg->fragment_count, frag_msg->fragment_size, frag_msg->hash);
@@ -316,24 +513,36 @@ void handle_frag_request(robusto_peer_t *peer, e_media_type media_type, const ui
 
     last_frag_msg = frag_msg;
     media->last_receive = r_millis();
+    if (frag_msg->send_acks)
+    {
+        // Lets the sender know that we acknowledge, and measure the round trip
+        send_frag_ack(peer, frag_msg, send_message);
+    }
+}
+
+/**
+ * @brief Combine the CRCs of the fragments into the hash of the whole message
+ */
+static uint32_t fragment_combine_crcs(const fragmented_message_t *frag_msg)
+{
+    uint32_t fragment_op = robusto_crc32_combine_gen(frag_msg->fragment_size);
+    uint32_t last = frag_msg->fragment_count - 1;
+    uint32_t hash = 0;
+    for (uint32_t i = 0; i < last; i++)
+    {
+        hash = robusto_crc32_combine_op(hash, frag_msg->fragment_crcs[i], fragment_op);
+    }
+    return robusto_crc32_combine(hash, frag_msg->fragment_crcs[last], frag_msg->receive_buffer_length - frag_msg->fragment_size * last);
 }
 
 void check_fragments(robusto_peer_t *peer, e_media_type media_type, fragmented_message_t *frag_msg, cb_send_message *send_message, bool send_resend_request)
 {
 
-    // Check that we have no missing parts, we do this extra pass to save memory
-    uint32_t missing_fragments = 0;
+    uint32_t missing_fragments = fragment_missing_count(frag_msg);
 
-    for (uint32_t pass_one_count = 0; pass_one_count < frag_msg->fragment_count; pass_one_count++)
-    {
-        if (frag_msg->received_fragments[pass_one_count] == 0)
-        {
-            missing_fragments++;
-            frag_msg->last_requested = pass_one_count;
-        }
-    }
     if (missing_fragments > 0)
     {
+        frag_msg->last_requested = fragment_last_missing(frag_msg);
         if (!send_resend_request)
         {
             ROB_LOGI(fragmentation_log_prefix,
@@ -344,7 +553,6 @@ void check_fragments(robusto_peer_t *peer, e_media_type media_type, fragmented_m
                      (unsigned long)frag_msg->hash);
             return;
         }
-        // Gather missing fragments into an array
         fragment_stats_add(&fragment_stats.resend_request_sent, 1U, ROBUSTO_STATS_LEVEL_BASIC);
         fragment_stats_add(&fragment_stats.missing_fragments_reported, missing_fragments, ROBUSTO_STATS_LEVEL_BASIC);
         ROB_LOGW(fragmentation_log_prefix,
@@ -353,24 +561,71 @@ void check_fragments(robusto_peer_t *peer, e_media_type media_type, fragmented_m
                (unsigned long)fragment_first_missing(frag_msg),
                (unsigned long)frag_msg->last_requested,
                (unsigned long)frag_msg->hash);
-        uint8_t *missing = robusto_malloc(ROBUSTO_CRC_LENGTH + 2 + frag_msg->fragment_count);
+
+        // List the missing ranges, as many as fits in a fragment. If not all fit, the rest are requested
+        // when the last of these has arrived.
+        uint32_t max_ranges = (FRAG_HEADER_LEN + frag_msg->fragment_size - FRAG_RESEND_HEADER_LEN) / FRAG_RESEND_RANGE_LEN;
+        if (max_ranges == 0)
+        {
+            max_ranges = 1;
+        }
+        uint8_t *missing = robusto_malloc(FRAG_RESEND_HEADER_LEN + (frag_msg->fragment_count > max_ranges * FRAG_RESEND_RANGE_LEN ? frag_msg->fragment_count : max_ranges * FRAG_RESEND_RANGE_LEN));
+        if (missing == NULL)
+        {
+            fragment_stats_add(&fragment_stats.fragment_oom, 1U, ROBUSTO_STATS_LEVEL_ERRORS);
+            ROB_LOGE(fragmentation_log_prefix, "Failed allocating the resend request.");
+            return;
+        }
         memcpy(missing, &frag_msg->hash, 4);
         missing[ROBUSTO_CRC_LENGTH] = MSG_FRAGMENTED;
-        missing[ROBUSTO_CRC_LENGTH + 1] = FRAG_RESEND;
 
-        for (uint32_t missing_counter = 0; missing_counter < frag_msg->fragment_count; missing_counter++)
+        uint32_t range_count = 0;
+        uint32_t first = fragment_first_missing(frag_msg);
+        while (first != FRAG_NO_REQUESTED_FRAGMENT && range_count < max_ranges)
         {
-            missing[ROBUSTO_CRC_LENGTH + 2 + missing_counter] = frag_msg->received_fragments[missing_counter];
+            uint32_t end = fragment_find_next(frag_msg, first, true);
+            if (end == FRAG_NO_REQUESTED_FRAGMENT)
+            {
+                end = frag_msg->fragment_count;
+            }
+            uint32_t count = end - first;
+            memcpy(missing + FRAG_RESEND_HEADER_LEN + range_count * FRAG_RESEND_RANGE_LEN, &first, 4);
+            memcpy(missing + FRAG_RESEND_HEADER_LEN + range_count * FRAG_RESEND_RANGE_LEN + 4, &count, 4);
+            range_count++;
+            frag_msg->last_requested = end - 1;
+            first = fragment_find_next(frag_msg, end, false);
+        }
+
+        uint32_t missing_length;
+        if (!frag_msg->resend_ranges || (first == FRAG_NO_REQUESTED_FRAGMENT && frag_msg->fragment_count <= range_count * FRAG_RESEND_RANGE_LEN))
+        {
+            // The map of all fragments, if the sender does not understand ranges or the map is no bigger
+            missing[ROBUSTO_CRC_LENGTH + 1] = FRAG_RESEND;
+            if (!frag_msg->resend_ranges)
+            {
+                // It resends all that is missing
+                frag_msg->last_requested = fragment_last_missing(frag_msg);
+            }
+            for (uint32_t missing_counter = 0; missing_counter < frag_msg->fragment_count; missing_counter++)
+            {
+                missing[FRAG_RESEND_HEADER_LEN + missing_counter] = fragment_is_received(frag_msg, missing_counter) ? 1 : 0;
+            }
+            missing_length = FRAG_RESEND_HEADER_LEN + frag_msg->fragment_count;
+        }
+        else
+        {
+            missing[ROBUSTO_CRC_LENGTH + 1] = FRAG_RESEND_RANGES;
+            missing_length = FRAG_RESEND_HEADER_LEN + range_count * FRAG_RESEND_RANGE_LEN;
         }
-        rob_log_bit_mesh(ROB_LOG_DEBUG, fragmentation_log_prefix, missing, ROBUSTO_CRC_LENGTH + 2 + frag_msg->fragment_count);
-        send_message(peer, missing, ROBUSTO_CRC_LENGTH + 2 + frag_msg->fragment_count, true);
+        rob_log_bit_mesh(ROB_LOG_DEBUG, fragmentation_log_prefix, missing, missing_length);
+        send_message(peer, missing, missing_length, true);
         robusto_free(missing);
         return;
     }
     else
     {
         // Last, check hash and reply with result
-        if (frag_msg->hash != robusto_crc32(0, frag_msg->receive_buffer, frag_msg->receive_buffer_length))
+        if (frag_msg->hash != fragment_combine_crcs(frag_msg))
         {
             fragment_stats_add(&fragment_stats.full_message_crc_mismatch, 1U, ROBUSTO_STATS_LEVEL_ERRORS);
             ROB_LOGE(fragmentation_log_prefix, "The full message did not match with the hash");
@@ -434,17 +689,42 @@ void handle_frag_message(robusto_peer_t *peer, e_media_type media_type, const ui
 
     uint32_t expected_message_length = FRAG_HEADER_LEN + curr_frag_size;
     ROB_LOGD(fragmentation_log_prefix, "Received part %lu (of %lu), length %lu bytes.", msg_frag_count + 1, frag_msg->fragment_count, curr_frag_size);
-    if (expected_message_length != len)
+    // Fragments sent before the sender got our acknowledgement of the request don't have a CRC
+    bool has_crc = frag_msg->fragment_crc && len == expected_message_length + FRAG_CRC_LEN;
+    if (expected_message_length != len && !has_crc)
     {
         fragment_stats_add(&fragment_stats.wrong_fragment_length, 1U, ROBUSTO_STATS_LEVEL_ERRORS);
         ROB_LOGE(fragmentation_log_prefix, "Wrong length of fragment %lu: %i bytes, expected %lu", msg_frag_count, len, expected_message_length);
         return;
     }
+    const uint8_t *payload = data + FRAG_HEADER_LEN + (has_crc ? FRAG_CRC_LEN : 0);
+    // The CRC is needed for the hash anyway, calculate it while the fragment is at hand
+    uint32_t fragment_crc = robusto_crc32(0, payload, curr_frag_size);
+    if (has_crc && memcmp(&fragment_crc, data + FRAG_HEADER_LEN, FRAG_CRC_LEN) != 0)
+    {
+        // Treat it like it never arrived, so that it is requested again
+        fragment_stats_add(&fragment_stats.fragment_crc_mismatch, 1U, ROBUSTO_STATS_LEVEL_ERRORS);
+        ROB_LOGW(fragmentation_log_prefix, "Fragment %lu did not match its CRC, hash=%lu", (unsigned long)msg_frag_count, (unsigned long)frag_msg->hash);
+        send_frag_ack(peer, frag_msg, send_message);
+        return;
+    }
 
     // Length of the data checks out
-    ROB_LOGD(fragmentation_log_prefix, "Storing fragment: %lu. Offset: %lu, length: %i", msg_frag_count, fragment_size * msg_frag_count, len - FRAG_HEADER_LEN);
-    memcpy(frag_msg->receive_buffer + (frag_msg->fragment_size * msg_frag_count), data + FRAG_HEADER_LEN, len - FRAG_HEADER_LEN);
-    frag_msg->received_fragments[msg_frag_count] = 1;
+    ROB_LOGD(fragmentation_log_prefix, "Storing fragment: %lu. Offset: %lu, length: %lu", msg_frag_count, fragment_size * msg_frag_count, curr_frag_size);
+    memcpy(frag_msg->receive_buffer + (frag_msg->fragment_size * msg_frag_count), payload, curr_frag_size);
+    frag_msg->fragment_crcs[msg_frag_count] = fragment_crc;
+    fragment_mark_range(frag_msg, msg_frag_count, 1, true);
+
+    if (frag_msg->send_acks)
+    {
+        // Acknowledge when asked to, and right away when a fragment has been lost
+        uint32_t first_missing = fragment_first_missing(frag_msg);
+        bool new_loss = first_missing < msg_frag_count && first_missing != frag_msg->last_ack_base;
+        if (data[ROBUSTO_CRC_LENGTH + 1] == FRAG_MESSAGE_ACK_NOW || new_loss)
+        {
+            send_frag_ack(peer, frag_msg, send_message);
+        }
+    }
 
     // Are we at the last, or last requested, fragment, no less?
     if ((frag_msg->last_requested != FRAG_NO_REQUESTED_FRAGMENT && msg_frag_count == frag_msg->last_requested) ||
@@ -482,116 +762,372 @@ void handle_frag_message(robusto_peer_t *peer, e_media_type media_type, const ui
     ROB_LOGD(fragmentation_log_prefix, "Returning from handle_frag_message");
 }
 
-void send_fragments(robusto_peer_t *peer, e_media_type media_type, fragmented_message_t *frag_msg, cb_send_message *send_message)
+/**
+ * @brief Send one fragment
+ *
+ * @param buffer A buffer big enough for the largest fragment, with the hash and MSG_FRAGMENTED set
+ * @param fragment_type FRAG_MESSAGE or FRAG_MESSAGE_ACK_NOW
+ * @param resend If this fragment has been sent before
+ */
+static rob_ret_val_t send_fragment(robusto_peer_t *peer, fragmented_message_t *frag_msg, uint8_t *buffer, uint32_t curr_fragment,
+                                   uint8_t fragment_type, bool resend, cb_send_message *send_message)
 {
+    uint32_t curr_frag_size = frag_msg->fragment_size;
 
-    ROB_LOGD(fragmentation_log_prefix, "Sending %" PRIu32 " fragments:", frag_msg->fragment_count);
-    
-    uint8_t *buffer = NULL;
-    uint32_t curr_frag_size = curr_frag_size = frag_msg->fragment_size;
-
-    robusto_media_t *info = get_media_info(peer, media_type);
+    buffer[ROBUSTO_CRC_LENGTH + 1] = fragment_type;
+    // Counter
+    memcpy(buffer + ROBUSTO_CRC_LENGTH + 2, &curr_fragment, sizeof(curr_fragment));
 
-    // Allocate a buffer big enough for the largest fragment
-    buffer = robusto_malloc(frag_msg->fragment_size + FRAG_HEADER_LEN);
-    // We always send the same hash, as an identifier
-    memcpy(buffer, &frag_msg->hash, 4);
-    buffer[ROBUSTO_CRC_LENGTH] = MSG_FRAGMENTED;
-    buffer[ROBUSTO_CRC_LENGTH + 1] = FRAG_MESSAGE;
-
-    for (uint32_t curr_fragment = 0; curr_fragment < frag_msg->fragment_count; curr_fragment++)
+    // If it is the last part, send only the remaining data
+    if (curr_fragment == (frag_msg->fragment_count - 1))
     {
-        if (frag_msg->abort_transmission)
-        {
-            robusto_free(buffer);
-            return;
-        }
-        // QoS will disturb sending like this
-        info->postpone_qos = true;
+        curr_frag_size = frag_msg->send_data_length - (frag_msg->fragment_size * curr_fragment);
+    }
 
-        if (frag_msg->received_fragments[curr_fragment] == 1)
-        {
-            ROB_LOGD(fragmentation_log_prefix, "Skipping part %lu", curr_fragment);
-            continue;
-        }
-        // Counter
-        memcpy(buffer + ROBUSTO_CRC_LENGTH + 2, &curr_fragment, sizeof(curr_fragment));
+    if (resend)
+    {
+        ROB_LOGD(fragmentation_log_prefix, "Re-sending fragment %lu (of %lu), pos %lu, length %lu bytes of (%lu total bytes).",
+                 curr_fragment + 1, frag_msg->fragment_count, frag_msg->fragment_size * curr_fragment, curr_frag_size, frag_msg->send_data_length);
+    }
+    else
+    {
+        ROB_LOGD(fragmentation_log_prefix, "Sending fragment %lu (of %lu), pos %lu, length %lu bytes of (%lu total bytes).",
+                 curr_fragment + 1, frag_msg->fragment_count, frag_msg->fragment_size * curr_fragment, curr_frag_size, frag_msg->send_data_length);
+    }
+    uint32_t header_length = FRAG_HEADER_LEN;
+    if (frag_msg->fragment_crc)
+    {
+        memcpy(buffer + FRAG_HEADER_LEN, &frag_msg->fragment_crcs[curr_fragment], FRAG_CRC_LEN);
+        header_length += FRAG_CRC_LEN;
+    }
+    if (frag_msg->send_segments != NULL)
+    {
+        robusto_message_segments_copy(frag_msg->send_segments, frag_msg->send_segments_offset + (frag_msg->fragment_size * curr_fragment),
+                                      buffer + header_length, curr_frag_size);
+    }
+    else
+    {
+        memcpy(buffer + header_length, frag_msg->send_data + (frag_msg->fragment_size * curr_fragment), curr_frag_size);
+    }
 
-        // If it is the last part, send only the remaining data
-        if (curr_fragment == (frag_msg->fragment_count - 1))
-        {
-            curr_frag_size = frag_msg->send_data_length - (frag_msg->fragment_size * curr_fragment);
-        }
+    if (curr_fragment == 10U)
+    {
+        ROB_LOGW(fragmentation_log_prefix,
+                 "About to send fragment index=10 hash=%lu state=%u len=%lu total_frags=%lu total_bytes=%lu",
+                 (unsigned long)frag_msg->hash,
+                 frag_msg->state,
+                 (unsigned long)curr_frag_size,
+                 (unsigned long)frag_msg->fragment_count,
+                 (unsigned long)frag_msg->send_data_length);
+    }
 
-        if (frag_msg->state == ROB_ST_RETRYING)
+    if (SKIP_FRAGMENT_TEST)
+    {
+        if (resend)
         {
-            ROB_LOGD(fragmentation_log_prefix, "Re-sending fragment %lu (of %lu), pos %lu, length %lu bytes of (%lu total bytes).",
-                     curr_fragment + 1, frag_msg->fragment_count, frag_msg->fragment_size * curr_fragment, curr_frag_size, frag_msg->send_data_length);
+            fragment_stats_add(&fragment_stats.fragments_resent, 1U, ROBUSTO_STATS_LEVEL_VERBOSE);
         }
         else
         {
-            ROB_LOGD(fragmentation_log_prefix, "Sending fragment %lu (of %lu), pos %lu, length %lu bytes of (%lu total bytes).",
-                     curr_fragment + 1, frag_msg->fragment_count, frag_msg->fragment_size * curr_fragment, curr_frag_size, frag_msg->send_data_length);
+            fragment_stats_add(&fragment_stats.fragments_sent, 1U, ROBUSTO_STATS_LEVEL_VERBOSE);
         }
-        memcpy(buffer + FRAG_HEADER_LEN, frag_msg->send_data + (frag_msg->fragment_size * curr_fragment), curr_frag_size);
 
+        rob_ret_val_t send_retval = send_message(peer, buffer, header_length + curr_frag_size, true);
         if (curr_fragment == 10U)
         {
             ROB_LOGW(fragmentation_log_prefix,
-                     "About to send fragment index=10 hash=%lu state=%u len=%lu total_frags=%lu total_bytes=%lu",
+                     "Sent fragment index=10 hash=%lu state=%u retval=%d len=%lu total_frags=%lu total_bytes=%lu",
                      (unsigned long)frag_msg->hash,
                      frag_msg->state,
+                     send_retval,
                      (unsigned long)curr_frag_size,
                      (unsigned long)frag_msg->fragment_count,
                      (unsigned long)frag_msg->send_data_length);
         }
+        if (send_retval != ROB_OK)
+        {
+            ROB_LOGE(fragmentation_log_prefix, "Failed sending fragment [%" PRIu32 "].", curr_fragment);
+        }
+        return send_retval;
+    }
+    else
+    {
+        ROB_LOGW(fragmentation_log_prefix,
+                 "Fragment %lu intentionally skipped by CONFIG_ROBUSTO_TESTING_SKIP_NTH_FRAGMENT=%d while state=%u hash=%lu",
+                 (unsigned long)curr_fragment,
+                 SKIP_FRAGMENT_INDEX,
+                 frag_msg->state,
+                 (unsigned long)frag_msg->hash);
+        return ROB_OK;
+    }
+}
+
+static uint8_t *create_fragment_buffer(fragmented_message_t *frag_msg)
+{
+    // Allocate a buffer big enough for the largest fragment
+    uint8_t *buffer = robusto_malloc(frag_msg->fragment_size + FRAG_HEADER_LEN + FRAG_CRC_LEN);
+    if (buffer == NULL)
+    {
+        fragment_stats_add(&fragment_stats.fragment_oom, 1U, ROBUSTO_STATS_LEVEL_ERRORS);
+        ROB_LOGE(fragmentation_log_prefix, "Failed allocating the fragment buffer.");
+        return NULL;
+    }
+    // We always send the same hash, as an identifier
+    memcpy(buffer, &frag_msg->hash, 4);
+    buffer[ROBUSTO_CRC_LENGTH] = MSG_FRAGMENTED;
+    return buffer;
+}
+
+/**
+ * @brief Send all the fragments the receiver is missing, without waiting for acknowledgements
+ */
+void send_fragments(robusto_peer_t *peer, e_media_type media_type, fragmented_message_t *frag_msg, cb_send_message *send_message)
+{
+
+    ROB_LOGD(fragmentation_log_prefix, "Sending %" PRIu32 " fragments:", frag_msg->fragment_count);
+    
+    robusto_media_t *info = get_media_info(peer, media_type);
+
+    uint8_t *buffer = create_fragment_buffer(frag_msg);
+    if (buffer == NULL)
+    {
+        return;
+    }
+
+    // Only send the fragments the receiver is missing
+    for (uint32_t curr_fragment = fragment_find_next(frag_msg, 0, false);
+         curr_fragment != FRAG_NO_REQUESTED_FRAGMENT;
+         curr_fragment = fragment_find_next(frag_msg, curr_fragment + 1, false))
+    {
+        if (frag_msg->abort_transmission)
+        {
+            robusto_free(buffer);
+            return;
+        }
+        // QoS will disturb sending like this
+        info->postpone_qos = true;
+        // TODO: We till need to handle failed sends
+        send_fragment(peer, frag_msg, buffer, curr_fragment, FRAG_MESSAGE, frag_msg->state == ROB_ST_RETRYING, send_message);
+    }
+    robusto_free(buffer);
+    // The response may be really quick, so we only set to done if none of the result states are set
+    if (frag_msg->state < ROB_ST_DONE) {
+        frag_msg->state = ROB_ST_DONE;
+    }
+    
+}
 
-        if (SKIP_FRAGMENT_TEST)
+/**
+ * @brief Send the fragments with a sliding window, that the receiver's acknowledgements move
+ *
+ * @note The window grows by one per acknowledgement while no fragments are lost and the round trip doesn't
+ * grow much, and is halved on loss. Fragments reported lost are resent right away, and unacknowledged ones on timeout.
+ * If the receiver stops acknowledging, the rest is sent without a window and the resend requests take over.
+ * @param srtt_ms The round trip time measured so far
+ */
+static void send_fragments_windowed(robusto_peer_t *peer, e_media_type media_type, fragmented_message_t *frag_msg,
+                                    uint32_t srtt_ms, cb_send_message *send_message)
+{
+    robusto_media_t *info = get_media_info(peer, media_type);
+    uint32_t window_max = CONFIG_ROBUSTO_FRAG_WINDOW_MAX > 0 ? CONFIG_ROBUSTO_FRAG_WINDOW_MAX : 1;
+    // Start lower on media that have been losing data
+    float failure_rate = info->failure_rate < 0.0f ? 0.0f : (info->failure_rate > 1.0f ? 1.0f : info->failure_rate);
+    uint32_t window = (uint32_t)((float)CONFIG_ROBUSTO_FRAG_WINDOW_INITIAL * (1.0f - failure_rate));
+    window = window < 1 ? 1 : (window > window_max ? window_max : window);
+
+    uint32_t next_fragment = 0;
+    uint32_t retransmitted_end = 0;
+    uint32_t recovery_point = 0;
+    uint32_t min_rtt_ms = srtt_ms;
+    uint32_t rtt_probe = FRAG_NO_REQUESTED_FRAGMENT;
+    uint32_t rtt_probe_time = 0;
+    uint32_t until_ack_request = 0;
+    uint32_t timeouts = 0;
+    uint32_t started = r_millis();
+
+    ROB_LOGD(fragmentation_log_prefix, "Sending %" PRIu32 " fragments, window %" PRIu32 ", rtt %" PRIu32 " ms:",
+             frag_msg->fragment_count, window, srtt_ms);
+    uint8_t *buffer = create_fragment_buffer(frag_msg);
+    if (buffer == NULL)
+    {
+        return;
+    }
+
+    while (!frag_msg->abort_transmission && frag_msg->state == ROB_ST_RUNNING &&
+           frag_msg->acked_base < frag_msg->fragment_count &&
+           (uint32_t)(r_millis() - started) < FRAG_RUNNING_WAIT_MS)
+    {
+        // QoS will disturb sending like this
+        info->postpone_qos = true;
+        // Fill the window, asking for acknowledgements twice per window
+        while (next_fragment < frag_msg->fragment_count && next_fragment - frag_msg->acked_base < window)
         {
-            if (frag_msg->state == ROB_ST_RETRYING)
+            if (until_ack_request == 0)
+            {
+                until_ack_request = window / 2 > 0 ? window / 2 : 1;
+            }
+            until_ack_request--;
+            bool ack_now = until_ack_request == 0 || next_fragment - frag_msg->acked_base + 1 == window ||
+                           next_fragment == frag_msg->fragment_count - 1;
+            if (rtt_probe == FRAG_NO_REQUESTED_FRAGMENT)
             {
-                fragment_stats_add(&fragment_stats.fragments_resent, 1U, ROBUSTO_STATS_LEVEL_VERBOSE);
+                rtt_probe = next_fragment;
+                rtt_probe_time = r_millis();
             }
-            else
+            send_fragment(peer, frag_msg, buffer, next_fragment, ack_now ? FRAG_MESSAGE_ACK_NOW : FRAG_MESSAGE, false, send_message);
+            if (ack_now)
             {
-                fragment_stats_add(&fragment_stats.fragments_sent, 1U, ROBUSTO_STATS_LEVEL_VERBOSE);
+                until_ack_request = 0;
             }
+            next_fragment++;
+        }
+
+        // Wait for the receiver
+        uint32_t seen_ack_count = frag_msg->ack_count;
+        uint32_t seen_base = frag_msg->acked_base;
+        uint32_t rto = srtt_ms > 0 ? srtt_ms * 2 : FRAG_INITIAL_RTO_MS;
+        rto = rto < FRAG_MIN_RTO_MS ? FRAG_MIN_RTO_MS : rto;
+        uint32_t wait_start = r_millis();
+        while (frag_msg->ack_count == seen_ack_count && frag_msg->state == ROB_ST_RUNNING && !frag_msg->abort_transmission &&
+               (uint32_t)(r_millis() - wait_start) < rto)
+        {
+            robusto_yield();
+        }
 
-            rob_ret_val_t send_retval = send_message(peer, buffer, FRAG_HEADER_LEN + curr_frag_size, true);
-            if (curr_fragment == 10U)
+        if (frag_msg->ack_count != seen_ack_count)
+        {
+            timeouts = 0;
+            if (rtt_probe != FRAG_NO_REQUESTED_FRAGMENT && frag_msg->acked_base > rtt_probe)
             {
-                ROB_LOGW(fragmentation_log_prefix,
-                         "Sent fragment index=10 hash=%lu state=%u retval=%d len=%lu total_frags=%lu total_bytes=%lu",
-                         (unsigned long)frag_msg->hash,
-                         frag_msg->state,
-                         send_retval,
-                         (unsigned long)curr_frag_size,
-                         (unsigned long)frag_msg->fragment_count,
-                         (unsigned long)frag_msg->send_data_length);
+                uint32_t sample = r_millis() - rtt_probe_time;
+                srtt_ms = srtt_ms > 0 ? (srtt_ms * 7 + sample) / 8 : sample;
+                min_rtt_ms = min_rtt_ms == 0 || sample < min_rtt_ms ? sample : min_rtt_ms;
+                rtt_probe = FRAG_NO_REQUESTED_FRAGMENT;
             }
-            if (send_retval != ROB_OK)
+            if (frag_msg->acked_end > frag_msg->acked_base)
             {
-                // TODO: We till need to handle failed sends
-                ROB_LOGE(fragmentation_log_prefix, "Failed sending fragment [%" PRIu32 "].", curr_fragment);
+                // Something after the first missing fragment has arrived, so that one and any other gaps were lost
+                uint32_t from = frag_msg->acked_base > retransmitted_end ? frag_msg->acked_base : retransmitted_end;
+                uint32_t acked_end = frag_msg->acked_end;
+                bool resent = false;
+                for (uint32_t lost = fragment_find_next(frag_msg, from, false);
+                     lost != FRAG_NO_REQUESTED_FRAGMENT && lost < acked_end && !frag_msg->abort_transmission;
+                     lost = fragment_find_next(frag_msg, lost + 1, false))
+                {
+                    send_fragment(peer, frag_msg, buffer, lost, FRAG_MESSAGE_ACK_NOW, true, send_message);
+                    resent = true;
+                }
+                if (acked_end > retransmitted_end)
+                {
+                    retransmitted_end = acked_end;
+                }
+                // Only back off once per window of losses
+                if (resent && frag_msg->acked_base >= recovery_point)
+                {
+                    window = window / 2 > 0 ? window / 2 : 1;
+                    recovery_point = next_fragment;
+                }
+                // Resent fragments would give a misleading round trip
+                rtt_probe = FRAG_NO_REQUESTED_FRAGMENT;
+            }
+            else if (frag_msg->acked_base > seen_base && window < window_max &&
+                     (min_rtt_ms == 0 || srtt_ms <= min_rtt_ms * 2))
+            {
+                // No losses and no queueing building up, try sending more at a time
+                window++;
             }
         }
-        else
+        else if (frag_msg->state == ROB_ST_RUNNING && !frag_msg->abort_transmission && (uint32_t)(r_millis() - wait_start) >= rto)
         {
-            ROB_LOGW(fragmentation_log_prefix,
-                     "Fragment %lu intentionally skipped by CONFIG_ROBUSTO_TESTING_SKIP_NTH_FRAGMENT=%d while state=%u hash=%lu",
-                     (unsigned long)curr_fragment,
-                     SKIP_FRAGMENT_INDEX,
-                     frag_msg->state,
-                     (unsigned long)frag_msg->hash);
+            if (++timeouts > FRAG_WINDOW_MAX_TIMEOUTS)
+            {
+                ROB_LOGW(fragmentation_log_prefix, "No fragment acknowledgements in %" PRIu32 " tries, sending the rest without a window. hash=%lu",
+                         timeouts - 1, (unsigned long)frag_msg->hash);
+                window = frag_msg->fragment_count;
+                break;
+            }
+            // Nothing came back, resend what is unacknowledged in a smaller window
+            window = window / 2 > 0 ? window / 2 : 1;
+            srtt_ms = srtt_ms * 2;
+            rtt_probe = FRAG_NO_REQUESTED_FRAGMENT;
+            uint32_t resend_end = frag_msg->acked_base + window < next_fragment ? frag_msg->acked_base + window : next_fragment;
+            for (uint32_t lost = fragment_find_next(frag_msg, frag_msg->acked_base, false);
+                 lost != FRAG_NO_REQUESTED_FRAGMENT && lost < resend_end;
+                 lost = fragment_find_next(frag_msg, lost + 1, false))
+            {
+                uint32_t after = fragment_find_next(frag_msg, lost + 1, false);
+                send_fragment(peer, frag_msg, buffer, lost,
+                              after == FRAG_NO_REQUESTED_FRAGMENT || after >= resend_end ? FRAG_MESSAGE_ACK_NOW : FRAG_MESSAGE,
+                              true, send_message);
+            }
         }
+    }
+    fragment_stats.window_size = window;
 
+    // Whatever is left is sent without a window
+    while (next_fragment < frag_msg->fragment_count && !frag_msg->abort_transmission && frag_msg->state == ROB_ST_RUNNING)
+    {
+        info->postpone_qos = true;
+        send_fragment(peer, frag_msg, buffer, next_fragment, FRAG_MESSAGE, false, send_message);
+        next_fragment++;
     }
     robusto_free(buffer);
-    // The response may be really quick, so we only set to done if none of the result states are set
     if (frag_msg->state < ROB_ST_DONE) {
         frag_msg->state = ROB_ST_DONE;
     }
-    
+}
+
+/**
+ * @brief Handle an acknowledgement from the receiver of the fragments
+ */
+void handle_frag_ack(robusto_peer_t *peer, e_media_type media_type, const uint8_t *data, int len)
+{
+    fragment_stats_add(&fragment_stats.acks_received, 1U, ROBUSTO_STATS_LEVEL_VERBOSE);
+    fragmented_message_t *frag_msg = find_fragmented_message(*(uint32_t *)data);
+    if (!frag_msg || (frag_msg->send_data == NULL && frag_msg->send_segments == NULL))
+    {
+        fragment_stats_add(&fragment_stats.invalid_fragment_reference, 1U, ROBUSTO_STATS_LEVEL_ERRORS);
+        return;
+    }
+    if (len != FRAG_ACK_LEN)
+    {
+        fragment_stats_add(&fragment_stats.wrong_fragment_length, 1U, ROBUSTO_STATS_LEVEL_ERRORS);
+        ROB_LOGE(fragmentation_log_prefix, "Wrong length of fragment acknowledgement: %i.", len);
+        return;
+    }
+    uint32_t base, bits;
+    memcpy(&base, data + FRAG_RESEND_HEADER_LEN, 4);
+    memcpy(&bits, data + FRAG_RESEND_HEADER_LEN + 4, 4);
+    if (base > frag_msg->fragment_count)
+    {
+        fragment_stats_add(&fragment_stats.invalid_fragment_index, 1U, ROBUSTO_STATS_LEVEL_ERRORS);
+        ROB_LOGE(fragmentation_log_prefix, "Invalid acknowledged fragment %lu, fragment count %lu.",
+                 (unsigned long)base, (unsigned long)frag_msg->fragment_count);
+        return;
+    }
+    if (base > frag_msg->acked_base)
+    {
+        fragment_mark_range(frag_msg, frag_msg->acked_base, base - frag_msg->acked_base, true);
+        frag_msg->acked_base = base;
+    }
+    uint32_t acked_end = base;
+    while (bits != 0)
+    {
+        uint32_t index = base + 1U + (uint32_t)__builtin_ctz(bits);
+        bits &= bits - 1U;
+        if (index >= frag_msg->fragment_count)
+        {
+            break;
+        }
+        fragment_mark_range(frag_msg, index, 1, true);
+        acked_end = index + 1U;
+    }
+    if (acked_end > frag_msg->acked_end)
+    {
+        frag_msg->acked_end = acked_end;
+    }
+    get_media_info(peer, media_type)->receive_successes++;
+    frag_msg->ack_count++;
 }
 
 /**
@@ -619,16 +1155,57 @@ void handle_frag_resend(robusto_peer_t *peer, e_media_type media_type, const uin
     }
     ROB_LOGD(fragmentation_log_prefix, "In handle_frag_resend, fragment count: %lu ", frag_msg->fragment_count);
     frag_msg->state = ROB_ST_RETRYING;
-    if (len - (ROBUSTO_CRC_LENGTH + 2) != frag_msg->fragment_count)
+    if (data[ROBUSTO_CRC_LENGTH + 1] == FRAG_RESEND_RANGES)
     {
-        fragment_stats_add(&fragment_stats.wrong_resend_map_length, 1U, ROBUSTO_STATS_LEVEL_ERRORS);
-        ROB_LOGE(fragmentation_log_prefix, "Wrong length of missing fragments data: %i. Expected: %lu.", len - (ROBUSTO_CRC_LENGTH + 2), frag_msg->fragment_count);
-        media->receive_failures++;
-        return;
+        uint32_t ranges_length = len - FRAG_RESEND_HEADER_LEN;
+        if (len <= FRAG_RESEND_HEADER_LEN || ranges_length % FRAG_RESEND_RANGE_LEN != 0)
+        {
+            fragment_stats_add(&fragment_stats.wrong_resend_map_length, 1U, ROBUSTO_STATS_LEVEL_ERRORS);
+            ROB_LOGE(fragmentation_log_prefix, "Wrong length of missing fragment ranges: %i.", len - FRAG_RESEND_HEADER_LEN);
+            media->receive_failures++;
+            return;
+        }
+        // Validate all ranges before changing anything
+        for (uint32_t offset = 0; offset < ranges_length; offset += FRAG_RESEND_RANGE_LEN)
+        {
+            uint32_t first, count;
+            memcpy(&first, data + FRAG_RESEND_HEADER_LEN + offset, 4);
+            memcpy(&count, data + FRAG_RESEND_HEADER_LEN + offset + 4, 4);
+            if (first >= frag_msg->fragment_count || count == 0 || count > frag_msg->fragment_count - first)
+            {
+                fragment_stats_add(&fragment_stats.invalid_fragment_index, 1U, ROBUSTO_STATS_LEVEL_ERRORS);
+                ROB_LOGE(fragmentation_log_prefix, "Invalid missing fragment range %lu+%lu, fragment count %lu.",
+                         (unsigned long)first, (unsigned long)count, (unsigned long)frag_msg->fragment_count);
+                media->receive_failures++;
+                return;
+            }
+        }
+        // Everything not listed has been received
+        fragment_mark_range(frag_msg, 0, frag_msg->fragment_count, true);
+        for (uint32_t offset = 0; offset < ranges_length; offset += FRAG_RESEND_RANGE_LEN)
+        {
+            uint32_t first, count;
+            memcpy(&first, data + FRAG_RESEND_HEADER_LEN + offset, 4);
+            memcpy(&count, data + FRAG_RESEND_HEADER_LEN + offset + 4, 4);
+            fragment_mark_range(frag_msg, first, count, false);
+        }
+    }
+    else
+    {
+        if (len - FRAG_RESEND_HEADER_LEN != frag_msg->fragment_count)
+        {
+            fragment_stats_add(&fragment_stats.wrong_resend_map_length, 1U, ROBUSTO_STATS_LEVEL_ERRORS);
+            ROB_LOGE(fragmentation_log_prefix, "Wrong length of missing fragments data: %i. Expected: %lu.", len - FRAG_RESEND_HEADER_LEN, frag_msg->fragment_count);
+            media->receive_failures++;
+            return;
+        }
+        for (uint32_t index = 0; index < frag_msg->fragment_count; index++)
+        {
+            fragment_mark_range(frag_msg, index, 1, data[FRAG_RESEND_HEADER_LEN + index] != 0);
+        }
     }
     media->receive_successes++;
     frag_msg->state = ROB_ST_RETRYING;
-    memcpy(frag_msg->received_fragments, data + ROBUSTO_CRC_LENGTH + 2, len - (ROBUSTO_CRC_LENGTH + 2));
     ROB_LOGW(fragmentation_log_prefix,
              "Resend requested hash=%lu missing_before_resend=%lu first_missing=%lu last_requested=%lu",
              (unsigned long)frag_msg->hash,
@@ -732,13 +1309,15 @@ bool handle_fragmented(robusto_peer_t *peer, e_media_type media_type, uint8_t *d
     switch (data[ROBUSTO_CRC_LENGTH + 1])
     {
     case FRAG_REQUEST:
-        handle_frag_request(peer, media_type, data, len, fragment_size);
+        handle_frag_request(peer, media_type, data, len, fragment_size, send_message);
         receipt = true;
         break;
     case FRAG_MESSAGE:
+    case FRAG_MESSAGE_ACK_NOW:
         handle_frag_message(peer, media_type, data, len, fragment_size, send_message);
         break;
     case FRAG_RESEND:
+    case FRAG_RESEND_RANGES:
         handle_frag_resend(peer, media_type, data, len, fragment_size, send_message);
         break;
     case FRAG_RESULT:
@@ -747,6 +1326,9 @@ bool handle_fragmented(robusto_peer_t *peer, e_media_type media_type, uint8_t *d
     case FRAG_CHECK:
         handle_frag_check(peer, media_type, data, len, fragment_size, send_message);
         break;
+    case FRAG_ACK:
+        handle_frag_ack(peer, media_type, data, len);
+        break;
     default:
         fragment_stats_add(&fragment_stats.invalid_fragment_type, 1U, ROBUSTO_STATS_LEVEL_ERRORS);
         ROB_LOGE(fragmentation_log_prefix, "Invalid fragment type byte: %hu", data[ROBUSTO_CRC_LENGTH + 1]);
@@ -776,9 +1358,11 @@ rob_ret_val_t send_frag_check(robusto_peer_t *peer, e_media_type media_type, fra
     return ROB_OK;
 }
 /**
- * @brief Sends a fragmented message
+ * @brief Sends a fragmented message, from data or, if it is NULL, gathered from segments
  */
-rob_ret_val_t send_message_fragmented(robusto_peer_t *peer, e_media_type media_type, uint8_t *data, uint32_t data_length, uint32_t fragment_size, cb_send_message *send_message)
+static rob_ret_val_t send_message_fragmented_from(robusto_peer_t *peer, e_media_type media_type, uint8_t *data,
+                                                  const robusto_message_segments_t *segments, uint32_t segments_offset,
+                                                  uint32_t data_length, uint32_t fragment_size, cb_send_message *send_message)
 {
     int rc = ROB_FAIL;
     fragment_stats_add(&fragment_stats.send_started, 1U, ROBUSTO_STATS_LEVEL_BASIC);
@@ -792,7 +1376,8 @@ rob_ret_val_t send_message_fragmented(robusto_peer_t *peer, e_media_type media_t
     ROB_LOGD(fragmentation_log_prefix, "Creating and sending a %lu-part, %lu-byte fragmented message in %lu-byte chunks.", fragment_count, data_length, fragment_size);
     //   rob_log_bit_mesh(ROB_LOG_INFO, fragmentation_log_prefix, data, data_length);
     uint32_t curr_part = 0;
-    uint8_t *buffer = robusto_malloc(fragment_size + sizeof(curr_part));
+    uint32_t buffer_length = fragment_size + sizeof(curr_part);
+    uint8_t *buffer = robusto_malloc(buffer_length > FRAG_REQUEST_LEN + 1 ? buffer_length : FRAG_REQUEST_LEN + 1);
     if (buffer == NULL)
     {
         fragment_stats_add(&fragment_stats.fragment_oom, 1U, ROBUSTO_STATS_LEVEL_ERRORS);
@@ -814,19 +1399,40 @@ rob_ret_val_t send_message_fragmented(robusto_peer_t *peer, e_media_type media_t
     frag_msg->last_requested = FRAG_NO_REQUESTED_FRAGMENT;
     frag_msg->send_data_length = data_length;
     frag_msg->send_data = data;
+    frag_msg->send_segments = segments;
+    frag_msg->send_segments_offset = segments_offset;
     frag_msg->fragment_count = fragment_count;
     frag_msg->fragment_size = fragment_size;
-    frag_msg->hash = robusto_crc32(0, data, data_length);
-    frag_msg->received_fragments = robusto_malloc(frag_msg->fragment_count);
-    if (frag_msg->received_fragments == NULL)
+    frag_msg->received_fragments = fragment_map_create(frag_msg->fragment_count);
+    frag_msg->fragment_crcs = robusto_malloc(fragment_count * sizeof(uint32_t));
+    if (frag_msg->received_fragments == NULL || frag_msg->fragment_crcs == NULL)
     {
         fragment_stats_add(&fragment_stats.fragment_oom, 1U, ROBUSTO_STATS_LEVEL_ERRORS);
         ROB_LOGE(fragmentation_log_prefix, "Could not initiate fragmented messaging, received-fragment map allocation failed.");
         rc = ROB_ERR_OUT_OF_MEMORY;
+        if (frag_msg->received_fragments != NULL)
+        {
+            robusto_free(frag_msg->received_fragments);
+        }
+        if (frag_msg->fragment_crcs != NULL)
+        {
+            robusto_free(frag_msg->fragment_crcs);
+        }
         robusto_free(frag_msg);
         goto finish_buffer_only;
     }
-    memset(frag_msg->received_fragments, 0, frag_msg->fragment_count);
+    // The hash identifies the message so it is needed up front. Go through the data once, fragment by fragment,
+    // keeping the CRC of each fragment to send with it, and combine them into the hash.
+    uint32_t fragment_op = robusto_crc32_combine_gen(fragment_size);
+    frag_msg->hash = 0;
+    for (uint32_t i = 0; i < fragment_count; i++)
+    {
+        uint32_t length = i < fragment_count - 1 ? fragment_size : data_length - fragment_size * i;
+        frag_msg->fragment_crcs[i] = data != NULL ? robusto_crc32(0, data + fragment_size * i, length)
+                                                  : robusto_message_segments_crc32(0, segments, segments_offset + fragment_size * i, length);
+        frag_msg->hash = i < fragment_count - 1 ? robusto_crc32_combine_op(frag_msg->hash, frag_msg->fragment_crcs[i], fragment_op)
+                                                : robusto_crc32_combine(frag_msg->hash, frag_msg->fragment_crcs[i], length);
+    }
     frag_msg->abort_transmission = false;
     frag_msg->state = ROB_ST_RUNNING;
     frag_msg->start_time = (uint32_t)r_millis();
@@ -839,6 +1445,12 @@ rob_ret_val_t send_message_fragmented(robusto_peer_t *peer, e_media_type media_t
     memcpy(buffer + ROBUSTO_CRC_LENGTH + 6, &fragment_count, 4);
     memcpy(buffer + ROBUSTO_CRC_LENGTH + 10, &frag_msg->fragment_size, 4);
     memcpy(buffer + ROBUSTO_CRC_LENGTH + 14, &frag_msg->hash, 4);
+    // Ask the receiver to acknowledge fragments, receivers that don't know about it ignore this byte
+    uint8_t request_flags = CONFIG_ROBUSTO_FRAG_WINDOW_INITIAL > 0 ? FRAG_REQUEST_FLAG_WINDOWED : 0;
+#ifdef CONFIG_ROBUSTO_FRAG_FRAGMENT_CRC
+    request_flags |= CONFIG_ROBUSTO_FRAG_WINDOW_INITIAL > 0 ? FRAG_REQUEST_FLAG_FRAGMENT_CRC : 0;
+#endif
+    buffer[FRAG_REQUEST_LEN] = request_flags;
 
     last_frag_msg = frag_msg;
 
@@ -846,16 +1458,33 @@ rob_ret_val_t send_message_fragmented(robusto_peer_t *peer, e_media_type media_t
     memcpy(buffer, &msg_hash, 4);
 
     ROB_LOGD(fragmentation_log_prefix, "Sending a fragment request:");
-    rob_log_bit_mesh(ROB_LOG_DEBUG, fragmentation_log_prefix, buffer, ROBUSTO_CRC_LENGTH + 18);
+    rob_log_bit_mesh(ROB_LOG_DEBUG, fragmentation_log_prefix, buffer, FRAG_REQUEST_LEN + 1);
 
-    if (send_message(peer, buffer, ROBUSTO_CRC_LENGTH + 18, true) != ROB_OK)
+    uint32_t request_sent = r_millis();
+    if (send_message(peer, buffer, FRAG_REQUEST_LEN + 1, true) != ROB_OK)
     {
         ROB_LOGE(fragmentation_log_prefix, "Could not initiate fragmented messaging, got a failure sending");
         rc = ROB_FAIL;
         goto finish;
     }
 
-    send_fragments(peer, media_type, frag_msg, send_message);
+    // A receiver that acknowledges answers the request right away, which also gives the round trip time
+    while (CONFIG_ROBUSTO_FRAG_WINDOW_INITIAL > 0 && frag_msg->ack_count == 0 && frag_msg->state == ROB_ST_RUNNING &&
+           (uint32_t)(r_millis() - request_sent) < FRAG_INITIAL_RTO_MS)
+    {
+        robusto_yield();
+    }
+    if (frag_msg->ack_count > 0)
+    {
+        // A receiver that acknowledges also takes the fragment CRCs if we asked for them
+        frag_msg->fragment_crc = (request_flags & FRAG_REQUEST_FLAG_FRAGMENT_CRC) != 0;
+        send_fragments_windowed(peer, media_type, frag_msg, r_millis() - request_sent, send_message);
+    }
+    else
+    {
+        fragment_stats.window_size = fragment_count;
+        send_fragments(peer, media_type, frag_msg, send_message);
+    }
     ROB_LOGD(fragmentation_log_prefix, "Waiting for fragmented message to complete, current state: %u, start time: %lu", frag_msg->state, frag_msg->start_time);
     
     uint32_t starttime;
@@ -919,6 +1548,8 @@ rob_ret_val_t send_message_fragmented(robusto_peer_t *peer, e_media_type media_t
             ROB_LOGD(fragmentation_log_prefix, "Fragmented message sent successfully");
             rc = ROB_OK;
             fragment_stats_add(&fragment_stats.send_succeeded, 1U, ROBUSTO_STATS_LEVEL_BASIC);
+            uint32_t elapsed_ms = (uint32_t)(r_millis() - frag_msg->start_time);
+            fragment_stats.goodput_bytes_per_s = (uint32_t)(((uint64_t)data_length * 1000U) / (elapsed_ms > 0 ? elapsed_ms : 1U));
             goto finish;
         }
 
@@ -966,6 +1597,23 @@ finish_buffer_only:
     return rc;
 }
 
+/**
+ * @brief Sends a fragmented message
+ */
+rob_ret_val_t send_message_fragmented(robusto_peer_t *peer, e_media_type media_type, uint8_t *data, uint32_t data_length, uint32_t fragment_size, cb_send_message *send_message)
+{
+    return send_message_fragmented_from(peer, media_type, data, NULL, 0, data_length, fragment_size, send_message);
+}
+
+/**
+ * @brief Sends a fragmented message gathered from its segments, without making it contiguous first
+ */
+rob_ret_val_t send_message_fragmented_segments(robusto_peer_t *peer, e_media_type media_type, const robusto_message_segments_t *segments, uint32_t offset,
+                                               uint32_t fragment_size, cb_send_message *send_message)
+{
+    return send_message_fragmented_from(peer, media_type, NULL, segments, offset, segments->length - offset, fragment_size, send_message);
+}
+
 void robusto_message_fragment_init(char *_log_prefix)
 {
     fragmentation_log_prefix = _log_prefix;
@@ -74,17 +74,28 @@ bool robusto_check_message(uint8_t *data, int data_len, uint8_t prefix_bytes) {
 
 }
 
-rob_ret_val_t robusto_network_parse_message(uint8_t *data, uint32_t data_len, robusto_peer_t *peer, robusto_message_t **msg, int prefix_bytes) 
+/**
+ * @brief Parse a message into msg_inst, pointing into the data instead of copying it.
+ * The strings array is filled in the same pass that checks the strings section, in strings if they fit.
+ * If they do not, and allocate_strings is set, an array is allocated for them, otherwise only string_count is set.
+ */
+static rob_ret_val_t parse_message(uint8_t *data, uint32_t data_len, robusto_peer_t *peer, robusto_message_t *msg_inst, int prefix_bytes,
+                                   char **strings, uint16_t strings_capacity, bool allocate_strings)
 {
-    ROB_LOGD(message_parsing_log_prefix, "In robusto_network_parse_message, prefix bytes: %"PRIu8"", prefix_bytes);
-        
-    // TODO: Decide on calling it prefix_bytes or offset.
-    *msg = robusto_malloc(sizeof(robusto_message_t));    
-    robusto_message_t *msg_inst = *msg;
     msg_inst->raw_data = data;
     msg_inst->raw_data_length = data_len;
     msg_inst->peer = peer;
-    ROB_LOGD(message_parsing_log_prefix, "%"PRIu32" bytes memory allocated. Parsing context.", data_len);
+    msg_inst->service_id = 0;
+    msg_inst->conversation_id = 0;
+    msg_inst->strings = NULL;
+    msg_inst->string_count = 0;
+    msg_inst->strings_data = NULL;
+    msg_inst->strings_length = 0;
+    msg_inst->strings_allocated = false;
+    msg_inst->binary_data = NULL;
+    msg_inst->binary_data_length = 0;
+    msg_inst->pool = NULL;
+    ROB_LOGD(message_parsing_log_prefix, "Parsing context of %"PRIu32" bytes.", data_len);
     
     // Then, there is the message context. 
     uint8_t first_byte = data[prefix_bytes + ROBUSTO_CRC_LENGTH];
@@ -118,66 +129,66 @@ rob_ret_val_t robusto_network_parse_message(uint8_t *data, uint32_t data_len, ro
 
     /* If there are null terminated string arrays in the message, they begin here */ 
     if (msg_inst->context.has_strings) {
-        uint16_t strings_end = 0;
+        uint32_t strings_end = 0;
         if (msg_inst->context.has_binary) {
             // If it also has a binary part, it must say how long the strings are, and we can infer where they end.
-            strings_end = (uint16_t)(data[curr_pos]) + curr_pos + 2;
+            uint16_t strings_length = 0;
+            memcpy(&strings_length, data + curr_pos, 2);
+            strings_end = strings_length + curr_pos + 2;
             curr_pos += 2;
         } else {
             strings_end = data_len;
         }
-        // Loop to count all null values.
-        int nullcount = 0;
-        for (int i = curr_pos; i < strings_end; i++)
-        {
-            if (data[i] == 0)
-            {
-                nullcount++;
-            }
-        }
-        if (nullcount == 0) {
-            // TODO: Should we add separate error codes for security violations? 
-            // TODO: And a ROB_EXT_LOGE()-macro that sends to a logging (forwarding    ) server? Or are we doing categories as well for that?
-            ROB_LOGE(message_parsing_log_prefix, "The strings had no null separators at all, this is a protocol and security violation. Message discarded.");
-            // TODO: Mark the connection suspect
+        if (strings_end <= curr_pos || strings_end > data_len) {
+            ROB_LOGE(message_parsing_log_prefix, "The strings section does not fit in the message, this is a protocol and security violation. Message discarded.");
             rob_log_bit_mesh(ROB_LOG_ERROR, message_parsing_log_prefix, data, data_len);
-            return ROB_ERR_PARSING_FAILED;            
+            return ROB_ERR_PARSING_FAILED;
         }
+        // As the section must end with a null, that also means that there is at least one.
         if (data[strings_end -1] != 0) {
             ROB_LOGE(message_parsing_log_prefix, "The strings section has not ended with a null value, this is a protocol and security violation. Message discarded.");
             rob_log_bit_mesh(ROB_LOG_ERROR, message_parsing_log_prefix, data, data_len);
             return ROB_ERR_PARSING_FAILED;
         }
-        ROB_LOGD(message_parsing_log_prefix, "Number of null terminators: %d", nullcount);
-        msg_inst->strings = robusto_malloc(nullcount * sizeof(int32_t)); 
-        // The first byte is always the beginning of a part
-        msg_inst->strings[0] = (char *)(data + curr_pos);
-        msg_inst->string_count = 0;
-        ROB_LOGD(message_parsing_log_prefix, "String[%i] = %s", msg_inst->string_count, msg_inst->strings[msg_inst->string_count]);
-        // Loop the data and set pointers, note that it disregards it if it doesn't end with a NULL value.
+        msg_inst->strings_data = data + curr_pos;
+        msg_inst->strings_length = strings_end - curr_pos;
+        // One pass, counting the strings and pointing to them as long as they fit.
+        uint16_t string_count = 0;
+        uint32_t string_start = curr_pos;
         for (uint32_t j = curr_pos; j < strings_end; j++)
         {
             if (data[j] == 0)
             {
-                msg_inst->string_count++;
-                // The last null does not mean there is more data.
-                if (j < strings_end -1) {
-                    msg_inst->strings[msg_inst->string_count] = (char *)(data + j + 1);
-                    ROB_LOGD(message_parsing_log_prefix, "String[%i] = %s", msg_inst->string_count, msg_inst->strings[msg_inst->string_count]);
+                if (string_count < strings_capacity) {
+                    strings[string_count] = (char *)(data + string_start);
+                    ROB_LOGD(message_parsing_log_prefix, "String[%i] = %s", string_count, strings[string_count]);
                 }
+                string_count++;
+                string_start = j + 1;
+            }
+        }
+        ROB_LOGD(message_parsing_log_prefix, "Number of null terminators: %d", string_count);
+        msg_inst->string_count = string_count;
+        if (string_count <= strings_capacity) {
+            msg_inst->strings = strings;
+        } else if (allocate_strings) {
+            msg_inst->strings = robusto_malloc(string_count * sizeof(char *));
+            if (msg_inst->strings == NULL) {
+                ROB_LOGE(message_parsing_log_prefix, "Failed allocating %hu string pointers.", string_count);
+                return ROB_ERR_OUT_OF_MEMORY;
+            }
+            msg_inst->strings_allocated = true;
+            uint16_t index = 0;
+            for (const char *curr = NULL; (curr = robusto_message_next_string(msg_inst, curr)) != NULL;) {
+                msg_inst->strings[index++] = (char *)curr;
             }
         }
         curr_pos = strings_end;
-    } else {
-        msg_inst->strings = NULL;
-        msg_inst->string_count = 0;
-
     }
     /* The rest of the message contains binary data */
     if (msg_inst->context.has_binary) {
         // There is a binary part,lets parse it
         if (data_len < curr_pos + 1) {
-            msg_inst->binary_data_length = 0;
             ROB_LOGE(message_parsing_log_prefix, "The message seems has the binary bit set but no trailing binary data. ");
             rob_log_bit_mesh(ROB_LOG_ERROR, message_parsing_log_prefix, data, data_len);
             return ROB_ERR_PARSING_FAILED;
@@ -191,15 +202,56 @@ rob_ret_val_t robusto_network_parse_message(uint8_t *data, uint32_t data_len, ro
         ROB_LOGE(message_parsing_log_prefix, "The message seems to be have trailing data and no binary bit set. ");
         rob_log_bit_mesh(ROB_LOG_ERROR, message_parsing_log_prefix, data, data_len > 20 ? 20: data_len);
         return ROB_ERR_PARSING_FAILED;
-    } else {
-        msg_inst->binary_data = NULL;
-        msg_inst->binary_data_length = 0;
     }
-  
 
     ROB_LOGD(message_parsing_log_prefix, "Message successfully parsed.");
     return ROB_OK;
+}
 
+rob_ret_val_t robusto_network_parse_message(uint8_t *data, uint32_t data_len, robusto_peer_t *peer, robusto_message_t **msg, int prefix_bytes) 
+{
+    ROB_LOGD(message_parsing_log_prefix, "In robusto_network_parse_message, prefix bytes: %"PRIu8"", prefix_bytes);
+        
+    // TODO: Decide on calling it prefix_bytes or offset.
+    *msg = robusto_malloc(sizeof(robusto_message_t));
+    if (*msg == NULL) {
+        return ROB_ERR_OUT_OF_MEMORY;
+    }
+    rob_ret_val_t retval = parse_message(data, data_len, peer, *msg, prefix_bytes, NULL, 0, true);
+    if (retval != ROB_OK) {
+        if ((*msg)->strings_allocated) {
+            robusto_free((*msg)->strings);
+        }
+        robusto_free(*msg);
+        *msg = NULL;
+    }
+    return retval;
+}
+
+rob_ret_val_t robusto_network_parse_message_into(uint8_t *data, uint32_t data_len, robusto_peer_t *peer, robusto_message_t *msg, int prefix_bytes,
+                                                 char **strings, uint16_t strings_capacity)
+{
+    ROB_LOGD(message_parsing_log_prefix, "In robusto_network_parse_message_into, prefix bytes: %"PRIu8"", prefix_bytes);
+    rob_ret_val_t retval = parse_message(data, data_len, peer, msg, prefix_bytes, strings, strings_capacity, strings != NULL);
+    if (retval != ROB_OK && msg->strings_allocated) {
+        robusto_free(msg->strings);
+        msg->strings = NULL;
+        msg->strings_allocated = false;
+    }
+    return retval;
+}
+
+const char *robusto_message_next_string(const robusto_message_t *message, const char *previous)
+{
+    if (message->strings_data == NULL) {
+        return NULL;
+    }
+    if (previous == NULL) {
+        return (const char *)message->strings_data;
+    }
+    // The section ends with a null, so the string before the end of it is always terminated
+    const char *next = previous + strlen(previous) + 1;
+    return next < (const char *)message->strings_data + message->strings_length ? next : NULL;
 }
 
 void robusto_message_parsing_init(char * _log_prefix)
@@ -218,7 +218,11 @@ int get_media_type_prefix_len(e_media_type media_type, robusto_peer_t *peer)
     return prefix_length;
 }
 
-rob_ret_val_t send_message_raw_internal(robusto_peer_t *peer, e_media_type media_type, uint8_t *data, uint32_t data_length, queue_state *state, bool receipt, e_media_queue_item_type queue_item_type, uint8_t depth, uint8_t exclude_media_types, bool important)
+/**
+ * @brief Put a message on a media queue, if buffer is set, data belongs to it and the queue item takes a reference.
+ * If segments are set, the queue item owns them, and data, if any, is their contiguous copy.
+ */
+static rob_ret_val_t queue_media_item(robusto_peer_t *peer, e_media_type media_type, uint8_t *data, uint32_t data_length, queue_state *state, bool receipt, e_media_queue_item_type queue_item_type, uint8_t depth, uint8_t exclude_media_types, bool important, robusto_completion_t *completion, robusto_buffer_t *buffer, robusto_message_segments_t *segments)
 {
 
     rob_ret_val_t retval = ROB_FAIL;
@@ -262,58 +266,76 @@ rob_ret_val_t send_message_raw_internal(robusto_peer_t *peer, e_media_type media
     {
         ROB_LOGI(message_sending_log_prefix, ">> Mock sending to mock host: %lu ", peer->relation_id_outgoing);
         // ROB_LOGI(message_sending_log_prefix, ">> Data %i bytes (including 4 bytes preamble): ", data_length);
-        rob_log_bit_mesh(ROB_LOG_INFO, message_sending_log_prefix, data, data_length);
+        if (data != NULL)
+        {
+            rob_log_bit_mesh(ROB_LOG_INFO, message_sending_log_prefix, data, data_length);
+        }
     }
 #endif
 
     if (queue_ctx != NULL)
     {
         robusto_media_t *media_info = get_media_info(peer, media_type);
-        media_queue_item_t *new_item = robusto_malloc(sizeof(media_queue_item_t));
+        media_queue_item_t *new_item = robusto_pool_malloc(sizeof(media_queue_item_t));
         if (new_item == NULL)
         {
             return ROB_ERR_OUT_OF_MEMORY;
         }
         new_item->peer = peer;
         new_item->data = data;
+        new_item->segments = segments;
         new_item->data_length = data_length;
         new_item->queue_item_type = queue_item_type;
         new_item->exclude_media = exclude_media_types;
         new_item->depth = depth + 1;
         new_item->receipt = receipt;
-        new_item->state = state;
+        // With a completion, the item state is that of the completion
+        new_item->state = (state == NULL && completion != NULL) ? robusto_completion_get_state(completion) : state;
+        new_item->completion = completion;
+        if (completion != NULL)
+        {
+            robusto_completion_retain(completion);
+        }
+        new_item->buffer = buffer;
+        if (buffer != NULL)
+        {
+            robusto_buffer_retain(buffer);
+        }
         new_item->important = important;
-        ROB_LOGW(message_sending_log_prefix,
-                 ">> Queue add attempt peer=%s mt=%hhu bytes=%lu qtype=%hhu important=%u receipt=%u depth=%hhu count=%u normal_max=%u important_max=%u blocked=%u tasks=%u rssi_valid=%u rssi_dbm=%i",
-                 peer->name,
-                 media_type,
-                 data_length,
-                 queue_item_type,
-                 important,
-                 receipt,
-                 new_item->depth,
-                 queue_ctx->count,
-                 queue_ctx->normal_max_count,
-                 queue_ctx->important_max_count,
-                 queue_ctx->blocked,
-                 queue_ctx->task_count,
-                 media_info != NULL && media_info->latest_rssi_valid ? 1U : 0U,
-                 media_info != NULL ? (int)media_info->latest_rssi_dbm : 0);
+        ROB_LOGW_DEFERRED(message_sending_log_prefix,
+                          ">> Queue add attempt peer=%s mt=%hhu bytes=%lu qtype=%hhu important=%u receipt=%u depth=%hhu count=%u normal_max=%u important_max=%u blocked=%u tasks=%u rssi_valid=%u rssi_dbm=%i",
+                          peer->name,
+                          media_type,
+                          data_length,
+                          queue_item_type,
+                          important,
+                          receipt,
+                          new_item->depth,
+                          queue_ctx->count,
+                          queue_ctx->normal_max_count,
+                          queue_ctx->important_max_count,
+                          queue_ctx->blocked,
+                          queue_ctx->task_count,
+                          media_info != NULL && media_info->latest_rssi_valid ? 1U : 0U,
+                          media_info != NULL ? (int)media_info->latest_rssi_dbm : 0);
         retval = robusto_set_queue_state_queued_on_ok(new_item->state, safe_add_work_queue(queue_ctx, new_item, important));
-        ROB_LOGW(message_sending_log_prefix,
-                 ">> Queue add result peer=%s mt=%hhu retval=%hi count=%u normal_max=%u important_max=%u blocked=%u tasks=%u rssi_valid=%u rssi_dbm=%i",
-                 peer->name,
-                 media_type,
-                 retval,
-                 queue_ctx->count,
-                 queue_ctx->normal_max_count,
-                 queue_ctx->important_max_count,
-                 queue_ctx->blocked,
-                 queue_ctx->task_count,
-                 media_info != NULL && media_info->latest_rssi_valid ? 1U : 0U,
-                 media_info != NULL ? (int)media_info->latest_rssi_dbm : 0);
+        ROB_LOGW_DEFERRED(message_sending_log_prefix,
+                          ">> Queue add result peer=%s mt=%hhu retval=%hi count=%u normal_max=%u important_max=%u blocked=%u tasks=%u rssi_valid=%u rssi_dbm=%i",
+                          peer->name,
+                          media_type,
+                          retval,
+                          queue_ctx->count,
+                          queue_ctx->normal_max_count,
+                          queue_ctx->important_max_count,
+                          queue_ctx->blocked,
+                          queue_ctx->task_count,
+                          media_info != NULL && media_info->latest_rssi_valid ? 1U : 0U,
+                          media_info != NULL ? (int)media_info->latest_rssi_dbm : 0);
         if (retval != ROB_OK)
         {
+            // Not queued, so the item will not signal it
+            robusto_completion_release(new_item->completion);
+            robusto_buffer_release(new_item->buffer);
             robusto_free(new_item);
         }
     }
@@ -343,9 +365,29 @@ rob_ret_val_t send_message_raw_internal(robusto_peer_t *peer, e_media_type media
     return retval;
 }
 
+rob_ret_val_t send_message_raw_internal(robusto_peer_t *peer, e_media_type media_type, uint8_t *data, uint32_t data_length, queue_state *state, bool receipt, e_media_queue_item_type queue_item_type, uint8_t depth, uint8_t exclude_media_types, bool important, robusto_completion_t *completion)
+{
+    return queue_media_item(peer, media_type, data, data_length, state, receipt, queue_item_type, depth, exclude_media_types, important, completion, NULL, NULL);
+}
+
 rob_ret_val_t send_message_raw(robusto_peer_t *peer, e_media_type media_type, uint8_t *data, uint32_t data_length, queue_state *state, bool receipt)
 {
-    return send_message_raw_internal(peer, media_type, data, data_length, state, receipt, media_qit_normal, 0, robusto_mt_none, false);
+    return send_message_raw_internal(peer, media_type, data, data_length, state, receipt, media_qit_normal, 0, robusto_mt_none, false, NULL);
+}
+
+rob_ret_val_t send_message_raw_buffer(robusto_peer_t *peer, e_media_type media_type, robusto_buffer_t *buffer, queue_state *state, bool receipt)
+{
+    return queue_media_item(peer, media_type, robusto_buffer_get_data(buffer), robusto_buffer_get_length(buffer), state, receipt, media_qit_normal, 0, robusto_mt_none, false, NULL, buffer, NULL);
+}
+
+rob_ret_val_t send_message_raw_completion(robusto_peer_t *peer, e_media_type media_type, uint8_t *data, uint32_t data_length, robusto_completion_t *completion, bool receipt)
+{
+    rob_ret_val_t retval = send_message_raw_internal(peer, media_type, data, data_length, NULL, receipt, media_qit_normal, 0, robusto_mt_none, false, completion);
+    if (retval != ROB_OK)
+    {
+        robusto_completion_signal(completion, retval);
+    }
+    return retval;
 }
 
 rob_ret_val_t send_message_multi(robusto_peer_t *peer, uint16_t service_id, uint16_t conversation_id,
@@ -358,9 +400,16 @@ rob_ret_val_t send_message_multi(robusto_peer_t *peer, uint16_t service_id, uint
     }
     uint8_t *dest_message = NULL;
     e_media_type media_type;
+    // The message is made first, as how well it suits a media can depend on what it is
+    int message_length = robusto_make_multi_message_internal(MSG_MESSAGE, service_id, conversation_id,
+                                                                  strings_data, strings_length, binary_data, binary_length, &dest_message);
+    if (message_length < 0) {
+        ROB_LOGE(message_sending_log_prefix, "Error creating message to %s, res %i", peer->name, message_length);
+        goto fail;
+    }
     if (force_media_type == robusto_mt_none)
     {
-        rob_ret_val_t suitability_res = set_suitable_media(peer, strings_length + binary_length, robusto_mt_none, &media_type);
+        rob_ret_val_t suitability_res = set_suitable_media_for_message(peer, dest_message, message_length, robusto_mt_none, &media_type);
         if (suitability_res != ROB_OK)
         {
             ROB_LOGW(message_sending_log_prefix, "set_suitable_media failed, media will not change.");
@@ -372,13 +421,6 @@ rob_ret_val_t send_message_multi(robusto_peer_t *peer, uint16_t service_id, uint
         media_type = force_media_type;
     }
 
-    int message_length = robusto_make_multi_message_internal(MSG_MESSAGE, service_id, conversation_id,
-                                                                  strings_data, strings_length, binary_data, binary_length, &dest_message);
-    if (message_length < 0) {
-        ROB_LOGE(message_sending_log_prefix, "Error creating message to %s using %s, res %i", peer->name, media_type_to_str(media_type), message_length);
-        goto fail;
-    }
-
     if (send_message_raw(peer, media_type, dest_message, message_length, state, true) != ROB_OK)
     {
         goto fail;
@@ -395,6 +437,49 @@ fail:
     robusto_set_queue_state_queued_on_ok(state, ROB_FAIL);
     return ROB_FAIL;
 }
+
+rob_ret_val_t send_message_multi_buffer(robusto_peer_t *peer, uint16_t service_id, uint16_t conversation_id,
+                                        uint8_t *strings_data, uint32_t strings_length, robusto_buffer_t *binary, queue_state *state, e_media_type force_media_type)
+{
+    if (peer == NULL)
+    {
+        ROB_LOGE(message_sending_log_prefix, "The peer is not set!");
+        return ROB_FAIL;
+    }
+    robusto_message_segments_t *segments = NULL;
+    e_media_type media_type;
+    // The binary data is referenced, not copied, it is only made contiguous if the media needs it
+    segments = robusto_message_segments_create(MSG_MESSAGE, service_id, conversation_id, strings_data, strings_length, binary);
+    if (segments == NULL)
+    {
+        ROB_LOGE(message_sending_log_prefix, "Error creating message to %s", peer->name);
+        goto fail;
+    }
+    if (force_media_type == robusto_mt_none)
+    {
+        // The header is enough to tell what kind of message it is
+        rob_ret_val_t suitability_res = set_suitable_media_for_message(peer, segments->header, segments->length, robusto_mt_none, &media_type);
+        if (suitability_res != ROB_OK)
+        {
+            ROB_LOGW(message_sending_log_prefix, "set_suitable_media failed, media will not change.");
+            goto fail;
+        }
+    }
+    else
+    {
+        media_type = force_media_type;
+    }
+
+    if (queue_media_item(peer, media_type, NULL, segments->length, state, true, media_qit_normal, 0, robusto_mt_none, false, NULL, NULL, segments) == ROB_OK)
+    {
+        return ROB_OK;
+    }
+fail:
+    robusto_message_segments_free(segments);
+    robusto_set_queue_state_queued_on_ok(state, ROB_FAIL);
+    return ROB_FAIL;
+}
+
 rob_ret_val_t send_message_strings(robusto_peer_t *peer, uint16_t service_id, uint16_t conversation_id,
                                    uint8_t *strings_data, uint32_t strings_length, queue_state *state)
 {
@@ -412,28 +497,69 @@ void robusto_message_sending_register_on_activity(on_send_activity_t *_on_send_a
     on_send_activity = _on_send_activity;
 }
 
+void robusto_free_media_queue_item_data(media_queue_item_t *queue_item)
+{
+    if (queue_item->buffer != NULL)
+    {
+        robusto_buffer_release(queue_item->buffer);
+        queue_item->buffer = NULL;
+    }
+    else if (queue_item->segments != NULL)
+    {
+        // The data is only there if a media needed the segments contiguous
+        if (queue_item->data != NULL)
+        {
+            robusto_free(queue_item->data);
+        }
+        robusto_message_segments_free(queue_item->segments);
+        queue_item->segments = NULL;
+    }
+    else
+    {
+        robusto_free(queue_item->data);
+    }
+    queue_item->data = NULL;
+}
+
+void robusto_set_media_queue_item_result(media_queue_item_t *queue_item, rob_ret_val_t result)
+{
+    robusto_set_queue_state_result(queue_item->state, result);
+    if (queue_item->completion != NULL)
+    {
+        robusto_completion_signal(queue_item->completion, result);
+        robusto_completion_release(queue_item->completion);
+        queue_item->completion = NULL;
+    }
+}
+
 void send_work_item(media_queue_item_t *queue_item, robusto_media_t *info, e_media_type media_type, send_callback_cb *send_callback, poll_callback_cb *poll_callback, queue_context_t *queue_context)
+{
+    send_work_item_segments(queue_item, info, media_type, send_callback, NULL, poll_callback, queue_context);
+}
+
+void send_work_item_segments(media_queue_item_t *queue_item, robusto_media_t *info, e_media_type media_type, send_callback_cb *send_callback,
+                             send_segments_callback_cb *send_segments_callback, poll_callback_cb *poll_callback, queue_context_t *queue_context)
 {
 
     int retval = ROB_FAIL;
     int send_retries = 0;
 
-    ROB_LOGW(message_sending_log_prefix,
-             ">> Work send start peer=%s mt=%hhu bytes=%lu qtype=%hhu important=%u receipt=%u depth=%hhu media_state=%hhu media_problem=%hhu count=%u blocked=%u tasks=%u rssi_valid=%u rssi_dbm=%i",
-             queue_item->peer->name,
-             media_type,
-             queue_item->data_length,
-             queue_item->queue_item_type,
-             queue_item->important,
-             queue_item->receipt,
-             queue_item->depth,
-             info->state,
-             info->problem,
-             queue_context->count,
-             queue_context->blocked,
-             queue_context->task_count,
-             info->latest_rssi_valid ? 1U : 0U,
-             (int)info->latest_rssi_dbm);
+    ROB_LOGW_DEFERRED(message_sending_log_prefix,
+                      ">> Work send start peer=%s mt=%hhu bytes=%lu qtype=%hhu important=%u receipt=%u depth=%hhu media_state=%hhu media_problem=%hhu count=%u blocked=%u tasks=%u rssi_valid=%u rssi_dbm=%i",
+                      queue_item->peer->name,
+                      media_type,
+                      queue_item->data_length,
+                      queue_item->queue_item_type,
+                      queue_item->important,
+                      queue_item->receipt,
+                      queue_item->depth,
+                      info->state,
+                      info->problem,
+                      queue_context->count,
+                      queue_context->blocked,
+                      queue_context->task_count,
+                      info->latest_rssi_valid ? 1U : 0U,
+                      (int)info->latest_rssi_dbm);
 
     // Only try to send if we are not recovering and this is not a recovery message.
     if (!(info->state == media_state_recovering && queue_item->queue_item_type != media_qit_recovery))
@@ -444,9 +570,26 @@ void send_work_item(media_queue_item_t *queue_item, robusto_media_t *info, e_med
         }
 
         robusto_set_queue_state_running(queue_item->state);
+        if (queue_item->segments != NULL && send_segments_callback == NULL && queue_item->data == NULL)
+        {
+            // The media needs the message contiguous, put it together once for all attempts
+            queue_item->data = robusto_message_segments_linearise(queue_item->segments);
+        }
         do
         {
-            retval = send_callback(queue_item->peer, queue_item->data, queue_item->data_length, queue_item->receipt);
+            if (queue_item->segments != NULL && send_segments_callback != NULL)
+            {
+                retval = send_segments_callback(queue_item->peer, queue_item->segments, queue_item->receipt);
+            }
+            else if (queue_item->data == NULL)
+            {
+                retval = ROB_ERR_OUT_OF_MEMORY;
+                break;
+            }
+            else
+            {
+                retval = send_callback(queue_item->peer, queue_item->data, queue_item->data_length, queue_item->receipt);
+            }
             if (!queue_item->receipt)
             {
                 // If we fail here, and there is no requirement for a receipt, there is no point in retrying with this media at this time
@@ -484,24 +627,24 @@ void send_work_item(media_queue_item_t *queue_item, robusto_media_t *info, e_med
         ROB_LOGI(message_sending_log_prefix, ">> As the %s, mt %i is recovering, we might need to try some other media for a message (%i, %i)", queue_item->peer->name, media_type, info->state, queue_item->queue_item_type);
     }
 
-    ROB_LOGW(message_sending_log_prefix,
-             ">> Work send result peer=%s mt=%hhu retval=%i retries=%i qtype=%hhu important=%u receipt=%u media_state=%hhu media_problem=%hhu send_failures=%lu send_successes=%lu count=%u blocked=%u tasks=%u rssi_valid=%u rssi_dbm=%i",
-             queue_item->peer->name,
-             media_type,
-             retval,
-             send_retries,
-             queue_item->queue_item_type,
-             queue_item->important,
-             queue_item->receipt,
-             info->state,
-             info->problem,
-             info->send_failures,
-             info->send_successes,
-             queue_context->count,
-             queue_context->blocked,
-             queue_context->task_count,
-             info->latest_rssi_valid ? 1U : 0U,
-             (int)info->latest_rssi_dbm);
+    ROB_LOGW_DEFERRED(message_sending_log_prefix,
+                      ">> Work send result peer=%s mt=%hhu retval=%i retries=%i qtype=%hhu important=%u receipt=%u media_state=%hhu media_problem=%hhu send_failures=%lu send_successes=%lu count=%u blocked=%u tasks=%u rssi_valid=%u rssi_dbm=%i",
+                      queue_item->peer->name,
+                      media_type,
+                      retval,
+                      send_retries,
+                      queue_item->queue_item_type,
+                      queue_item->important,
+                      queue_item->receipt,
+                      info->state,
+                      info->problem,
+                      info->send_failures,
+                      info->send_successes,
+                      queue_context->count,
+                      queue_context->blocked,
+                      queue_context->task_count,
+                      info->latest_rssi_valid ? 1U : 0U,
+                      (int)info->latest_rssi_dbm);
 
     if ((retval != ROB_OK) &&                                                           // We only try other medias if we have failed..
         (queue_item->receipt) &&                                                        // ..and if it is receipt required, then we infer that we will try with multiple medias
@@ -514,46 +657,43 @@ void send_work_item(media_queue_item_t *queue_item, robusto_media_t *info, e_med
 
         ROB_LOGW(message_sending_log_prefix, "Failed sending using %s, will try some other media.", media_type_to_str(media_type));
         // Check suitability again to find another media to try
-        rob_ret_val_t suitability_res = set_suitable_media(queue_item->peer, queue_item->data_length, queue_item->exclude_media, &next_media_type);
+        rob_ret_val_t suitability_res = set_suitable_media_for_message(queue_item->peer, queue_item->data != NULL ? queue_item->data : (queue_item->segments != NULL ? queue_item->segments->header : NULL),
+                                                                        queue_item->data_length, queue_item->exclude_media, &next_media_type);
 
         if (suitability_res != ROB_OK)
         {
             ROB_LOGW(message_sending_log_prefix, "Couldn't find another media to try.");
-            robusto_set_queue_state_result(queue_item->state, QUEUE_STATE_FAILED);
-            robusto_free(queue_item->data);
+            robusto_set_media_queue_item_result(queue_item, ROB_FAIL);
+            robusto_free_media_queue_item_data(queue_item);
         }
         else
         {
             ROB_LOGW(message_sending_log_prefix, "Will try sending using %s instead.", media_type_to_str(next_media_type));
-            // Another media found, try sending using that instead
-            queue_state *new_state = (queue_state *)robusto_malloc(sizeof(queue_state));
+            /* Another media found, queue the retry on it and move on to the next item instead of waiting for the result.
+               The retry is handed the original state, so the state resolves when the retry, or any further retries, finishes. */
             robusto_set_queue_state_trying(queue_item->state);
-            rob_ret_val_t retry_retval;
-            rob_ret_val_t retry_res = send_message_raw_internal(queue_item->peer, next_media_type, queue_item->data, queue_item->data_length, new_state, queue_item->receipt, queue_item->queue_item_type, queue_item->depth, queue_item->exclude_media, queue_item->important);
+            rob_ret_val_t retry_res = queue_media_item(queue_item->peer, next_media_type, queue_item->data, queue_item->data_length, queue_item->state, queue_item->receipt, queue_item->queue_item_type, queue_item->depth, queue_item->exclude_media, queue_item->important, queue_item->completion, queue_item->buffer, queue_item->segments);
             if (retry_res != ROB_OK)
             {
                 ROB_LOGE(message_sending_log_prefix, "Error queueing retry: %i %i", retry_res, next_media_type);
-                robusto_set_queue_state_result(queue_item->state, ROB_FAIL);
-                robusto_free(queue_item->data);
-            }
-            else if (!robusto_waitfor_queue_state(new_state, 6000, &retry_retval))
-            {
-                ROB_LOGE(message_sending_log_prefix, "Failed retrying sending presentation to %s, using mt %hhu, queue state %hhu , reason code: %hi",
-                         queue_item->peer->name, next_media_type, *(uint8_t *)new_state[0], retry_retval);
-                robusto_set_queue_state_result(queue_item->state, retry_retval);
-                // Leaving this here to remind that the queue handling frees the queue when done
-                // robusto_free(queue_item->data);
+                robusto_set_media_queue_item_result(queue_item, ROB_FAIL);
+                robusto_free_media_queue_item_data(queue_item);
             }
             else
             {
-                robusto_set_queue_state_result(queue_item->state, ROB_OK);
+                // The retry owns the data and segments, and has its own references to the completion and buffer
+                robusto_completion_release(queue_item->completion);
+                queue_item->completion = NULL;
+                robusto_buffer_release(queue_item->buffer);
+                queue_item->buffer = NULL;
+                queue_item->segments = NULL;
             }
         }
     }
     else
     {
-        robusto_set_queue_state_result(queue_item->state, retval);
-        robusto_free(queue_item->data); // Not if re-sent, that would re-free..
+        robusto_set_media_queue_item_result(queue_item, retval);
+        robusto_free_media_queue_item_data(queue_item); // Not if re-sent, that would re-free..
     }
     // Letting those monitoring the queue state react
     robusto_yield();
@@ -346,10 +346,11 @@ robusto_media_t * get_media_info(robusto_peer_t * peer, e_media_type media_type)
  * @brief Returns a connection score for the peer
  *
  * @param peer The peer to analyze
+ * @param message The message with its prefix, at least its headers, NULL if it is not made yet
  * @param data_length The length of data to send
  * @return float The score = -100 don't use, +100 use
  */
-float score_peer(robusto_peer_t *peer, e_media_type media_type, int data_length)
+float score_peer(robusto_peer_t *peer, e_media_type media_type, const uint8_t *message, int data_length)
 {
 
     robusto_media_t *curr_info = get_media_info(peer, media_type);
@@ -361,7 +362,7 @@ float score_peer(robusto_peer_t *peer, e_media_type media_type, int data_length)
 
     // TODO: Add different demands, like "wired"? "secure", "fast", "roundtrip", or similar?
     // TODO: Obviously, the length score should go down if we are forced to slow down, with a low actual speed.
-    float length_score = robusto_calc_suitability(media_type, data_length);
+    float length_score = robusto_calc_suitability(peer, media_type, message, data_length);
 
     // A failure fraction of 0.1 - 0. No failures - 10. Anything over 0.5 returns -100.
     float success_score = 10 - (curr_info->failure_rate * 100);
@@ -394,6 +395,11 @@ float score_peer(robusto_peer_t *peer, e_media_type media_type, int data_length)
 }
 
 rob_ret_val_t set_suitable_media(robusto_peer_t *peer, uint16_t data_length, e_media_type exclude, e_media_type *result)
+{
+    return set_suitable_media_for_message(peer, NULL, data_length, exclude, result);
+}
+
+rob_ret_val_t set_suitable_media_for_message(robusto_peer_t *peer, const uint8_t *message, uint32_t data_length, e_media_type exclude, e_media_type *result)
 {
     // 
     float score = -49;
@@ -403,7 +409,7 @@ rob_ret_val_t set_suitable_media(robusto_peer_t *peer, uint16_t data_length, e_m
 
     #if defined(CONFIG_ROBUSTO_SUPPORTS_ESP_NOW) || defined(CONFIG_ROBUSTO_NETWORK_QOS_TESTING)
     if ((peer->supported_media_types & robusto_mt_espnow) && !(exclude & robusto_mt_espnow)) {
-        new_score = score_peer(peer, robusto_mt_espnow, data_length);
+        new_score = score_peer(peer, robusto_mt_espnow, message, data_length);
 
         if (new_score > score && peer->espnow_info.state < media_state_recovering) {
             score = new_score;
@@ -414,7 +420,7 @@ rob_ret_val_t set_suitable_media(robusto_peer_t *peer, uint16_t data_length, e_m
 
     #if defined(CONFIG_ROBUSTO_SUPPORTS_BLE) || defined(CONFIG_ROBUSTO_NETWORK_QOS_TESTING)
     if ((peer->supported_media_types & robusto_mt_ble) && !(exclude & robusto_mt_espnow)) {
-        new_score = score_peer(peer, robusto_mt_ble, data_length);
+        new_score = score_peer(peer, robusto_mt_ble, message, data_length);
 
         if (new_score > score && peer->ble_info.state < media_state_recovering) {
             score = new_score;
@@ -424,7 +430,7 @@ rob_ret_val_t set_suitable_media(robusto_peer_t *peer, uint16_t data_length, e_m
     #endif
     #if defined(CONFIG_ROBUSTO_SUPPORTS_LORA) || defined(CONFIG_ROBUSTO_NETWORK_QOS_TESTING)
     if ((peer->supported_media_types & robusto_mt_lora) && !(exclude & robusto_mt_lora)) {
-        new_score = score_peer(peer, robusto_mt_lora, data_length);
+        new_score = score_peer(peer, robusto_mt_lora, message, data_length);
 
         if (new_score > score && peer->lora_info.state < media_state_recovering) {
             score = new_score;
@@ -434,7 +440,7 @@ rob_ret_val_t set_suitable_media(robusto_peer_t *peer, uint16_t data_length, e_m
     #endif    
     #if defined(CONFIG_ROBUSTO_SUPPORTS_I2C) || defined(CONFIG_ROBUSTO_NETWORK_QOS_TESTING)
     if ((peer->supported_media_types & robusto_mt_i2c) && !(exclude & robusto_mt_i2c)) {
-        new_score = score_peer(peer, robusto_mt_i2c, data_length);
+        new_score = score_peer(peer, robusto_mt_i2c, message, data_length);
 
         if (new_score > score && peer->i2c_info.state < media_state_recovering) {
             score = new_score;
@@ -444,7 +450,7 @@ rob_ret_val_t set_suitable_media(robusto_peer_t *peer, uint16_t data_length, e_m
     #endif       
     #if defined(CONFIG_ROBUSTO_SUPPORTS_CANBUS) || defined(CONFIG_ROBUSTO_NETWORK_QOS_TESTING)
     if ((peer->supported_media_types & robusto_mt_canbus) && !(exclude & robusto_mt_canbus)) {
-        new_score = score_peer(peer, robusto_mt_canbus, data_length);
+        new_score = score_peer(peer, robusto_mt_canbus, message, data_length);
 
         if (new_score > score && peer->canbus_info.state < media_state_recovering) {
             score = new_score;
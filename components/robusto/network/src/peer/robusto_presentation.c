@@ -92,7 +92,6 @@ rob_ret_val_t robusto_send_presentation(robusto_peer_t *peer, robusto_media_type
     }
     ROB_LOGD(presentation_log_prefix, ">> Presentation to send:");
     rob_log_bit_mesh(ROB_LOG_DEBUG, presentation_log_prefix, msg, msg_len);
-    queue_state *q_state = robusto_malloc(sizeof(queue_state));
     e_media_type supported_mt = get_host_supported_media_types();
     rob_ret_val_t ret_val_flag = ROB_FAIL;
     for (uint16_t media_type = 1; media_type < 25; media_type = media_type * 2)
@@ -102,15 +101,21 @@ rob_ret_val_t robusto_send_presentation(robusto_peer_t *peer, robusto_media_type
             continue;
         }
         robusto_media_t *info = get_media_info(peer, media_type);
+        robusto_completion_t *completion = robusto_completion_create();
+        if (completion == NULL)
+        {
+            ret_val_flag = ROB_ERR_OUT_OF_MEMORY;
+            break;
+        }
         /* Send presentation:
          * no receipt as a reply requires know outgoing id, which is only available after presentation is parsed
          * only send to the mentioned media type
          * if reason is recovery, set that as the type so that the presentation isn't purged from the queue
          * replies are triggered by remote HI messages, so do not let them consume the important queue reserve
         */
-        rob_ret_val_t queue_ret = send_message_raw_internal(peer, media_type, msg, msg_len, q_state, false, 
+        rob_ret_val_t queue_ret = send_message_raw_internal(peer, media_type, msg, msg_len, NULL, false, 
             (reason == presentation_recover) ?  media_qit_recovery : media_qit_normal, 
-            0, peer->supported_media_types & ~media_type, !is_reply || reason == presentation_recover);
+            0, peer->supported_media_types & ~media_type, !is_reply || reason == presentation_recover, completion);
 
         if (queue_ret != ROB_OK)
         {
@@ -118,31 +123,26 @@ rob_ret_val_t robusto_send_presentation(robusto_peer_t *peer, robusto_media_type
             ROB_LOGE(presentation_log_prefix, ">> Error queueing presentation: %i %i", queue_ret, media_type);
             ret_val_flag = queue_ret;
         }
-        else if (!robusto_waitfor_queue_state(q_state, PRESENTATION_QUEUE_WAIT_MS, &ret_val_flag))
+        else if (robusto_completion_wait(completion, PRESENTATION_QUEUE_WAIT_MS, &ret_val_flag) != ROB_OK || ret_val_flag != ROB_OK)
         {
             peer->state = failstate;
 
-            uint8_t q_progress = q_state[0][0];
-            bool queue_in_flight = (q_progress == QUEUE_STATE_QUEUED) ||
-                                   (q_progress == QUEUE_STATE_RUNNING) ||
-                                   (q_progress == QUEUE_STATE_TRYING_MEDIAS);
-
-            if (ret_val_flag == ROB_ERR_TIMEOUT && q_progress == QUEUE_STATE_SUCCEEDED) {
-                // Queue completed around the timeout boundary; treat this as success.
-                ret_val_flag = ROB_OK;
+            // If the wait timed out, the message is still queued or being sent
+            bool queue_in_flight = !robusto_completion_is_done(completion);
+            if (queue_in_flight) {
+                ret_val_flag = ROB_ERR_TIMEOUT;
             }
 
-            if (!is_reply &&
-                ret_val_flag != ROB_ERR_TIMEOUT && !queue_in_flight &&
+            if (!is_reply && !queue_in_flight &&
                 info->state == media_state_working) {
                 set_state(peer, info, media_type, media_state_problem, media_problem_send_problem);
             }
             
-            ROB_LOGE(presentation_log_prefix, ">> Failed sending presentation to %s, mt %hhu, queue state %hhu , reason code: %hi", peer->name, media_type, *(uint8_t *)q_state[0], ret_val_flag);
+            ROB_LOGE(presentation_log_prefix, ">> Failed sending presentation to %s, mt %hhu, queue state %hhu , reason code: %hi", peer->name, media_type, *robusto_completion_get_state(completion)[0], ret_val_flag);
             if (queue_in_flight) {
                 ROB_LOGW(presentation_log_prefix,
                          ">> Presentation timeout while queue state still in-flight (%hhu), keeping media state unchanged",
-                         q_progress);
+                         *robusto_completion_get_state(completion)[0]);
             }
         }
         else {
@@ -162,11 +162,14 @@ rob_ret_val_t robusto_send_presentation(robusto_peer_t *peer, robusto_media_type
                     r_delay(1000);
                 } else {
                     ret_val_flag = ROB_OK;
+                    robusto_completion_release(completion);
                     break;
                 }
 
             } 
         }
+        // If still in flight, the queue item keeps its own reference
+        robusto_completion_release(completion);
     
         if (peer->state > PEER_PRESENTING)
         {
@@ -178,7 +181,6 @@ rob_ret_val_t robusto_send_presentation(robusto_peer_t *peer, robusto_media_type
         // This is kind of odd, we are in here while presenting or unknown.
         peer->state = failstate;
     }
-    robusto_free_queue_state(q_state);
     return ret_val_flag;
 }
 
@@ -56,6 +56,7 @@
 #endif
 #if defined(CONFIG_ROBUSTO_SUPPORTS_CANBUS) || defined(CONFIG_ROBUSTO_NETWORK_QOS_TESTING)
 #include "../media/canbus/canbus_messaging.h"
+#include "../media/canbus/canbus_frame.h"
 #endif
 
 #ifdef CONFIG_ROBUSTO_NETWORK_MOCK_TESTING
@@ -110,6 +111,8 @@ void add_to_history(robusto_media_t *stats, bool sending, rob_ret_val_t result)
 /**
  * @brief Calculate the suitability
  *
+ * @param peer The peer to transfer to, what it supports affects the suitability
+ * @param message The message with its prefix, at least its headers, NULL if it is not made yet
  * @param data_length The length of data to transfer
  * @param base_value The initial position, is this generally a good or worse media
  * @param base_offset 
@@ -117,13 +120,14 @@ void add_to_history(robusto_media_t *stats, bool sending, rob_ret_val_t result)
  * @return float
  */
 
-uint32_t robusto_calc_suitability(e_media_type media_type, uint32_t payloadSize) {
+uint32_t robusto_calc_suitability(robusto_peer_t *peer, e_media_type media_type, const uint8_t *message, uint32_t payloadSize) {
     int phc;
     switch (media_type) {
         #if CONFIG_ROBUSTO_SUPPORTS_CANBUS
         case robusto_mt_canbus:
-        // CAN bus is great with small volumes, but quickly start losing out.
-            phc = (payloadSize - CANBUS_MESSAGE_OFFSET <= 8) ? 100 : 80 - ((payloadSize - CANBUS_MESSAGE_OFFSET - 8) / 10);
+        // CAN bus is great with small volumes, but quickly start losing out. 
+        // Peers that take extended frames get 9-byte messages and short service calls in one frame.
+            phc = canbus_fits_single_frame(peer, message != NULL ? message + CANBUS_MESSAGE_OFFSET : NULL, payloadSize - CANBUS_MESSAGE_OFFSET) ? 100 : 80 - ((payloadSize - CANBUS_MESSAGE_OFFSET - CANBUS_FRAME_LENGTH) / 10);
         // TODO: Shoud stop showing the data length with a lot of data that won't be used in many cases, especially like the 20 bytes here
             break;
         #endif
@@ -16,11 +16,38 @@ extern "C" {
 typedef uint32_t (*robusto_proxy_clock_now_ms)(void *context);
 typedef void (*robusto_proxy_clock_wait_ms)(void *context, uint32_t delay_ms);
 typedef uint32_t (*robusto_proxy_retry_jitter_ms)(void *context, uint32_t maximum_ms);
+typedef void (*robusto_proxy_client_lock)(void *context);
+
+/**
+ * Completion of a request submitted with robusto_proxy_client_submit.
+ *
+ * payload is the success payload, only valid during the call.
+ */
+typedef void (*robusto_proxy_client_completion)(
+    void *context,
+    rob_ret_val_t result,
+    const uint8_t *payload,
+    size_t payload_size);
+
+/** A submitted request waiting for its response, in the slot of its frame. */
+typedef struct robusto_proxy_client_pending {
+    robusto_proxy_client_completion completion;
+    void *completion_context;
+    uint32_t correlation_id;
+    uint8_t domain;
+    uint8_t opcode;
+    bool mutation;
+    bool active;
+} robusto_proxy_client_pending_t;
 
 /**
  * Configuration for robusto_proxy_client_init.
  *
  * request_frame/response_frame must remain valid for the client lifetime.
+ *
+ * Submitting requests without waiting needs send and pipeline_frames, one
+ * frame of pipeline_frame_size bytes per outstanding request. If requests are
+ * made from several tasks, lock/unlock must serialise access to the client.
  */
 typedef struct robusto_proxy_client_config {
     robusto_proxy_profile_t profile;
@@ -39,6 +66,13 @@ typedef struct robusto_proxy_client_config {
     size_t request_frame_size;
     uint8_t *response_frame;
     size_t response_frame_size;
+    robusto_proxy_transport_send send;
+    uint8_t *pipeline_frames;
+    size_t pipeline_frame_size;
+    uint16_t pipeline_frame_count;
+    robusto_proxy_client_lock lock;
+    robusto_proxy_client_lock unlock;
+    void *lock_context;
 } robusto_proxy_client_config_t;
 
 typedef struct robusto_proxy_client {
@@ -71,6 +105,14 @@ typedef struct robusto_proxy_client {
     uint32_t pubsub_delivery_data_received;
     uint32_t retries;
     uint8_t consecutive_health_timeouts;
+    robusto_proxy_transport_send send;
+    uint8_t *pipeline_frames;
+    size_t pipeline_frame_size;
+    uint16_t pipeline_frame_count;
+    robusto_proxy_client_pending_t pending[ROBUSTO_PROXY_MAX_INFLIGHT_REQUESTS];
+    robusto_proxy_client_lock lock;
+    robusto_proxy_client_lock unlock;
+    void *lock_context;
 } robusto_proxy_client_t;
 
 /** Initializes a proxy client instance from config. */
@@ -130,6 +172,39 @@ rob_ret_val_t robusto_proxy_client_request(
 
 uint64_t robusto_proxy_client_take_operation_id(robusto_proxy_client_t *client);
 
+/**
+ * Sends a request without waiting for its response.
+ *
+ * Up to the negotiated in-flight capacity may be outstanding, and responses
+ * may arrive in any order. completion is called when the response is handed
+ * to robusto_proxy_client_dispatch, or when it has timed out in
+ * robusto_proxy_client_expire, but not if this returns an error.
+ * Submitted requests are not retried.
+ */
+rob_ret_val_t robusto_proxy_client_submit(
+    robusto_proxy_client_t *client,
+    uint8_t domain,
+    uint8_t opcode,
+    const uint8_t *payload,
+    size_t payload_size,
+    bool mutation,
+    robusto_proxy_client_completion completion,
+    void *completion_context);
+
+/**
+ * Completes the submitted request that a response frame answers.
+ *
+ * Returns false if the frame does not answer a submitted request, for example
+ * when it is the response of robusto_proxy_client_request.
+ */
+bool robusto_proxy_client_dispatch(
+    robusto_proxy_client_t *client,
+    const uint8_t *frame,
+    size_t frame_size);
+
+/** Completes submitted requests that have timed out, returns how many. */
+uint16_t robusto_proxy_client_expire(robusto_proxy_client_t *client);
+
 #ifdef __cplusplus
 }
 #endif
\ No newline at end of file
@@ -8,6 +8,8 @@ extern "C" {
 #endif
 
 uint32_t robusto_proxy_crc32_iso_hdlc(const uint8_t *data, size_t length);
+/* Continues a CRC over the next part of the data, start with 0 and pass the previous result */
+uint32_t robusto_proxy_crc32_iso_hdlc_update(uint32_t crc, const uint8_t *data, size_t length);
 
 #ifdef __cplusplus
 }
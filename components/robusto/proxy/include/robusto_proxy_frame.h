@@ -27,6 +27,12 @@ robusto_proxy_result_t robusto_proxy_frame_validate_buffer(
     size_t length,
     uint32_t *out_crc);
 
+/**
+ * Encodes a frame into buffer.
+ *
+ * The payload may already be in place at buffer + ROBUSTO_PROXY_HEADER_SIZE_BYTES,
+ * then only the header and CRC are written.
+ */
 robusto_proxy_result_t robusto_proxy_frame_encode(
     uint8_t *buffer,
     size_t buffer_size,
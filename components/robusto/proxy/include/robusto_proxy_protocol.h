@@ -49,10 +49,15 @@ extern "C" {
 #define ROBUSTO_PROXY_PUBSUB_OPCODE_DELIVERY_BEGIN 0x81U
 #define ROBUSTO_PROXY_PUBSUB_OPCODE_DELIVERY_CHUNK 0x82U
 #define ROBUSTO_PROXY_PUBSUB_OPCODE_DELIVERY_COMMIT 0x83U
+#define ROBUSTO_PROXY_PUBSUB_OPCODE_DELIVERY_BATCH 0x84U
 
 #define ROBUSTO_PROXY_FEATURE_PUBSUB_V1 0x0000000000000001ULL
 #define ROBUSTO_PROXY_FEATURE_PUBSUB_CHUNKED_PUBLISH 0x0000000000000002ULL
 #define ROBUSTO_PROXY_FEATURE_PUBSUB_CHUNKED_DELIVERY 0x0000000000000004ULL
+/** PUBLISH_CHUNK responses acknowledge the bytes received so far, so chunks can be sent in a window. */
+#define ROBUSTO_PROXY_FEATURE_PUBSUB_WINDOWED_PUBLISH 0x0000000000000008ULL
+/** Several inline deliveries may share one DELIVERY_BATCH event frame. */
+#define ROBUSTO_PROXY_FEATURE_PUBSUB_DELIVERY_BATCH 0x0000000000000010ULL
 
 #define ROBUSTO_PROXY_STATUS_OK 0x0000U
 #define ROBUSTO_PROXY_STATUS_INTERNAL 0x0001U
@@ -22,6 +22,7 @@ extern "C" {
 #define ROBUSTO_PROXY_PUBSUB_SUBSCRIBE_HEADER_SIZE_BYTES 12U
 #define ROBUSTO_PROXY_PUBSUB_UNSUBSCRIBE_REQUEST_SIZE_BYTES 12U
 #define ROBUSTO_PROXY_PUBSUB_PUBLISH_RESPONSE_SIZE_BYTES 8U
+#define ROBUSTO_PROXY_PUBSUB_PUBLISH_CHUNK_RESPONSE_SIZE_BYTES 4U
 #define ROBUSTO_PROXY_PUBSUB_SUBSCRIBE_RESPONSE_SIZE_BYTES 12U
 #define ROBUSTO_PROXY_PUBSUB_UNSUBSCRIBE_RESPONSE_SIZE_BYTES 4U
 #define ROBUSTO_PROXY_PUBSUB_STATUS_RESPONSE_SIZE_BYTES 52U
@@ -29,6 +30,7 @@ extern "C" {
 #define ROBUSTO_PROXY_PUBSUB_DELIVERY_BEGIN_SIZE_BYTES 12U
 #define ROBUSTO_PROXY_PUBSUB_DELIVERY_CHUNK_HEADER_SIZE_BYTES 16U
 #define ROBUSTO_PROXY_PUBSUB_DELIVERY_COMMIT_SIZE_BYTES 8U
+#define ROBUSTO_PROXY_PUBSUB_DELIVERY_BATCH_HEADER_SIZE_BYTES 4U
 #define ROBUSTO_PROXY_PUBSUB_MAX_DELIVERY_CHUNK_DATA_BYTES \
     (ROBUSTO_PROXY_MAX_PAYLOAD_BYTES - ROBUSTO_PROXY_PUBSUB_DELIVERY_CHUNK_HEADER_SIZE_BYTES)
 
@@ -75,6 +77,12 @@ typedef struct robusto_proxy_pubsub_publish_response {
     uint32_t delivery_count;
 } robusto_proxy_pubsub_publish_response_t;
 
+/** Response to PUBLISH_CHUNK when PUBSUB_WINDOWED_PUBLISH is negotiated. */
+typedef struct robusto_proxy_pubsub_publish_chunk_response {
+    /** Bytes of the transfer received without gaps, the offset to continue from. */
+    uint32_t received;
+} robusto_proxy_pubsub_publish_chunk_response_t;
+
 typedef struct robusto_proxy_pubsub_subscribe_response {
     uint32_t subscription_id;
     uint32_t topic_hash;
@@ -173,6 +181,12 @@ robusto_proxy_result_t robusto_proxy_pubsub_encode_publish_response(
 robusto_proxy_result_t robusto_proxy_pubsub_decode_publish_response(
     const uint8_t *buffer, size_t buffer_size,
     robusto_proxy_pubsub_publish_response_t *response);
+robusto_proxy_result_t robusto_proxy_pubsub_encode_publish_chunk_response(
+    uint8_t *buffer, size_t buffer_size,
+    const robusto_proxy_pubsub_publish_chunk_response_t *response);
+robusto_proxy_result_t robusto_proxy_pubsub_decode_publish_chunk_response(
+    const uint8_t *buffer, size_t buffer_size,
+    robusto_proxy_pubsub_publish_chunk_response_t *response);
 robusto_proxy_result_t robusto_proxy_pubsub_encode_subscribe_response(
     uint8_t *buffer, size_t buffer_size,
     const robusto_proxy_pubsub_subscribe_response_t *response);
@@ -215,6 +229,19 @@ robusto_proxy_result_t robusto_proxy_pubsub_encode_delivery_commit(
 robusto_proxy_result_t robusto_proxy_pubsub_decode_delivery_commit(
     const uint8_t *buffer, size_t buffer_size,
     robusto_proxy_pubsub_delivery_commit_t *commit);
+/**
+ * A DELIVERY_BATCH payload is a count followed by that many DELIVERY payloads back to back.
+ * The header is written once the entries are in place, the entries with encode_delivery.
+ */
+robusto_proxy_result_t robusto_proxy_pubsub_encode_delivery_batch_header(
+    uint8_t *buffer, size_t buffer_size, uint16_t count);
+/** Validates every entry of a batch, so that the entries can then be read without failing. */
+robusto_proxy_result_t robusto_proxy_pubsub_decode_delivery_batch(
+    const uint8_t *buffer, size_t buffer_size, uint16_t *count);
+/** Reads the entry at *offset (start at zero) of a validated batch and advances *offset past it. */
+robusto_proxy_result_t robusto_proxy_pubsub_decode_delivery_batch_entry(
+    const uint8_t *buffer, size_t buffer_size, size_t *offset,
+    robusto_proxy_pubsub_delivery_t *delivery);
 
 #ifdef __cplusplus
 }
@@ -47,6 +47,11 @@ typedef struct robusto_proxy_pubsub_subscription {
     char topic[ROBUSTO_PROXY_PUBSUB_MAX_TOPIC_BYTES + 1U];
 } robusto_proxy_pubsub_subscription_t;
 
+/**
+ * A queued delivery. Small data is kept in the event pool, a byte ring, at pool_offset.
+ * Large data is in transfer_data, a reference counted buffer shared by the deliveries
+ * of all subscriptions the data was published to.
+ */
 typedef struct robusto_proxy_pubsub_event_descriptor {
     uint32_t subscription_id;
     uint32_t delivery_sequence;
@@ -76,6 +81,7 @@ typedef struct robusto_proxy_pubsub_server_adapter {
     uint8_t event_count;
     uint8_t pending_delivery_opcode;
     uint32_t pending_delivery_chunk_length;
+    uint8_t pending_delivery_count;
     bool delivery_pending;
     uint8_t *publish_data;
     uint64_t publish_operation_id;
@@ -85,7 +91,9 @@ typedef struct robusto_proxy_pubsub_server_adapter {
     char publish_topic[ROBUSTO_PROXY_PUBSUB_MAX_TOPIC_BYTES + 1U];
     uint8_t *publish_dispatch_data;
     uint32_t publish_dispatch_data_length;
-    bool publish_dispatch_transferred;
+    /* The large delivery data queued last and where it was copied from, reused for more subscriptions */
+    uint8_t *shared_data;
+    const uint8_t *shared_source;
     uint32_t publish_requests;
     uint32_t subscribe_requests;
     uint32_t unsubscribe_requests;
@@ -122,6 +130,21 @@ bool robusto_proxy_pubsub_server_adapter_take_delivery(
     size_t payload_buffer_size,
     size_t *payload_size);
 
+/**
+ * Takes up to max_events queued inline deliveries into one DELIVERY_BATCH payload.
+ * Returns false, leaving the queue to take_delivery, unless at least two of them fit.
+ */
+bool robusto_proxy_pubsub_server_adapter_take_delivery_batch(
+    robusto_proxy_pubsub_server_adapter_t *adapter,
+    uint8_t max_events,
+    uint8_t *payload_buffer,
+    size_t payload_buffer_size,
+    size_t *payload_size);
+
+/** The number of queued delivery events, for deciding whether to wait for more to batch. */
+uint8_t robusto_proxy_pubsub_server_adapter_pending_deliveries(
+    robusto_proxy_pubsub_server_adapter_t *adapter);
+
 bool robusto_proxy_pubsub_server_adapter_complete_delivery(
     robusto_proxy_pubsub_server_adapter_t *adapter,
     bool sent);
@@ -33,6 +33,8 @@ typedef struct robusto_proxy_pubsub_adapter {
                                robusto_proxy_pubsub_publish_response_t *response);
     uint16_t (*publish_abort)(void *context,
                               const robusto_proxy_pubsub_publish_transfer_request_t *request);
+    /** Optional, bytes of a chunked publish received without gaps. Enables windowed publish. */
+    uint16_t (*publish_progress)(void *context, uint64_t operation_id, uint32_t *received);
     uint16_t (*session_reset)(void *context);
     uint16_t (*subscribe)(void *context,
                           const robusto_proxy_pubsub_subscribe_request_t *request,
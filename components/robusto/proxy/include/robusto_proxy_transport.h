@@ -25,6 +25,17 @@ typedef rob_ret_val_t (*robusto_proxy_transport_exchange)(
     uint32_t timeout_ms,
     robusto_proxy_transfer_acceptance_t *acceptance);
 
+/**
+ * Sends a request frame without waiting for its response, which the transport
+ * hands to robusto_proxy_client_dispatch when it arrives.
+ */
+typedef rob_ret_val_t (*robusto_proxy_transport_send)(
+    void *context,
+    const uint8_t *request,
+    size_t request_size,
+    uint32_t timeout_ms,
+    robusto_proxy_transfer_acceptance_t *acceptance);
+
 #ifdef __cplusplus
 }
 #endif
\ No newline at end of file
@@ -35,6 +35,22 @@ static uint64_t nonzero_u64(uint64_t value)
     return value == 0U ? 1U : value;
 }
 
+static void client_lock(robusto_proxy_client_t *client)
+{
+    if (client->lock != NULL)
+    {
+        client->lock(client->lock_context);
+    }
+}
+
+static void client_unlock(robusto_proxy_client_t *client)
+{
+    if (client->unlock != NULL)
+    {
+        client->unlock(client->lock_context);
+    }
+}
+
 static uint8_t maximum_retries(uint8_t domain, uint8_t opcode, bool mutation)
 {
     if (mutation)
@@ -137,7 +153,11 @@ rob_ret_val_t robusto_proxy_client_init(
         config->retry_jitter_ms == NULL || config->request_frame == NULL ||
         config->request_frame_size < ROBUSTO_PROXY_SLOT_SIZE_BYTES ||
         config->response_frame == NULL ||
-        config->response_frame_size < ROBUSTO_PROXY_SLOT_SIZE_BYTES)
+        config->response_frame_size < ROBUSTO_PROXY_SLOT_SIZE_BYTES ||
+        (config->send != NULL &&
+         (config->pipeline_frames == NULL || config->pipeline_frame_count == 0U ||
+          config->pipeline_frame_size < ROBUSTO_PROXY_SLOT_SIZE_BYTES)) ||
+        ((config->lock == NULL) != (config->unlock == NULL)))
     {
         return ROB_ERR_INVALID_ARG;
     }
@@ -161,6 +181,16 @@ rob_ret_val_t robusto_proxy_client_init(
     client->response_frame_size = config->response_frame_size;
     client->next_operation_id = nonzero_u64(config->operation_seed);
     client->request_timeout_ms = config->request_timeout_ms;
+    client->send = config->send;
+    client->pipeline_frames = config->pipeline_frames;
+    client->pipeline_frame_size = config->pipeline_frame_size;
+    client->pipeline_frame_count =
+        config->pipeline_frame_count < ROBUSTO_PROXY_MAX_INFLIGHT_REQUESTS
+            ? config->pipeline_frame_count
+            : ROBUSTO_PROXY_MAX_INFLIGHT_REQUESTS;
+    client->lock = config->lock;
+    client->unlock = config->unlock;
+    client->lock_context = config->lock_context;
     return ROB_OK;
 }
 
@@ -220,6 +250,7 @@ rob_ret_val_t robusto_proxy_client_request(
     client->last_status = 0U;
     client->last_result_flags = 0U;
     client->last_retry_after_ms = 0U;
+    client_lock(client);
     correlation_id = robusto_proxy_session_take_correlation_id(&client->session);
     sequence = robusto_proxy_session_take_sequence(&client->session);
     now_ms = client->now_ms(client->clock_context);
@@ -228,8 +259,10 @@ rob_ret_val_t robusto_proxy_client_request(
                                      client->request_timeout_ms,
                                      client->session.peer_boot_id) != ROBUSTO_PROXY_RESULT_OK)
     {
+        client_unlock(client);
         return ROB_ERR_CONV_LIST_FULL;
     }
+    client_unlock(client);
     retry_limit = maximum_retries(domain, opcode, mutation);
     for (attempt = 0U; attempt <= retry_limit; ++attempt)
     {
@@ -237,6 +270,7 @@ rob_ret_val_t robusto_proxy_client_request(
             ROBUSTO_PROXY_TRANSFER_NOT_ACCEPTED;
         uint8_t flags = ROBUSTO_PROXY_FLAG_REQUEST;
 
+        client_lock(client);
         if (attempt > 0U)
         {
             sequence = robusto_proxy_session_take_sequence(&client->session);
@@ -246,11 +280,13 @@ rob_ret_val_t robusto_proxy_client_request(
         inflight_entry = robusto_proxy_inflight_find(&client->inflight, correlation_id);
         if (inflight_entry == NULL)
         {
+            client_unlock(client);
             result = ROB_FAIL;
             break;
         }
         inflight_entry->sequence = sequence;
         inflight_entry->started_at_ms = now_ms;
+        client_unlock(client);
         robusto_proxy_frame_header_init(&request_header, flags, domain, opcode,
                                         correlation_id, sequence,
                                         (uint32_t)payload_size);
@@ -347,10 +383,239 @@ rob_ret_val_t robusto_proxy_client_request(
         result = ROB_OK;
         break;
     }
+    client_lock(client);
     (void)robusto_proxy_inflight_complete(&client->inflight, correlation_id);
+    client_unlock(client);
     return result;
 }
 
+rob_ret_val_t robusto_proxy_client_submit(
+    robusto_proxy_client_t *client,
+    uint8_t domain,
+    uint8_t opcode,
+    const uint8_t *payload,
+    size_t payload_size,
+    bool mutation,
+    robusto_proxy_client_completion completion,
+    void *completion_context)
+{
+    robusto_proxy_frame_header_t request_header;
+    robusto_proxy_client_pending_t *pending = NULL;
+    robusto_proxy_transfer_acceptance_t acceptance =
+        ROBUSTO_PROXY_TRANSFER_NOT_ACCEPTED;
+    uint8_t *frame;
+    uint32_t correlation_id;
+    uint32_t sequence;
+    size_t request_size;
+    uint16_t index;
+    rob_ret_val_t result;
+
+    if (client == NULL || completion == NULL ||
+        (payload_size > 0U && payload == NULL) ||
+        payload_size > ROBUSTO_PROXY_MAX_PAYLOAD_BYTES)
+    {
+        return ROB_ERR_INVALID_ARG;
+    }
+    if (client->send == NULL)
+    {
+        return ROB_ERR_NOT_SUPPORTED;
+    }
+    client_lock(client);
+    if (client->session.state != ROBUSTO_PROXY_SESSION_ESTABLISHED)
+    {
+        client_unlock(client);
+        return ROB_ERR_NOT_READY;
+    }
+    for (index = 0U; index < client->pipeline_frame_count; ++index)
+    {
+        if (!client->pending[index].active)
+        {
+            pending = &client->pending[index];
+            break;
+        }
+    }
+    if (pending == NULL)
+    {
+        client_unlock(client);
+        return ROB_ERR_CONV_LIST_FULL;
+    }
+    correlation_id = robusto_proxy_session_take_correlation_id(&client->session);
+    sequence = robusto_proxy_session_take_sequence(&client->session);
+    if (robusto_proxy_inflight_begin(&client->inflight, domain, opcode,
+                                     correlation_id, sequence,
+                                     client->now_ms(client->clock_context),
+                                     client->request_timeout_ms,
+                                     client->session.peer_boot_id) != ROBUSTO_PROXY_RESULT_OK)
+    {
+        client_unlock(client);
+        return ROB_ERR_CONV_LIST_FULL;
+    }
+    frame = client->pipeline_frames + index * client->pipeline_frame_size;
+    robusto_proxy_frame_header_init(&request_header, ROBUSTO_PROXY_FLAG_REQUEST,
+                                    domain, opcode, correlation_id, sequence,
+                                    (uint32_t)payload_size);
+    if (robusto_proxy_frame_encode(frame, client->pipeline_frame_size,
+                                   &request_header, payload,
+                                   &request_size) != ROBUSTO_PROXY_RESULT_OK)
+    {
+        (void)robusto_proxy_inflight_complete(&client->inflight, correlation_id);
+        client_unlock(client);
+        return ROB_ERR_INVALID_ARG;
+    }
+    pending->completion = completion;
+    pending->completion_context = completion_context;
+    pending->correlation_id = correlation_id;
+    pending->domain = domain;
+    pending->opcode = opcode;
+    pending->mutation = mutation;
+    pending->active = true;
+    client_unlock(client);
+
+    // The frame is owned by the pending request, so other requests can be sent meanwhile
+    result = client->send(client->transport_context, frame, request_size,
+                          client->request_timeout_ms, &acceptance);
+    if (result == ROB_OK)
+    {
+        return ROB_OK;
+    }
+    client_lock(client);
+    if (pending->active && pending->correlation_id == correlation_id)
+    {
+        pending->active = false;
+        (void)robusto_proxy_inflight_complete(&client->inflight, correlation_id);
+        client_unlock(client);
+        return mutation && acceptance != ROBUSTO_PROXY_TRANSFER_NOT_ACCEPTED
+                   ? ROB_ERR_OUTCOME_UNKNOWN
+                   : result;
+    }
+    // A response arrived even though sending failed, the completion has been called
+    client_unlock(client);
+    return ROB_OK;
+}
+
+bool robusto_proxy_client_dispatch(
+    robusto_proxy_client_t *client,
+    const uint8_t *frame,
+    size_t frame_size)
+{
+    const robusto_proxy_frame_header_t *header;
+    robusto_proxy_response_prefix_t prefix;
+    robusto_proxy_client_completion completion;
+    void *completion_context;
+    const uint8_t *payload = NULL;
+    size_t payload_size = 0U;
+    rob_ret_val_t result;
+    uint16_t index;
+    bool mutation;
+
+    if (client == NULL || frame == NULL ||
+        robusto_proxy_frame_validate_buffer(frame, frame_size, NULL) !=
+            ROBUSTO_PROXY_RESULT_OK)
+    {
+        return false;
+    }
+    header = (const robusto_proxy_frame_header_t *)frame;
+    if (header->flags != ROBUSTO_PROXY_FLAG_RESPONSE ||
+        frame_size != robusto_proxy_frame_size_bytes(header->payload_length))
+    {
+        return false;
+    }
+    client_lock(client);
+    for (index = 0U; index < client->pipeline_frame_count; ++index)
+    {
+        if (client->pending[index].active &&
+            client->pending[index].correlation_id == header->correlation_id &&
+            client->pending[index].domain == header->domain &&
+            client->pending[index].opcode == header->opcode)
+        {
+            break;
+        }
+    }
+    if (index == client->pipeline_frame_count)
+    {
+        client_unlock(client);
+        return false;
+    }
+    completion = client->pending[index].completion;
+    completion_context = client->pending[index].completion_context;
+    mutation = client->pending[index].mutation;
+    client->pending[index].active = false;
+    (void)robusto_proxy_inflight_complete(&client->inflight, header->correlation_id);
+    client_unlock(client);
+
+    if (robusto_proxy_decode_response_prefix(
+            frame + ROBUSTO_PROXY_HEADER_SIZE_BYTES, header->payload_length,
+            &prefix) != ROBUSTO_PROXY_RESULT_OK)
+    {
+        result = mutation ? ROB_ERR_OUTCOME_UNKNOWN : ROB_ERR_PARSING_FAILED;
+    }
+    else if (!robusto_proxy_response_prefix_is_success(&prefix))
+    {
+        result = robusto_proxy_status_to_robusto(prefix.status);
+    }
+    else
+    {
+        payload = frame + ROBUSTO_PROXY_HEADER_SIZE_BYTES +
+                  ROBUSTO_PROXY_RESPONSE_PREFIX_SIZE_BYTES + prefix.detail_length;
+        payload_size = header->payload_length -
+                       ROBUSTO_PROXY_RESPONSE_PREFIX_SIZE_BYTES -
+                       prefix.detail_length;
+        result = ROB_OK;
+    }
+    completion(completion_context, result, payload, payload_size);
+    return true;
+}
+
+/* Ends the submitted requests that match, and calls their completions with result */
+static uint16_t end_pending(robusto_proxy_client_t *client, bool only_expired,
+                            rob_ret_val_t result)
+{
+    robusto_proxy_client_pending_t ended[ROBUSTO_PROXY_MAX_INFLIGHT_REQUESTS];
+    robusto_proxy_inflight_entry_t *entry;
+    uint32_t now_ms = client->now_ms(client->clock_context);
+    uint16_t count = 0U;
+    uint16_t index;
+
+    client_lock(client);
+    for (index = 0U; index < client->pipeline_frame_count; ++index)
+    {
+        robusto_proxy_client_pending_t *pending = &client->pending[index];
+
+        if (!pending->active)
+        {
+            continue;
+        }
+        entry = robusto_proxy_inflight_find(&client->inflight, pending->correlation_id);
+        if (only_expired && entry != NULL &&
+            !robusto_proxy_inflight_is_expired(entry, now_ms))
+        {
+            continue;
+        }
+        ended[count++] = *pending;
+        pending->active = false;
+        (void)robusto_proxy_inflight_complete(&client->inflight, pending->correlation_id);
+    }
+    client_unlock(client);
+    for (index = 0U; index < count; ++index)
+    {
+        ended[index].completion(
+            ended[index].completion_context,
+            ended[index].mutation && result == ROB_ERR_TIMEOUT ? ROB_ERR_OUTCOME_UNKNOWN
+                                                               : result,
+            NULL, 0U);
+    }
+    return count;
+}
+
+uint16_t robusto_proxy_client_expire(robusto_proxy_client_t *client)
+{
+    if (client == NULL)
+    {
+        return 0U;
+    }
+    return end_pending(client, true, ROB_ERR_TIMEOUT);
+}
+
 rob_ret_val_t robusto_proxy_client_connect(robusto_proxy_client_t *client)
 {
     robusto_proxy_hello_request_t request;
@@ -382,7 +647,13 @@ rob_ret_val_t robusto_proxy_client_connect(robusto_proxy_client_t *client)
     request.max_in_flight = client->session.local_limits.max_in_flight;
     request.required_features = ROBUSTO_PROXY_FEATURE_PUBSUB_V1;
     request.optional_features = ROBUSTO_PROXY_FEATURE_PUBSUB_CHUNKED_PUBLISH |
-                                ROBUSTO_PROXY_FEATURE_PUBSUB_CHUNKED_DELIVERY;
+                                ROBUSTO_PROXY_FEATURE_PUBSUB_CHUNKED_DELIVERY |
+                                ROBUSTO_PROXY_FEATURE_PUBSUB_DELIVERY_BATCH;
+    if (client->send != NULL)
+    {
+        // Chunks can only be sent in a window if requests can be submitted without waiting
+        request.optional_features |= ROBUSTO_PROXY_FEATURE_PUBSUB_WINDOWED_PUBLISH;
+    }
     if (robusto_proxy_encode_hello_request(client->response_frame,
                                            client->response_frame_size,
                                            &request) != ROBUSTO_PROXY_RESULT_OK)
@@ -390,6 +661,8 @@ rob_ret_val_t robusto_proxy_client_connect(robusto_proxy_client_t *client)
         return ROB_FAIL;
     }
 
+    // Responses to requests submitted in the previous session will not come
+    (void)end_pending(client, false, ROB_ERR_NOT_READY);
     client->session.state = ROBUSTO_PROXY_SESSION_NEGOTIATING;
     result = robusto_proxy_client_request(
         client, ROBUSTO_PROXY_DOMAIN_CONTROL, ROBUSTO_PROXY_OPCODE_HELLO,
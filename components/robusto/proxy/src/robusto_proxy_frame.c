@@ -219,7 +219,6 @@ robusto_proxy_result_t robusto_proxy_frame_encode(
         return ROBUSTO_PROXY_RESULT_BAD_LENGTH;
     }
 
-    memset(buffer, 0, required_size);
     buffer[0] = header->magic[0];
     buffer[1] = header->magic[1];
     buffer[2] = header->protocol_major;
@@ -231,7 +230,8 @@ robusto_proxy_result_t robusto_proxy_frame_encode(
     write_le32(buffer + 8U, header->correlation_id);
     write_le32(buffer + 12U, header->sequence);
     write_le32(buffer + 16U, header->payload_length);
-    if (header->payload_length > 0U)
+    // A payload built in place in the frame is not copied
+    if (header->payload_length > 0U && payload != buffer + ROBUSTO_PROXY_HEADER_SIZE_BYTES)
     {
         memcpy(buffer + ROBUSTO_PROXY_HEADER_SIZE_BYTES, payload, header->payload_length);
     }
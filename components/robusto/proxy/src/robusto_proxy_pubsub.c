@@ -437,6 +437,30 @@ robusto_proxy_result_t robusto_proxy_pubsub_decode_publish_response(
     return ROBUSTO_PROXY_RESULT_OK;
 }
 
+robusto_proxy_result_t robusto_proxy_pubsub_encode_publish_chunk_response(
+    uint8_t *buffer, size_t buffer_size,
+    const robusto_proxy_pubsub_publish_chunk_response_t *response)
+{
+    if (buffer == NULL || response == NULL || buffer_size < ROBUSTO_PROXY_PUBSUB_PUBLISH_CHUNK_RESPONSE_SIZE_BYTES)
+    {
+        return ROBUSTO_PROXY_RESULT_INVALID_ARGUMENT;
+    }
+    write_le32(buffer, response->received);
+    return ROBUSTO_PROXY_RESULT_OK;
+}
+
+robusto_proxy_result_t robusto_proxy_pubsub_decode_publish_chunk_response(
+    const uint8_t *buffer, size_t buffer_size,
+    robusto_proxy_pubsub_publish_chunk_response_t *response)
+{
+    if (buffer == NULL || response == NULL || buffer_size != ROBUSTO_PROXY_PUBSUB_PUBLISH_CHUNK_RESPONSE_SIZE_BYTES)
+    {
+        return ROBUSTO_PROXY_RESULT_BAD_LENGTH;
+    }
+    response->received = read_le32(buffer);
+    return ROBUSTO_PROXY_RESULT_OK;
+}
+
 robusto_proxy_result_t robusto_proxy_pubsub_encode_subscribe_response(
     uint8_t *buffer, size_t buffer_size,
     const robusto_proxy_pubsub_subscribe_response_t *response)
@@ -583,7 +607,7 @@ robusto_proxy_result_t robusto_proxy_pubsub_encode_delivery(
     write_le32(buffer, delivery->subscription_id);
     write_le32(buffer + 4U, delivery->delivery_sequence);
     write_le32(buffer + 8U, delivery->data_length);
-    if (delivery->data_length > 0U)
+    if (delivery->data_length > 0U && delivery->data != buffer + 12U)
     {
         memcpy(buffer + 12U, delivery->data, delivery->data_length);
     }
@@ -737,3 +761,78 @@ robusto_proxy_result_t robusto_proxy_pubsub_decode_delivery_commit(
                ? ROBUSTO_PROXY_RESULT_OK
                : ROBUSTO_PROXY_RESULT_INVALID_ARGUMENT;
 }
+
+robusto_proxy_result_t robusto_proxy_pubsub_encode_delivery_batch_header(
+    uint8_t *buffer, size_t buffer_size, uint16_t count)
+{
+    if (buffer == NULL || count == 0U ||
+        buffer_size < ROBUSTO_PROXY_PUBSUB_DELIVERY_BATCH_HEADER_SIZE_BYTES)
+    {
+        return ROBUSTO_PROXY_RESULT_INVALID_ARGUMENT;
+    }
+    write_le16(buffer, count);
+    write_le16(buffer + 2U, 0U);
+    return ROBUSTO_PROXY_RESULT_OK;
+}
+
+robusto_proxy_result_t robusto_proxy_pubsub_decode_delivery_batch_entry(
+    const uint8_t *buffer, size_t buffer_size, size_t *offset,
+    robusto_proxy_pubsub_delivery_t *delivery)
+{
+    size_t entry_offset;
+    size_t entry_size;
+    robusto_proxy_result_t result;
+
+    if (buffer == NULL || offset == NULL || delivery == NULL)
+    {
+        return ROBUSTO_PROXY_RESULT_BAD_LENGTH;
+    }
+    entry_offset = *offset == 0U ? ROBUSTO_PROXY_PUBSUB_DELIVERY_BATCH_HEADER_SIZE_BYTES : *offset;
+    if (entry_offset > buffer_size ||
+        buffer_size - entry_offset < ROBUSTO_PROXY_PUBSUB_DELIVERY_HEADER_SIZE_BYTES)
+    {
+        return ROBUSTO_PROXY_RESULT_BAD_LENGTH;
+    }
+    entry_size = ROBUSTO_PROXY_PUBSUB_DELIVERY_HEADER_SIZE_BYTES +
+                 (size_t)read_le32(buffer + entry_offset + 8U);
+    if (entry_size > buffer_size - entry_offset)
+    {
+        return ROBUSTO_PROXY_RESULT_BAD_LENGTH;
+    }
+    result = robusto_proxy_pubsub_decode_delivery(buffer + entry_offset, entry_size, delivery);
+    if (result == ROBUSTO_PROXY_RESULT_OK)
+    {
+        *offset = entry_offset + entry_size;
+    }
+    return result;
+}
+
+robusto_proxy_result_t robusto_proxy_pubsub_decode_delivery_batch(
+    const uint8_t *buffer, size_t buffer_size, uint16_t *count)
+{
+    robusto_proxy_pubsub_delivery_t delivery;
+    robusto_proxy_result_t result;
+    size_t offset = 0U;
+    uint16_t index;
+
+    if (buffer == NULL || count == NULL ||
+        buffer_size < ROBUSTO_PROXY_PUBSUB_DELIVERY_BATCH_HEADER_SIZE_BYTES)
+    {
+        return ROBUSTO_PROXY_RESULT_BAD_LENGTH;
+    }
+    *count = read_le16(buffer);
+    if (*count == 0U || read_le16(buffer + 2U) != 0U)
+    {
+        return ROBUSTO_PROXY_RESULT_INVALID_ARGUMENT;
+    }
+    for (index = 0U; index < *count; ++index)
+    {
+        result = robusto_proxy_pubsub_decode_delivery_batch_entry(
+            buffer, buffer_size, &offset, &delivery);
+        if (result != ROBUSTO_PROXY_RESULT_OK)
+        {
+            return result;
+        }
+    }
+    return offset == buffer_size ? ROBUSTO_PROXY_RESULT_OK : ROBUSTO_PROXY_RESULT_BAD_LENGTH;
+}
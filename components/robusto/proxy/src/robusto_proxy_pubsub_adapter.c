@@ -1,5 +1,6 @@
 #include "robusto_proxy_pubsub_adapter.h"
 
+#include <stddef.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -7,25 +8,136 @@
 #include "esp_heap_caps.h"
 #endif
 
-static uint8_t *allocate_publish_data(uint32_t data_length)
+/* Large data with its reference count, deliveries and publish transfers point at data */
+typedef struct shared_data {
+    uint32_t references;
+    uint32_t length;
+    uint8_t data[];
+} shared_data_t;
+
+static shared_data_t *shared_of(uint8_t *data)
+{
+    return (shared_data_t *)(data - offsetof(shared_data_t, data));
+}
+
+static uint8_t *allocate_shared_data(uint32_t data_length, bool prefer_spiram)
 {
+    shared_data_t *shared;
+    size_t size = sizeof(shared_data_t) + data_length;
+
 #ifdef ESP_PLATFORM
-    return heap_caps_malloc_prefer(
-        data_length, 2U,
-        MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT,
-        MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    shared = prefer_spiram
+                 ? heap_caps_malloc_prefer(size, 2U,
+                                           MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT,
+                                           MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT)
+                 : heap_caps_malloc(size, MALLOC_CAP_8BIT);
 #else
-    return malloc(data_length);
+    (void)prefer_spiram;
+    shared = malloc(size);
 #endif
+    if (shared == NULL)
+    {
+        return NULL;
+    }
+    shared->references = 1U;
+    shared->length = data_length;
+    return shared->data;
+}
+
+static uint8_t *allocate_publish_data(uint32_t data_length)
+{
+    return allocate_shared_data(data_length, true);
 }
 
 static uint8_t *allocate_delivery_data(uint32_t data_length)
 {
-#ifdef ESP_PLATFORM
-    return heap_caps_malloc(data_length, MALLOC_CAP_8BIT);
-#else
-    return malloc(data_length);
-#endif
+    return allocate_shared_data(data_length, false);
+}
+
+static uint8_t *retain_shared_data(uint8_t *data)
+{
+    shared_of(data)->references += 1U;
+    return data;
+}
+
+/* Called with the adapter lock held */
+static void release_shared_data(robusto_proxy_pubsub_server_adapter_t *adapter, uint8_t *data)
+{
+    shared_data_t *shared;
+
+    if (data == NULL)
+    {
+        return;
+    }
+    shared = shared_of(data);
+    shared->references -= 1U;
+    if (shared->references == 0U)
+    {
+        if (adapter->shared_data == data)
+        {
+            adapter->shared_data = NULL;
+            adapter->shared_source = NULL;
+        }
+        free(shared);
+    }
+}
+
+static void event_pool_write(robusto_proxy_pubsub_server_adapter_t *adapter,
+                             const uint8_t *data, uint32_t data_length)
+{
+    uint32_t first_length = adapter->event_pool_capacity - adapter->event_pool_write;
+
+    if (data_length == 0U)
+    {
+        return;
+    }
+    if (first_length > data_length)
+    {
+        first_length = data_length;
+    }
+    memcpy(adapter->event_pool + adapter->event_pool_write, data, first_length);
+    memcpy(adapter->event_pool, data + first_length, data_length - first_length);
+    adapter->event_pool_write = (adapter->event_pool_write + data_length) %
+                                adapter->event_pool_capacity;
+    adapter->event_pool_used += data_length;
+}
+
+static void event_pool_copy(const robusto_proxy_pubsub_server_adapter_t *adapter,
+                            uint32_t pool_offset, uint8_t *destination, uint32_t data_length)
+{
+    uint32_t first_length = adapter->event_pool_capacity - pool_offset;
+
+    if (data_length == 0U)
+    {
+        return;
+    }
+    if (first_length > data_length)
+    {
+        first_length = data_length;
+    }
+    memcpy(destination, adapter->event_pool + pool_offset, first_length);
+    memcpy(destination + first_length, adapter->event_pool, data_length - first_length);
+}
+
+/* Releases the data of the oldest event and removes it, called with the adapter lock held */
+static void release_oldest_event(robusto_proxy_pubsub_server_adapter_t *adapter)
+{
+    robusto_proxy_pubsub_event_descriptor_t *event = &adapter->events[adapter->event_read_index];
+
+    if (event->transfer_data != NULL)
+    {
+        release_shared_data(adapter, event->transfer_data);
+    }
+    else
+    {
+        adapter->event_pool_read = (adapter->event_pool_read + event->data_length) %
+                                   adapter->event_pool_capacity;
+        adapter->event_pool_used -= event->data_length;
+    }
+    memset(event, 0, sizeof(*event));
+    adapter->event_read_index = (uint8_t)((adapter->event_read_index + 1U) %
+                                          ROBUSTO_PROXY_PUBSUB_EVENT_DESCRIPTOR_LIMIT);
+    adapter->event_count -= 1U;
 }
 
 static bool adapter_take(robusto_proxy_pubsub_server_adapter_t *adapter)
@@ -152,11 +264,16 @@ static uint16_t queue_delivery(void *context, const uint8_t *data, uint32_t data
     if (data_length > ROBUSTO_PROXY_PUBSUB_MAX_DELIVERY_DATA_BYTES)
     {
         if (data == adapter->publish_dispatch_data &&
-            data_length == adapter->publish_dispatch_data_length &&
-            !adapter->publish_dispatch_transferred)
+            data_length == adapter->publish_dispatch_data_length)
+        {
+            event->transfer_data = retain_shared_data(adapter->publish_dispatch_data);
+        }
+        else if (data == adapter->shared_source && adapter->shared_data != NULL &&
+                 shared_of(adapter->shared_data)->length == data_length &&
+                 memcmp(adapter->shared_data, data, data_length) == 0)
         {
-            event->transfer_data = adapter->publish_dispatch_data;
-            adapter->publish_dispatch_transferred = true;
+            // Another subscription to what was just published, deliver the same copy
+            event->transfer_data = retain_shared_data(adapter->shared_data);
         }
         else
         {
@@ -168,18 +285,14 @@ static uint16_t queue_delivery(void *context, const uint8_t *data, uint32_t data
                 return ROBUSTO_PROXY_STATUS_OK;
             }
             memcpy(event->transfer_data, data, data_length);
+            adapter->shared_data = event->transfer_data;
+            adapter->shared_source = data;
         }
     }
     else
     {
         event->pool_offset = adapter->event_pool_write;
-        for (uint32_t index = 0U; index < data_length; ++index)
-        {
-            adapter->event_pool[adapter->event_pool_write] = data[index];
-            adapter->event_pool_write =
-                (adapter->event_pool_write + 1U) % adapter->event_pool_capacity;
-        }
-        adapter->event_pool_used += data_length;
+        event_pool_write(adapter, data, data_length);
     }
     adapter->event_write_index = (uint8_t)((adapter->event_write_index + 1U) %
                                            ROBUSTO_PROXY_PUBSUB_EVENT_DESCRIPTOR_LIMIT);
@@ -220,7 +333,7 @@ static uint16_t adapter_publish(void *context,
 
 static void release_publish_transfer(robusto_proxy_pubsub_server_adapter_t *adapter)
 {
-    free(adapter->publish_data);
+    release_shared_data(adapter, adapter->publish_data);
     adapter->publish_data = NULL;
     adapter->publish_operation_id = 0U;
     adapter->publish_data_length = 0U;
@@ -300,6 +413,30 @@ static uint16_t adapter_publish_chunk(
     return ROBUSTO_PROXY_STATUS_OK;
 }
 
+static uint16_t adapter_publish_progress(
+    void *context, uint64_t operation_id, uint32_t *received)
+{
+    robusto_proxy_pubsub_server_adapter_t *adapter = context;
+
+    if (adapter == NULL || received == NULL || operation_id == 0U)
+    {
+        return ROBUSTO_PROXY_STATUS_INVALID_ARGUMENT;
+    }
+    if (!adapter_take(adapter))
+    {
+        return ROBUSTO_PROXY_STATUS_BUSY;
+    }
+    if (adapter->publish_data == NULL ||
+        adapter->publish_operation_id != operation_id)
+    {
+        adapter_give(adapter);
+        return ROBUSTO_PROXY_STATUS_CONFLICT;
+    }
+    *received = adapter->publish_data_received;
+    adapter_give(adapter);
+    return ROBUSTO_PROXY_STATUS_OK;
+}
+
 static uint16_t adapter_publish_commit(
     void *context, const robusto_proxy_pubsub_publish_transfer_request_t *request,
     robusto_proxy_pubsub_publish_response_t *response)
@@ -344,7 +481,6 @@ static uint16_t adapter_publish_commit(
     adapter->publish_topic[0] = '\0';
     adapter->publish_dispatch_data = publish_data;
     adapter->publish_dispatch_data_length = publish_data_length;
-    adapter->publish_dispatch_transferred = false;
     adapter_give(adapter);
 
     memset(&publish_request, 0, sizeof(publish_request));
@@ -354,13 +490,13 @@ static uint16_t adapter_publish_commit(
     publish_request.data = publish_data;
     publish_request.data_length = publish_data_length;
     status = adapter_publish(adapter, &publish_request, response);
-    bool transferred = adapter->publish_dispatch_transferred;
-    adapter->publish_dispatch_data = NULL;
-    adapter->publish_dispatch_data_length = 0U;
-    adapter->publish_dispatch_transferred = false;
-    if (!transferred)
+    // Deliveries queued by the publish hold their own references to the data
+    if (adapter_take(adapter))
     {
-        free(publish_data);
+        adapter->publish_dispatch_data = NULL;
+        adapter->publish_dispatch_data_length = 0U;
+        release_shared_data(adapter, publish_data);
+        adapter_give(adapter);
     }
     return status;
 }
@@ -404,26 +540,11 @@ static uint16_t adapter_session_reset(void *context)
     release_publish_transfer(adapter);
     while (adapter->event_count > 0U)
     {
-        robusto_proxy_pubsub_event_descriptor_t *event =
-            &adapter->events[adapter->event_read_index];
-        if (event->transfer_data != NULL)
-        {
-            free(event->transfer_data);
-        }
-        else
-        {
-            adapter->event_pool_read =
-                (adapter->event_pool_read + event->data_length) %
-                adapter->event_pool_capacity;
-            adapter->event_pool_used -= event->data_length;
-        }
-        memset(event, 0, sizeof(*event));
-        adapter->event_read_index = (uint8_t)((adapter->event_read_index + 1U) %
-                                              ROBUSTO_PROXY_PUBSUB_EVENT_DESCRIPTOR_LIMIT);
-        adapter->event_count -= 1U;
+        release_oldest_event(adapter);
     }
     adapter->pending_delivery_opcode = 0U;
     adapter->pending_delivery_chunk_length = 0U;
+    adapter->pending_delivery_count = 0U;
     adapter->delivery_pending = false;
     adapter_give(adapter);
     return ROBUSTO_PROXY_STATUS_OK;
@@ -566,6 +687,7 @@ static const robusto_proxy_pubsub_adapter_t operations = {
     .publish_chunk = adapter_publish_chunk,
     .publish_commit = adapter_publish_commit,
     .publish_abort = adapter_publish_abort,
+    .publish_progress = adapter_publish_progress,
     .session_reset = adapter_session_reset,
     .subscribe = adapter_subscribe,
     .unsubscribe = adapter_unsubscribe,
@@ -645,19 +767,14 @@ bool robusto_proxy_pubsub_server_adapter_deinit(
     release_publish_transfer(adapter);
     while (adapter->event_count > 0U)
     {
-        robusto_proxy_pubsub_event_descriptor_t *event =
-            &adapter->events[adapter->event_read_index];
-        free(event->transfer_data);
-        memset(event, 0, sizeof(*event));
-        adapter->event_read_index = (uint8_t)((adapter->event_read_index + 1U) %
-                                              ROBUSTO_PROXY_PUBSUB_EVENT_DESCRIPTOR_LIMIT);
-        adapter->event_count -= 1U;
+        release_oldest_event(adapter);
     }
     adapter->event_pool_read = 0U;
     adapter->event_pool_write = 0U;
     adapter->event_pool_used = 0U;
     adapter->pending_delivery_opcode = 0U;
     adapter->pending_delivery_chunk_length = 0U;
+    adapter->pending_delivery_count = 0U;
     adapter->delivery_pending = false;
     adapter_give(adapter);
     return success;
@@ -695,12 +812,7 @@ bool robusto_proxy_pubsub_server_adapter_take_delivery(
     {
         if (!chunked_delivery_enabled)
         {
-            free(event.transfer_data);
-            memset(&adapter->events[adapter->event_read_index], 0,
-                   sizeof(adapter->events[adapter->event_read_index]));
-            adapter->event_read_index = (uint8_t)((adapter->event_read_index + 1U) %
-                                                  ROBUSTO_PROXY_PUBSUB_EVENT_DESCRIPTOR_LIMIT);
-            adapter->event_count -= 1U;
+            release_oldest_event(adapter);
             adapter->delivery_drops += 1U;
             adapter_give(adapter);
             return false;
@@ -779,11 +891,9 @@ bool robusto_proxy_pubsub_server_adapter_take_delivery(
         adapter_give(adapter);
         return false;
     }
-    for (uint32_t index = 0U; index < event.data_length; ++index)
-    {
-        payload_buffer[ROBUSTO_PROXY_PUBSUB_DELIVERY_HEADER_SIZE_BYTES + index] =
-            adapter->event_pool[(event.pool_offset + index) % adapter->event_pool_capacity];
-    }
+    event_pool_copy(adapter, event.pool_offset,
+                    payload_buffer + ROBUSTO_PROXY_PUBSUB_DELIVERY_HEADER_SIZE_BYTES,
+                    event.data_length);
     delivery.subscription_id = event.subscription_id;
     delivery.delivery_sequence = event.delivery_sequence;
     delivery.data_length = event.data_length;
@@ -802,6 +912,93 @@ bool robusto_proxy_pubsub_server_adapter_take_delivery(
     return true;
 }
 
+bool robusto_proxy_pubsub_server_adapter_take_delivery_batch(
+    robusto_proxy_pubsub_server_adapter_t *adapter,
+    uint8_t max_events,
+    uint8_t *payload_buffer,
+    size_t payload_buffer_size,
+    size_t *payload_size)
+{
+    robusto_proxy_pubsub_delivery_t delivery;
+    size_t offset = ROBUSTO_PROXY_PUBSUB_DELIVERY_BATCH_HEADER_SIZE_BYTES;
+    size_t entry_size;
+    uint8_t count = 0U;
+
+    if (adapter == NULL || payload_buffer == NULL || payload_size == NULL ||
+        !adapter_take(adapter))
+    {
+        return false;
+    }
+    if (adapter->delivery_pending)
+    {
+        adapter_give(adapter);
+        return false;
+    }
+    if (max_events > adapter->event_count)
+    {
+        max_events = adapter->event_count;
+    }
+    while (count < max_events)
+    {
+        const robusto_proxy_pubsub_event_descriptor_t *event =
+            &adapter->events[(adapter->event_read_index + count) %
+                             ROBUSTO_PROXY_PUBSUB_EVENT_DESCRIPTOR_LIMIT];
+        // Large deliveries are chunked on their own, the batch ends before one
+        if (event->transfer_data != NULL)
+        {
+            break;
+        }
+        entry_size = ROBUSTO_PROXY_PUBSUB_DELIVERY_HEADER_SIZE_BYTES + event->data_length;
+        if (entry_size > payload_buffer_size - offset)
+        {
+            break;
+        }
+        event_pool_copy(adapter, event->pool_offset,
+                        payload_buffer + offset + ROBUSTO_PROXY_PUBSUB_DELIVERY_HEADER_SIZE_BYTES,
+                        event->data_length);
+        delivery.subscription_id = event->subscription_id;
+        delivery.delivery_sequence = event->delivery_sequence;
+        delivery.data_length = event->data_length;
+        delivery.data = payload_buffer + offset + ROBUSTO_PROXY_PUBSUB_DELIVERY_HEADER_SIZE_BYTES;
+        if (robusto_proxy_pubsub_encode_delivery(payload_buffer + offset,
+                                                  payload_buffer_size - offset,
+                                                  &delivery, &entry_size) != ROBUSTO_PROXY_RESULT_OK)
+        {
+            break;
+        }
+        offset += entry_size;
+        count += 1U;
+    }
+    if (count < 2U ||
+        robusto_proxy_pubsub_encode_delivery_batch_header(
+            payload_buffer, payload_buffer_size, count) != ROBUSTO_PROXY_RESULT_OK)
+    {
+        adapter_give(adapter);
+        return false;
+    }
+    *payload_size = offset;
+    adapter->pending_delivery_opcode = ROBUSTO_PROXY_PUBSUB_OPCODE_DELIVERY_BATCH;
+    adapter->pending_delivery_chunk_length = 0U;
+    adapter->pending_delivery_count = count;
+    adapter->delivery_pending = true;
+    adapter_give(adapter);
+    return true;
+}
+
+uint8_t robusto_proxy_pubsub_server_adapter_pending_deliveries(
+    robusto_proxy_pubsub_server_adapter_t *adapter)
+{
+    uint8_t count;
+
+    if (adapter == NULL || !adapter_take(adapter))
+    {
+        return 0U;
+    }
+    count = adapter->event_count;
+    adapter_give(adapter);
+    return count;
+}
+
 bool robusto_proxy_pubsub_server_adapter_complete_delivery(
     robusto_proxy_pubsub_server_adapter_t *adapter,
     bool sent)
@@ -832,28 +1029,22 @@ bool robusto_proxy_pubsub_server_adapter_complete_delivery(
                 event->transfer_stage = 2U;
             }
         }
-        else
+        else if (adapter->pending_delivery_opcode == ROBUSTO_PROXY_PUBSUB_OPCODE_DELIVERY_BATCH)
         {
-            if (event->transfer_data != NULL)
-            {
-                free(event->transfer_data);
-            }
-            else
+            while (adapter->pending_delivery_count > 0U)
             {
-                adapter->event_pool_read =
-                    (adapter->event_pool_read + event->data_length) %
-                    adapter->event_pool_capacity;
-                adapter->event_pool_used -= event->data_length;
+                release_oldest_event(adapter);
+                adapter->pending_delivery_count -= 1U;
             }
-            memset(event, 0, sizeof(*event));
-            adapter->event_read_index =
-                (uint8_t)((adapter->event_read_index + 1U) %
-                          ROBUSTO_PROXY_PUBSUB_EVENT_DESCRIPTOR_LIMIT);
-            adapter->event_count -= 1U;
+        }
+        else
+        {
+            release_oldest_event(adapter);
         }
     }
     adapter->pending_delivery_opcode = 0U;
     adapter->pending_delivery_chunk_length = 0U;
+    adapter->pending_delivery_count = 0U;
     adapter->delivery_pending = false;
     adapter_give(adapter);
     return true;
@@ -1,5 +1,6 @@
 #include "robusto_proxy_pubsub_client.h"
 
+#include <stdatomic.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -10,6 +11,9 @@
 #include "robusto_proxy_frame.h"
 #include "robusto_proxy_pubsub.h"
 
+/* Times a windowed publish goes back to the acknowledged offset after link errors before it gives up */
+#define PUBLISH_WINDOW_RESUMES 3U
+
 typedef struct robusto_proxy_pubsub_client_subscription_fields {
     robusto_proxy_client_t *client;
     robusto_proxy_pubsub_callback *callback;
@@ -137,6 +141,27 @@ static rob_ret_val_t dispatch_delivery(
     return callback_result;
 }
 
+static rob_ret_val_t dispatch_inline_delivery(
+    robusto_proxy_client_t *client,
+    const robusto_proxy_pubsub_delivery_t *delivery)
+{
+    robusto_proxy_pubsub_client_subscription_fields_t *fields;
+
+    if (client->pubsub_delivery_data != NULL &&
+        delivery->subscription_id == client->pubsub_delivery_subscription_id)
+    {
+        return ROB_ERR_PARSING_FAILED;
+    }
+    fields = find_subscription_by_id(client, delivery->subscription_id);
+    if (fields == NULL)
+    {
+        client->pubsub_unknown_deliveries += 1U;
+        return ROB_ERR_INVALID_ID;
+    }
+    return dispatch_delivery(client, fields, delivery->delivery_sequence,
+                             (uint8_t *)delivery->data, delivery->data_length);
+}
+
 rob_ret_val_t robusto_proxy_pubsub_configure(
     robusto_proxy_client_t *client,
     robusto_proxy_pubsub_client_subscription_t *subscriptions,
@@ -339,19 +364,236 @@ static rob_ret_val_t finish_failed_publish(
     return publish_result == ROB_ERR_OUTCOME_UNKNOWN ? ROB_FAIL : publish_result;
 }
 
+typedef struct publish_window_chunk {
+    uint32_t offset;
+    uint32_t length;
+    uint32_t received;
+    rob_ret_val_t result;
+    bool in_flight;
+    /* Set by the completion, which may run in the task that dispatches responses */
+    atomic_bool done;
+} publish_window_chunk_t;
+
+static rob_ret_val_t send_chunks_in_order(
+    robusto_proxy_client_t *client, uint64_t operation_id,
+    uint8_t *data, uint32_t data_length)
+{
+    robusto_proxy_pubsub_publish_chunk_request_t chunk_request;
+    const uint8_t *response_payload;
+    size_t response_payload_size;
+    size_t request_size;
+    uint32_t offset = 0U;
+    rob_ret_val_t result;
+
+    while (offset < data_length)
+    {
+        uint32_t remaining = data_length - offset;
+        uint32_t chunk_length = remaining > ROBUSTO_PROXY_PUBSUB_MAX_CHUNK_DATA_BYTES
+                                    ? ROBUSTO_PROXY_PUBSUB_MAX_CHUNK_DATA_BYTES
+                                    : remaining;
+        memset(&chunk_request, 0, sizeof(chunk_request));
+        chunk_request.operation_id = operation_id;
+        chunk_request.offset = offset;
+        chunk_request.data = data + offset;
+        chunk_request.data_length = chunk_length;
+        if (robusto_proxy_pubsub_encode_publish_chunk_request(
+                client->response_frame, client->response_frame_size,
+                &chunk_request, &request_size) != ROBUSTO_PROXY_RESULT_OK)
+        {
+            return ROB_FAIL;
+        }
+        result = robusto_proxy_client_request(
+            client, ROBUSTO_PROXY_DOMAIN_PUBSUB,
+            ROBUSTO_PROXY_PUBSUB_OPCODE_PUBLISH_CHUNK,
+            client->response_frame, request_size, true,
+            &response_payload, &response_payload_size);
+        if (result != ROB_OK)
+        {
+            return result;
+        }
+        offset += chunk_length;
+    }
+    return ROB_OK;
+}
+
+static void publish_window_chunk_completed(
+    void *context, rob_ret_val_t result, const uint8_t *payload, size_t payload_size)
+{
+    publish_window_chunk_t *chunk = context;
+    robusto_proxy_pubsub_publish_chunk_response_t response;
+
+    if (result == ROB_OK)
+    {
+        if (robusto_proxy_pubsub_decode_publish_chunk_response(
+                payload, payload_size, &response) == ROBUSTO_PROXY_RESULT_OK)
+        {
+            chunk->received = response.received;
+        }
+        else
+        {
+            result = ROB_ERR_PARSING_FAILED;
+        }
+    }
+    chunk->result = result;
+    atomic_store_explicit(&chunk->done, true, memory_order_release);
+}
+
+static bool publish_window_can_resume(rob_ret_val_t result)
+{
+    // Chunks are acknowledged cumulatively and resent ones are ignored, so link errors can be resumed from
+    return result == ROB_ERR_TIMEOUT || result == ROB_ERR_OUTCOME_UNKNOWN ||
+           result == ROB_ERR_SEND_FAIL || result == ROB_ERR_WRONG_CRC;
+}
+
+/**
+ * Sends the chunks of a publish with up to the negotiated in-flight capacity outstanding.
+ * The delegate acknowledges the bytes it has received without gaps. When a chunk is lost,
+ * or a link error occurs, the outstanding chunks are let to finish and sending continues
+ * from the acknowledged offset.
+ */
+static rob_ret_val_t send_chunks_windowed(
+    robusto_proxy_client_t *client, uint64_t operation_id,
+    uint8_t *data, uint32_t data_length)
+{
+    publish_window_chunk_t chunks[ROBUSTO_PROXY_MAX_INFLIGHT_REQUESTS];
+    robusto_proxy_pubsub_publish_chunk_request_t chunk_request;
+    uint16_t window = client->pipeline_frame_count;
+    uint32_t acknowledged = 0U;
+    uint32_t next_offset = 0U;
+    uint32_t resumes = 0U;
+    uint16_t in_flight = 0U;
+    uint16_t index;
+    rob_ret_val_t failure = ROB_OK;
+    bool gap = false;
+
+    if (window > client->session.negotiated_limits.max_in_flight)
+    {
+        window = client->session.negotiated_limits.max_in_flight;
+    }
+    if (window > ROBUSTO_PROXY_MAX_INFLIGHT_REQUESTS)
+    {
+        window = ROBUSTO_PROXY_MAX_INFLIGHT_REQUESTS;
+    }
+    memset(chunks, 0, sizeof(chunks));
+    while (acknowledged < data_length || in_flight > 0U)
+    {
+        bool progressed = false;
+
+        for (index = 0U; index < window && failure == ROB_OK && !gap &&
+                         next_offset < data_length;
+             ++index)
+        {
+            publish_window_chunk_t *chunk = &chunks[index];
+            uint32_t remaining = data_length - next_offset;
+            size_t request_size;
+            rob_ret_val_t result;
+
+            if (chunk->in_flight)
+            {
+                continue;
+            }
+            chunk->offset = next_offset;
+            chunk->length = remaining > ROBUSTO_PROXY_PUBSUB_MAX_CHUNK_DATA_BYTES
+                                ? ROBUSTO_PROXY_PUBSUB_MAX_CHUNK_DATA_BYTES
+                                : remaining;
+            chunk->received = 0U;
+            chunk->result = ROB_OK;
+            atomic_store_explicit(&chunk->done, false, memory_order_relaxed);
+            memset(&chunk_request, 0, sizeof(chunk_request));
+            chunk_request.operation_id = operation_id;
+            chunk_request.offset = chunk->offset;
+            chunk_request.data = data + chunk->offset;
+            chunk_request.data_length = chunk->length;
+            if (robusto_proxy_pubsub_encode_publish_chunk_request(
+                    client->response_frame, client->response_frame_size,
+                    &chunk_request, &request_size) != ROBUSTO_PROXY_RESULT_OK)
+            {
+                failure = ROB_FAIL;
+                break;
+            }
+            chunk->in_flight = true;
+            result = robusto_proxy_client_submit(
+                client, ROBUSTO_PROXY_DOMAIN_PUBSUB,
+                ROBUSTO_PROXY_PUBSUB_OPCODE_PUBLISH_CHUNK,
+                client->response_frame, request_size, true,
+                publish_window_chunk_completed, chunk);
+            if (result != ROB_OK)
+            {
+                chunk->in_flight = false;
+                // When other requests hold the capacity, wait for them instead
+                if (result != ROB_ERR_CONV_LIST_FULL)
+                {
+                    failure = result;
+                }
+                break;
+            }
+            in_flight += 1U;
+            next_offset += chunk->length;
+        }
+
+        for (index = 0U; index < window; ++index)
+        {
+            publish_window_chunk_t *chunk = &chunks[index];
+
+            if (!chunk->in_flight ||
+                !atomic_load_explicit(&chunk->done, memory_order_acquire))
+            {
+                continue;
+            }
+            chunk->in_flight = false;
+            in_flight -= 1U;
+            progressed = true;
+            if (chunk->result != ROB_OK)
+            {
+                failure = failure == ROB_OK ? chunk->result : failure;
+            }
+            else if (chunk->received > data_length)
+            {
+                failure = ROB_ERR_PARSING_FAILED;
+            }
+            else
+            {
+                acknowledged = chunk->received > acknowledged ? chunk->received : acknowledged;
+                // The delegate is missing data before this chunk
+                gap = gap || chunk->received < chunk->offset + chunk->length;
+            }
+        }
+
+        if ((failure != ROB_OK || gap) && in_flight == 0U)
+        {
+            if (failure != ROB_OK)
+            {
+                if (!publish_window_can_resume(failure) || resumes == PUBLISH_WINDOW_RESUMES)
+                {
+                    return failure;
+                }
+                resumes += 1U;
+                client->retries += 1U;
+            }
+            next_offset = acknowledged;
+            failure = ROB_OK;
+            gap = false;
+        }
+        else if (!progressed)
+        {
+            client->wait_ms(client->clock_context, 1U);
+            (void)robusto_proxy_client_expire(client);
+        }
+    }
+    return ROB_OK;
+}
+
 static rob_ret_val_t publish_chunked(
     robusto_proxy_client_t *client, const char *topic_name, size_t topic_length,
     uint8_t *data, uint32_t data_length)
 {
     robusto_proxy_pubsub_publish_begin_request_t begin_request;
-    robusto_proxy_pubsub_publish_chunk_request_t chunk_request;
     robusto_proxy_pubsub_publish_transfer_request_t commit_request;
     robusto_proxy_pubsub_publish_response_t response;
     const uint8_t *response_payload;
     size_t response_payload_size;
     size_t request_size;
     uint64_t operation_id = robusto_proxy_client_take_operation_id(client);
-    uint32_t offset = 0U;
     rob_ret_val_t result;
 
     if ((client->session.enabled_features &
@@ -385,34 +627,15 @@ static rob_ret_val_t publish_chunked(
         return result;
     }
 
-    while (offset < data_length)
+    if ((client->session.enabled_features &
+         ROBUSTO_PROXY_FEATURE_PUBSUB_WINDOWED_PUBLISH) != 0U &&
+        client->send != NULL)
     {
-        uint32_t remaining = data_length - offset;
-        uint32_t chunk_length = remaining > ROBUSTO_PROXY_PUBSUB_MAX_CHUNK_DATA_BYTES
-                                    ? ROBUSTO_PROXY_PUBSUB_MAX_CHUNK_DATA_BYTES
-                                    : remaining;
-        memset(&chunk_request, 0, sizeof(chunk_request));
-        chunk_request.operation_id = operation_id;
-        chunk_request.offset = offset;
-        chunk_request.data = data + offset;
-        chunk_request.data_length = chunk_length;
-        if (robusto_proxy_pubsub_encode_publish_chunk_request(
-                client->response_frame, client->response_frame_size,
-                &chunk_request, &request_size) != ROBUSTO_PROXY_RESULT_OK)
-        {
-            result = ROB_FAIL;
-            break;
-        }
-        result = robusto_proxy_client_request(
-            client, ROBUSTO_PROXY_DOMAIN_PUBSUB,
-            ROBUSTO_PROXY_PUBSUB_OPCODE_PUBLISH_CHUNK,
-            client->response_frame, request_size, true,
-            &response_payload, &response_payload_size);
-        if (result != ROB_OK)
-        {
-            break;
-        }
-        offset += chunk_length;
+        result = send_chunks_windowed(client, operation_id, data, data_length);
+    }
+    else
+    {
+        result = send_chunks_in_order(client, operation_id, data, data_length);
     }
     if (result != ROB_OK)
     {
@@ -582,20 +805,42 @@ rob_ret_val_t robusto_proxy_pubsub_handle_event(
         robusto_proxy_pubsub_delivery_t delivery;
 
         if (robusto_proxy_pubsub_decode_delivery(
-                payload, header->payload_length, &delivery) != ROBUSTO_PROXY_RESULT_OK ||
-            (client->pubsub_delivery_data != NULL &&
-             delivery.subscription_id == client->pubsub_delivery_subscription_id))
+                payload, header->payload_length, &delivery) != ROBUSTO_PROXY_RESULT_OK)
         {
             return ROB_ERR_PARSING_FAILED;
         }
-        fields = find_subscription_by_id(client, delivery.subscription_id);
-        if (fields == NULL)
+        return dispatch_inline_delivery(client, &delivery);
+    }
+    if (header->opcode == ROBUSTO_PROXY_PUBSUB_OPCODE_DELIVERY_BATCH)
+    {
+        robusto_proxy_pubsub_delivery_t delivery;
+        rob_ret_val_t result = ROB_OK;
+        rob_ret_val_t entry_result;
+        size_t offset = 0U;
+        uint16_t count;
+
+        if ((client->session.enabled_features &
+             ROBUSTO_PROXY_FEATURE_PUBSUB_DELIVERY_BATCH) == 0U)
         {
-            client->pubsub_unknown_deliveries += 1U;
-            return ROB_ERR_INVALID_ID;
+            return ROB_ERR_NOT_SUPPORTED;
+        }
+        if (robusto_proxy_pubsub_decode_delivery_batch(
+                payload, header->payload_length, &count) != ROBUSTO_PROXY_RESULT_OK)
+        {
+            return ROB_ERR_PARSING_FAILED;
+        }
+        // The whole batch is validated, so every entry is delivered even if an earlier one fails
+        while (count-- > 0U)
+        {
+            (void)robusto_proxy_pubsub_decode_delivery_batch_entry(
+                payload, header->payload_length, &offset, &delivery);
+            entry_result = dispatch_inline_delivery(client, &delivery);
+            if (entry_result != ROB_OK)
+            {
+                result = entry_result;
+            }
         }
-        return dispatch_delivery(client, fields, delivery.delivery_sequence,
-                                 (uint8_t *)delivery.data, delivery.data_length);
+        return result;
     }
     if ((client->session.enabled_features &
          ROBUSTO_PROXY_FEATURE_PUBSUB_CHUNKED_DELIVERY) == 0U)
@@ -82,10 +82,15 @@ static uint64_t available_features(const robusto_proxy_service_t *service)
         adapter->publish_abort != NULL && adapter->session_reset != NULL)
     {
         features |= ROBUSTO_PROXY_FEATURE_PUBSUB_CHUNKED_PUBLISH;
+        if (adapter->publish_progress != NULL)
+        {
+            features |= ROBUSTO_PROXY_FEATURE_PUBSUB_WINDOWED_PUBLISH;
+        }
     }
     if (adapter != NULL)
     {
-        features |= ROBUSTO_PROXY_FEATURE_PUBSUB_CHUNKED_DELIVERY;
+        features |= ROBUSTO_PROXY_FEATURE_PUBSUB_CHUNKED_DELIVERY |
+                    ROBUSTO_PROXY_FEATURE_PUBSUB_DELIVERY_BATCH;
     }
     return features;
 }
@@ -789,6 +794,36 @@ bool robusto_proxy_service_handle_pubsub_request(
         {
             status = service->pubsub_adapter->publish_chunk(
                 service->pubsub_adapter_context, &request);
+            if ((service->session.enabled_features &
+                 ROBUSTO_PROXY_FEATURE_PUBSUB_WINDOWED_PUBLISH) != 0U &&
+                (status == ROBUSTO_PROXY_STATUS_OK ||
+                 status == ROBUSTO_PROXY_STATUS_MALFORMED_PAYLOAD))
+            {
+                robusto_proxy_pubsub_publish_chunk_response_t response;
+                uint16_t progress_status = service->pubsub_adapter->publish_progress(
+                    service->pubsub_adapter_context, request.operation_id,
+                    &response.received);
+                // A chunk already received, or one after a lost chunk, is acknowledged with
+                // what has been received so far, so that the sender continues from there.
+                if (progress_status == ROBUSTO_PROXY_STATUS_OK &&
+                    (status == ROBUSTO_PROXY_STATUS_OK || request.offset != response.received))
+                {
+                    status = ROBUSTO_PROXY_STATUS_OK;
+                    if (robusto_proxy_pubsub_encode_publish_chunk_response(
+                            success_buffer,
+                            response_buffer_size - ROBUSTO_PROXY_RESPONSE_PREFIX_SIZE_BYTES,
+                            &response) != ROBUSTO_PROXY_RESULT_OK)
+                    {
+                        service->requests -= 1U;
+                        return false;
+                    }
+                    success_size = ROBUSTO_PROXY_PUBSUB_PUBLISH_CHUNK_RESPONSE_SIZE_BYTES;
+                }
+                else if (progress_status != ROBUSTO_PROXY_STATUS_OK)
+                {
+                    status = progress_status;
+                }
+            }
         }
     }
     else if (opcode == ROBUSTO_PROXY_PUBSUB_OPCODE_PUBLISH_COMMIT)
@@ -1013,6 +1048,17 @@ robusto_proxy_result_t robusto_proxy_service_build_pubsub_event(
         result = robusto_proxy_pubsub_decode_delivery(
             event_payload, event_payload_size, &delivery);
     }
+    else if (opcode == ROBUSTO_PROXY_PUBSUB_OPCODE_DELIVERY_BATCH)
+    {
+        uint16_t count;
+        if ((service->session.enabled_features &
+             ROBUSTO_PROXY_FEATURE_PUBSUB_DELIVERY_BATCH) == 0U)
+        {
+            return ROBUSTO_PROXY_RESULT_INVALID_ARGUMENT;
+        }
+        result = robusto_proxy_pubsub_decode_delivery_batch(
+            event_payload, event_payload_size, &count);
+    }
     else if ((service->session.enabled_features &
               ROBUSTO_PROXY_FEATURE_PUBSUB_CHUNKED_DELIVERY) == 0U)
     {
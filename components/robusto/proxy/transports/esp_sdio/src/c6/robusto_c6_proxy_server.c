@@ -32,7 +32,6 @@ typedef struct {
 static proxy_frame_item_t callback_frame;
 static proxy_frame_item_t worker_frame;
 static uint8_t worker_response[ROBUSTO_PROXY_SLOT_SIZE_BYTES];
-static uint8_t delivery_payload[ROBUSTO_PROXY_SLOT_SIZE_BYTES];
 static uint8_t delivery_event[ROBUSTO_PROXY_SLOT_SIZE_BYTES];
 static bool reboot_requested;
 
@@ -59,19 +58,72 @@ static void frame_request_callback(uint32_t msg_id,
     }
 }
 
-static void send_pending_deliveries(void)
+/* Set while queued deliveries wait for more to fill a batch, since coalescing_since_ms */
+static bool coalescing;
+static uint32_t coalescing_since_ms;
+
+static bool delivery_batching(void)
 {
+    return CONFIG_ROBUSTO_PROXY_C6_DELIVERY_BATCH_MAX > 1 &&
+           (proxy_service.session.enabled_features &
+            ROBUSTO_PROXY_FEATURE_PUBSUB_DELIVERY_BATCH) != 0U;
+}
+
+/* Whether to let the queued deliveries wait for more to fill a batch */
+static bool hold_deliveries(void)
+{
+    uint8_t pending;
+    uint32_t now_ms;
+
+    if (!delivery_batching() || CONFIG_ROBUSTO_PROXY_C6_DELIVERY_BATCH_DELAY_MS == 0) {
+        return false;
+    }
+    pending = robusto_proxy_pubsub_server_adapter_pending_deliveries(&pubsub_adapter);
+    if (pending == 0U || pending >= CONFIG_ROBUSTO_PROXY_C6_DELIVERY_BATCH_MAX) {
+        coalescing = false;
+        return false;
+    }
+    now_ms = (uint32_t)(esp_timer_get_time() / 1000);
+    if (!coalescing) {
+        coalescing = true;
+        coalescing_since_ms = now_ms;
+    }
+    if (now_ms - coalescing_since_ms < CONFIG_ROBUSTO_PROXY_C6_DELIVERY_BATCH_DELAY_MS) {
+        return true;
+    }
+    coalescing = false;
+    return false;
+}
+
+/* Sends the queued deliveries, returns true if they are held back to be batched */
+static bool send_pending_deliveries(void)
+{
+    /* The delivery is taken straight into the payload of the event frame */
+    uint8_t *delivery_payload = delivery_event + ROBUSTO_PROXY_HEADER_SIZE_BYTES;
+    bool batching = delivery_batching();
     uint8_t opcode;
     size_t payload_size;
     size_t event_size;
 
-    while (robusto_proxy_pubsub_server_adapter_take_delivery(
-        &pubsub_adapter,
-        (proxy_service.session.enabled_features &
-         ROBUSTO_PROXY_FEATURE_PUBSUB_CHUNKED_DELIVERY) != 0U,
-        &opcode, delivery_payload,
-        ROBUSTO_PROXY_SDIO_SLAVE_MAX_EVENT_PAYLOAD_SIZE,
-        &payload_size)) {
+    if (hold_deliveries()) {
+        return true;
+    }
+    for (;;) {
+        if (batching &&
+            robusto_proxy_pubsub_server_adapter_take_delivery_batch(
+                &pubsub_adapter, CONFIG_ROBUSTO_PROXY_C6_DELIVERY_BATCH_MAX,
+                delivery_payload, ROBUSTO_PROXY_SDIO_SLAVE_MAX_EVENT_PAYLOAD_SIZE,
+                &payload_size)) {
+            opcode = ROBUSTO_PROXY_PUBSUB_OPCODE_DELIVERY_BATCH;
+        } else if (!robusto_proxy_pubsub_server_adapter_take_delivery(
+                       &pubsub_adapter,
+                       (proxy_service.session.enabled_features &
+                        ROBUSTO_PROXY_FEATURE_PUBSUB_CHUNKED_DELIVERY) != 0U,
+                       &opcode, delivery_payload,
+                       ROBUSTO_PROXY_SDIO_SLAVE_MAX_EVENT_PAYLOAD_SIZE,
+                       &payload_size)) {
+            break;
+        }
         robusto_proxy_result_t result =
             robusto_proxy_service_build_pubsub_event(
                 &proxy_service, opcode, delivery_payload, payload_size,
@@ -104,15 +156,21 @@ static void send_pending_deliveries(void)
             break;
         }
     }
+    return false;
 }
 
 static void bridge_task_main(void *context)
 {
     size_t response_size;
+    TickType_t wait = pdMS_TO_TICKS(20);
+    TickType_t coalescing_wait = pdMS_TO_TICKS(CONFIG_ROBUSTO_PROXY_C6_DELIVERY_BATCH_DELAY_MS);
 
     (void)context;
+    if (coalescing_wait == 0) {
+        coalescing_wait = 1;
+    }
     for (;;) {
-        if (xQueueReceive(frame_queue, &worker_frame, pdMS_TO_TICKS(20)) == pdTRUE) {
+        if (xQueueReceive(frame_queue, &worker_frame, wait) == pdTRUE) {
             response_size = 0;
             robusto_proxy_result_t result = robusto_proxy_service_handle_frame(
                 &proxy_service,
@@ -143,7 +201,7 @@ static void bridge_task_main(void *context)
                 ESP_LOGW(TAG, "Drop logical frame result=%d", result);
             }
         }
-        send_pending_deliveries();
+        wait = send_pending_deliveries() ? coalescing_wait : pdMS_TO_TICKS(20);
         (void)robusto_proxy_service_tick(&proxy_service,
                                          (uint32_t)(esp_timer_get_time() / 1000));
     }
@@ -27,6 +27,8 @@ static const char *TAG = "robusto_p4_proxy";
 #define P4_PROXY_REQUEST_TIMEOUT_MS 2000U
 #define P4_PROXY_RUNLEVEL 1U
 #define ROBUSTO_PROXY_SDIO_EVENT_QUEUE_CAPACITY 4U
+/* Submitted requests that can be outstanding at once, each has its own frame. The low memory profile allows two in flight. */
+#define P4_PIPELINE_DEPTH 2U
 
 typedef struct robusto_proxy_sdio_frame_item {
     size_t size;
@@ -39,6 +41,7 @@ typedef struct robusto_proxy_sdio {
     robusto_proxy_client_service_config_t service_config;
     uint8_t request_frame[ROBUSTO_PROXY_SLOT_SIZE_BYTES];
     uint8_t response_frame[ROBUSTO_PROXY_SLOT_SIZE_BYTES];
+    uint8_t pipeline_frames[P4_PIPELINE_DEPTH][ROBUSTO_PROXY_SLOT_SIZE_BYTES];
     robusto_proxy_sdio_frame_item_t exchange_item;
     robusto_proxy_sdio_frame_item_t receive_item;
     robusto_proxy_sdio_frame_item_t event_item;
@@ -53,6 +56,10 @@ typedef struct robusto_proxy_sdio {
     StaticEventGroup_t worker_events_storage;
     SemaphoreHandle_t exchange_mutex;
     StaticSemaphore_t exchange_mutex_storage;
+    SemaphoreHandle_t send_mutex;
+    StaticSemaphore_t send_mutex_storage;
+    SemaphoreHandle_t client_mutex;
+    StaticSemaphore_t client_mutex_storage;
     TaskHandle_t receive_task;
     TaskHandle_t event_task;
     portMUX_TYPE response_lock;
@@ -135,6 +142,22 @@ static void recover_host_after_send_failure(esp_err_t error)
     ESP_LOGI(TAG, "SDIO host recovery completed after send timeout");
 }
 
+/* Requests are sent both by exchanges and by submitted requests, one at a time */
+static esp_err_t host_send_request(robusto_proxy_sdio_t *binding,
+                                   const uint8_t *request, size_t request_size,
+                                   uint32_t timeout_ms)
+{
+    esp_err_t error;
+
+    if (xSemaphoreTake(binding->send_mutex, pdMS_TO_TICKS(timeout_ms)) != pdTRUE) {
+        return ESP_ERR_TIMEOUT;
+    }
+    error = robusto_proxy_sdio_host_send(ROBUSTO_PROXY_SDIO_REQUEST_MSG_ID,
+                                         request, request_size, timeout_ms);
+    xSemaphoreGive(binding->send_mutex);
+    return error;
+}
+
 static rob_ret_val_t p4_exchange(
     void *context,
     const uint8_t *request,
@@ -186,8 +209,7 @@ static rob_ret_val_t p4_exchange(
              (unsigned long)request_header->correlation_id,
              (unsigned int)request_size);
 
-    error = robusto_proxy_sdio_host_send(ROBUSTO_PROXY_SDIO_REQUEST_MSG_ID,
-                                      request, request_size, remaining_ms);
+    error = host_send_request(binding, request, request_size, remaining_ms);
     if (error != ESP_OK) {
         portENTER_CRITICAL(&binding->response_lock);
         binding->awaiting_response = false;
@@ -278,6 +300,52 @@ static rob_ret_val_t p4_exchange(
     return result;
 }
 
+static rob_ret_val_t p4_send(
+    void *context,
+    const uint8_t *request,
+    size_t request_size,
+    uint32_t timeout_ms,
+    robusto_proxy_transfer_acceptance_t *acceptance)
+{
+    robusto_proxy_sdio_t *binding = context;
+    const robusto_proxy_frame_header_t *request_header;
+    esp_err_t error;
+
+    if (binding == NULL || request == NULL ||
+        request_size < ROBUSTO_PROXY_HEADER_SIZE_BYTES || acceptance == NULL) {
+        return ROB_ERR_INVALID_ARG;
+    }
+    *acceptance = ROBUSTO_PROXY_TRANSFER_NOT_ACCEPTED;
+    if (!binding->transport_started) {
+        // Without the receive task, nothing would dispatch the response
+        return ROB_ERR_NOT_READY;
+    }
+    request_header = (const robusto_proxy_frame_header_t *)request;
+    error = host_send_request(binding, request, request_size, timeout_ms);
+    if (error != ESP_OK) {
+        ESP_LOGE(TAG, "submit opcode=%u: %s", request_header->opcode,
+                 esp_err_to_name(error));
+        recover_host_after_send_failure(error);
+        return map_exchange_error(error);
+    }
+    *acceptance = ROBUSTO_PROXY_TRANSFER_ACCEPTED;
+    return ROB_OK;
+}
+
+static void p4_client_lock(void *context)
+{
+    robusto_proxy_sdio_t *binding = context;
+
+    xSemaphoreTake(binding->client_mutex, portMAX_DELAY);
+}
+
+static void p4_client_unlock(void *context)
+{
+    robusto_proxy_sdio_t *binding = context;
+
+    xSemaphoreGive(binding->client_mutex);
+}
+
 static uint32_t p4_now_ms(void *context)
 {
     (void)context;
@@ -346,7 +414,11 @@ static void receive_task_main(void *context)
                        item->size >= ROBUSTO_PROXY_HEADER_SIZE_BYTES &&
                        header->correlation_id == binding->expected_correlation_id;
             portEXIT_CRITICAL(&binding->response_lock);
-            if (!expected) {
+            if (!expected &&
+                robusto_proxy_client_dispatch(&binding->client, item->bytes,
+                                              item->size)) {
+                // A submitted request, its completion has been called
+            } else if (!expected) {
                 ESP_LOGW(TAG, "drop stale response correlation=0x%08lx",
                          item->size >= ROBUSTO_PROXY_HEADER_SIZE_BYTES
                              ? (unsigned long)header->correlation_id
@@ -377,6 +449,7 @@ static void event_task_main(void *context)
     while (!binding->stopping) {
         if (xQueueReceive(binding->event_queue, item,
                           pdMS_TO_TICKS(P4_RECEIVE_TIMEOUT_MS)) != pdTRUE) {
+            (void)robusto_proxy_client_expire(&binding->client);
             continue;
         }
         rob_ret_val_t result = robusto_proxy_pubsub_handle_event(
@@ -475,7 +548,12 @@ rob_ret_val_t robusto_proxy_sdio_register(
     binding->response_lock = (portMUX_TYPE)portMUX_INITIALIZER_UNLOCKED;
     binding->exchange_mutex = xSemaphoreCreateMutexStatic(
         &binding->exchange_mutex_storage);
-    if (binding->exchange_mutex == NULL) {
+    binding->send_mutex = xSemaphoreCreateMutexStatic(
+        &binding->send_mutex_storage);
+    binding->client_mutex = xSemaphoreCreateMutexStatic(
+        &binding->client_mutex_storage);
+    if (binding->exchange_mutex == NULL || binding->send_mutex == NULL ||
+        binding->client_mutex == NULL) {
         return ROB_ERR_OUT_OF_MEMORY;
     }
     binding->service_config.client = &binding->client;
@@ -500,6 +578,15 @@ rob_ret_val_t robusto_proxy_sdio_register(
     binding->service_config.client_config.response_frame = binding->response_frame;
     binding->service_config.client_config.response_frame_size =
         sizeof(binding->response_frame);
+    binding->service_config.client_config.send = p4_send;
+    binding->service_config.client_config.pipeline_frames =
+        &binding->pipeline_frames[0][0];
+    binding->service_config.client_config.pipeline_frame_size =
+        sizeof(binding->pipeline_frames[0]);
+    binding->service_config.client_config.pipeline_frame_count = P4_PIPELINE_DEPTH;
+    binding->service_config.client_config.lock = p4_client_lock;
+    binding->service_config.client_config.unlock = p4_client_unlock;
+    binding->service_config.client_config.lock_context = binding;
     binding->service_config.transport_init = p4_transport_init;
     binding->service_config.transport_start = p4_transport_start;
     binding->service_config.transport_stop = p4_transport_stop;
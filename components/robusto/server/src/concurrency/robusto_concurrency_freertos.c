@@ -43,6 +43,7 @@
 #include <freertos/task.h>
 #include <freertos/semphr.h>
 #include <freertos/projdefs.h>
+#include "esp_attr.h"
 #include "esp_task_wdt.h"
 #endif
 
@@ -104,6 +105,49 @@ rob_ret_val_t robusto_mutex_give(mutex_ref_t mutex) {
     }
 }
 
+semaphore_ref_t robusto_semaphore_init() {
+    semaphore_ref_t retval = xSemaphoreCreateBinary();
+    if (!retval) {
+        ROB_LOGE("FREERTOS", "Failure getting a binary semaphore");
+    }
+    return retval;
+}
+
+void robusto_semaphore_deinit(semaphore_ref_t semaphore) {
+    vSemaphoreDelete(semaphore);
+}
+
+rob_ret_val_t robusto_semaphore_take(semaphore_ref_t semaphore, uint32_t timeout_ms) {
+    // Always wait at least one tick, a zero timeout would turn waiting into spinning.
+    TickType_t ticks = pdMS_TO_TICKS(timeout_ms);
+    if (ticks == 0) {
+        ticks = 1;
+    }
+    if (pdTRUE == xSemaphoreTake(semaphore, ticks)) {
+        return ROB_OK;
+    } else {
+        return ROB_ERR_TIMEOUT;
+    }
+}
+
+rob_ret_val_t robusto_semaphore_give(semaphore_ref_t semaphore) {
+    // Failing to give an already given binary semaphore is fine, someone is already signalled.
+    xSemaphoreGive(semaphore);
+    return ROB_OK;
+}
+
+#ifdef USE_ESPIDF
+IRAM_ATTR
+#endif
+rob_ret_val_t robusto_semaphore_give_from_isr(semaphore_ref_t semaphore) {
+    BaseType_t higher_priority_task_woken = pdFALSE;
+    xSemaphoreGiveFromISR(semaphore, &higher_priority_task_woken);
+    if (higher_priority_task_woken == pdTRUE) {
+        portYIELD_FROM_ISR();
+    }
+    return ROB_OK;
+}
+
 /**
  * @brief  If there is a task watchdog, set its timeout. 
  * @note This applies mostly to microcontrollers, has no effect on bigger computers(TODO: Maybe it should?)
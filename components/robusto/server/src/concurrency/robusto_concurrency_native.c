@@ -38,6 +38,13 @@
 #include <sched.h>
 #include <time.h>
 #include <stdlib.h> 
+#include <errno.h>
+
+struct robusto_native_semaphore {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    bool given;
+};
 
 rob_ret_val_t robusto_create_task(TaskFunction_t task_function, void *parameter, char *task_name, rob_task_handle_t **handle, int affinity) {
     pthread_t new_thread;
@@ -93,6 +100,62 @@ rob_ret_val_t robusto_mutex_give(mutex_ref_t mutex) {
 
 }
 
+semaphore_ref_t robusto_semaphore_init() {
+    semaphore_ref_t semaphore = malloc(sizeof(struct robusto_native_semaphore));
+    if (semaphore == NULL) {
+        return NULL;
+    }
+    pthread_mutex_init(&semaphore->lock, NULL);
+    pthread_cond_init(&semaphore->cond, NULL);
+    semaphore->given = false;
+    return semaphore;
+}
+
+void robusto_semaphore_deinit(semaphore_ref_t semaphore) {
+    if (semaphore == NULL) {
+        return;
+    }
+    pthread_cond_destroy(&semaphore->cond);
+    pthread_mutex_destroy(&semaphore->lock);
+    free(semaphore);
+}
+
+rob_ret_val_t robusto_semaphore_take(semaphore_ref_t semaphore, uint32_t timeout_ms) {
+    // pthread_cond_timedwait wants an absolute time
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += timeout_ms / 1000;
+    deadline.tv_nsec += (long)(timeout_ms % 1000) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+
+    pthread_mutex_lock(&semaphore->lock);
+    int rc = 0;
+    while (!semaphore->given && rc != ETIMEDOUT) {
+        rc = pthread_cond_timedwait(&semaphore->cond, &semaphore->lock, &deadline);
+    }
+    bool taken = semaphore->given;
+    semaphore->given = false;
+    pthread_mutex_unlock(&semaphore->lock);
+
+    return taken ? ROB_OK : ROB_ERR_TIMEOUT;
+}
+
+rob_ret_val_t robusto_semaphore_give(semaphore_ref_t semaphore) {
+    pthread_mutex_lock(&semaphore->lock);
+    semaphore->given = true;
+    pthread_cond_signal(&semaphore->cond);
+    pthread_mutex_unlock(&semaphore->lock);
+    return ROB_OK;
+}
+
+rob_ret_val_t robusto_semaphore_give_from_isr(semaphore_ref_t semaphore) {
+    // There are no interrupt handlers here, only threads.
+    return robusto_semaphore_give(semaphore);
+}
+
 /**
  * @brief  If there is a task watchdog, set its timeout
  * @note This applies mostly to microcontrollers, has no effect on bigger computers (TODO: Maybe it should?)
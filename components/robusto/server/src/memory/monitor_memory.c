@@ -84,6 +84,9 @@ struct history_item
 };
 struct history_item history[CONFIG_ROBUSTO_MONITOR_HISTORY_LENGTH];
 
+/* Pool exhaustion count at the last report, to warn when pools have run out since */
+static uint32_t last_pools_exhausted = 0;
+
 /* Reporting state: track last reported memory to compute user-facing delta */
 static uint64_t last_reported_mem = 0;
 static bool last_reported_set = false;
@@ -173,6 +176,21 @@ void monitor_memory_cb()
                   curr_mem_avail, avg_mem_avail, avg_mem_avail - first_average_memory_available, delta_mem_avail, least_memory_available, most_memory_available);
     #endif
 
+    /* Report the pools, warn if any has run out since the last report, they may need to be larger */
+    robusto_pool_stats_t stats;
+    uint32_t pools_exhausted = 0;
+    for (uint8_t i = 0; robusto_pool_get_stats(i, &stats); i++)
+    {
+        pools_exhausted += stats.exhausted;
+    }
+    int pool_level = pools_exhausted > last_pools_exhausted ? ROB_LOG_WARN : level;
+    last_pools_exhausted = pools_exhausted;
+    for (uint8_t i = 0; robusto_pool_get_stats(i, &stats); i++)
+    {
+        ROB_LOG_LEVEL(pool_level, memory_monitor_log_prefix, "Pool %s: %u of %u slots of %lu bytes in use, high water %u, exhausted %lu times.",
+                      stats.name, stats.in_use, stats.slot_count, (unsigned long)stats.slot_size, stats.high_water, (unsigned long)stats.exhausted);
+    }
+
     /* Update last reported baseline after printing only if it was actually visible at current log level */
     if (will_log) {
         last_reported_mem = curr_mem_avail;
@@ -0,0 +1,175 @@
+/**
+ * @file robusto_completion.c
+ * @author Nicklas Börjesson (<nicklasb at gmail dot com>)
+ * @brief Completions, a one-shot notification of the result of a queued operation.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright
+ * Copyright (c) 2026, Nicklas Börjesson <nicklasb at gmail dot com>
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * A completion is created by the one wanting to know the result (for example a sender), 
+ * and is then passed along with the work. It holds a reference count:
+ * - The creator owns the first reference.
+ * - Whoever is going to signal it (typically the queue item) takes another. 
+ * Both release their reference when done, the last one frees it. So neither needs to know if the other is done.
+ * 
+ * The completion is signalled exactly once, further signals are ignored. 
+ * A waiting task is blocked on a semaphore, so it doesn't use any CPU while waiting.
+ */
+#include <robusto_queue.h>
+#include <robusto_concurrency.h>
+#include <robusto_system.h>
+#include <robusto_logging.h>
+
+#include <stdatomic.h>
+#include <string.h>
+
+struct robusto_completion
+{
+    /* Kept for the progress and for code that use queue states */
+    queue_state state;
+    /* The result, only valid when done */
+    rob_ret_val_t result;
+    /* Given when signalled */
+    semaphore_ref_t __x_done_semaphore;
+    _Atomic uint8_t references;
+    /* Set by the first signaller */
+    _Atomic bool signalled;
+    /* Set when the result is available */
+    _Atomic bool done;
+    /* Optional callback and its data */
+    _Atomic(robusto_completion_cb *) callback;
+    void *user_data;
+    /* Set by whoever calls the callback, so that it is only called once */
+    _Atomic bool callback_claimed;
+};
+
+robusto_completion_t *robusto_completion_create()
+{
+    robusto_completion_t *completion = robusto_pool_malloc(sizeof(robusto_completion_t));
+    if (completion == NULL)
+    {
+        return NULL;
+    }
+    memset(completion, 0, sizeof(robusto_completion_t));
+    completion->__x_done_semaphore = robusto_semaphore_init();
+    if (completion->__x_done_semaphore == NULL)
+    {
+        robusto_free(completion);
+        return NULL;
+    }
+    completion->state[0] = QUEUE_STATE_QUEUED;
+    atomic_init(&completion->references, 1);
+    atomic_init(&completion->signalled, false);
+    atomic_init(&completion->done, false);
+    atomic_init(&completion->callback, NULL);
+    atomic_init(&completion->callback_claimed, false);
+    return completion;
+}
+
+void robusto_completion_retain(robusto_completion_t *completion)
+{
+    atomic_fetch_add(&completion->references, 1);
+}
+
+void robusto_completion_release(robusto_completion_t *completion)
+{
+    if (completion == NULL)
+    {
+        return;
+    }
+    if (atomic_fetch_sub(&completion->references, 1) == 1)
+    {
+        robusto_semaphore_deinit(completion->__x_done_semaphore);
+        robusto_free(completion);
+    }
+}
+
+static void call_callback(robusto_completion_t *completion)
+{
+    robusto_completion_cb *callback = atomic_load(&completion->callback);
+    // Both the signaller and robusto_completion_on_done may get here, only one may call it.
+    if (callback != NULL && !atomic_exchange(&completion->callback_claimed, true))
+    {
+        callback(completion, completion->result, completion->user_data);
+    }
+}
+
+bool robusto_completion_signal(robusto_completion_t *completion, rob_ret_val_t result)
+{
+    if (completion == NULL || atomic_exchange(&completion->signalled, true))
+    {
+        // Already signalled, the first result stands
+        return false;
+    }
+    completion->result = result;
+    completion->state[0] = result == ROB_OK ? QUEUE_STATE_SUCCEEDED : QUEUE_STATE_FAILED;
+    // The result must be set before done, as done is what the others look at.
+    atomic_store(&completion->done, true);
+    robusto_semaphore_give(completion->__x_done_semaphore);
+    call_callback(completion);
+    return true;
+}
+
+rob_ret_val_t robusto_completion_wait(robusto_completion_t *completion, uint32_t timeout_ms, rob_ret_val_t *result)
+{
+    if (!atomic_load(&completion->done))
+    {
+        robusto_semaphore_take(completion->__x_done_semaphore, timeout_ms);
+        if (!atomic_load(&completion->done))
+        {
+            return ROB_ERR_TIMEOUT;
+        }
+        // Pass it on, in case more than one is waiting
+        robusto_semaphore_give(completion->__x_done_semaphore);
+    }
+    if (result != NULL)
+    {
+        *result = completion->result;
+    }
+    return ROB_OK;
+}
+
+void robusto_completion_on_done(robusto_completion_t *completion, robusto_completion_cb *callback, void *user_data)
+{
+    completion->user_data = user_data;
+    atomic_store(&completion->callback, callback);
+    // If already signalled, the signaller may not have seen the callback
+    if (atomic_load(&completion->done))
+    {
+        call_callback(completion);
+    }
+}
+
+bool robusto_completion_is_done(robusto_completion_t *completion)
+{
+    return atomic_load(&completion->done);
+}
+
+queue_state *robusto_completion_get_state(robusto_completion_t *completion)
+{
+    return &completion->state;
+}
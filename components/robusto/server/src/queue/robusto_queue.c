@@ -61,6 +61,10 @@ void robusto_set_queue_state_result(queue_state *state, rob_ret_val_t return_val
 rob_ret_val_t robusto_set_queue_state_queued_on_ok(queue_state *state, rob_ret_val_t retval) {
     if (state == NULL) { 
         return retval; }
+    // A dropped state must stay dropped, so that it is freed when the result is set
+    if (*state[0] == QUEUE_STATE_DROPPED) {
+        return retval;
+    }
     if (retval == ROB_OK) {
         *state[0] = QUEUE_STATE_QUEUED;
     } else {
@@ -98,11 +102,13 @@ void robusto_set_queue_state_queued(queue_state *state) {
 
 void robusto_set_queue_state_running(queue_state *state) {
     if (state == NULL) { return; }
+    if (*state[0] == QUEUE_STATE_DROPPED) { return; }
     *state[0] = QUEUE_STATE_RUNNING;  
 };
 
 void robusto_set_queue_state_trying(queue_state *state) {
     if (state == NULL) { return; }
+    if (*state[0] == QUEUE_STATE_DROPPED) { return; }
     *state[0] = QUEUE_STATE_TRYING_MEDIAS;  
 };
 
@@ -129,6 +135,33 @@ bool robusto_waitfor_queue_state(queue_state *state, uint32_t timeout_ms, rob_re
 }
 
 
+#ifdef CONFIG_ROBUSTO_QUEUE_RING
+/**
+ * @brief Add to a ring-backed queue, neither locks nor allocates.
+ */
+static rob_ret_val_t safe_add_work_ring(queue_context_t *q_context, void *new_item, bool important)
+{
+    uint32_t count = robusto_ring_count(q_context->ring);
+    if (count >= q_context->normal_max_count) {
+        if (!important) {
+            ROB_LOGI(q_context->log_prefix, "The queue is full at %lu items, dropping normal message.", (unsigned long)count);
+            return ROB_ERR_QUEUE_FULL;
+        } else if (count >= q_context->important_max_count) {
+            ROB_LOGE(q_context->log_prefix, "The queue is full at %lu items, dropping important message.", (unsigned long)count);
+            return ROB_ERR_QUEUE_FULL;
+        }
+    }
+    if (!robusto_ring_push(q_context->ring, new_item)) {
+        ROB_LOGE(q_context->log_prefix, "The queue ring is full, dropping message.");
+        return ROB_ERR_QUEUE_FULL;
+    }
+    // Only informative, the ring keeps the actual count
+    q_context->count = (uint8_t)robusto_ring_count(q_context->ring);
+    robusto_semaphore_give(q_context->__x_work_semaphore);
+    return ROB_OK;
+}
+#endif
+
 rob_ret_val_t safe_add_work_queue(queue_context_t *q_context, void *new_item, bool important)
 {
     bool queue_full;
@@ -140,6 +173,12 @@ rob_ret_val_t safe_add_work_queue(queue_context_t *q_context, void *new_item, bo
         return ROB_ERR_MUTEX;
     } 
 
+#ifdef CONFIG_ROBUSTO_QUEUE_RING
+    if (q_context->ring != NULL) {
+        return safe_add_work_ring(q_context, new_item, important);
+    }
+#endif
+
     if (ROB_OK == robusto_mutex_take(q_context->__x_queue_mutex, (q_context->watchdog_timeout-1) * 1000)) // TODO: Not fond of max delay here, what should it be?
     {
         queue_full = q_context->count >= q_context->normal_max_count;
@@ -183,6 +222,10 @@ rob_ret_val_t safe_add_work_queue(queue_context_t *q_context, void *new_item, bo
             q_context->insert_tail_cb(q_context, new_item);
         }
         robusto_mutex_give(q_context->__x_queue_mutex);
+        if (result == ROB_OK) {
+            // Tell the worker there is something to do
+            robusto_semaphore_give(q_context->__x_work_semaphore);
+        }
     }
     else
     {
@@ -200,6 +243,10 @@ void set_queue_blocked(queue_context_t *q_context, bool blocked)
     {
         q_context->blocked = blocked;
         robusto_mutex_give(q_context->__x_queue_mutex);
+        if (!blocked) {
+            // There may be items waiting that the worker didn't touch while blocked
+            wake_queue_worker(q_context);
+        }
     }
     else
     {
@@ -208,6 +255,9 @@ void set_queue_blocked(queue_context_t *q_context, bool blocked)
     }
 }
 
-
-
-
+void wake_queue_worker(queue_context_t *q_context)
+{
+    if (q_context->__x_work_semaphore != NULL) {
+        robusto_semaphore_give(q_context->__x_work_semaphore);
+    }
+}
@@ -0,0 +1,184 @@
+/**
+ * @file robusto_ring.c
+ * @author Nicklas Börjesson (<nicklasb at gmail dot com>)
+ * @brief A lock-free, fixed-capacity ring buffer backend for Robusto queues.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright
+ * Copyright (c) 2026, Nicklas Börjesson <nicklasb at gmail dot com>
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * This is a bounded multi-producer queue where every slot has a sequence number, 
+ * (based on Dmitry Vyukov's bounded MPMC queue):
+ * - A producer claims a slot by advancing the head with a compare-and-swap, writes the item, 
+ *   and then publishes it by setting the slot sequence. 
+ * - The consumer only reads a slot when its sequence says it has been published. 
+ * There are no locks and no allocations after creation, so any number of tasks may add items 
+ * while the worker takes them. 
+ * Note that the queue is only lock-free where the platform has native atomics, 
+ * on others the compiler falls back to short critical sections.
+ */
+
+#include <robusto_queue.h>
+#ifdef CONFIG_ROBUSTO_QUEUE_RING
+
+#include <robusto_system.h>
+#include <stdatomic.h>
+
+typedef struct robusto_ring_cell
+{
+    _Atomic uint32_t sequence;
+    void *item;
+} robusto_ring_cell_t;
+
+struct robusto_ring
+{
+    uint32_t mask;
+    /* Producers and the consumer are kept apart to avoid them sharing cache lines where there are such */
+    _Atomic uint32_t head;
+    uint8_t __padding[32];
+    _Atomic uint32_t tail;
+    robusto_ring_cell_t *cells;
+};
+
+robusto_ring_t *robusto_ring_create(uint16_t capacity)
+{
+    // Round up to a power of two, so that the position can be masked into an index
+    uint32_t size = 2;
+    while (size < capacity)
+    {
+        size <<= 1;
+    }
+
+    robusto_ring_t *ring = robusto_malloc(sizeof(robusto_ring_t));
+    if (ring == NULL)
+    {
+        return NULL;
+    }
+    ring->cells = robusto_malloc(sizeof(robusto_ring_cell_t) * size);
+    if (ring->cells == NULL)
+    {
+        robusto_free(ring);
+        return NULL;
+    }
+    ring->mask = size - 1;
+    for (uint32_t i = 0; i < size; i++)
+    {
+        atomic_init(&ring->cells[i].sequence, i);
+        ring->cells[i].item = NULL;
+    }
+    atomic_init(&ring->head, 0);
+    atomic_init(&ring->tail, 0);
+    return ring;
+}
+
+void robusto_ring_free(robusto_ring_t *ring)
+{
+    if (ring != NULL)
+    {
+        robusto_free(ring->cells);
+        robusto_free(ring);
+    }
+}
+
+bool robusto_ring_push(robusto_ring_t *ring, void *item)
+{
+    robusto_ring_cell_t *cell;
+    uint32_t pos = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    for (;;)
+    {
+        cell = &ring->cells[pos & ring->mask];
+        uint32_t sequence = atomic_load_explicit(&cell->sequence, memory_order_acquire);
+        int32_t diff = (int32_t)(sequence - pos);
+        if (diff == 0)
+        {
+            // The cell is free, try to claim it
+            uint32_t expected = pos;
+            if (atomic_compare_exchange_weak_explicit(&ring->head, &expected, pos + 1, memory_order_relaxed, memory_order_relaxed))
+            {
+                break;
+            }
+            pos = expected;
+        }
+        else if (diff < 0)
+        {
+            // The consumer hasn't released this cell yet, the ring is full
+            return false;
+        }
+        else
+        {
+            // Another producer claimed it first
+            pos = atomic_load_explicit(&ring->head, memory_order_relaxed);
+        }
+    }
+    cell->item = item;
+    // Publish the item to the consumer
+    atomic_store_explicit(&cell->sequence, pos + 1, memory_order_release);
+    return true;
+}
+
+void *robusto_ring_pop(robusto_ring_t *ring)
+{
+    robusto_ring_cell_t *cell;
+    uint32_t pos = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    for (;;)
+    {
+        cell = &ring->cells[pos & ring->mask];
+        uint32_t sequence = atomic_load_explicit(&cell->sequence, memory_order_acquire);
+        int32_t diff = (int32_t)(sequence - (pos + 1));
+        if (diff == 0)
+        {
+            uint32_t expected = pos;
+            if (atomic_compare_exchange_weak_explicit(&ring->tail, &expected, pos + 1, memory_order_relaxed, memory_order_relaxed))
+            {
+                break;
+            }
+            pos = expected;
+        }
+        else if (diff < 0)
+        {
+            // Nothing published here, the ring is empty
+            return NULL;
+        }
+        else
+        {
+            pos = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+        }
+    }
+    void *item = cell->item;
+    // Release the cell to the producers for the next lap
+    atomic_store_explicit(&cell->sequence, pos + ring->mask + 1, memory_order_release);
+    return item;
+}
+
+uint32_t robusto_ring_count(robusto_ring_t *ring)
+{
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    // Claimed, but not yet published, items are included
+    return head - tail;
+}
+
+#endif
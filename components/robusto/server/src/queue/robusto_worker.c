@@ -46,8 +46,37 @@
 /* The log prefix for all logging */
 static const char *robusto_worker_log_prefix;
 
+/* A worker in the pool of a multitasking queue */
+struct queue_pool_worker
+{
+    queue_context_t *q_context;
+    /* Parks the worker until it is handed an item or told to stop */
+    semaphore_ref_t __x_wake_semaphore;
+    /* The item the worker should handle */
+    void *work;
+    /* Set by the dispatcher when handing over an item, cleared by the worker when done.
+    As with the queue state, single byte access is atomic on all relevant platforms. */
+    bool busy;
+    /* If set, the worker will stop when idle */
+    bool stop;
+    /* Set by the worker when it has stopped */
+    bool stopped;
+    uint32_t items_handled;
+    uint32_t busy_ms;
+    char task_name[30];
+};
+
 void *safe_get_head_work_item(queue_context_t *q_context)
 {
+#ifdef CONFIG_ROBUSTO_QUEUE_RING
+    if (q_context->ring != NULL)
+    {
+        // Only the worker takes items, so the ring needs no lock
+        void *curr_work = robusto_ring_pop(q_context->ring);
+        q_context->count = (uint8_t)robusto_ring_count(q_context->ring);
+        return curr_work;
+    }
+#endif
     if (ROB_OK == robusto_mutex_take(q_context->__x_queue_mutex, 300))
     {
         /* Pull the first item from the work queue */
@@ -57,15 +86,15 @@ void *safe_get_head_work_item(queue_context_t *q_context)
         if (curr_work != NULL)
         {
             q_context->remove_first_queueitem_cb(q_context);
-            ROB_LOGW(robusto_worker_log_prefix,
-                     ">> Queue dequeue queue=%s count=%u normal_max=%u important_max=%u blocked=%u tasks=%u multitasking=%u",
-                     q_context->worker_task_name,
-                     q_context->count,
-                     q_context->normal_max_count,
-                     q_context->important_max_count,
-                     q_context->blocked,
-                     q_context->task_count,
-                     q_context->multitasking);
+            ROB_LOGW_DEFERRED(robusto_worker_log_prefix,
+                              ">> Queue dequeue queue=%s count=%u normal_max=%u important_max=%u blocked=%u tasks=%u multitasking=%u",
+                              q_context->worker_task_name,
+                              q_context->count,
+                              q_context->normal_max_count,
+                              q_context->important_max_count,
+                              q_context->blocked,
+                              q_context->task_count,
+                              q_context->multitasking);
         }
         robusto_mutex_give(q_context->__x_queue_mutex);
         return curr_work;
@@ -83,6 +112,10 @@ void alter_task_count(queue_context_t *q_context, int change)
     {
         q_context->task_count = q_context->task_count + change;
         robusto_mutex_give(q_context->__x_task_state_mutex);
+        if (change < 0) {
+            // A task slot was freed, a worker waiting for it may continue
+            wake_queue_worker(q_context);
+        }
     }
     else
     {
@@ -97,12 +130,139 @@ void alter_task_count(queue_context_t *q_context, int change)
  */
 void cleanup_queue_task(queue_context_t *q_context)
 {
-    ROB_LOGI(robusto_worker_log_prefix, "Cleaning up tasks.");
-    alter_task_count(q_context, -1);
-    if (q_context->multitasking)
+    // The pool workers are reused and keep track of the task count themselves.
+    (void)q_context;
+}
+
+static void robusto_pool_worker(queue_pool_worker_t *worker)
+{
+    queue_context_t *q_context = worker->q_context;
+    robusto_watchdog_set_timeout(q_context->watchdog_timeout);
+
+    for (;;)
+    {
+        robusto_semaphore_take(worker->__x_wake_semaphore, CONFIG_ROBUSTO_WORKER_IDLE_TIMEOUT_MS);
+        if (worker->busy)
+        {
+            uint32_t starttime = r_millis();
+            q_context->on_work_cb(worker->work);
+            worker->busy_ms += r_millis() - starttime;
+            worker->items_handled++;
+            worker->work = NULL;
+            worker->busy = false;
+            // Also wakes the dispatcher, as there is now an idle worker
+            alter_task_count(q_context, -1);
+        }
+        else if (worker->stop)
+        {
+            break;
+        }
+    }
+    ROB_LOGI(robusto_worker_log_prefix, "Pool worker %s stopped.", worker->task_name);
+    robusto_semaphore_deinit(worker->__x_wake_semaphore);
+    worker->__x_wake_semaphore = NULL;
+    worker->stopped = true;
+    robusto_delete_current_task();
+}
+
+static queue_pool_worker_t *get_idle_pool_worker(queue_context_t *q_context)
+{
+    for (uint8_t i = 0; i < q_context->pool_size; i++)
+    {
+        if (!q_context->pool[i].busy)
+        {
+            return &q_context->pool[i];
+        }
+    }
+    return NULL;
+}
+
+static rob_ret_val_t start_worker_pool(queue_context_t *q_context)
+{
+    uint8_t pool_size = q_context->max_task_count > 0 ? q_context->max_task_count : CONFIG_ROBUSTO_WORKER_POOL_SIZE;
+    q_context->pool = robusto_malloc(sizeof(queue_pool_worker_t) * pool_size);
+    if (q_context->pool == NULL)
+    {
+        ROB_LOGE(robusto_worker_log_prefix, "Failed allocating a pool of %u workers for %s.", pool_size, q_context->worker_task_name);
+        return ROB_ERR_OUT_OF_MEMORY;
+    }
+    memset(q_context->pool, 0, sizeof(queue_pool_worker_t) * pool_size);
+    q_context->pool_size = 0;
+
+    for (uint8_t i = 0; i < pool_size; i++)
+    {
+        queue_pool_worker_t *worker = &q_context->pool[i];
+        worker->q_context = q_context;
+        worker->__x_wake_semaphore = robusto_semaphore_init();
+        assert(worker->__x_wake_semaphore);
+        sprintf(worker->task_name, "%s_worker_%d", robusto_worker_log_prefix, i + 1);
+        rob_task_handle_t *task_handle = NULL;
+        /* To avoid congestion on Core 0, we act on non-immidiate requests on Core 1 (APP) */
+#if defined(CONFIG_ROBUSTO_WORKER_TASK_STACK_SIZE) && CONFIG_ROBUSTO_WORKER_TASK_STACK_SIZE > 0
+        rob_ret_val_t rc = robusto_create_task_custom((TaskFunction_t)robusto_pool_worker, worker, worker->task_name, &task_handle, 1, CONFIG_ROBUSTO_WORKER_TASK_STACK_SIZE);
+#else
+        rob_ret_val_t rc = robusto_create_task((TaskFunction_t)robusto_pool_worker, worker, worker->task_name, &task_handle, 1);
+#endif
+        if (rc != ROB_OK)
+        {
+            ROB_LOGE(robusto_worker_log_prefix, "Failed creating pool worker %s, returned: %i (see projdefs.h)", worker->task_name, rc);
+            robusto_semaphore_deinit(worker->__x_wake_semaphore);
+            break;
+        }
+        q_context->pool_size++;
+    }
+    if (q_context->pool_size == 0)
     {
-        // If we do this when it is not multitasking, we kill the entire queue worker task.
-        robusto_delete_current_task();
+        robusto_free(q_context->pool);
+        q_context->pool = NULL;
+        return ROB_ERR_INIT_FAIL;
+    }
+    ROB_LOGI(robusto_worker_log_prefix, "Started %u pool workers for %s.", q_context->pool_size, q_context->worker_task_name);
+    return ROB_OK;
+}
+
+static void stop_worker_pool(queue_context_t *q_context)
+{
+    // Tell all workers to stop, busy workers will stop when done
+    for (uint8_t i = 0; i < q_context->pool_size; i++)
+    {
+        q_context->pool[i].stop = true;
+        robusto_semaphore_give(q_context->pool[i].__x_wake_semaphore);
+    }
+    for (uint8_t i = 0; i < q_context->pool_size; i++)
+    {
+        if (!robusto_waitfor_bool(&q_context->pool[i].stopped, q_context->watchdog_timeout * 1000))
+        {
+            // We can't free the pool under a running worker
+            ROB_LOGE(robusto_worker_log_prefix, "Pool worker %s did not stop, not freeing the pool.", q_context->pool[i].task_name);
+            return;
+        }
+    }
+    robusto_free(q_context->pool);
+    q_context->pool = NULL;
+    q_context->pool_size = 0;
+}
+
+uint8_t get_queue_worker_stats(queue_context_t *q_context, queue_worker_stats_t *stats, uint8_t max_count)
+{
+    uint8_t count = 0;
+    for (; count < q_context->pool_size && count < max_count; count++)
+    {
+        stats[count].items_handled = q_context->pool[count].items_handled;
+        stats[count].busy_ms = q_context->pool[count].busy_ms;
+        stats[count].busy = q_context->pool[count].busy;
+    }
+    return count;
+}
+
+void log_queue_worker_stats(queue_context_t *q_context)
+{
+    ROB_LOGI(robusto_worker_log_prefix, "%s pool workers:", q_context->worker_task_name);
+    for (uint8_t i = 0; i < q_context->pool_size; i++)
+    {
+        ROB_LOGI(robusto_worker_log_prefix, "%s: items handled: %lu, busy: %lu ms%s", q_context->pool[i].task_name,
+                 (unsigned long)q_context->pool[i].items_handled, (unsigned long)q_context->pool[i].busy_ms,
+                 q_context->pool[i].busy ? " (working)" : "");
     }
 }
 
@@ -116,6 +276,7 @@ void log_queue_context(queue_context_t *q_context)
     ROB_LOGI(robusto_worker_log_prefix, "insert_tail_cb: %p", q_context->insert_tail_cb);
     ROB_LOGI(robusto_worker_log_prefix, "insert_head_cb: %p", q_context->insert_head_cb);
     ROB_LOGI(robusto_worker_log_prefix, "multitasking: %s", q_context->multitasking ? "true" : "false");
+    ROB_LOGI(robusto_worker_log_prefix, "pool_size: %i", q_context->pool_size);
     ROB_LOGI(robusto_worker_log_prefix, "watchdog_timeout: %i seconds", q_context->watchdog_timeout);
     ROB_LOGI(robusto_worker_log_prefix, "---------------------------");
 }
@@ -128,7 +289,8 @@ static void robusto_worker(queue_context_t *q_context)
     robusto_watchdog_set_timeout(q_context->watchdog_timeout);
 
     void *curr_work = NULL;
-    uint8_t yield_counter = 0;
+    /* Workers with a poll callback must wake up regularily to call it, others only need to check for shutdown */
+    uint32_t wait_timeout_ms = q_context->on_poll_cb != NULL ? CONFIG_ROBUSTO_WORKER_POLL_INTERVAL_MS : CONFIG_ROBUSTO_WORKER_IDLE_TIMEOUT_MS;
 
     for (;;)
     {
@@ -137,36 +299,26 @@ static void robusto_worker(queue_context_t *q_context)
         {
             break;
         }
+        curr_work = NULL;
         // First check so that the queue isn't blocked
         if (!q_context->blocked)
         {
-            // Use separate tasks
+            // Hand the work to the worker pool
             if (q_context->multitasking)
             {
-                // Check that we don't have a maximum number of tasks
-                if (q_context->max_task_count == 0 ||
-                    // Or if we do, that we don't exceed it
-                    (q_context->max_task_count > 0 && (q_context->task_count < q_context->max_task_count)))
+                // If all workers are busy, we will be woken when one is done
+                queue_pool_worker_t *worker = get_idle_pool_worker(q_context);
+                if (worker != NULL)
                 {
                     // Check if there is anything to do
                     curr_work = safe_get_head_work_item(q_context);
                     if (curr_work != NULL)
                     {
-                        ROB_LOGI(robusto_worker_log_prefix, ">> Running multitasking callback on_work. Worker address %p", q_context->on_work_cb);
-                        char taskname[30] = "\0";
-                        sprintf(taskname, "%s_worker_%d", robusto_worker_log_prefix, q_context->task_count + 1);
-                        /* To avoid congestion on Core 0, we act on non-immidiate requests on Core 1 (APP) */
+                        ROB_LOGD(robusto_worker_log_prefix, ">> Handing work %p to pool worker %s.", curr_work, worker->task_name);
                         alter_task_count(q_context, 1);
-                        rob_ret_val_t rc = robusto_create_task((TaskFunction_t)q_context->on_work_cb, q_context, taskname, (rob_task_handle_t **)&q_context->worker_task_handle, 1);
-                        if (rc != ROB_OK)
-                        {
-                            ROB_LOGE(robusto_worker_log_prefix, ">> Failed creating work task, returned: %i (see projdefs.h)", rc);
-                            alter_task_count(q_context, -1);
-                        }
-                        else
-                        {
-                            ROB_LOGI(robusto_worker_log_prefix, ">> Created task: %s, taskcount: %i", taskname, q_context->task_count);
-                        }
+                        worker->work = curr_work;
+                        worker->busy = true;
+                        robusto_semaphore_give(worker->__x_wake_semaphore);
                     }
                 }
             }
@@ -179,22 +331,27 @@ static void robusto_worker(queue_context_t *q_context)
                     ROB_LOGD(robusto_worker_log_prefix, ">> Running single task callback on_work. Worker address %p, work address %p.", (void *)(q_context->on_work_cb), (void *)(curr_work));
                     q_context->on_work_cb(curr_work);
                 }
-                robusto_yield();
             }
-
-        
-        }
-        // Only yield every 10th time, to avoid minimize latency
-        if (++yield_counter >= 10) {
-            robusto_yield();   
-            /* If defined, call the poll callback. */
-
-            yield_counter = 0;
         }
+        /* If defined, call the poll callback. */
         if (q_context->on_poll_cb != NULL)
         {
             q_context->on_poll_cb(q_context);
-        }  
+        }
+        if (curr_work != NULL)
+        {
+            // There may be more in the queue, just let others run before we continue draining it.
+            robusto_yield();
+        }
+        else
+        {
+            // Nothing to do, sleep until someone adds work, unblocks the queue or the poll timeout passes.
+            robusto_semaphore_take(q_context->__x_work_semaphore, wait_timeout_ms);
+        }
+    }
+    if (q_context->pool != NULL)
+    {
+        stop_worker_pool(q_context);
     }
     ROB_LOGI(robusto_worker_log_prefix, "Worker task %s shut down, deleting task.", q_context->worker_task_name);
     // TODO: Should there be some freeing of semaphore here?
@@ -202,15 +359,22 @@ static void robusto_worker(queue_context_t *q_context)
 
     robusto_mutex_deinit(q_context->__x_queue_mutex);
     robusto_mutex_deinit(q_context->__x_task_state_mutex);
+    robusto_semaphore_deinit(q_context->__x_work_semaphore);
+    q_context->__x_work_semaphore = NULL;
+#ifdef CONFIG_ROBUSTO_QUEUE_RING
+    robusto_ring_free(q_context->ring);
+    q_context->ring = NULL;
+#endif
 
     robusto_delete_current_task();
 }
 
-rob_ret_val_t init_work_queue(queue_context_t *q_context, const char *_log_prefix, const char *queue_name)
+static rob_ret_val_t start_work_queue(queue_context_t *q_context, const char *_log_prefix, const char *queue_name, robusto_ring_t *ring)
 {
     robusto_worker_log_prefix = _log_prefix;
 
     ROB_LOGI(robusto_worker_log_prefix, "Initiating the %s work queue.", queue_name);
+    q_context->ring = ring;
 
     if (q_context->on_work_cb == NULL)
     {
@@ -237,6 +401,8 @@ rob_ret_val_t init_work_queue(queue_context_t *q_context, const char *_log_prefi
     assert(q_context->__x_queue_mutex);
     q_context->__x_task_state_mutex = robusto_mutex_init();
     assert(q_context->__x_task_state_mutex);
+    q_context->__x_work_semaphore = robusto_semaphore_init();
+    assert(q_context->__x_work_semaphore);
     // Reset task count (unsafely as this must be the only initiator)
     q_context->task_count = 0;
 
@@ -257,6 +423,17 @@ rob_ret_val_t init_work_queue(queue_context_t *q_context, const char *_log_prefi
      * TODO: Should we try to allocate these tasks statically using xTaskCreateStatic or/and xTaskCreateRestrictedStatic?
      */
     // TODO: Apps aren't actually run on 1? So should we move these to 1 instead?
+    q_context->pool = NULL;
+    q_context->pool_size = 0;
+    if (q_context->multitasking)
+    {
+        rob_ret_val_t pool_rc = start_worker_pool(q_context);
+        if (pool_rc != ROB_OK)
+        {
+            return pool_rc;
+        }
+    }
+
     ROB_LOGI(robusto_worker_log_prefix, "Register the worker task. Name: %s", q_context->worker_task_name);
     /* We obviously don't immidiately want to shutdown the worker just because someone haven't set shutdown to false. */
     q_context->shutdown = false;
@@ -269,6 +446,10 @@ rob_ret_val_t init_work_queue(queue_context_t *q_context, const char *_log_prefi
     if (rc != ROB_OK)
     {
         ROB_LOGE(robusto_worker_log_prefix, "Failed creating worker task, returned: %i (see projdefs.h)", rc);
+        if (q_context->pool != NULL)
+        {
+            stop_worker_pool(q_context);
+        }
         return ROB_ERR_INIT_FAIL;
     }
 
@@ -276,3 +457,27 @@ rob_ret_val_t init_work_queue(queue_context_t *q_context, const char *_log_prefi
 
     return ROB_OK;
 }
+
+rob_ret_val_t init_work_queue(queue_context_t *q_context, const char *_log_prefix, const char *queue_name)
+{
+    return start_work_queue(q_context, _log_prefix, queue_name, NULL);
+}
+
+#ifdef CONFIG_ROBUSTO_QUEUE_RING
+rob_ret_val_t init_work_queue_ring(queue_context_t *q_context, const char *_log_prefix, const char *queue_name, uint16_t capacity)
+{
+    robusto_ring_t *ring = robusto_ring_create(capacity);
+    if (ring == NULL)
+    {
+        ROB_LOGE(_log_prefix, "Work queue init of %s failed; could not allocate a ring of %u items.", queue_name, capacity);
+        return ROB_ERR_OUT_OF_MEMORY;
+    }
+    rob_ret_val_t retval = start_work_queue(q_context, _log_prefix, queue_name, ring);
+    if (retval != ROB_OK)
+    {
+        q_context->ring = NULL;
+        robusto_ring_free(ring);
+    }
+    return retval;
+}
+#endif
@@ -0,0 +1,82 @@
+#!/usr/bin/env python3
+"""
+Generates the CRC32 lookup tables used by components/robusto/base/src/system/robusto_crc32.c
+
+Usage: python3 development/gen_crc32_tables.py
+"""
+
+from pathlib import Path
+
+OUTPUT = Path(__file__).resolve().parents[1] / "components" / "robusto" / "base" / "src" / "system" / "robusto_crc32_tables.h"
+SLICES = 8
+
+
+def msb_first_tables(polynomial):
+    first = []
+    for n in range(256):
+        crc = n << 24
+        for _ in range(8):
+            crc = ((crc << 1) ^ polynomial if crc & 0x80000000 else crc << 1) & 0xFFFFFFFF
+        first.append(crc)
+    tables = [first]
+    for _ in range(1, SLICES):
+        previous = tables[-1]
+        tables.append([((c << 8) & 0xFFFFFFFF) ^ first[c >> 24] for c in previous])
+    return tables
+
+
+def lsb_first_tables(polynomial):
+    first = []
+    for n in range(256):
+        crc = n
+        for _ in range(8):
+            crc = (crc >> 1) ^ polynomial if crc & 1 else crc >> 1
+        first.append(crc)
+    tables = [first]
+    for _ in range(1, SLICES):
+        previous = tables[-1]
+        tables.append([(c >> 8) ^ first[c & 0xFF] for c in previous])
+    return tables
+
+
+def format_table(name, comment, tables):
+    lines = [f"/* {comment} */", f"static const uint32_t {name}[ROBUSTO_CRC32_SLICES][256] = {{"]
+    for index, table in enumerate(tables):
+        if index == 1:
+            lines.append("#if ROBUSTO_CRC32_SLICES > 1")
+        lines.append("    {")
+        for row in range(0, 256, 6):
+            lines.append("        " + " ".join(f"0x{value:08x}U," for value in table[row:row + 6]))
+        lines.append("    },")
+    lines.append("#endif")
+    lines.append("};")
+    return "\n".join(lines)
+
+
+def main():
+    content = "\n".join(
+        (
+            "/* Generated by development/gen_crc32_tables.py, do not edit. */",
+            "#pragma once",
+            "",
+            "#include <stdint.h>",
+            "",
+            format_table(
+                "crc32_msb_first_tables",
+                "CRC32 polynomial 0x04c11db7, most significant bit first. Table k advances a byte k bytes from the end.",
+                msb_first_tables(0x04C11DB7),
+            ),
+            "",
+            format_table(
+                "crc32_lsb_first_tables",
+                "CRC32 polynomial 0x04c11db7 reflected (0xedb88320), least significant bit first.",
+                lsb_first_tables(0xEDB88320),
+            ),
+            "",
+        )
+    )
+    OUTPUT.write_text(content)
+
+
+if __name__ == "__main__":
+    main()
@@ -1613,6 +1613,18 @@ static uint16_t fake_pubsub_publish_chunk(
     return ROBUSTO_PROXY_STATUS_OK;
 }
 
+static uint16_t fake_pubsub_publish_progress(
+    void *context, uint64_t operation_id, uint32_t *received)
+{
+    fake_pubsub_adapter_state_t *state = context;
+    if (operation_id != state->last_operation_id)
+    {
+        return ROBUSTO_PROXY_STATUS_CONFLICT;
+    }
+    *received = state->publish_data_received;
+    return ROBUSTO_PROXY_STATUS_OK;
+}
+
 static uint16_t fake_pubsub_publish_commit(
     void *context, const robusto_proxy_pubsub_publish_transfer_request_t *request,
     robusto_proxy_pubsub_publish_response_t *response)
@@ -2055,7 +2067,8 @@ static void test_proxy_client_connect_publish_and_acceptance(void)
     TEST_ASSERT_EQUAL_U32(0xC6U, (uint32_t)capabilities.proxy_boot_id);
     TEST_ASSERT_EQUAL_U32(ROBUSTO_PROXY_FEATURE_PUBSUB_V1 |
                               ROBUSTO_PROXY_FEATURE_PUBSUB_CHUNKED_PUBLISH |
-                              ROBUSTO_PROXY_FEATURE_PUBSUB_CHUNKED_DELIVERY,
+                              ROBUSTO_PROXY_FEATURE_PUBSUB_CHUNKED_DELIVERY |
+                              ROBUSTO_PROXY_FEATURE_PUBSUB_DELIVERY_BATCH,
                           (uint32_t)capabilities.enabled_features);
 
     TEST_ASSERT_EQUAL_INT(
@@ -2517,6 +2530,111 @@ static uint16_t fake_server_unsubscribe(void *context, uint32_t topic_hash,
     return ROBUSTO_PROXY_STATUS_OK;
 }
 
+static void test_pubsub_server_adapter_shares_large_data_and_wraps_the_pool(void)
+{
+    static const uint8_t topic[] = "sensor.temp";
+    static const uint8_t second_topic[] = "sensor.pressure";
+    static const uint8_t first_data[] = {1U, 2U, 3U, 4U, 5U};
+    static const uint8_t wrapped_data[] = {6U, 7U, 8U, 9U, 10U, 11U};
+    static uint8_t large_data[5000U];
+    const robusto_proxy_pubsub_backend_t backend = {
+        fake_server_publish, fake_server_subscribe, fake_server_unsubscribe};
+    fake_server_backend_state_t backend_state = {0};
+    robusto_proxy_pubsub_server_adapter_t adapter;
+    robusto_proxy_pubsub_subscription_t subscriptions[2];
+    uint8_t event_pool[8];
+    robusto_proxy_pubsub_subscribe_request_t subscribe = {
+        1U, topic, 11U, ROBUSTO_PROXY_PUBSUB_SUBSCRIBE_DELIVERIES};
+    robusto_proxy_pubsub_subscribe_response_t subscribe_response;
+    robusto_proxy_pubsub_delivery_t delivery;
+    robusto_proxy_service_t service;
+    uint8_t event_frame[ROBUSTO_PROXY_SLOT_SIZE_BYTES];
+    uint8_t *payload = event_frame + ROBUSTO_PROXY_HEADER_SIZE_BYTES;
+    uint8_t delivery_opcode = 0U;
+    size_t payload_size = 0U;
+    size_t event_frame_size = 0U;
+    const robusto_proxy_pubsub_adapter_t *operations =
+        robusto_proxy_pubsub_server_adapter_operations();
+
+    TEST_ASSERT_TRUE(robusto_proxy_pubsub_server_adapter_init(
+        &adapter, &backend, &backend_state, subscriptions, 2U,
+        event_pool, sizeof(event_pool), (robusto_proxy_pubsub_lock_t){0}));
+    TEST_ASSERT_EQUAL_U32(ROBUSTO_PROXY_STATUS_OK,
+                          operations->subscribe(&adapter, &subscribe, &subscribe_response));
+    subscribe.operation_id = 2U;
+    subscribe.topic = second_topic;
+    subscribe.topic_length = 15U;
+    TEST_ASSERT_EQUAL_U32(ROBUSTO_PROXY_STATUS_OK,
+                          operations->subscribe(&adapter, &subscribe, &subscribe_response));
+
+    /* Both subscriptions deliver the same copy of large data */
+    for (size_t index = 0U; index < sizeof(large_data); ++index)
+    {
+        large_data[index] = (uint8_t)(index * 7U);
+    }
+    for (uint16_t index = 0U; index < 2U; ++index)
+    {
+        TEST_ASSERT_EQUAL_U32(ROBUSTO_PROXY_STATUS_OK,
+                              subscriptions[index].delivery_callback(
+                                  subscriptions[index].delivery_callback_context,
+                                  large_data, sizeof(large_data)));
+    }
+    TEST_ASSERT_EQUAL_U32(2U, adapter.event_count);
+    TEST_ASSERT_TRUE(adapter.events[0].transfer_data != NULL);
+    TEST_ASSERT_TRUE(adapter.events[0].transfer_data != large_data);
+    TEST_ASSERT_TRUE(adapter.events[0].transfer_data == adapter.events[1].transfer_data);
+    /* Changed data at the same address is copied again */
+    large_data[0] ^= 0xFFU;
+    TEST_ASSERT_EQUAL_U32(ROBUSTO_PROXY_STATUS_OK,
+                          subscriptions[0].delivery_callback(
+                              subscriptions[0].delivery_callback_context,
+                              large_data, sizeof(large_data)));
+    TEST_ASSERT_TRUE(adapter.events[2].transfer_data != adapter.events[0].transfer_data);
+    TEST_ASSERT_TRUE(memcmp(adapter.events[2].transfer_data, large_data,
+                            sizeof(large_data)) == 0);
+    TEST_ASSERT_EQUAL_U32(ROBUSTO_PROXY_STATUS_OK, operations->session_reset(&adapter));
+    TEST_ASSERT_EQUAL_U32(0U, adapter.event_count);
+    TEST_ASSERT_TRUE(adapter.shared_data == NULL);
+
+    /* Small data wraps around the end of the pool, and is taken straight into an event frame */
+    robusto_proxy_service_init(&service, ROBUSTO_PROXY_PROFILE_LOW_MEMORY,
+                               1U, 1U, 9U, 2U, 0U);
+    service.session.state = ROBUSTO_PROXY_SESSION_ESTABLISHED;
+    service.session.enabled_features = ROBUSTO_PROXY_FEATURE_PUBSUB_V1;
+    TEST_ASSERT_EQUAL_U32(ROBUSTO_PROXY_STATUS_OK,
+                          subscriptions[0].delivery_callback(
+                              subscriptions[0].delivery_callback_context,
+                              first_data, sizeof(first_data)));
+    TEST_ASSERT_TRUE(robusto_proxy_pubsub_server_adapter_take_delivery(
+        &adapter, true, &delivery_opcode, payload, ROBUSTO_PROXY_MAX_PAYLOAD_BYTES,
+        &payload_size));
+    TEST_ASSERT_TRUE(robusto_proxy_pubsub_server_adapter_complete_delivery(
+        &adapter, true));
+    TEST_ASSERT_EQUAL_U32(ROBUSTO_PROXY_STATUS_OK,
+                          subscriptions[1].delivery_callback(
+                              subscriptions[1].delivery_callback_context,
+                              wrapped_data, sizeof(wrapped_data)));
+    TEST_ASSERT_EQUAL_U32(3U, adapter.event_pool_write);
+    TEST_ASSERT_TRUE(robusto_proxy_pubsub_server_adapter_take_delivery(
+        &adapter, true, &delivery_opcode, payload, ROBUSTO_PROXY_MAX_PAYLOAD_BYTES,
+        &payload_size));
+    TEST_ASSERT_EQUAL_INT(ROBUSTO_PROXY_RESULT_OK,
+                          robusto_proxy_service_build_pubsub_event(
+                              &service, delivery_opcode, payload, payload_size,
+                              event_frame, sizeof(event_frame), &event_frame_size));
+    TEST_ASSERT_EQUAL_INT(ROBUSTO_PROXY_RESULT_OK,
+                          robusto_proxy_frame_validate_buffer(
+                              event_frame, event_frame_size, NULL));
+    TEST_ASSERT_EQUAL_INT(ROBUSTO_PROXY_RESULT_OK,
+                          robusto_proxy_pubsub_decode_delivery(payload, payload_size, &delivery));
+    TEST_ASSERT_EQUAL_U32(sizeof(wrapped_data), delivery.data_length);
+    TEST_ASSERT_TRUE(memcmp(delivery.data, wrapped_data, sizeof(wrapped_data)) == 0);
+    TEST_ASSERT_TRUE(robusto_proxy_pubsub_server_adapter_complete_delivery(
+        &adapter, true));
+    TEST_ASSERT_EQUAL_U32(0U, adapter.event_pool_used);
+    TEST_ASSERT_EQUAL_U32(0U, adapter.event_count);
+}
+
 static void test_pubsub_server_adapter_subscription_delivery_and_overflow(void)
 {
     static const uint8_t topic[] = "sensor.temp";
@@ -2904,6 +3022,498 @@ static void test_pubsub_client_interleaves_inline_and_chunked_deliveries(void)
     TEST_ASSERT_TRUE(client.pubsub_delivery_data == NULL);
 }
 
+#define FAKE_PIPELINE_RESPONSES 4U
+
+typedef struct fake_pipeline_transport {
+    robusto_proxy_service_t *service;
+    /* If set, waiting hands the kept responses to the client, like a receive task would */
+    robusto_proxy_client_t *client;
+    uint32_t now_ms;
+    uint32_t sends;
+    uint32_t delivered;
+    uint32_t max_outstanding;
+    /* One-based number of a send that is lost on the link, zero for none */
+    uint32_t lost_send;
+    size_t response_sizes[FAKE_PIPELINE_RESPONSES];
+    uint8_t responses[FAKE_PIPELINE_RESPONSES][ROBUSTO_PROXY_SLOT_SIZE_BYTES];
+} fake_pipeline_transport_t;
+
+typedef struct fake_pipeline_completion {
+    uint32_t calls;
+    rob_ret_val_t result;
+    size_t payload_size;
+    robusto_proxy_health_response_t health;
+} fake_pipeline_completion_t;
+
+static uint32_t fake_pipeline_now_ms(void *context)
+{
+    return ((fake_pipeline_transport_t *)context)->now_ms;
+}
+
+static void fake_pipeline_wait_ms(void *context, uint32_t delay_ms)
+{
+    fake_pipeline_transport_t *transport = context;
+    transport->now_ms += delay_ms;
+    while (transport->client != NULL && transport->delivered < transport->sends)
+    {
+        uint32_t index = transport->delivered % FAKE_PIPELINE_RESPONSES;
+        transport->delivered += 1U;
+        if (transport->response_sizes[index] > 0U)
+        {
+            (void)robusto_proxy_client_dispatch(transport->client,
+                                                transport->responses[index],
+                                                transport->response_sizes[index]);
+        }
+    }
+}
+
+static rob_ret_val_t fake_pipeline_exchange(
+    void *context,
+    const uint8_t *request,
+    size_t request_size,
+    uint8_t *response,
+    size_t response_capacity,
+    size_t *response_size,
+    uint32_t timeout_ms,
+    robusto_proxy_transfer_acceptance_t *acceptance)
+{
+    fake_pipeline_transport_t *transport = context;
+    (void)timeout_ms;
+    *acceptance = ROBUSTO_PROXY_TRANSFER_ACCEPTED;
+    return robusto_proxy_service_handle_frame(
+               transport->service, request, request_size, transport->now_ms,
+               response, response_capacity, response_size) == ROBUSTO_PROXY_RESULT_OK
+               ? ROB_OK
+               : ROB_ERR_PARSING_FAILED;
+}
+
+/* Keeps the responses, so that the test decides when and in which order they arrive */
+static rob_ret_val_t fake_pipeline_send(
+    void *context,
+    const uint8_t *request,
+    size_t request_size,
+    uint32_t timeout_ms,
+    robusto_proxy_transfer_acceptance_t *acceptance)
+{
+    fake_pipeline_transport_t *transport = context;
+    uint32_t index = transport->sends % FAKE_PIPELINE_RESPONSES;
+    (void)timeout_ms;
+    transport->sends += 1U;
+    if (transport->sends - transport->delivered > transport->max_outstanding)
+    {
+        transport->max_outstanding = transport->sends - transport->delivered;
+    }
+    *acceptance = ROBUSTO_PROXY_TRANSFER_ACCEPTED;
+    transport->response_sizes[index] = 0U;
+    if (transport->sends == transport->lost_send)
+    {
+        return ROB_OK;
+    }
+    return robusto_proxy_service_handle_frame(
+               transport->service, request, request_size, transport->now_ms,
+               transport->responses[index], sizeof(transport->responses[index]),
+               &transport->response_sizes[index]) == ROBUSTO_PROXY_RESULT_OK
+               ? ROB_OK
+               : ROB_ERR_PARSING_FAILED;
+}
+
+static void fake_pipeline_completed(
+    void *context,
+    rob_ret_val_t result,
+    const uint8_t *payload,
+    size_t payload_size)
+{
+    fake_pipeline_completion_t *completion = context;
+    completion->calls += 1U;
+    completion->result = result;
+    completion->payload_size = payload_size;
+    if (result == ROB_OK)
+    {
+        (void)robusto_proxy_decode_health_response(payload, payload_size,
+                                                   &completion->health);
+    }
+}
+
+static void test_proxy_client_pipelines_requests_out_of_order(void)
+{
+    static uint8_t request_frame[ROBUSTO_PROXY_SLOT_SIZE_BYTES];
+    static uint8_t response_frame[ROBUSTO_PROXY_SLOT_SIZE_BYTES];
+    static uint8_t pipeline_frames[2][ROBUSTO_PROXY_SLOT_SIZE_BYTES];
+    static fake_pipeline_transport_t transport;
+    robusto_proxy_service_t service;
+    robusto_proxy_client_t client;
+    fake_pipeline_completion_t first = {0};
+    fake_pipeline_completion_t second = {0};
+    fake_pipeline_completion_t third = {0};
+    robusto_proxy_client_config_t config = {
+        .profile = ROBUSTO_PROXY_PROFILE_LOW_MEMORY,
+        .controller_boot_id = 0x1122334455667788ULL,
+        .correlation_seed = 10U,
+        .sequence_seed = 20U,
+        .operation_seed = 30U,
+        .request_timeout_ms = 1000U,
+        .exchange = fake_pipeline_exchange,
+        .transport_context = &transport,
+        .now_ms = fake_pipeline_now_ms,
+        .wait_ms = fake_pipeline_wait_ms,
+        .retry_jitter_ms = fake_client_retry_jitter_ms,
+        .clock_context = &transport,
+        .request_frame = request_frame,
+        .request_frame_size = sizeof(request_frame),
+        .response_frame = response_frame,
+        .response_frame_size = sizeof(response_frame),
+        .send = fake_pipeline_send,
+        .pipeline_frames = &pipeline_frames[0][0],
+        .pipeline_frame_size = sizeof(pipeline_frames[0]),
+        .pipeline_frame_count = 2U,
+    };
+
+    memset(&transport, 0, sizeof(transport));
+    robusto_proxy_service_init(&service, ROBUSTO_PROXY_PROFILE_LOW_MEMORY,
+                               0xC6U, 1U, 1U, 2U, 0U);
+    transport.service = &service;
+    transport.now_ms = 100U;
+    TEST_ASSERT_EQUAL_INT(ROB_OK, robusto_proxy_client_init(&client, &config));
+    TEST_ASSERT_EQUAL_INT(
+        ROB_ERR_NOT_READY,
+        robusto_proxy_client_submit(&client, ROBUSTO_PROXY_DOMAIN_CONTROL,
+                                    ROBUSTO_PROXY_OPCODE_HEALTH, NULL, 0U, false,
+                                    fake_pipeline_completed, &first));
+    TEST_ASSERT_EQUAL_INT(ROB_OK, robusto_proxy_client_connect(&client));
+
+    /* Two outstanding at once, the negotiated capacity */
+    TEST_ASSERT_EQUAL_INT(
+        ROB_OK,
+        robusto_proxy_client_submit(&client, ROBUSTO_PROXY_DOMAIN_CONTROL,
+                                    ROBUSTO_PROXY_OPCODE_HEALTH, NULL, 0U, false,
+                                    fake_pipeline_completed, &first));
+    TEST_ASSERT_EQUAL_INT(
+        ROB_OK,
+        robusto_proxy_client_submit(&client, ROBUSTO_PROXY_DOMAIN_CONTROL,
+                                    ROBUSTO_PROXY_OPCODE_HEALTH, NULL, 0U, false,
+                                    fake_pipeline_completed, &second));
+    TEST_ASSERT_EQUAL_INT(
+        ROB_ERR_CONV_LIST_FULL,
+        robusto_proxy_client_submit(&client, ROBUSTO_PROXY_DOMAIN_CONTROL,
+                                    ROBUSTO_PROXY_OPCODE_HEALTH, NULL, 0U, false,
+                                    fake_pipeline_completed, &third));
+    TEST_ASSERT_EQUAL_U32(2U, transport.sends);
+    TEST_ASSERT_EQUAL_U32(2U, client.inflight.active_count);
+
+    /* The second response arrives first, and is matched by its correlation id */
+    TEST_ASSERT_TRUE(robusto_proxy_client_dispatch(
+        &client, transport.responses[1], transport.response_sizes[1]));
+    TEST_ASSERT_EQUAL_U32(0U, first.calls);
+    TEST_ASSERT_EQUAL_U32(1U, second.calls);
+    TEST_ASSERT_EQUAL_INT(ROB_OK, second.result);
+    TEST_ASSERT_EQUAL_U32(0xC6U, (uint32_t)second.health.proxy_boot_id);
+    TEST_ASSERT_FALSE(robusto_proxy_client_dispatch(
+        &client, transport.responses[1], transport.response_sizes[1]));
+    TEST_ASSERT_EQUAL_U32(1U, second.calls);
+
+    /* The freed capacity can be used while the first is still outstanding */
+    TEST_ASSERT_EQUAL_INT(
+        ROB_OK,
+        robusto_proxy_client_submit(&client, ROBUSTO_PROXY_DOMAIN_CONTROL,
+                                    ROBUSTO_PROXY_OPCODE_HEALTH, NULL, 0U, false,
+                                    fake_pipeline_completed, &third));
+    TEST_ASSERT_EQUAL_U32(3U, transport.sends);
+    TEST_ASSERT_TRUE(robusto_proxy_client_dispatch(
+        &client, transport.responses[0], transport.response_sizes[0]));
+    TEST_ASSERT_EQUAL_U32(1U, first.calls);
+    TEST_ASSERT_EQUAL_INT(ROB_OK, first.result);
+    TEST_ASSERT_EQUAL_U32(1U, client.inflight.active_count);
+
+    /* Unanswered requests time out */
+    TEST_ASSERT_EQUAL_U32(0U, robusto_proxy_client_expire(&client));
+    transport.now_ms += 1001U;
+    TEST_ASSERT_EQUAL_U32(1U, robusto_proxy_client_expire(&client));
+    TEST_ASSERT_EQUAL_U32(1U, third.calls);
+    TEST_ASSERT_EQUAL_INT(ROB_ERR_TIMEOUT, third.result);
+    TEST_ASSERT_EQUAL_U32(0U, client.inflight.active_count);
+
+    /* Synchronous requests still work alongside */
+    robusto_proxy_health_response_t health;
+    TEST_ASSERT_EQUAL_INT(ROB_OK, robusto_proxy_client_query_health(&client, &health));
+    TEST_ASSERT_EQUAL_U32(0xC6U, (uint32_t)health.proxy_boot_id);
+}
+
+static void test_pubsub_client_publishes_chunks_in_a_window(void)
+{
+    static const robusto_proxy_pubsub_adapter_t adapter = {
+        .publish = fake_pubsub_publish,
+        .publish_begin = fake_pubsub_publish_begin,
+        .publish_chunk = fake_pubsub_publish_chunk,
+        .publish_commit = fake_pubsub_publish_commit,
+        .publish_abort = fake_pubsub_publish_abort,
+        .publish_progress = fake_pubsub_publish_progress,
+        .session_reset = fake_pubsub_session_reset,
+        .subscribe = fake_pubsub_subscribe,
+        .unsubscribe = fake_pubsub_unsubscribe,
+        .status = fake_pubsub_status,
+    };
+    static uint8_t request_frame[ROBUSTO_PROXY_SLOT_SIZE_BYTES];
+    static uint8_t response_frame[ROBUSTO_PROXY_SLOT_SIZE_BYTES];
+    static uint8_t pipeline_frames[2][ROBUSTO_PROXY_SLOT_SIZE_BYTES];
+    static uint8_t large_data[64U * 1024U];
+    static fake_pipeline_transport_t transport;
+    robusto_proxy_service_t service;
+    robusto_proxy_client_t client;
+    robusto_proxy_capability_response_t capabilities;
+    fake_pubsub_adapter_state_t adapter_state = {0};
+    robusto_proxy_client_config_t config = {
+        .profile = ROBUSTO_PROXY_PROFILE_LOW_MEMORY,
+        .controller_boot_id = 0x1122334455667788ULL,
+        .correlation_seed = 10U,
+        .sequence_seed = 20U,
+        .operation_seed = 30U,
+        .request_timeout_ms = 1000U,
+        .exchange = fake_pipeline_exchange,
+        .transport_context = &transport,
+        .now_ms = fake_pipeline_now_ms,
+        .wait_ms = fake_pipeline_wait_ms,
+        .retry_jitter_ms = fake_client_retry_jitter_ms,
+        .clock_context = &transport,
+        .request_frame = request_frame,
+        .request_frame_size = sizeof(request_frame),
+        .response_frame = response_frame,
+        .response_frame_size = sizeof(response_frame),
+        .send = fake_pipeline_send,
+        .pipeline_frames = &pipeline_frames[0][0],
+        .pipeline_frame_size = sizeof(pipeline_frames[0]),
+        .pipeline_frame_count = 2U,
+    };
+
+    memset(&transport, 0, sizeof(transport));
+    for (size_t index = 0U; index < sizeof(large_data); ++index)
+    {
+        large_data[index] = (uint8_t)index;
+    }
+    robusto_proxy_service_init(&service, ROBUSTO_PROXY_PROFILE_LOW_MEMORY,
+                               0xC6U, 1U, 1U, 2U, 0U);
+    robusto_proxy_service_set_pubsub_adapter(&service, &adapter, &adapter_state);
+    transport.service = &service;
+    transport.client = &client;
+    transport.now_ms = 100U;
+    TEST_ASSERT_EQUAL_INT(ROB_OK, robusto_proxy_client_init(&client, &config));
+    TEST_ASSERT_EQUAL_INT(ROB_OK, robusto_proxy_client_connect(&client));
+    TEST_ASSERT_EQUAL_INT(
+        ROB_OK,
+        robusto_proxy_client_query_capabilities(&client, &capabilities));
+    TEST_ASSERT_TRUE((capabilities.enabled_features &
+                      ROBUSTO_PROXY_FEATURE_PUBSUB_WINDOWED_PUBLISH) != 0U);
+
+    /* 17 chunks, two outstanding at a time */
+    TEST_ASSERT_EQUAL_INT(
+        ROB_OK,
+        robusto_proxy_pubsub_publish(&client, "client.window", large_data,
+                                     sizeof(large_data)));
+    TEST_ASSERT_EQUAL_U32(17U, transport.sends);
+    TEST_ASSERT_EQUAL_U32(2U, transport.max_outstanding);
+    TEST_ASSERT_EQUAL_U32(17U, adapter_state.publish_chunk_calls);
+    TEST_ASSERT_EQUAL_U32(sizeof(large_data), adapter_state.publish_data_received);
+    TEST_ASSERT_EQUAL_U32(1U, adapter_state.publish_commit_calls);
+    TEST_ASSERT_EQUAL_U32(0U, client.inflight.active_count);
+
+    /* A lost chunk times out, the next is acknowledged short, and sending resumes from the acknowledged offset */
+    transport.lost_send = transport.sends + 3U;
+    TEST_ASSERT_EQUAL_INT(
+        ROB_OK,
+        robusto_proxy_pubsub_publish(&client, "client.window", large_data,
+                                     sizeof(large_data)));
+    TEST_ASSERT_EQUAL_U32(34U, adapter_state.publish_chunk_calls);
+    TEST_ASSERT_EQUAL_U32(sizeof(large_data), adapter_state.publish_data_received);
+    TEST_ASSERT_EQUAL_U32(2U, adapter_state.publish_commit_calls);
+    TEST_ASSERT_EQUAL_U32(0U, adapter_state.publish_abort_calls);
+    TEST_ASSERT_EQUAL_U32(1U, client.retries);
+    TEST_ASSERT_EQUAL_U32(36U, transport.sends);
+    TEST_ASSERT_EQUAL_INT(ROBUSTO_PROXY_SESSION_ESTABLISHED, client.session.state);
+}
+
+static void test_pubsub_client_receives_batched_deliveries(void)
+{
+    static const robusto_proxy_pubsub_adapter_t adapter = {
+        .publish = fake_pubsub_publish,
+        .publish_begin = fake_pubsub_publish_begin,
+        .publish_chunk = fake_pubsub_publish_chunk,
+        .publish_commit = fake_pubsub_publish_commit,
+        .publish_abort = fake_pubsub_publish_abort,
+        .session_reset = fake_pubsub_session_reset,
+        .subscribe = fake_pubsub_subscribe,
+        .unsubscribe = fake_pubsub_unsubscribe,
+        .status = fake_pubsub_status,
+    };
+    static const uint8_t topic[] = "sensor.temp";
+    static const uint8_t second_topic[] = "sensor.pressure";
+    static const uint8_t first_data[] = {1U, 2U, 3U};
+    static const uint8_t second_data[] = {4U, 5U};
+    static const uint8_t third_data[] = {6U};
+    static uint8_t large_data[5000U];
+    static uint8_t request_frame[ROBUSTO_PROXY_SLOT_SIZE_BYTES];
+    static uint8_t response_frame[ROBUSTO_PROXY_SLOT_SIZE_BYTES];
+    static uint8_t event_frame[ROBUSTO_PROXY_SLOT_SIZE_BYTES];
+    uint8_t *payload = event_frame + ROBUSTO_PROXY_HEADER_SIZE_BYTES;
+    const robusto_proxy_pubsub_backend_t backend = {
+        fake_server_publish, fake_server_subscribe, fake_server_unsubscribe};
+    fake_server_backend_state_t backend_state = {0};
+    robusto_proxy_pubsub_server_adapter_t server_adapter;
+    robusto_proxy_pubsub_subscription_t server_subscriptions[2];
+    uint8_t event_pool[32];
+    robusto_proxy_pubsub_subscribe_request_t subscribe = {
+        1U, topic, 11U, ROBUSTO_PROXY_PUBSUB_SUBSCRIBE_DELIVERIES};
+    robusto_proxy_pubsub_subscribe_response_t subscribe_response;
+    const robusto_proxy_pubsub_adapter_t *operations =
+        robusto_proxy_pubsub_server_adapter_operations();
+    robusto_proxy_pubsub_client_subscription_t subscriptions[2];
+    robusto_proxy_pubsub_client_subscription_t *temp_subscription = NULL;
+    robusto_proxy_pubsub_client_subscription_t *pressure_subscription = NULL;
+    robusto_proxy_pubsub_delivery_t delivery;
+    robusto_proxy_service_t service;
+    fake_pubsub_adapter_state_t adapter_state = {0};
+    fake_client_transport_t transport = {0};
+    robusto_proxy_client_t client;
+    uint32_t temp_callbacks = 0U;
+    uint32_t pressure_callbacks = 0U;
+    uint8_t delivery_opcode = 0U;
+    uint16_t count = 0U;
+    size_t offset = 0U;
+    size_t payload_size = 0U;
+    size_t event_frame_size = 0U;
+    robusto_proxy_client_config_t config = {
+        .profile = ROBUSTO_PROXY_PROFILE_LOW_MEMORY,
+        .controller_boot_id = 0x1234U,
+        .correlation_seed = 1U,
+        .sequence_seed = 1U,
+        .operation_seed = 1U,
+        .request_timeout_ms = 1000U,
+        .exchange = fake_client_exchange,
+        .transport_context = &transport,
+        .now_ms = fake_client_now_ms,
+        .wait_ms = fake_client_wait_ms,
+        .retry_jitter_ms = fake_client_retry_jitter_ms,
+        .clock_context = &transport,
+        .request_frame = request_frame,
+        .request_frame_size = sizeof(request_frame),
+        .response_frame = response_frame,
+        .response_frame_size = sizeof(response_frame),
+    };
+
+    /* The C6 side adapter numbers its subscriptions 1 and 2, the P4 side is told the same */
+    TEST_ASSERT_TRUE(robusto_proxy_pubsub_server_adapter_init(
+        &server_adapter, &backend, &backend_state, server_subscriptions, 2U,
+        event_pool, sizeof(event_pool), (robusto_proxy_pubsub_lock_t){0}));
+    TEST_ASSERT_EQUAL_U32(ROBUSTO_PROXY_STATUS_OK,
+                          operations->subscribe(&server_adapter, &subscribe, &subscribe_response));
+    subscribe.operation_id = 2U;
+    subscribe.topic = second_topic;
+    subscribe.topic_length = 15U;
+    TEST_ASSERT_EQUAL_U32(ROBUSTO_PROXY_STATUS_OK,
+                          operations->subscribe(&server_adapter, &subscribe, &subscribe_response));
+    robusto_proxy_service_init(&service, ROBUSTO_PROXY_PROFILE_LOW_MEMORY,
+                               0xC6U, 1U, 1U, 2U, 0U);
+    robusto_proxy_service_set_pubsub_adapter(&service, &adapter, &adapter_state);
+    transport.service = &service;
+    transport.now_ms = 100U;
+    TEST_ASSERT_EQUAL_INT(ROB_OK, robusto_proxy_client_init(&client, &config));
+    TEST_ASSERT_EQUAL_INT(ROB_OK,
+                          robusto_proxy_pubsub_configure(&client, subscriptions, 2U));
+    TEST_ASSERT_EQUAL_INT(ROB_OK, robusto_proxy_client_connect(&client));
+    TEST_ASSERT_TRUE((client.session.enabled_features &
+                      ROBUSTO_PROXY_FEATURE_PUBSUB_DELIVERY_BATCH) != 0U);
+    adapter_state.subscription_id = 1U;
+    TEST_ASSERT_EQUAL_INT(
+        ROB_OK,
+        robusto_proxy_pubsub_subscribe(&client, "sensor.temp",
+                                       fake_proxy_delivery_callback, &temp_callbacks,
+                                       &temp_subscription));
+    adapter_state.subscription_id = 2U;
+    TEST_ASSERT_EQUAL_INT(
+        ROB_OK,
+        robusto_proxy_pubsub_subscribe(&client, "sensor.pressure",
+                                       fake_proxy_delivery_callback, &pressure_callbacks,
+                                       &pressure_subscription));
+
+    /* Three small deliveries share a frame, the batch ends before the large one */
+    for (size_t index = 0U; index < sizeof(large_data); ++index)
+    {
+        large_data[index] = (uint8_t)index;
+    }
+    TEST_ASSERT_EQUAL_U32(ROBUSTO_PROXY_STATUS_OK,
+                          server_subscriptions[0].delivery_callback(
+                              server_subscriptions[0].delivery_callback_context,
+                              first_data, sizeof(first_data)));
+    TEST_ASSERT_EQUAL_U32(ROBUSTO_PROXY_STATUS_OK,
+                          server_subscriptions[1].delivery_callback(
+                              server_subscriptions[1].delivery_callback_context,
+                              second_data, sizeof(second_data)));
+    TEST_ASSERT_EQUAL_U32(ROBUSTO_PROXY_STATUS_OK,
+                          server_subscriptions[0].delivery_callback(
+                              server_subscriptions[0].delivery_callback_context,
+                              third_data, sizeof(third_data)));
+    TEST_ASSERT_EQUAL_U32(ROBUSTO_PROXY_STATUS_OK,
+                          server_subscriptions[1].delivery_callback(
+                              server_subscriptions[1].delivery_callback_context,
+                              large_data, sizeof(large_data)));
+    TEST_ASSERT_EQUAL_U32(4U, robusto_proxy_pubsub_server_adapter_pending_deliveries(
+                                  &server_adapter));
+    TEST_ASSERT_TRUE(robusto_proxy_pubsub_server_adapter_take_delivery_batch(
+        &server_adapter, 4U, payload, ROBUSTO_PROXY_MAX_PAYLOAD_BYTES, &payload_size));
+    TEST_ASSERT_EQUAL_U32(ROBUSTO_PROXY_PUBSUB_DELIVERY_BATCH_HEADER_SIZE_BYTES +
+                              3U * ROBUSTO_PROXY_PUBSUB_DELIVERY_HEADER_SIZE_BYTES + 6U,
+                          payload_size);
+    TEST_ASSERT_EQUAL_INT(ROBUSTO_PROXY_RESULT_OK,
+                          robusto_proxy_pubsub_decode_delivery_batch(payload, payload_size, &count));
+    TEST_ASSERT_EQUAL_U32(3U, count);
+    TEST_ASSERT_EQUAL_INT(ROBUSTO_PROXY_RESULT_BAD_LENGTH,
+                          robusto_proxy_pubsub_decode_delivery_batch(payload, payload_size + 1U,
+                                                                     &count));
+    TEST_ASSERT_EQUAL_INT(ROBUSTO_PROXY_RESULT_OK,
+                          robusto_proxy_pubsub_decode_delivery_batch_entry(
+                              payload, payload_size, &offset, &delivery));
+    TEST_ASSERT_EQUAL_U32(1U, delivery.subscription_id);
+    TEST_ASSERT_TRUE(memcmp(delivery.data, first_data, sizeof(first_data)) == 0);
+    TEST_ASSERT_EQUAL_INT(ROBUSTO_PROXY_RESULT_OK,
+                          robusto_proxy_pubsub_decode_delivery_batch_entry(
+                              payload, payload_size, &offset, &delivery));
+    TEST_ASSERT_EQUAL_U32(2U, delivery.subscription_id);
+    TEST_ASSERT_TRUE(memcmp(delivery.data, second_data, sizeof(second_data)) == 0);
+    TEST_ASSERT_EQUAL_INT(ROBUSTO_PROXY_RESULT_OK,
+                          robusto_proxy_service_build_pubsub_event(
+                              &service, ROBUSTO_PROXY_PUBSUB_OPCODE_DELIVERY_BATCH,
+                              payload, payload_size, event_frame, sizeof(event_frame),
+                              &event_frame_size));
+    TEST_ASSERT_EQUAL_INT(ROB_OK,
+                          robusto_proxy_pubsub_handle_event(&client, event_frame,
+                                                            event_frame_size));
+    TEST_ASSERT_EQUAL_U32(2U, temp_callbacks);
+    TEST_ASSERT_EQUAL_U32(1U, pressure_callbacks);
+    TEST_ASSERT_EQUAL_U32(3U, client.pubsub_delivery_events);
+    TEST_ASSERT_EQUAL_U32(0U, client.pubsub_delivery_sequence_gaps);
+    TEST_ASSERT_TRUE(robusto_proxy_pubsub_server_adapter_complete_delivery(
+        &server_adapter, true));
+    TEST_ASSERT_EQUAL_U32(1U, server_adapter.event_count);
+    TEST_ASSERT_EQUAL_U32(0U, server_adapter.event_pool_used);
+
+    /* A single delivery is not a batch, the large one continues as a chunked transfer */
+    TEST_ASSERT_FALSE(robusto_proxy_pubsub_server_adapter_take_delivery_batch(
+        &server_adapter, 4U, payload, ROBUSTO_PROXY_MAX_PAYLOAD_BYTES, &payload_size));
+    TEST_ASSERT_TRUE(robusto_proxy_pubsub_server_adapter_take_delivery(
+        &server_adapter, true, &delivery_opcode, payload, ROBUSTO_PROXY_MAX_PAYLOAD_BYTES,
+        &payload_size));
+    TEST_ASSERT_EQUAL_U32(ROBUSTO_PROXY_PUBSUB_OPCODE_DELIVERY_BEGIN, delivery_opcode);
+    TEST_ASSERT_TRUE(robusto_proxy_pubsub_server_adapter_complete_delivery(
+        &server_adapter, false));
+    TEST_ASSERT_EQUAL_U32(ROBUSTO_PROXY_STATUS_OK, operations->session_reset(&server_adapter));
+
+    /* Batches are only sent when negotiated */
+    service.session.enabled_features &= ~ROBUSTO_PROXY_FEATURE_PUBSUB_DELIVERY_BATCH;
+    TEST_ASSERT_EQUAL_INT(ROBUSTO_PROXY_RESULT_INVALID_ARGUMENT,
+                          robusto_proxy_service_build_pubsub_event(
+                              &service, ROBUSTO_PROXY_PUBSUB_OPCODE_DELIVERY_BATCH,
+                              payload, payload_size, event_frame, sizeof(event_frame),
+                              &event_frame_size));
+}
+
 int main(void)
 {
     test_crc32_golden_vector();
@@ -2938,10 +3548,14 @@ int main(void)
     test_pubsub_codec_rejects_malformed_payloads();
     test_service_pubsub_dispatch_and_gates();
     test_pubsub_server_adapter_subscription_delivery_and_overflow();
+    test_pubsub_server_adapter_shares_large_data_and_wraps_the_pool();
     test_pubsub_server_adapter_chunked_publish();
     test_pubsub_server_adapter_deinit_retries_backend_failure();
     test_proxy_client_connect_publish_and_acceptance();
     test_pubsub_client_interleaves_inline_and_chunked_deliveries();
+    test_proxy_client_pipelines_requests_out_of_order();
+    test_pubsub_client_publishes_chunks_in_a_window();
+    test_pubsub_client_receives_batched_deliveries();
 
     if (tests_failed != 0)
     {
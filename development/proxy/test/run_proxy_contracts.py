@@ -88,6 +88,7 @@ def run_contract(
         *(f"-I{include}" for include in includes),
         str(TEST_DIRECTORY / f"{name}.c"),
         *(str(PROXY_SOURCE_DIRECTORY / source) for source in proxy_sources),
+        str(ROBUSTO_DIRECTORY / "base" / "src" / "system" / "robusto_crc32.c"),
     ]
     if not proxy_sources:
         command.extend(
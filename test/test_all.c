@@ -140,6 +140,16 @@ void runUnityTests(void *pvParameters)
     robusto_yield();
     RUN_TEST(tst_fragmentation_short_request_does_not_create_state);
     robusto_yield();
+    RUN_TEST(tst_fragmentation_request_count_mismatch_does_not_create_state);
+    robusto_yield();
+    RUN_TEST(tst_fragmentation_resend_ranges);
+    robusto_yield();
+    RUN_TEST(tst_fragmentation_legacy_sender_gets_resend_map);
+    robusto_yield();
+    RUN_TEST(tst_fragmentation_selective_acks);
+    robusto_yield();
+    RUN_TEST(tst_fragmentation_fragment_crc);
+    robusto_yield();
 #endif
 
     UNITY_END();
@@ -156,6 +166,25 @@ void runUnityTests(void *pvParameters)
     RUN_TEST(tst_blink);
     robusto_yield();
 
+    RUN_TEST(tst_shared_buffer);
+    robusto_yield();
+
+    RUN_TEST(tst_pool);
+    robusto_yield();
+
+    RUN_TEST(tst_pool_size_classes);
+    robusto_yield();
+
+#ifdef CONFIG_ROBUSTO_LOG_DEFERRED
+    RUN_TEST(tst_log_deferred);
+    robusto_yield();
+#endif
+
+    RUN_TEST(tst_crc32);
+    robusto_yield();
+    RUN_TEST(tst_crc32_benchmark);
+    robusto_yield();
+
     RUN_TEST(tst_logging);
     robusto_yield();
     RUN_TEST(tst_bit_logging);
@@ -173,6 +202,10 @@ void runUnityTests(void *pvParameters)
 
     RUN_TEST(tst_make_multi_conversation_message);
     robusto_yield();
+    RUN_TEST(tst_make_multi_message_segments);
+    robusto_yield();
+    RUN_TEST(tst_parse_message_into);
+    robusto_yield();
     RUN_TEST(tst_build_strings_data);
     robusto_yield();
 
@@ -190,6 +223,12 @@ void runUnityTests(void *pvParameters)
 #if defined(CONFIG_ROBUSTO_PUBSUB_SERVER) ||  defined(CONFIG_ROBUSTO_PUBSUB_CLIENT)
     RUN_TEST(tst_pubsub); 
     robusto_yield();
+#ifdef CONFIG_ROBUSTO_PUBSUB_SERVER
+    RUN_TEST(tst_pubsub_indexes);
+    robusto_yield();
+    RUN_TEST(tst_pubsub_concurrent_publish);
+    robusto_yield();
+#endif
 #endif
     // TODO: Add a message parsing unit test
 
@@ -203,6 +242,18 @@ void runUnityTests(void *pvParameters)
     // Adds the MOCK media type to the host, and tests if it was added
     RUN_TEST(tst_add_host_media_type_mock);
     robusto_yield();
+    RUN_TEST(tst_espnow_transmit_outstanding);
+    robusto_yield();
+    RUN_TEST(tst_lora_schedule_duty_cycle);
+    robusto_yield();
+    RUN_TEST(tst_lora_batch_airtime);
+    robusto_yield();
+    RUN_TEST(tst_lora_batch_handle);
+    robusto_yield();
+    RUN_TEST(tst_canbus_reassembly_in_place);
+    robusto_yield();
+    RUN_TEST(tst_canbus_extended_frames);
+    robusto_yield();
     ROB_LOGW("TEST", "Adding test peer.");
     // Adds 
     /* TODO: This adds the TEST_MOCK peer, perhaps this should not be done in the test*/
@@ -217,6 +268,12 @@ void runUnityTests(void *pvParameters)
     RUN_TEST(tst_async_mock_send_message);
     robusto_yield();
 
+    RUN_TEST(tst_async_mock_send_message_completion);
+    robusto_yield();
+
+    RUN_TEST(tst_async_mock_send_message_shared_buffer);
+    robusto_yield();
+
     RUN_TEST(tst_async_mock_receive_string_message);
     robusto_yield();
 
@@ -476,6 +533,8 @@ void runUnityTests(void *pvParameters)
      */
     RUN_TEST(tst_task);
     robusto_yield();
+    RUN_TEST(tst_semaphore);
+    robusto_yield();
     RUN_TEST(tst_queue_start);
     robusto_yield();
     RUN_TEST(tst_queue_check_poll);
@@ -486,6 +545,14 @@ void runUnityTests(void *pvParameters)
     robusto_yield();
     RUN_TEST(tst_queue_shutdown);
     robusto_yield();
+    RUN_TEST(tst_queue_worker_pool);
+    robusto_yield();
+    RUN_TEST(tst_queue_completion);
+    robusto_yield();
+#ifdef CONFIG_ROBUSTO_QUEUE_RING
+    RUN_TEST(tst_queue_ring_benchmark);
+    robusto_yield();
+#endif
 
 
 #ifdef CONFIG_ROBUSTO_NETWORK_QOS_TESTING
@@ -49,3 +49,32 @@ void tst_task(void) {
     TEST_ASSERT_TRUE(false);
 
 }
+
+void semaphore_giver(semaphore_ref_t semaphore) {
+    r_delay(20);
+    robusto_semaphore_give(semaphore);
+    robusto_delete_current_task();
+}
+
+/**
+ * @brief Check that a semaphore times out when not given, and wakes up when given
+ */
+void tst_semaphore(void) {
+    ROB_LOGI("Test", "In tst_semaphore");
+    semaphore_ref_t semaphore = robusto_semaphore_init();
+    TEST_ASSERT_NOT_NULL_MESSAGE(semaphore, "Failed to create semaphore");
+
+    TEST_ASSERT_EQUAL_INT_MESSAGE(ROB_ERR_TIMEOUT, robusto_semaphore_take(semaphore, 20), "Take should time out if nobody gives");
+
+    rob_task_handle_t *task_handle;
+    char task_name[30] = "semaphore_giver";
+    robusto_create_task((TaskFunction_t)semaphore_giver, semaphore, task_name, &task_handle, 0);
+    uint32_t starttime = r_millis();
+    TEST_ASSERT_EQUAL_INT_MESSAGE(ROB_OK, robusto_semaphore_take(semaphore, 1000), "Take should succeed when given");
+    TEST_ASSERT_TRUE_MESSAGE(r_millis() - starttime < 500, "Take should return when given, not at timeout");
+
+    robusto_semaphore_give_from_isr(semaphore);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(ROB_OK, robusto_semaphore_take(semaphore, 20), "Take should succeed when given from an interrupt");
+
+    robusto_semaphore_deinit(semaphore);
+}
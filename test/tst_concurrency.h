@@ -1,3 +1,4 @@
 #pragma once
 #include <robconfig.h>
 void tst_task(void);
+void tst_semaphore(void);
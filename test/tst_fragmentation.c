@@ -34,6 +34,12 @@ static bool captured_request = false;
 static uint32_t captured_request_fragment_count = 0;
 static uint32_t sent_result_count = 0;
 static uint32_t sent_resend_count = 0;
+static uint8_t sent_resend_ranges[64];
+static uint32_t sent_resend_ranges_length = 0;
+static uint32_t sent_resend_map_length = 0;
+static uint32_t sent_ack_count = 0;
+static uint32_t sent_ack_base = 0;
+static uint32_t sent_ack_bits = 0;
 
 static uint64_t memory_loss_bytes(uint64_t before_mem, uint64_t after_mem)
 {
@@ -50,6 +56,9 @@ static void reset_fragment_tracking(void)
     captured_request_fragment_count = 0;
     sent_result_count = 0;
     sent_resend_count = 0;
+    sent_resend_ranges_length = 0;
+    sent_resend_map_length = 0;
+    sent_ack_count = 0;
 }
 
 static uint8_t *build_frag_request_packet(uint32_t receive_buffer_length, uint32_t fragment_count, uint32_t fragment_size, uint32_t hash)
@@ -89,7 +98,6 @@ static uint8_t *build_frag_message_packet(uint32_t hash, uint32_t index, const u
 static rob_ret_val_t callback_capture_frag_responses(robusto_peer_t *peer, uint8_t *data, uint32_t len, bool receipt)
 {
     (void)peer;
-    (void)len;
     (void)receipt;
 
     if (data[ROBUSTO_CRC_LENGTH] == MSG_FRAGMENTED)
@@ -101,6 +109,23 @@ static rob_ret_val_t callback_capture_frag_responses(robusto_peer_t *peer, uint8
         if (data[ROBUSTO_CRC_LENGTH + 1] == FRAG_RESEND)
         {
             sent_resend_count++;
+            sent_resend_map_length = len - (ROBUSTO_CRC_LENGTH + 2);
+        }
+        if (data[ROBUSTO_CRC_LENGTH + 1] == FRAG_RESEND_RANGES)
+        {
+            sent_resend_count++;
+            sent_resend_ranges_length = len - (ROBUSTO_CRC_LENGTH + 2);
+            if (sent_resend_ranges_length > sizeof(sent_resend_ranges))
+            {
+                sent_resend_ranges_length = sizeof(sent_resend_ranges);
+            }
+            memcpy(sent_resend_ranges, data + ROBUSTO_CRC_LENGTH + 2, sent_resend_ranges_length);
+        }
+        if (data[ROBUSTO_CRC_LENGTH + 1] == FRAG_ACK && len == ROBUSTO_CRC_LENGTH + 10)
+        {
+            sent_ack_count++;
+            memcpy(&sent_ack_base, data + ROBUSTO_CRC_LENGTH + 2, 4);
+            memcpy(&sent_ack_bits, data + ROBUSTO_CRC_LENGTH + 6, 4);
         }
     }
 
@@ -442,6 +467,33 @@ void tst_fragmentation_short_request_does_not_create_state(void)
                                   "Short FRAG_REQUEST should not mutate active fragmented message state");
 }
 
+void tst_fragmentation_request_count_mismatch_does_not_create_state(void)
+{
+    robusto_peer_t *local_peer = ensure_fragmentation_mock_peer();
+    TEST_ASSERT_NOT_NULL(local_peer);
+
+    reset_fragment_tracking();
+    fragmented_message_t *before = get_last_frag_message();
+
+    // 2 bytes in 1-byte fragments is 2 fragments, a huge count must not be allocated by.
+    uint8_t payload[2] = {0x50, 0x60};
+    uint32_t hash = robusto_crc32(0, payload, 2);
+    uint8_t *request = build_frag_request_packet(2, 0x40000001, 1, hash);
+
+    bool req_receipt = handle_fragmented(local_peer, robusto_mt_mock, request, ROBUSTO_CRC_LENGTH + 18,
+                                         TST_FRAG_SIZE, &callback_capture_frag_responses);
+    TEST_ASSERT_TRUE_MESSAGE(req_receipt, "FRAG_REQUEST should still map to receipt semantics");
+    TEST_ASSERT_EQUAL_PTR_MESSAGE(before, get_last_frag_message(),
+                                  "A FRAG_REQUEST whose count does not match its length must be rejected without creating state");
+
+    // Nor can the fragment size be zero
+    request = build_frag_request_packet(2, 2, 0, hash);
+    handle_fragmented(local_peer, robusto_mt_mock, request, ROBUSTO_CRC_LENGTH + 18,
+                      TST_FRAG_SIZE, &callback_capture_frag_responses);
+    TEST_ASSERT_EQUAL_PTR_MESSAGE(before, get_last_frag_message(),
+                                  "A FRAG_REQUEST with a zero fragment size must be rejected without creating state");
+}
+
 void tst_fragmentation_interleaved_hashes_are_resolved(void)
 {
     robusto_peer_t *local_peer = ensure_fragmentation_mock_peer();
@@ -471,5 +523,255 @@ void tst_fragmentation_interleaved_hashes_are_resolved(void)
                              "Interleaved fragmented transmissions should resolve by hash and request missing parts");
 }
 
-#endif
+void tst_fragmentation_resend_ranges(void)
+{
+    robusto_peer_t *local_peer = ensure_fragmentation_mock_peer();
+    TEST_ASSERT_NOT_NULL(local_peer);
+
+    reset_fragment_tracking();
 
+    // 100 16-byte fragments, of which 10-19 and 50 never arrive. A fragment has room for two ranges.
+    uint8_t payload[1600];
+    for (int i = 0; i < 1600; i++)
+    {
+        payload[i] = (uint8_t)i;
+    }
+    uint32_t hash = robusto_crc32(0, payload, 1600);
+    // The flags byte, even without flags, tells that the sender understands ranges
+    uint8_t *request = build_frag_request_packet(1600, 100, 16, hash);
+    uint8_t *flagged_request = robusto_malloc(ROBUSTO_CRC_LENGTH + 19);
+    memcpy(flagged_request, request, ROBUSTO_CRC_LENGTH + 18);
+    robusto_free(request);
+    flagged_request[ROBUSTO_CRC_LENGTH + 18] = 0x00;
+    handle_fragmented(local_peer, robusto_mt_mock, flagged_request, ROBUSTO_CRC_LENGTH + 19,
+                      TST_FRAG_SIZE, &callback_capture_frag_responses);
+    for (uint32_t i = 0; i < 100; i++)
+    {
+        if ((i >= 10 && i < 20) || i == 50)
+        {
+            continue;
+        }
+        uint8_t *m = build_frag_message_packet(hash, i, payload + i * 16, 16);
+        handle_fragmented(local_peer, robusto_mt_mock, m, TST_FRAG_HEADER_LEN + 16, TST_FRAG_SIZE,
+                          &callback_capture_frag_responses);
+    }
+    fragmented_message_t *frag_msg = get_last_frag_message();
+    TEST_ASSERT_NOT_NULL(frag_msg);
+    TEST_ASSERT_EQUAL_UINT32(89, frag_msg->received_count);
+
+    uint8_t *check = robusto_malloc(ROBUSTO_CRC_LENGTH + 2);
+    memcpy(check, &hash, 4);
+    check[ROBUSTO_CRC_LENGTH] = MSG_FRAGMENTED;
+    check[ROBUSTO_CRC_LENGTH + 1] = FRAG_CHECK;
+    handle_fragmented(local_peer, robusto_mt_mock, check, ROBUSTO_CRC_LENGTH + 2, TST_FRAG_SIZE,
+                      &callback_capture_frag_responses);
+
+    // Two ranges are smaller than a map of all 100 fragments
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(16, sent_resend_ranges_length, "Expected two missing ranges");
+    uint32_t ranges[4];
+    memcpy(ranges, sent_resend_ranges, sizeof(ranges));
+    TEST_ASSERT_EQUAL_UINT32(10, ranges[0]);
+    TEST_ASSERT_EQUAL_UINT32(10, ranges[1]);
+    TEST_ASSERT_EQUAL_UINT32(50, ranges[2]);
+    TEST_ASSERT_EQUAL_UINT32(1, ranges[3]);
+
+    // Resend the missing fragments with the wrong data, the last requested one completes with a CRC mismatch
+    for (uint32_t i = 10; i <= 50; i++)
+    {
+        if (i >= 20 && i < 50)
+        {
+            continue;
+        }
+        uint8_t wrong[16];
+        memset(wrong, 0xFF, sizeof(wrong));
+        uint8_t *m = build_frag_message_packet(hash, i, wrong, 16);
+        handle_fragmented(local_peer, robusto_mt_mock, m, TST_FRAG_HEADER_LEN + 16, TST_FRAG_SIZE,
+                          &callback_capture_frag_responses);
+    }
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(1, sent_resend_count, "No more fragments should be requested");
+    TEST_ASSERT_TRUE_MESSAGE(sent_result_count > 0, "Expected FRAG_RESULT when all fragments have arrived");
+    TEST_ASSERT_NULL_MESSAGE(get_last_frag_message(), "Fragment state should be cleaned up after the result");
+}
+
+void tst_fragmentation_legacy_sender_gets_resend_map(void)
+{
+    robusto_peer_t *local_peer = ensure_fragmentation_mock_peer();
+    TEST_ASSERT_NOT_NULL(local_peer);
+
+    reset_fragment_tracking();
+
+    // A request without the flags byte is from a sender that only understands the map of all fragments
+    uint8_t payload[1600];
+    for (int i = 0; i < 1600; i++)
+    {
+        payload[i] = (uint8_t)i;
+    }
+    uint32_t hash = robusto_crc32(0, payload, 1600);
+    uint8_t *request = build_frag_request_packet(1600, 100, 16, hash);
+    handle_fragmented(local_peer, robusto_mt_mock, request, ROBUSTO_CRC_LENGTH + 18,
+                      TST_FRAG_SIZE, &callback_capture_frag_responses);
+    for (uint32_t i = 0; i < 100; i++)
+    {
+        if ((i >= 10 && i < 20) || i == 50)
+        {
+            continue;
+        }
+        uint8_t *m = build_frag_message_packet(hash, i, payload + i * 16, 16);
+        handle_fragmented(local_peer, robusto_mt_mock, m, TST_FRAG_HEADER_LEN + 16, TST_FRAG_SIZE,
+                          &callback_capture_frag_responses);
+    }
+    fragmented_message_t *frag_msg = get_last_frag_message();
+    TEST_ASSERT_NOT_NULL(frag_msg);
+    TEST_ASSERT_EQUAL_UINT32(89, frag_msg->received_count);
+
+    uint8_t *check = robusto_malloc(ROBUSTO_CRC_LENGTH + 2);
+    memcpy(check, &hash, 4);
+    check[ROBUSTO_CRC_LENGTH] = MSG_FRAGMENTED;
+    check[ROBUSTO_CRC_LENGTH + 1] = FRAG_CHECK;
+    handle_fragmented(local_peer, robusto_mt_mock, check, ROBUSTO_CRC_LENGTH + 2, TST_FRAG_SIZE,
+                      &callback_capture_frag_responses);
+
+    // Two ranges would be smaller, but the sender would not understand them
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(1, sent_resend_count, "Expected one resend request");
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, sent_resend_ranges_length, "Expected no ranges to a legacy sender");
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(100, sent_resend_map_length, "Expected a map of all 100 fragments");
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(50, frag_msg->last_requested, "Expected the last missing fragment to be requested");
+
+    // Complete the transfer so that the fragment state is cleaned up
+    for (uint32_t i = 10; i <= 50; i++)
+    {
+        if (i >= 20 && i < 50)
+        {
+            continue;
+        }
+        uint8_t *m = build_frag_message_packet(hash, i, payload + i * 16, 16);
+        handle_fragmented(local_peer, robusto_mt_mock, m, TST_FRAG_HEADER_LEN + 16, TST_FRAG_SIZE,
+                          &callback_capture_frag_responses);
+    }
+    TEST_ASSERT_TRUE_MESSAGE(sent_result_count > 0, "Expected FRAG_RESULT when all fragments have arrived");
+    TEST_ASSERT_NULL_MESSAGE(get_last_frag_message(), "Fragment state should be cleaned up after the result");
+}
+
+void tst_fragmentation_selective_acks(void)
+{
+    robusto_peer_t *local_peer = ensure_fragmentation_mock_peer();
+    TEST_ASSERT_NOT_NULL(local_peer);
+
+    reset_fragment_tracking();
+
+    uint8_t payload[160];
+    for (int i = 0; i < 160; i++)
+    {
+        payload[i] = (uint8_t)i;
+    }
+    uint32_t hash = robusto_crc32(0, payload, 160);
+
+    // A request asking for acknowledgements is answered right away
+    uint8_t *request = build_frag_request_packet(160, 10, 16, hash);
+    uint8_t *windowed_request = robusto_malloc(ROBUSTO_CRC_LENGTH + 19);
+    memcpy(windowed_request, request, ROBUSTO_CRC_LENGTH + 18);
+    robusto_free(request);
+    windowed_request[ROBUSTO_CRC_LENGTH + 18] = 0x01;
+    handle_fragmented(local_peer, robusto_mt_mock, windowed_request, ROBUSTO_CRC_LENGTH + 19,
+                      TST_FRAG_SIZE, &callback_capture_frag_responses);
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(1, sent_ack_count, "Expected an acknowledgement of the request");
+    TEST_ASSERT_EQUAL_UINT32(0, sent_ack_base);
+    TEST_ASSERT_EQUAL_UINT32(0, sent_ack_bits);
+
+    // Fragment 2 is lost, which fragment 3 reveals
+    uint32_t indexes[] = {0, 1, 3};
+    for (int i = 0; i < 3; i++)
+    {
+        uint8_t *m = build_frag_message_packet(hash, indexes[i], payload + indexes[i] * 16, 16);
+        handle_fragmented(local_peer, robusto_mt_mock, m, TST_FRAG_HEADER_LEN + 16, TST_FRAG_SIZE,
+                          &callback_capture_frag_responses);
+    }
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(2, sent_ack_count, "Expected an acknowledgement when a fragment is lost");
+    TEST_ASSERT_EQUAL_UINT32(2, sent_ack_base);
+    TEST_ASSERT_EQUAL_UINT32(0x01, sent_ack_bits);
+
+    // The sender asks for an acknowledgement
+    uint8_t *m = build_frag_message_packet(hash, 4, payload + 4 * 16, 16);
+    m[ROBUSTO_CRC_LENGTH + 1] = FRAG_MESSAGE_ACK_NOW;
+    handle_fragmented(local_peer, robusto_mt_mock, m, TST_FRAG_HEADER_LEN + 16, TST_FRAG_SIZE,
+                      &callback_capture_frag_responses);
+    TEST_ASSERT_EQUAL_UINT32(3, sent_ack_count);
+    TEST_ASSERT_EQUAL_UINT32(2, sent_ack_base);
+    TEST_ASSERT_EQUAL_UINT32(0x03, sent_ack_bits);
+
+    for (uint32_t i = 2; i < 10; i++)
+    {
+        if (i == 3 || i == 4)
+        {
+            continue;
+        }
+        m = build_frag_message_packet(hash, i, payload + i * 16, 16);
+        handle_fragmented(local_peer, robusto_mt_mock, m, TST_FRAG_HEADER_LEN + 16, TST_FRAG_SIZE,
+                          &callback_capture_frag_responses);
+    }
+    TEST_ASSERT_TRUE_MESSAGE(sent_result_count > 0, "Expected FRAG_RESULT when all fragments have arrived");
+}
+
+void tst_fragmentation_fragment_crc(void)
+{
+    robusto_peer_t *local_peer = ensure_fragmentation_mock_peer();
+    TEST_ASSERT_NOT_NULL(local_peer);
+
+    reset_fragment_tracking();
+
+    uint8_t payload[48];
+    for (int i = 0; i < 48; i++)
+    {
+        payload[i] = (uint8_t)(i * 3);
+    }
+    uint32_t hash = robusto_crc32(0, payload, 48);
+
+    // Acknowledged and with fragment CRCs
+    uint8_t *request = build_frag_request_packet(48, 3, 16, hash);
+    uint8_t *crc_request = robusto_malloc(ROBUSTO_CRC_LENGTH + 19);
+    memcpy(crc_request, request, ROBUSTO_CRC_LENGTH + 18);
+    robusto_free(request);
+    crc_request[ROBUSTO_CRC_LENGTH + 18] = 0x03;
+    handle_fragmented(local_peer, robusto_mt_mock, crc_request, ROBUSTO_CRC_LENGTH + 19,
+                      TST_FRAG_SIZE, &callback_capture_frag_responses);
+    TEST_ASSERT_EQUAL_UINT32(1, sent_ack_count);
+
+    // Fragment 1 is corrupted on the way, which its CRC reveals
+    robusto_fragment_stats_t before, delta;
+    robusto_fragment_stats_get(&before, &delta);
+    for (uint32_t i = 0; i < 2; i++)
+    {
+        uint8_t *m = robusto_malloc(TST_FRAG_HEADER_LEN + 4 + 16);
+        uint8_t *fragment = build_frag_message_packet(hash, i, payload + i * 16, 16);
+        memcpy(m, fragment, TST_FRAG_HEADER_LEN);
+        robusto_free(fragment);
+        uint32_t crc = robusto_crc32(0, payload + i * 16, 16);
+        memcpy(m + TST_FRAG_HEADER_LEN, &crc, 4);
+        memcpy(m + TST_FRAG_HEADER_LEN + 4, payload + i * 16, 16);
+        if (i == 1)
+        {
+            m[TST_FRAG_HEADER_LEN + 4 + 5] ^= 0x10;
+        }
+        handle_fragmented(local_peer, robusto_mt_mock, m, TST_FRAG_HEADER_LEN + 4 + 16, TST_FRAG_SIZE,
+                          &callback_capture_frag_responses);
+    }
+    fragmented_message_t *frag_msg = get_last_frag_message();
+    TEST_ASSERT_NOT_NULL(frag_msg);
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(1, frag_msg->received_count, "The corrupted fragment should not be stored");
+    robusto_fragment_stats_get(&before, &delta);
+    TEST_ASSERT_EQUAL_UINT32(1, delta.fragment_crc_mismatch);
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(2, sent_ack_count, "The corrupted fragment should be reported at once");
+    TEST_ASSERT_EQUAL_UINT32(1, sent_ack_base);
+
+    // Fragments without a CRC are still taken, from before the sender got the acknowledgement
+    for (uint32_t i = 1; i < 3; i++)
+    {
+        uint8_t *m = build_frag_message_packet(hash, i, payload + i * 16, 16);
+        handle_fragmented(local_peer, robusto_mt_mock, m, TST_FRAG_HEADER_LEN + 16, TST_FRAG_SIZE,
+                          &callback_capture_frag_responses);
+    }
+    TEST_ASSERT_TRUE_MESSAGE(sent_result_count > 0, "Expected FRAG_RESULT when all fragments have arrived");
+    TEST_ASSERT_NULL_MESSAGE(get_last_frag_message(), "Fragment state should be cleaned up after the result");
+}
+
+#endif
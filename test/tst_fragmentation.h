@@ -9,4 +9,9 @@ void tst_fragmentation_request_non_division_count(void);
 void tst_fragmentation_crc_mismatch_cleans_up_state(void);
 void tst_fragmentation_missing_fragments_does_not_leak_memory(void);
 void tst_fragmentation_short_request_does_not_create_state(void);
+void tst_fragmentation_request_count_mismatch_does_not_create_state(void);
 void tst_fragmentation_interleaved_hashes_are_resolved(void);
+void tst_fragmentation_resend_ranges(void);
+void tst_fragmentation_legacy_sender_gets_resend_map(void);
+void tst_fragmentation_selective_acks(void);
+void tst_fragmentation_fragment_crc(void);
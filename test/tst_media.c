@@ -5,6 +5,26 @@
 
 #include <robusto_media.h>
 #include <robusto_peer.h>
+
+#ifdef CONFIG_ROBUSTO_NETWORK_MOCK_TESTING
+#include <robusto_concurrency.h>
+#include <robusto_time.h>
+#include <stdatomic.h>
+#include <string.h>
+#include <robusto_message.h>
+#include <robusto_qos.h>
+#ifdef USE_ESPIDF
+#include <network/src/media/espnow/espnow_transmit.h>
+#include <network/src/media/lora/lora_schedule.h>
+#include <network/src/media/canbus/canbus_reassembly.h>
+#include <network/src/media/canbus/canbus_frame.h>
+#else
+#include "../components/robusto/network/src/media/espnow/espnow_transmit.h"
+#include "../components/robusto/network/src/media/lora/lora_schedule.h"
+#include "../components/robusto/network/src/media/canbus/canbus_reassembly.h"
+#include "../components/robusto/network/src/media/canbus/canbus_frame.h"
+#endif
+#endif
 /**
  * @brief Check to that at least 100 milliseconds is returned.
  */
@@ -27,3 +47,425 @@ void tst_add_host_media_type_mock(void)
     TEST_ASSERT_EQUAL_UINT8(supported_types, get_host_supported_media_types());
  
 }
+
+#ifdef CONFIG_ROBUSTO_NETWORK_MOCK_TESTING
+
+/* A fake ESP-NOW radio, that has room for fewer frames than the transmit engine has slots */
+#define FAKE_RADIO_BUFFERS 3
+#define FAKE_RADIO_RING 8
+/* The radio does not get an acknowledgement for frames beginning with this */
+#define FAKE_RADIO_LOST_FRAME 0xEE
+
+static uint8_t fake_radio_macs[FAKE_RADIO_RING][ESPNOW_TRANSMIT_MAC_LEN];
+static bool fake_radio_lost[FAKE_RADIO_RING];
+static _Atomic uint32_t fake_radio_head;
+static _Atomic uint32_t fake_radio_tail;
+static _Atomic bool fake_radio_running;
+static _Atomic uint32_t fake_radio_done_ok;
+static _Atomic uint32_t fake_radio_done_failed;
+
+static rob_ret_val_t fake_esp_now_send(const uint8_t *mac_address, const uint8_t *data, uint32_t data_length)
+{
+    uint32_t head = atomic_load(&fake_radio_head);
+    if (head - atomic_load(&fake_radio_tail) >= FAKE_RADIO_BUFFERS)
+    {
+        return ROB_ERR_OUT_OF_MEMORY;
+    }
+    memcpy(fake_radio_macs[head % FAKE_RADIO_RING], mac_address, ESPNOW_TRANSMIT_MAC_LEN);
+    fake_radio_lost[head % FAKE_RADIO_RING] = data_length > 0 && data[0] == FAKE_RADIO_LOST_FRAME;
+    atomic_store(&fake_radio_head, head + 1);
+    return ROB_OK;
+}
+
+static void fake_esp_now_done(const uint8_t *mac_address, bool success)
+{
+    atomic_fetch_add(success ? &fake_radio_done_ok : &fake_radio_done_failed, 1);
+}
+
+/* Reports the outcome of the frames in the order they were sent, like the Wi-Fi task does */
+static void fake_radio_task(void *arg)
+{
+    while (atomic_load(&fake_radio_running))
+    {
+        uint32_t tail = atomic_load(&fake_radio_tail);
+        if (tail == atomic_load(&fake_radio_head))
+        {
+            robusto_yield();
+            continue;
+        }
+        r_delay(1);
+        uint8_t mac_address[ESPNOW_TRANSMIT_MAC_LEN];
+        memcpy(mac_address, fake_radio_macs[tail % FAKE_RADIO_RING], ESPNOW_TRANSMIT_MAC_LEN);
+        bool lost = fake_radio_lost[tail % FAKE_RADIO_RING];
+        atomic_store(&fake_radio_tail, tail + 1);
+        espnow_transmit_complete(mac_address, !lost);
+    }
+    robusto_delete_current_task();
+}
+
+/**
+ * @brief Check that ESP-NOW frames to several peers are kept outstanding, that running out of memory
+ * only holds the sender back, and that a waited frame gets its own outcome.
+ */
+void tst_espnow_transmit_outstanding(void)
+{
+    uint8_t peer_a[ESPNOW_TRANSMIT_MAC_LEN] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x0A};
+    uint8_t peer_b[ESPNOW_TRANSMIT_MAC_LEN] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x0B};
+    uint8_t frame[200];
+    memset(frame, 0x42, sizeof(frame));
+
+    atomic_store(&fake_radio_head, 0);
+    atomic_store(&fake_radio_tail, 0);
+    atomic_store(&fake_radio_done_ok, 0);
+    atomic_store(&fake_radio_done_failed, 0);
+    atomic_store(&fake_radio_running, true);
+    espnow_transmit_init(&fake_esp_now_send, &fake_esp_now_done, "Test");
+
+    rob_task_handle_t *task_handle;
+    char task_name[30] = "fake_radio";
+    robusto_create_task((TaskFunction_t)fake_radio_task, NULL, task_name, &task_handle, 0);
+
+    for (int index = 0; index < 40; index++)
+    {
+        TEST_ASSERT_EQUAL_INT_MESSAGE(ROB_OK, espnow_transmit_send(index % 2 ? peer_b : peer_a, frame, sizeof(frame), NULL, 1000),
+                                      "A frame should be handed to the radio once there is room");
+    }
+
+    int ticket = -1;
+    frame[0] = FAKE_RADIO_LOST_FRAME;
+    TEST_ASSERT_EQUAL_INT(ROB_OK, espnow_transmit_send(peer_a, frame, sizeof(frame), &ticket, 1000));
+    TEST_ASSERT_EQUAL_INT_MESSAGE(ROB_FAIL, espnow_transmit_wait(ticket, 1000), "The lost frame should fail");
+    frame[0] = 0x42;
+    TEST_ASSERT_EQUAL_INT(ROB_OK, espnow_transmit_send(peer_a, frame, sizeof(frame), &ticket, 1000));
+    TEST_ASSERT_EQUAL_INT_MESSAGE(ROB_OK, espnow_transmit_wait(ticket, 1000), "The next frame should succeed");
+
+    uint32_t start = r_millis();
+    while (atomic_load(&fake_radio_done_ok) < 40 && r_millis() - start < 1000)
+    {
+        r_delay(1);
+    }
+    atomic_store(&fake_radio_running, false);
+    r_delay(10);
+
+    espnow_transmit_stats_t stats;
+    espnow_transmit_get_stats(&stats);
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(40, atomic_load(&fake_radio_done_ok), "Frames that are not waited for should complete on their own");
+    TEST_ASSERT_EQUAL_UINT32(0, atomic_load(&fake_radio_done_failed));
+    TEST_ASSERT_EQUAL_UINT32(42, stats.sent);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.failed);
+    TEST_ASSERT_TRUE_MESSAGE(stats.max_outstanding > 1, "Several frames should have been outstanding at once");
+    TEST_ASSERT_TRUE_MESSAGE(stats.no_mem > 0, "The radio should have run out of memory");
+    TEST_ASSERT_TRUE_MESSAGE(stats.max_outstanding <= CONFIG_ROBUSTO_ESP_NOW_TX_SLOTS, "Never more outstanding than there are slots");
+}
+
+/* A simulated LoRa radio, that only keeps the time and what has been on air */
+typedef struct sim_lora_radio
+{
+    lora_schedule_t schedule;
+    uint32_t now_ms;
+    uint32_t frames;
+    uint32_t airtime_ms;
+} sim_lora_radio_t;
+
+static uint32_t sim_lora_transmit(sim_lora_radio_t *radio, uint16_t frame_length)
+{
+    uint32_t airtime_ms = lora_schedule_time_on_air_ms(&radio->schedule, frame_length);
+    radio->now_ms += airtime_ms;
+    radio->airtime_ms += airtime_ms;
+    radio->frames++;
+    return airtime_ms;
+}
+
+/**
+ * @brief Check the time on air against the Semtech formula, and that the duty-cycle budget
+ * keeps a reserve for important messages and is refilled over time.
+ */
+void tst_lora_schedule_duty_cycle(void)
+{
+    sim_lora_radio_t radio = {0};
+    // 1% over 10 seconds is 100 ms of airtime, of which normal messages leave 20 ms.
+    lora_schedule_init(&radio.schedule, 7, 125000, 5, 8, 10, 10, 20, radio.now_ms);
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(42, lora_schedule_time_on_air_ms(&radio.schedule, 10), "SF7, 125 kHz, 4/5, 10 bytes is 41.2 ms");
+    TEST_ASSERT_EQUAL_UINT32(26, lora_schedule_time_on_air_ms(&radio.schedule, 0));
+    TEST_ASSERT_EQUAL_UINT32(400, lora_schedule_time_on_air_ms(&radio.schedule, 255));
+    lora_schedule_t slow;
+    lora_schedule_init(&slow, 12, 125000, 5, 8, 10, 3600, 20, 0);
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(2466, lora_schedule_time_on_air_ms(&slow, 51), "SF12 uses the low data rate optimization");
+
+    uint32_t wait_ms = 0;
+    int admitted = 0;
+    while (lora_schedule_admit(&radio.schedule, 10, false, radio.now_ms, &wait_ms) == ROB_OK)
+    {
+        admitted++;
+    }
+    TEST_ASSERT_EQUAL_INT_MESSAGE(8, admitted, "Normal messages should leave the reserve");
+    TEST_ASSERT_EQUAL_UINT32(1000, wait_ms);
+    TEST_ASSERT_EQUAL_INT(ROB_OK, lora_schedule_admit(&radio.schedule, 10, true, radio.now_ms, &wait_ms));
+    TEST_ASSERT_EQUAL_INT(ROB_OK, lora_schedule_admit(&radio.schedule, 10, true, radio.now_ms, &wait_ms));
+    TEST_ASSERT_EQUAL_INT_MESSAGE(ROB_ERR_NOT_READY, lora_schedule_admit(&radio.schedule, 10, true, radio.now_ms, &wait_ms),
+                                  "Important messages may use the reserve, but not more");
+    TEST_ASSERT_EQUAL_UINT32(1000, wait_ms);
+
+    radio.now_ms += 999;
+    TEST_ASSERT_EQUAL_INT(ROB_ERR_NOT_READY, lora_schedule_admit(&radio.schedule, 10, true, radio.now_ms, &wait_ms));
+    TEST_ASSERT_EQUAL_UINT32(1, wait_ms);
+    radio.now_ms += 1;
+    TEST_ASSERT_EQUAL_INT_MESSAGE(ROB_OK, lora_schedule_admit(&radio.schedule, 10, true, radio.now_ms, &wait_ms), "The budget should have been refilled");
+
+    // Receipts are charged even if there is no budget
+    lora_schedule_charge(&radio.schedule, sim_lora_transmit(&radio, 6), radio.now_ms);
+    TEST_ASSERT_EQUAL_UINT32(0, lora_schedule_budget_ms(&radio.schedule, radio.now_ms));
+    TEST_ASSERT_EQUAL_INT_MESSAGE(ROB_ERR_MESSAGE_TOO_LONG, lora_schedule_admit(&radio.schedule, 90, false, radio.now_ms, &wait_ms),
+                                  "A normal message larger than what is outside of the reserve can never be sent");
+    radio.now_ms += 10000;
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(100, lora_schedule_budget_ms(&radio.schedule, radio.now_ms), "The budget is never more than the window allows");
+    TEST_ASSERT_EQUAL_INT(ROB_OK, lora_schedule_admit(&radio.schedule, 90, true, radio.now_ms, &wait_ms));
+    TEST_ASSERT_EQUAL_UINT32(3, radio.schedule.deferred);
+}
+
+/**
+ * @brief Check that small messages batched into one frame arrive intact, and
+ * use less airtime than sending them one by one, each with its own receipt.
+ */
+void tst_lora_batch_airtime(void)
+{
+    sim_lora_radio_t one_by_one = {0};
+    sim_lora_radio_t batched = {0};
+    lora_schedule_init(&one_by_one.schedule, 9, 125000, 5, 8, 1000, 3600, 0, 0);
+    lora_schedule_init(&batched.schedule, 9, 125000, 5, 8, 1000, 3600, 0, 0);
+
+    uint8_t *messages[6];
+    uint32_t message_lengths[6];
+    uint8_t binary[20];
+    lora_batch_t batch;
+    lora_batch_start(&batch);
+    for (uint8_t i = 0; i < 6; i++)
+    {
+        memset(binary, i, sizeof(binary));
+        message_lengths[i] = robusto_make_multi_message_internal(MSG_MESSAGE, 1, 0, NULL, 0, binary, sizeof(binary), &messages[i]);
+        // Each is sent with the relation id instead of the prefix, and gets a 6-byte receipt
+        sim_lora_transmit(&one_by_one, sizeof(uint32_t) + message_lengths[i] - ROBUSTO_PREFIX_BYTES);
+        sim_lora_transmit(&one_by_one, 6);
+        TEST_ASSERT_TRUE(lora_batch_add(&batch, messages[i] + ROBUSTO_PREFIX_BYTES, message_lengths[i] - ROBUSTO_PREFIX_BYTES));
+    }
+    TEST_ASSERT_FALSE_MESSAGE(lora_batch_fits(&batch, LORA_BATCH_MAX_LENGTH), "A batch cannot be larger than a LoRa frame");
+
+    uint32_t data_length = 0;
+    uint8_t *data = lora_batch_finish(&batch, &data_length);
+    sim_lora_transmit(&batched, sizeof(uint32_t) + data_length - ROBUSTO_PREFIX_BYTES);
+    sim_lora_transmit(&batched, 6);
+    TEST_ASSERT_TRUE_MESSAGE(data_length - ROBUSTO_PREFIX_BYTES <= LORA_BATCH_MAX_LENGTH, "The batch must fit in a frame with the relation id");
+    TEST_ASSERT_TRUE_MESSAGE(batched.airtime_ms * 2 < one_by_one.airtime_ms, "Batching should more than halve the airtime");
+    TEST_ASSERT_EQUAL_UINT32(2, batched.frames);
+    TEST_ASSERT_EQUAL_UINT32(12, one_by_one.frames);
+
+    // Receive it
+    TEST_ASSERT_TRUE_MESSAGE(robusto_check_message(data, data_length, ROBUSTO_PREFIX_BYTES), "The batch should pass its CRC check");
+    uint8_t *received = data + ROBUSTO_PREFIX_BYTES;
+    uint32_t received_length = data_length - ROBUSTO_PREFIX_BYTES;
+    uint32_t offset = 0;
+    const uint8_t *message;
+    uint32_t message_length;
+    uint8_t count = 0;
+    while (lora_batch_next(received, received_length, &offset, &message, &message_length))
+    {
+        TEST_ASSERT_TRUE_MESSAGE(count < 6, "There should be no more messages than were added");
+        TEST_ASSERT_EQUAL_UINT32(message_lengths[count] - ROBUSTO_PREFIX_BYTES, message_length);
+        TEST_ASSERT_EQUAL_MEMORY(messages[count] + ROBUSTO_PREFIX_BYTES, message, message_length);
+        TEST_ASSERT_TRUE(robusto_check_message((uint8_t *)message, message_length, 0));
+        count++;
+    }
+    TEST_ASSERT_EQUAL_UINT8(6, count);
+
+    // A damaged batch fails the CRC check as a whole, and a truncated one yields no partial message
+    data[ROBUSTO_PREFIX_BYTES + LORA_BATCH_HEADER_LENGTH + 3] ^= 0x01;
+    TEST_ASSERT_FALSE(robusto_check_message(data, data_length, ROBUSTO_PREFIX_BYTES));
+    offset = 0;
+    count = 0;
+    while (lora_batch_next(received, received_length - 1, &offset, &message, &message_length))
+    {
+        count++;
+    }
+    TEST_ASSERT_EQUAL_UINT8(5, count);
+
+    for (uint8_t i = 0; i < 6; i++)
+    {
+        robusto_free(messages[i]);
+    }
+}
+
+static uint8_t *batch_handled[3];
+static uint32_t batch_handled_lengths[3];
+static uint8_t batch_handled_count;
+
+static rob_ret_val_t tst_capture_batch_message(uint8_t *data, uint32_t data_length, robusto_peer_t *peer, e_media_type media_type, int offset)
+{
+    TEST_ASSERT_EQUAL_INT(robusto_mt_lora, media_type);
+    TEST_ASSERT_EQUAL_INT(0, offset);
+    TEST_ASSERT_TRUE_MESSAGE(batch_handled_count < 3, "There should be no more messages than were batched");
+    batch_handled[batch_handled_count] = data;
+    batch_handled_lengths[batch_handled_count++] = data_length;
+    // Like robusto_handle_incoming, a message that cannot be handled is reported but does not stop the rest
+    return data[ROBUSTO_CRC_LENGTH + ROBUSTO_CONTEXT_BYTE_LEN + 2] == 2 ? ROB_FAIL : ROB_OK;
+}
+
+/**
+ * @brief Check that a received batch is split back into its messages, that each are handed over in memory of their own,
+ * and that a failing message is reported without losing the others.
+ */
+void tst_lora_batch_handle(void)
+{
+    uint8_t *messages[3];
+    uint32_t message_lengths[3];
+    uint8_t binary[12];
+    lora_batch_t batch;
+    lora_batch_start(&batch);
+    for (uint8_t i = 0; i < 3; i++)
+    {
+        memset(binary, i, sizeof(binary));
+        message_lengths[i] = robusto_make_multi_message_internal(MSG_MESSAGE, 1, 0, NULL, 0, binary, sizeof(binary), &messages[i]);
+        TEST_ASSERT_TRUE(lora_batch_add(&batch, messages[i] + ROBUSTO_PREFIX_BYTES, message_lengths[i] - ROBUSTO_PREFIX_BYTES));
+    }
+    uint32_t data_length = 0;
+    uint8_t *data = lora_batch_finish(&batch, &data_length);
+    // All of the messages are in one frame, so they get one receipt
+    TEST_ASSERT_TRUE_MESSAGE(robusto_check_message(data, data_length, ROBUSTO_PREFIX_BYTES), "The batch should pass its CRC check");
+
+    batch_handled_count = 0;
+    TEST_ASSERT_EQUAL_INT(ROB_FAIL, lora_batch_handle(data + ROBUSTO_PREFIX_BYTES, data_length - ROBUSTO_PREFIX_BYTES, NULL, &tst_capture_batch_message));
+    TEST_ASSERT_EQUAL_UINT8(3, batch_handled_count);
+    for (uint8_t i = 0; i < 3; i++)
+    {
+        TEST_ASSERT_EQUAL_UINT32(message_lengths[i] - ROBUSTO_PREFIX_BYTES, batch_handled_lengths[i]);
+        TEST_ASSERT_EQUAL_MEMORY(messages[i] + ROBUSTO_PREFIX_BYTES, batch_handled[i], batch_handled_lengths[i]);
+        TEST_ASSERT_TRUE_MESSAGE(robusto_check_message(batch_handled[i], batch_handled_lengths[i], 0), "Each message should pass its own CRC check");
+        TEST_ASSERT_TRUE_MESSAGE(batch_handled[i] < data || batch_handled[i] >= data + data_length, "Each message should be a copy of its own");
+        robusto_free(batch_handled[i]);
+        robusto_free(messages[i]);
+    }
+
+    // Anything that is not a batch yields nothing
+    batch_handled_count = 0;
+    data[ROBUSTO_PREFIX_BYTES + ROBUSTO_CRC_LENGTH] = MSG_MESSAGE;
+    TEST_ASSERT_EQUAL_INT(ROB_OK, lora_batch_handle(data + ROBUSTO_PREFIX_BYTES, data_length - ROBUSTO_PREFIX_BYTES, NULL, &tst_capture_batch_message));
+    TEST_ASSERT_EQUAL_UINT8(0, batch_handled_count);
+}
+
+/**
+ * @brief Check that CAN bus messages from several sources are reassembled at the same time,
+ * into memory from the pools that is handed over instead of copied, and that broken messages are dropped.
+ */
+void tst_canbus_reassembly_in_place(void)
+{
+    uint8_t frame[8];
+    uint8_t *message = NULL;
+    uint32_t message_length = 0;
+    canbus_reassembly_init(8, "Test");
+
+    // Interleave a 29-byte message from 3 with a 24-byte one from 7
+    memset(frame, 3, sizeof(frame));
+    TEST_ASSERT_EQUAL_INT(ROB_OK, canbus_reassembly_start(3, 4, frame, 8));
+    memset(frame, 7, sizeof(frame));
+    TEST_ASSERT_EQUAL_INT(ROB_OK, canbus_reassembly_start(7, 3, frame, 8));
+    for (uint16_t index = 1; index < 3; index++)
+    {
+        memset(frame, 3, sizeof(frame));
+        TEST_ASSERT_EQUAL_INT(ROB_OK, canbus_reassembly_add(3, index, frame, 8, &message, &message_length));
+        TEST_ASSERT_NULL(message);
+        memset(frame, 7, sizeof(frame));
+        TEST_ASSERT_EQUAL_INT(ROB_OK, canbus_reassembly_add(7, index, frame, 8, &message, &message_length));
+    }
+    TEST_ASSERT_NOT_NULL_MESSAGE(message, "The last frame from 7 should complete its message");
+    TEST_ASSERT_EQUAL_UINT32(24, message_length);
+    TEST_ASSERT_EACH_EQUAL_UINT8(7, message, message_length);
+    TEST_ASSERT_TRUE_MESSAGE(robusto_pool_size_of(message) > 0, "A small message should be built in pool memory");
+    robusto_free(message);
+
+    memset(frame, 3, sizeof(frame));
+    TEST_ASSERT_EQUAL_INT(ROB_OK, canbus_reassembly_add(3, 3, frame, 5, &message, &message_length));
+    TEST_ASSERT_NOT_NULL(message);
+    TEST_ASSERT_EQUAL_UINT32(29, message_length);
+    TEST_ASSERT_EACH_EQUAL_UINT8(3, message, message_length);
+    robusto_free(message);
+
+    // A skipped frame drops the message, and the rest of it is then ignored
+    TEST_ASSERT_EQUAL_INT(ROB_OK, canbus_reassembly_start(3, 3, frame, 8));
+    TEST_ASSERT_EQUAL_INT(ROB_ERR_PARSING_FAILED, canbus_reassembly_add(3, 2, frame, 8, &message, &message_length));
+    TEST_ASSERT_EQUAL_INT(ROB_ERR_INVALID_ID, canbus_reassembly_add(3, 1, frame, 8, &message, &message_length));
+    TEST_ASSERT_NULL(message);
+
+    // A sender that starts over replaces its message, all in-flights can be used and then there are no more
+    TEST_ASSERT_EQUAL_INT(ROB_OK, canbus_reassembly_start(9, 3, frame, 8));
+    TEST_ASSERT_EQUAL_INT(ROB_OK, canbus_reassembly_start(9, 3, frame, 8));
+    for (uint8_t source = 10; source < 10 + CANBUS_MAX_IN_FLIGHT - 1; source++)
+    {
+        TEST_ASSERT_EQUAL_INT(ROB_OK, canbus_reassembly_start(source, 2, frame, 8));
+    }
+    TEST_ASSERT_EQUAL_INT(ROB_ERR_OUT_OF_MEMORY, canbus_reassembly_start(100, 2, frame, 8));
+
+    canbus_reassembly_stats_t stats;
+    canbus_reassembly_get_stats(&stats);
+    TEST_ASSERT_EQUAL_UINT32(2, stats.completed);
+    TEST_ASSERT_EQUAL_UINT32(3, stats.dropped);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.heap_allocations);
+    // Gives back what is still in flight
+    canbus_reassembly_init(8, "Test");
+}
+
+/**
+ * @brief Check that 9-byte messages and short service calls are carried in one extended CAN bus frame,
+ * and that everything else is left to normal frames.
+ */
+void tst_canbus_extended_frames(void)
+{
+    uint8_t message[12] = {CANBUS_COMPACT_CALL_CONTEXT, 0, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    uint16_t service_id = 1000;
+    memcpy(message + 1, &service_id, sizeof(service_id));
+    uint8_t header[CANBUS_EXTENDED_HEADER_MAX_LENGTH];
+    uint32_t identifier = 0;
+
+    // A service call with 8 bytes of binary data, the context byte and the service id go in the identifier
+    TEST_ASSERT_EQUAL_UINT8(3, canbus_encode_extended(message, 11, 8, 0x12, 0x34, &identifier));
+    TEST_ASSERT_EQUAL_HEX32(0x34, identifier & 0xFF);
+    TEST_ASSERT_EQUAL_HEX32(0x12, (identifier >> 8) & 0xFF);
+    TEST_ASSERT_EQUAL_UINT8(3, canbus_decode_extended(identifier, header));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(message, header, 3);
+    // With 9 bytes of data it is too long for one frame
+    TEST_ASSERT_EQUAL_UINT8(0, canbus_encode_extended(message, 12, 8, 0x12, 0x34, &identifier));
+
+    // Service ids that do not fit fall back to carrying only the context byte, which fits 9 bytes
+    service_id = CANBUS_COMPACT_CALL_MAX_SERVICE_ID + 1;
+    memcpy(message + 1, &service_id, sizeof(service_id));
+    TEST_ASSERT_EQUAL_UINT8(0, canbus_encode_extended(message, 11, 8, 0x12, 0x34, &identifier));
+    TEST_ASSERT_EQUAL_UINT8(1, canbus_encode_extended(message, 9, 8, 0x12, 0x34, &identifier));
+    TEST_ASSERT_EQUAL_UINT8(1, canbus_decode_extended(identifier, header));
+    TEST_ASSERT_EQUAL_UINT8(CANBUS_COMPACT_CALL_CONTEXT, header[0]);
+
+    // Any 9-byte message, like a context byte and two uint32s
+    message[0] = HEARTBEAT_CONTEXT;
+    TEST_ASSERT_EQUAL_UINT8(1, canbus_encode_extended(message, 9, 8, 0x12, 0x34, &identifier));
+    TEST_ASSERT_EQUAL_UINT8(1, canbus_decode_extended(identifier, header));
+    TEST_ASSERT_EQUAL_UINT8(HEARTBEAT_CONTEXT, header[0]);
+
+    // Normal frames are not decoded, whatever their count or index is
+    TEST_ASSERT_EQUAL_UINT8(0, canbus_decode_extended(canbus_make_identifier(0x12, 0x34, true, CANBUS_ID_COUNT_MASK), header));
+    TEST_ASSERT_EQUAL_UINT8(0, canbus_decode_extended(canbus_make_identifier(0x12, 0x34, false, 5), header));
+    // Peers from before extended frames only get normal ones
+    TEST_ASSERT_EQUAL_UINT8(CANBUS_FRAME_LENGTH, canbus_single_frame_length(ROBUSTO_PROTOCOL_VERSION_CANBUS_EXTENDED - 1));
+    robusto_peer_t old_peer = {0};
+    old_peer.protocol_version = ROBUSTO_PROTOCOL_VERSION_CANBUS_EXTENDED - 1;
+    TEST_ASSERT_TRUE(canbus_fits_single_frame(&old_peer, message, CANBUS_FRAME_LENGTH));
+    TEST_ASSERT_FALSE(canbus_fits_single_frame(&old_peer, message, CANBUS_FRAME_LENGTH + 1));
+#ifdef CONFIG_ROBUSTO_CANBUS_EXTENDED_PAYLOAD
+    // Scoring agrees with what is sent to peers that take them
+    robusto_peer_t new_peer = {0};
+    new_peer.protocol_version = ROBUSTO_PROTOCOL_VERSION_CANBUS_EXTENDED;
+    message[0] = CANBUS_COMPACT_CALL_CONTEXT;
+    service_id = 1000;
+    memcpy(message + 1, &service_id, sizeof(service_id));
+    TEST_ASSERT_TRUE(canbus_fits_single_frame(&new_peer, message, 11));
+    TEST_ASSERT_FALSE(canbus_fits_single_frame(&new_peer, message, 12));
+    TEST_ASSERT_TRUE(canbus_fits_single_frame(&new_peer, NULL, 9));
+#endif
+}
+#endif
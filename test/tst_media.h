@@ -5,6 +5,14 @@ extern "C"
 {
 #endif
 void tst_add_host_media_type_mock(void);
+#ifdef CONFIG_ROBUSTO_NETWORK_MOCK_TESTING
+void tst_espnow_transmit_outstanding(void);
+void tst_lora_schedule_duty_cycle(void);
+void tst_lora_batch_airtime(void);
+void tst_lora_batch_handle(void);
+void tst_canbus_reassembly_in_place(void);
+void tst_canbus_extended_frames(void);
+#endif
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
\ No newline at end of file
@@ -99,6 +99,86 @@ void tst_make_multi_conversation_message(void){
  
 }
 
+/**
+ * @brief Describe a multi message as segments, it should reference the data and put together to the same message
+ * 
+ */
+void tst_make_multi_message_segments(void){
+    uint8_t *tst_multi_res;
+    robusto_message_segments_t segments;
+    int tst_msg_length = robusto_make_multi_message_internal(MSG_MESSAGE, 0, 1, 
+    (uint8_t*)&tst_strings, sizeof(tst_strings),
+    (uint8_t*)&tst_binary, sizeof(tst_binary), 
+    &tst_multi_res);
+    int tst_seg_length = robusto_make_multi_message_segments(MSG_MESSAGE, 0, 1, 
+    (uint8_t*)&tst_strings, sizeof(tst_strings),
+    (uint8_t*)&tst_binary, sizeof(tst_binary), 
+    &segments);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(tst_msg_length, tst_seg_length, "The length of the segmented message doesn't match");
+    TEST_ASSERT_EQUAL_UINT8_MESSAGE(3, segments.segment_count, "Expected a header, a strings and a binary segment");
+    TEST_ASSERT_TRUE_MESSAGE(segments.segments[2].data == (uint8_t*)&tst_binary, "The binary segment should reference the data, not a copy");
+
+    uint8_t *tst_linear_res = robusto_message_segments_linearise(&segments);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY_MESSAGE(tst_multi_res + ROBUSTO_PREFIX_BYTES, tst_linear_res + ROBUSTO_PREFIX_BYTES, tst_msg_length - ROBUSTO_PREFIX_BYTES, "The segmented message content or CRC doesn't match");
+
+    // A range across all the segments, as the fragmentation gathers them
+    uint32_t offset = segments.segments[0].length - 3;
+    uint32_t length = tst_msg_length - offset - 2;
+    uint8_t range[sizeof(tst_strings) + sizeof(tst_binary) + 3];
+    robusto_message_segments_copy(&segments, offset, range, length);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY_MESSAGE(tst_multi_res + offset, range, length, "Copying a range out of the segments doesn't match");
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(robusto_crc32(0, tst_multi_res + offset, length), robusto_message_segments_crc32(0, &segments, offset, length),
+        "The CRC32 of a range across the segments doesn't match");
+
+    robusto_free(tst_linear_res);
+    robusto_free(tst_multi_res);
+}
+
+/**
+ * @brief Parse into a caller's message structure, with and without room for the string pointers
+ * 
+ */
+void tst_parse_message_into(void){
+    uint8_t *tst_multi_res;
+    int tst_msg_length = robusto_make_multi_message_internal(MSG_MESSAGE, 2, 1, 
+    (uint8_t*)&tst_strings, sizeof(tst_strings),
+    (uint8_t*)&tst_binary, sizeof(tst_binary), 
+    &tst_multi_res);
+    robusto_message_t message;
+    char *strings[2];
+
+    // Room for both strings, nothing is allocated
+    TEST_ASSERT_EQUAL_INT(ROB_OK, robusto_network_parse_message_into(tst_multi_res, tst_msg_length, NULL, &message, ROBUSTO_PREFIX_BYTES, strings, 2));
+    TEST_ASSERT_EQUAL_UINT16(2, message.service_id);
+    TEST_ASSERT_EQUAL_UINT16(1, message.conversation_id);
+    TEST_ASSERT_EQUAL_UINT16(2, message.string_count);
+    TEST_ASSERT_TRUE(message.strings == strings);
+    TEST_ASSERT_FALSE(message.strings_allocated);
+    TEST_ASSERT_EQUAL_STRING("ABC", message.strings[0]);
+    TEST_ASSERT_EQUAL_STRING("123", message.strings[1]);
+    TEST_ASSERT_TRUE_MESSAGE(message.binary_data == tst_multi_res + tst_msg_length - sizeof(tst_binary), "The binary data should point into the message");
+
+    // Too little room, the pointers get an array of their own
+    TEST_ASSERT_EQUAL_INT(ROB_OK, robusto_network_parse_message_into(tst_multi_res, tst_msg_length, NULL, &message, ROBUSTO_PREFIX_BYTES, strings, 1));
+    TEST_ASSERT_TRUE(message.strings_allocated);
+    TEST_ASSERT_EQUAL_STRING("123", message.strings[1]);
+    robusto_free(message.strings);
+
+    // No room at all, the strings are only walked
+    TEST_ASSERT_EQUAL_INT(ROB_OK, robusto_network_parse_message_into(tst_multi_res, tst_msg_length, NULL, &message, ROBUSTO_PREFIX_BYTES, NULL, 0));
+    TEST_ASSERT_NULL(message.strings);
+    TEST_ASSERT_EQUAL_UINT16(2, message.string_count);
+    const char *curr = robusto_message_next_string(&message, NULL);
+    TEST_ASSERT_EQUAL_STRING("ABC", curr);
+    curr = robusto_message_next_string(&message, curr);
+    TEST_ASSERT_EQUAL_STRING("123", curr);
+    TEST_ASSERT_NULL(robusto_message_next_string(&message, curr));
+
+    // A strings length that points past the end of the message is refused
+    tst_multi_res[ROBUSTO_PREFIX_BYTES + ROBUSTO_CRC_LENGTH + 5] = 0xFF;
+    TEST_ASSERT_EQUAL_INT(ROB_ERR_PARSING_FAILED, robusto_network_parse_message_into(tst_multi_res, tst_msg_length, NULL, &message, ROBUSTO_PREFIX_BYTES, strings, 2));
+    robusto_free(tst_multi_res);
+}
 
 /**
  * @brief Build null-separated strings
@@ -17,6 +17,16 @@ void tst_make_multi_message(void);
  * @brief Test making a message witn both and a conversation id
  */
 void tst_make_multi_conversation_message(void);
+/**
+ * @brief Describe a multi message as segments, and check that it puts together to the same message
+ * 
+ */
+void tst_make_multi_message_segments(void);
+/**
+ * @brief Parse a message into a message structure provided by the caller
+ * 
+ */
+void tst_parse_message_into(void);
 /**
  * @brief Test making building a strings payload
  */
@@ -91,4 +91,47 @@ void tst_async_mock_send_message(void)
     robusto_free_queue_state(q_state);
 }
 
+void tst_async_mock_send_message_completion(void)
+{
+    uint8_t *tst_strings_msg;
+    int tst_strings_length = robusto_make_multi_message_internal(MSG_MESSAGE, 1, 0, (uint8_t *)&tst_strings, 8, NULL, 0, &tst_strings_msg);
+    robusto_completion_t *completion = robusto_completion_create();
+    TEST_ASSERT_NOT_NULL(completion);
+    robusto_peer_t * test_peer_mock = robusto_peers_find_peer_by_name("TEST_MOCK_1");
+    rob_ret_val_t retval = send_message_raw_completion(test_peer_mock, robusto_mt_mock, tst_strings_msg, tst_strings_length, completion, true);
+    TEST_ASSERT_EQUAL_MESSAGE(ROB_OK, retval, "Not the right response, ie ROB_OK (0).");
+
+    rob_ret_val_t ret_val = ROB_FAIL;
+    TEST_ASSERT_EQUAL_MESSAGE(ROB_OK, robusto_completion_wait(completion, 1500, &ret_val), "Timed out waiting for the completion.");
+    TEST_ASSERT_EQUAL_MESSAGE(ROB_OK, ret_val, "The send failed.");
+    robusto_completion_release(completion);
+}
+
+void tst_async_mock_send_message_shared_buffer(void)
+{
+    uint8_t *tst_strings_msg;
+    int tst_strings_length = robusto_make_multi_message_internal(MSG_MESSAGE, 1, 0, (uint8_t *)&tst_strings, 8, NULL, 0, &tst_strings_msg);
+    robusto_buffer_t *buffer = robusto_buffer_create(tst_strings_length, false);
+    TEST_ASSERT_NOT_NULL(buffer);
+    memcpy(robusto_buffer_get_data(buffer), tst_strings_msg, tst_strings_length);
+    robusto_free(tst_strings_msg);
+    robusto_peer_t * test_peer_mock = robusto_peers_find_peer_by_name("TEST_MOCK_1");
+
+    // Send the same buffer twice, like to two subscribers
+    queue_state *q_states[2];
+    for (int i = 0; i < 2; i++)
+    {
+        q_states[i] = robusto_malloc(sizeof(queue_state));
+        TEST_ASSERT_EQUAL_MESSAGE(ROB_OK, send_message_raw_buffer(test_peer_mock, robusto_mt_mock, buffer, q_states[i], true), "Failed to queue the shared buffer.");
+    }
+    // The queue items have their own references
+    robusto_buffer_release(buffer);
+    for (int i = 0; i < 2; i++)
+    {
+        rob_ret_val_t ret_val;
+        TEST_ASSERT_TRUE_MESSAGE(robusto_waitfor_queue_state(q_states[i], 1500, &ret_val), "Sending the shared buffer failed.");
+        robusto_free_queue_state(q_states[i]);
+    }
+}
+
 #endif
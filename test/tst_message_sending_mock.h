@@ -1,4 +1,6 @@
 #pragma once
 #include <robconfig.h>
 void init_defs_mock();
-void tst_async_mock_send_message(void);
\ No newline at end of file
+void tst_async_mock_send_message(void);
+void tst_async_mock_send_message_completion(void);
+void tst_async_mock_send_message_shared_buffer(void);
\ No newline at end of file
@@ -4,9 +4,12 @@
 
 
 #include <string.h>
+#include <stdio.h>
 
 #include <robusto_message.h>
 #include <robusto_pubsub_server.h>
+#include <robusto_concurrency.h>
+#include <robusto_time.h>
 
 static uint8_t * pub_data = NULL;
 static uint16_t pub_data_length;
@@ -102,4 +105,148 @@ void tst_pubsub(void)
 
 }
 
+void tst_pubsub_indexes(void)
+{
+    // Enough topics to make the topic index grow several times
+    char topic_name[32];
+    pubsub_server_topic_t *topics[100];
+    robusto_peer_t peers[3];
+
+    memset(peers, 0, sizeof(peers));
+    for (int p = 0; p < 3; p++) {
+        sprintf(peers[p].name, "index_peer_%i", p);
+        peers[p].relation_id_incoming = 0x1000U + (uint32_t)p;
+    }
+
+    for (int t = 0; t < 100; t++) {
+        sprintf(topic_name, "test.index.%i", t);
+        topics[t] = robusto_pubsub_server_find_or_create_topic(topic_name);
+        TEST_ASSERT_NOT_NULL_MESSAGE(topics[t], "Failed to create an indexed topic");
+    }
+    for (int t = 0; t < 100; t++) {
+        sprintf(topic_name, "test.index.%i", t);
+        TEST_ASSERT_EQUAL_PTR_MESSAGE(topics[t], robusto_pubsub_server_find_or_create_topic(topic_name),
+                                      "Looking up a topic by name must not create a new one");
+        // Every peer subscribes to every third topic, peer 0 to all of them
+        for (int p = 0; p < 3; p++) {
+            if (p == 0 || t % 3 == p) {
+                TEST_ASSERT_EQUAL_UINT32_MESSAGE(topics[t]->hash,
+                                                 robusto_pubsub_server_subscribe(&peers[p], NULL, topic_name),
+                                                 "Peer subscription failed");
+            }
+        }
+        TEST_ASSERT_EQUAL_UINT32_MESSAGE(topics[t]->hash,
+                                         robusto_pubsub_server_subscribe(&peers[0], NULL, topic_name),
+                                         "A repeated peer subscription must return the same topic hash");
+    }
+    TEST_ASSERT_EQUAL_UINT8_MESSAGE(2, topics[1]->subscriber_count, "Wrong subscriber count");
+    TEST_ASSERT_EQUAL_UINT8_MESSAGE(1, topics[3]->subscriber_count, "Wrong subscriber count");
+
+    // Remove one subscription in the middle of both the topic and the peer lists
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(topics[50]->hash,
+                                     robusto_pubsub_server_unsubscribe(&peers[0], NULL, topics[50]->hash),
+                                     "Peer unsubscribe failed");
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, robusto_pubsub_server_unsubscribe(&peers[0], NULL, topics[50]->hash),
+                                     "Repeated peer unsubscribe must report no removal");
+    TEST_ASSERT_EQUAL_PTR_MESSAGE(&peers[2], topics[50]->first_subscriber->peer,
+                                  "The remaining subscriber is wrong");
+
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(33, robusto_pubsub_server_unsubscribe_peer_from_all(&peers[1]),
+                                     "Wrong number of subscriptions removed for peer 1");
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, robusto_pubsub_server_unsubscribe_peer_from_all(&peers[1]),
+                                     "Peer 1 must have no subscriptions left");
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(99, robusto_pubsub_server_unsubscribe_peer_from_all(&peers[0]),
+                                     "Wrong number of subscriptions removed for peer 0");
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(33, robusto_pubsub_server_unsubscribe_peer_from_all(&peers[2]),
+                                     "Wrong number of subscriptions removed for peer 2");
+    for (int t = 0; t < 100; t++) {
+        TEST_ASSERT_EQUAL_INT_MESSAGE(ROB_OK, robusto_pubsub_server_publish(topics[t]->hash, (uint8_t *)"x", 1),
+                                      "Looking up a topic by hash failed");
+        TEST_ASSERT_EQUAL_UINT8_MESSAGE(0, topics[t]->subscriber_count, "Subscribers left after removal");
+        TEST_ASSERT_NULL_MESSAGE(topics[t]->first_subscriber, "Subscriber list not empty after removal");
+        TEST_ASSERT_NULL_MESSAGE(topics[t]->last_subscriber, "Subscriber list end not reset after removal");
+    }
+}
+
+static volatile bool slow_entered;
+static volatile bool slow_release;
+static volatile bool slow_done;
+static uint32_t self_unsubscribe_hash;
+static uint16_t self_unsubscribe_count;
+
+static rob_ret_val_t on_slow_data(void *context, uint8_t *data, uint32_t data_length) {
+    (void)context;
+    (void)data;
+    (void)data_length;
+    slow_entered = true;
+    for (int i = 0; i < 2000 && !slow_release; i++) {
+        r_delay(1);
+    }
+    slow_done = true;
+    return ROB_OK;
+}
+
+static rob_ret_val_t on_data_unsubscribe_self(uint8_t *data, uint32_t data_length) {
+    (void)data;
+    (void)data_length;
+    self_unsubscribe_count++;
+    robusto_pubsub_server_unsubscribe(NULL, &on_data_unsubscribe_self, self_unsubscribe_hash);
+    return ROB_OK;
+}
+
+static void slow_publisher(uint32_t *topic_hash) {
+    robusto_pubsub_server_publish(*topic_hash, (uint8_t *)"slow", 4);
+    robusto_delete_current_task();
+}
+
+static void slow_releaser(void *unused) {
+    (void)unused;
+    r_delay(50);
+    slow_release = true;
+    robusto_delete_current_task();
+}
+
+/**
+ * @brief Check that a slow subscriber doesn't block other publishes, and that unsubscribing waits for it
+ */
+void tst_pubsub_concurrent_publish(void)
+{
+    int slow_context = 0;
+    rob_task_handle_t *task_handle;
+    slow_entered = false;
+    slow_release = false;
+    slow_done = false;
+
+    static uint32_t slow_hash;
+    slow_hash = robusto_pubsub_server_subscribe_with_context(&on_slow_data, &slow_context, "test.slow");
+    TEST_ASSERT_NOT_EQUAL(0, slow_hash);
+    robusto_create_task((TaskFunction_t)slow_publisher, &slow_hash, "slow_publisher", &task_handle, 0);
+    for (int i = 0; i < 2000 && !slow_entered; i++) {
+        r_delay(1);
+    }
+    TEST_ASSERT_TRUE_MESSAGE(slow_entered, "The slow subscriber was never called");
+
+    // Other topics can be subscribed to and published while the slow subscriber is busy
+    callback_count = 0;
+    uint32_t fast_hash = robusto_pubsub_server_subscribe(NULL, &on_data, "test.fast");
+    TEST_ASSERT_NOT_EQUAL(0, fast_hash);
+    TEST_ASSERT_EQUAL_INT(ROB_OK, robusto_pubsub_server_publish(fast_hash, (uint8_t *)"fast", 4));
+    TEST_ASSERT_EQUAL_UINT16(1, callback_count);
+    TEST_ASSERT_FALSE_MESSAGE(slow_done, "Publishing was blocked by the slow subscriber");
+    robusto_pubsub_server_unsubscribe(NULL, &on_data, fast_hash);
+
+    // Unsubscribing returns only when the slow subscriber is done with its context
+    robusto_create_task((TaskFunction_t)slow_releaser, NULL, "slow_releaser", &task_handle, 0);
+    TEST_ASSERT_EQUAL_UINT32(slow_hash,
+                             robusto_pubsub_server_unsubscribe_with_context(&on_slow_data, &slow_context, slow_hash));
+    TEST_ASSERT_TRUE_MESSAGE(slow_done, "Unsubscribe returned while the subscriber was still called");
+
+    // A subscriber may unsubscribe itself while being published to
+    self_unsubscribe_count = 0;
+    self_unsubscribe_hash = robusto_pubsub_server_subscribe(NULL, &on_data_unsubscribe_self, "test.self");
+    TEST_ASSERT_EQUAL_INT(ROB_OK, robusto_pubsub_server_publish(self_unsubscribe_hash, (uint8_t *)"self", 4));
+    TEST_ASSERT_EQUAL_INT(ROB_OK, robusto_pubsub_server_publish(self_unsubscribe_hash, (uint8_t *)"self", 4));
+    TEST_ASSERT_EQUAL_UINT16(1, self_unsubscribe_count);
+}
+
 #endif
\ No newline at end of file
@@ -2,4 +2,6 @@
 #include <robconfig.h>
 
 void tst_pubsub(void);
+void tst_pubsub_indexes(void);
+void tst_pubsub_concurrent_publish(void);
 
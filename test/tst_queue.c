@@ -14,6 +14,8 @@
 #include <robusto_logging.h>
 #include "sample_queue.h"
 #include <robusto_time.h>
+#include <robusto_concurrency.h>
+#include <stdlib.h>
 
 int poll_count = 0;
 int work_value = 0;
@@ -91,3 +93,255 @@ void tst_queue_shutdown(void) {
     TEST_ASSERT_TRUE(true);
 }
 
+static rob_ret_val_t completion_cb_result = ROB_FAIL;
+static int completion_cb_count = 0;
+
+static void completion_callback(robusto_completion_t *completion, rob_ret_val_t result, void *user_data)
+{
+    (void)completion;
+    completion_cb_result = result;
+    completion_cb_count += *(int *)user_data;
+}
+
+static void completion_signaller(robusto_completion_t *completion)
+{
+    r_delay(50);
+    robusto_completion_signal(completion, ROB_ERR_WHO);
+    robusto_completion_release(completion);
+    robusto_delete_current_task();
+}
+
+/**
+ * @brief Check that a completion can be waited for, calls its callback once and ignores later signals
+ */
+void tst_queue_completion(void)
+{
+    ROB_LOGI("Test", "In tst_queue_completion");
+    robusto_completion_t *completion = robusto_completion_create();
+    TEST_ASSERT_NOT_NULL(completion);
+    TEST_ASSERT_EQUAL_INT(ROB_ERR_TIMEOUT, robusto_completion_wait(completion, 20, NULL));
+    TEST_ASSERT_FALSE(robusto_completion_is_done(completion));
+
+    int increment = 1;
+    robusto_completion_on_done(completion, completion_callback, &increment);
+    // The signaller gets its own reference
+    robusto_completion_retain(completion);
+    rob_task_handle_t *task_handle;
+    robusto_create_task((TaskFunction_t)completion_signaller, completion, "completion_signaller", &task_handle, 0);
+
+    rob_ret_val_t result = ROB_OK;
+    TEST_ASSERT_EQUAL_INT(ROB_OK, robusto_completion_wait(completion, 2000, &result));
+    TEST_ASSERT_EQUAL_INT(ROB_ERR_WHO, result);
+    TEST_ASSERT_EQUAL_INT(ROB_ERR_WHO, completion_cb_result);
+    TEST_ASSERT_FALSE_MESSAGE(robusto_completion_signal(completion, ROB_OK), "A completion should only be signalled once");
+    TEST_ASSERT_EQUAL_INT(ROB_OK, robusto_completion_wait(completion, 0, &result));
+    TEST_ASSERT_EQUAL_INT(ROB_ERR_WHO, result);
+    TEST_ASSERT_EQUAL_INT(QUEUE_STATE_FAILED, *robusto_completion_get_state(completion)[0]);
+    TEST_ASSERT_EQUAL_INT(1, completion_cb_count);
+    // The callback has already been called, it is not called again
+    robusto_completion_on_done(completion, completion_callback, &increment);
+    TEST_ASSERT_EQUAL_INT(1, completion_cb_count);
+    robusto_completion_release(completion);
+}
+
+#define POOL_SIZE 3
+#define POOL_ITEMS 9
+
+STAILQ_HEAD(pool_work_q, sample_queue_item)
+pool_work_q;
+
+static int pool_handled = 0;
+static mutex_ref_t pool_handled_mutex;
+
+static void *pool_first_queueitem(queue_context_t *q_context)
+{
+    (void)q_context;
+    return STAILQ_FIRST(&pool_work_q);
+}
+
+static void pool_remove_first_queue_item(queue_context_t *q_context)
+{
+    STAILQ_REMOVE_HEAD(&pool_work_q, items);
+    q_context->count--;
+}
+
+static void pool_insert_tail(queue_context_t *q_context, void *new_item)
+{
+    STAILQ_INSERT_TAIL(&pool_work_q, (sample_queue_item_t *)new_item, items);
+    q_context->count++;
+}
+
+static void pool_work_callback(void *queue_item)
+{
+    // Long enough for the items to be spread over the workers
+    r_delay(20);
+    robusto_mutex_take(pool_handled_mutex, 1000);
+    pool_handled++;
+    robusto_mutex_give(pool_handled_mutex);
+    free(queue_item);
+}
+
+/**
+ * @brief Check that a multitasking queue spreads its work over the worker pool, and keeps statistics
+ */
+void tst_queue_worker_pool(void)
+{
+    ROB_LOGI("Test", "In tst_queue_worker_pool");
+    // The worker uses the context until it shuts down, so it is not freed.
+    queue_context_t *q_context = calloc(1, sizeof(queue_context_t));
+    STAILQ_INIT(&pool_work_q);
+    pool_handled_mutex = robusto_mutex_init();
+    q_context->first_queue_item_cb = pool_first_queueitem;
+    q_context->remove_first_queueitem_cb = pool_remove_first_queue_item;
+    q_context->insert_tail_cb = pool_insert_tail;
+    q_context->on_work_cb = pool_work_callback;
+    q_context->max_task_count = POOL_SIZE;
+    q_context->multitasking = true;
+    q_context->normal_max_count = POOL_ITEMS;
+    q_context->important_max_count = POOL_ITEMS;
+    q_context->watchdog_timeout = 7;
+
+    TEST_ASSERT_EQUAL_INT_MESSAGE(ROB_OK, init_work_queue(q_context, "pool_queue", "Pool test"), "Failed to initialize the pool queue");
+    TEST_ASSERT_EQUAL_UINT8_MESSAGE(POOL_SIZE, q_context->pool_size, "The pool should be sized by max_task_count");
+
+    for (int i = 0; i < POOL_ITEMS; i++)
+    {
+        sample_queue_item_t *new_item = malloc(sizeof(sample_queue_item_t));
+        new_item->test_value = i;
+        TEST_ASSERT_EQUAL_INT(ROB_OK, safe_add_work_queue(q_context, new_item, false));
+    }
+    uint32_t starttime = r_millis();
+    while (pool_handled < POOL_ITEMS && r_millis() < starttime + 5000)
+    {
+        r_delay(5);
+    }
+    TEST_ASSERT_EQUAL_INT_MESSAGE(POOL_ITEMS, pool_handled, "Not all items were handled by the pool");
+    // Let the last worker update its statistics
+    r_delay(50);
+
+    queue_worker_stats_t stats[POOL_SIZE + 1];
+    uint8_t count = get_queue_worker_stats(q_context, stats, POOL_SIZE + 1);
+    TEST_ASSERT_EQUAL_UINT8(POOL_SIZE, count);
+    uint32_t total = 0;
+    for (uint8_t i = 0; i < count; i++)
+    {
+        TEST_ASSERT_TRUE_MESSAGE(stats[i].items_handled > 0, "All pool workers should have been used");
+        TEST_ASSERT_TRUE_MESSAGE(stats[i].busy_ms >= 20 * stats[i].items_handled - 1, "Busy time should include the handling");
+        TEST_ASSERT_FALSE(stats[i].busy);
+        total += stats[i].items_handled;
+    }
+    TEST_ASSERT_EQUAL_UINT32(POOL_ITEMS, total);
+    log_queue_worker_stats(q_context);
+
+    q_context->shutdown = true;
+    wake_queue_worker(q_context);
+    r_delay(200);
+    TEST_ASSERT_NULL_MESSAGE(q_context->pool, "The pool should be freed at shutdown");
+}
+
+#ifdef CONFIG_ROBUSTO_QUEUE_RING
+
+#define BENCH_PRODUCERS 4
+#define BENCH_ITEMS_PER_PRODUCER 2000
+
+STAILQ_HEAD(bench_work_q, sample_queue_item)
+bench_work_q;
+
+static volatile int bench_handled = 0;
+
+static void *bench_first_queueitem(queue_context_t *q_context)
+{
+    (void)q_context;
+    return STAILQ_FIRST(&bench_work_q);
+}
+
+static void bench_remove_first_queue_item(queue_context_t *q_context)
+{
+    STAILQ_REMOVE_HEAD(&bench_work_q, items);
+    q_context->count--;
+}
+
+static void bench_insert_tail(queue_context_t *q_context, void *new_item)
+{
+    STAILQ_INSERT_TAIL(&bench_work_q, (sample_queue_item_t *)new_item, items);
+    q_context->count++;
+}
+
+static void bench_work_callback(void *queue_item)
+{
+    bench_handled++;
+    free(queue_item);
+}
+
+static void bench_producer(queue_context_t *q_context)
+{
+    for (int i = 0; i < BENCH_ITEMS_PER_PRODUCER; i++)
+    {
+        sample_queue_item_t *new_item = malloc(sizeof(sample_queue_item_t));
+        new_item->test_value = i;
+        while (safe_add_work_queue(q_context, new_item, true) != ROB_OK)
+        {
+            robusto_yield();
+        }
+    }
+    robusto_delete_current_task();
+}
+
+/**
+ * @brief Run BENCH_PRODUCERS tasks adding items to a queue, and return how many milliseconds it took until all were handled
+ */
+static uint32_t bench_run(bool use_ring)
+{
+    int total = BENCH_PRODUCERS * BENCH_ITEMS_PER_PRODUCER;
+    // The worker uses the context until it shuts down, so it is not freed.
+    queue_context_t *q_context = calloc(1, sizeof(queue_context_t));
+    STAILQ_INIT(&bench_work_q);
+    q_context->first_queue_item_cb = bench_first_queueitem;
+    q_context->remove_first_queueitem_cb = bench_remove_first_queue_item;
+    q_context->insert_tail_cb = bench_insert_tail;
+    q_context->on_work_cb = bench_work_callback;
+    q_context->max_task_count = 1;
+    q_context->normal_max_count = 200;
+    q_context->important_max_count = 250;
+    q_context->watchdog_timeout = 7;
+    bench_handled = 0;
+
+    rob_ret_val_t rc = use_ring ? init_work_queue_ring(q_context, "bench_queue", "Ring benchmark", 256)
+                                : init_work_queue(q_context, "bench_queue", "STAILQ benchmark");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(ROB_OK, rc, "Failed to initialize the benchmark queue");
+
+    uint32_t starttime = r_millis();
+    for (int i = 0; i < BENCH_PRODUCERS; i++)
+    {
+        rob_task_handle_t *task_handle;
+        char task_name[30];
+        sprintf(task_name, "bench_producer_%i", i);
+        robusto_create_task((TaskFunction_t)bench_producer, q_context, task_name, &task_handle, 0);
+    }
+    while (bench_handled < total && r_millis() < starttime + 20000)
+    {
+        r_delay(1);
+    }
+    uint32_t duration = r_millis() - starttime;
+    TEST_ASSERT_EQUAL_INT_MESSAGE(total, bench_handled, "Not all benchmark items were handled");
+
+    q_context->shutdown = true;
+    wake_queue_worker(q_context);
+    return duration;
+}
+
+/**
+ * @brief Compare the lock-free ring with the mutex-protected STAILQ with several producers
+ */
+void tst_queue_ring_benchmark(void)
+{
+    ROB_LOGI("Test", "In tst_queue_ring_benchmark");
+    uint32_t stailq_ms = bench_run(false);
+    // Let the first worker shut down before reusing the queue head
+    r_delay(CONFIG_ROBUSTO_WORKER_IDLE_TIMEOUT_MS + 100);
+    uint32_t ring_ms = bench_run(true);
+    ROB_LOGW("Test", "Queue benchmark, %i producers x %i items: STAILQ %lu ms, ring %lu ms",
+             BENCH_PRODUCERS, BENCH_ITEMS_PER_PRODUCER, (unsigned long)stailq_ms, (unsigned long)ring_ms);
+    r_delay(CONFIG_ROBUSTO_WORKER_IDLE_TIMEOUT_MS + 100);
+}
+#endif
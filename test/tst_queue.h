@@ -5,3 +5,8 @@ void tst_queue_check_poll(void);
 void tst_queue_add_work(void);
 void tst_queue_check_work(void);
 void tst_queue_shutdown(void);
+void tst_queue_worker_pool(void);
+void tst_queue_completion(void);
+#ifdef CONFIG_ROBUSTO_QUEUE_RING
+void tst_queue_ring_benchmark(void);
+#endif
@@ -3,6 +3,12 @@
 #include <unity.h>
 
 #include <robusto_system.h>
+#include <robusto_logging.h>
+#include <robusto_time.h>
+#include <string.h>
+#if defined(USE_NATIVE) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#endif
 
 /**
  * @brief Check to that at least 100 milliseconds is returned.
@@ -15,3 +21,247 @@ void tst_blink(void)
     robusto_led_blink(1, 1, 2);  // Let's go fast on native
     #endif
 }
+
+/**
+ * @brief Check that a shared buffer keeps its data until the last reference is released
+ */
+void tst_shared_buffer(void)
+{
+    robusto_buffer_t *buffer = robusto_buffer_create(32, false);
+    TEST_ASSERT_NOT_NULL(buffer);
+    TEST_ASSERT_EQUAL_UINT32(32, robusto_buffer_get_length(buffer));
+    memset(robusto_buffer_get_data(buffer), 0xAB, 32);
+    robusto_buffer_retain(buffer);
+    robusto_buffer_release(buffer);
+    // Still referenced by the creator
+    TEST_ASSERT_EACH_EQUAL_UINT8(0xAB, robusto_buffer_get_data(buffer), 32);
+    robusto_buffer_release(buffer);
+    // Releasing NULL is allowed, like free()
+    robusto_buffer_release(NULL);
+}
+
+/**
+ * @brief Take all slots of a pool, and give them back
+ */
+void tst_pool(void)
+{
+    robusto_pool_t *pool = robusto_pool_create("test", 20, 35);
+    TEST_ASSERT_NOT_NULL(pool);
+    TEST_ASSERT_EQUAL_UINT16(35, robusto_pool_available(pool));
+    void *slots[35];
+    for (int i = 0; i < 35; i++)
+    {
+        slots[i] = robusto_pool_take(pool);
+        TEST_ASSERT_NOT_NULL(slots[i]);
+        TEST_ASSERT_TRUE(robusto_pool_owns(pool, slots[i]));
+        // Slots must not overlap
+        memset(slots[i], i, 20);
+    }
+    TEST_ASSERT_NULL_MESSAGE(robusto_pool_take(pool), "An exhausted pool should not give out slots");
+    TEST_ASSERT_EQUAL_UINT16(0, robusto_pool_available(pool));
+    for (int i = 0; i < 35; i++)
+    {
+        TEST_ASSERT_EACH_EQUAL_UINT8(i, slots[i], 20);
+    }
+    TEST_ASSERT_TRUE(robusto_pool_give(pool, slots[33]));
+    TEST_ASSERT_TRUE_MESSAGE(robusto_pool_take(pool) == slots[33], "The slot given back should be taken again");
+
+    uint8_t not_pooled;
+    TEST_ASSERT_FALSE(robusto_pool_give(pool, &not_pooled));
+    TEST_ASSERT_FALSE(robusto_pool_give(NULL, &not_pooled));
+    TEST_ASSERT_NULL(robusto_pool_take(NULL));
+    for (int i = 0; i < 35; i++)
+    {
+        TEST_ASSERT_TRUE(robusto_pool_give(pool, slots[i]));
+    }
+    TEST_ASSERT_EQUAL_UINT16(35, robusto_pool_available(pool));
+}
+
+static bool get_pool_stats(const char *name, robusto_pool_stats_t *stats)
+{
+    for (uint8_t i = 0; robusto_pool_get_stats(i, stats); i++)
+    {
+        if (strcmp(stats->name, name) == 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Allocate from the size classes, and check that their usage is reported
+ */
+void tst_pool_size_classes(void)
+{
+    robusto_pool_stats_t stats;
+    TEST_ASSERT_TRUE_MESSAGE(get_pool_stats("small", &stats), "The small size class should be reported");
+    uint16_t small_in_use = stats.in_use;
+
+    uint8_t *small = robusto_pool_malloc(CONFIG_ROBUSTO_POOL_SMALL_SIZE - 1);
+    TEST_ASSERT_NOT_NULL(small);
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(CONFIG_ROBUSTO_POOL_SMALL_SIZE, robusto_pool_size_of(small));
+    TEST_ASSERT_TRUE(get_pool_stats("small", &stats));
+    TEST_ASSERT_EQUAL_UINT16(small_in_use + 1, stats.in_use);
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT16(stats.in_use, stats.high_water);
+
+    // Growing it moves it to a larger class, keeping the content
+    memset(small, 0x5A, CONFIG_ROBUSTO_POOL_SMALL_SIZE - 1);
+    uint8_t *grown = robusto_realloc(small, CONFIG_ROBUSTO_POOL_MEDIUM_SIZE);
+    TEST_ASSERT_NOT_NULL(grown);
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(CONFIG_ROBUSTO_POOL_MEDIUM_SIZE, robusto_pool_size_of(grown));
+    TEST_ASSERT_EACH_EQUAL_UINT8(0x5A, grown, CONFIG_ROBUSTO_POOL_SMALL_SIZE - 1);
+    TEST_ASSERT_TRUE(get_pool_stats("small", &stats));
+    TEST_ASSERT_EQUAL_UINT16(small_in_use, stats.in_use);
+    robusto_free(grown);
+
+    // Too large for any class comes from the heap
+    uint8_t *heap = robusto_pool_malloc(CONFIG_ROBUSTO_POOL_LARGE_SIZE + 1);
+    TEST_ASSERT_NOT_NULL(heap);
+    TEST_ASSERT_EQUAL_UINT32(0, robusto_pool_size_of(heap));
+    robusto_free(heap);
+
+    // Taking all large slots falls back to the heap, and is counted
+    TEST_ASSERT_TRUE(get_pool_stats("large", &stats));
+    uint32_t exhausted = stats.exhausted;
+    void *large[CONFIG_ROBUSTO_POOL_LARGE_SLOTS + 1];
+    for (int i = 0; i < CONFIG_ROBUSTO_POOL_LARGE_SLOTS + 1; i++)
+    {
+        large[i] = robusto_pool_malloc(CONFIG_ROBUSTO_POOL_LARGE_SIZE);
+        TEST_ASSERT_NOT_NULL(large[i]);
+    }
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, robusto_pool_size_of(large[CONFIG_ROBUSTO_POOL_LARGE_SLOTS]), "An exhausted class should fall back to the heap");
+    TEST_ASSERT_TRUE(get_pool_stats("large", &stats));
+    TEST_ASSERT_GREATER_THAN_UINT32(exhausted, stats.exhausted);
+    TEST_ASSERT_EQUAL_UINT16(stats.slot_count, stats.high_water);
+    for (int i = 0; i < CONFIG_ROBUSTO_POOL_LARGE_SLOTS + 1; i++)
+    {
+        robusto_free(large[i]);
+    }
+}
+
+#ifdef CONFIG_ROBUSTO_LOG_DEFERRED
+/**
+ * @brief Record log lines and check that they are formatted as printf would have done it
+ */
+void tst_log_deferred(void)
+{
+    char line[160];
+    rob_log_level_t level;
+    const char *tag;
+    while (rob_log_deferred_take(&level, &tag, line, sizeof(line)))
+    {
+    }
+
+    // Strings are copied, as they may be gone when the line is formatted
+    char name[8] = "peer";
+    TEST_ASSERT_TRUE(rob_log_deferred(ROB_LOG_WARN, "tst", "a=%s b=%hhu c=%lu d=%lld e=%*d f=%.2f g=%02x %% h=%zu",
+                                      name, 7, 123456UL, -5LL, 4, 9, 1.5, 10, sizeof(line)));
+    name[0] = 'X';
+    char expected[160];
+    snprintf(expected, sizeof(expected), "a=%s b=%hhu c=%lu d=%lld e=%*d f=%.2f g=%02x %% h=%zu",
+             "peer", 7, 123456UL, -5LL, 4, 9, 1.5, 10, sizeof(line));
+    TEST_ASSERT_TRUE(rob_log_deferred_take(&level, &tag, line, sizeof(line)));
+    TEST_ASSERT_EQUAL_STRING(expected, line);
+    TEST_ASSERT_EQUAL(ROB_LOG_WARN, level);
+    TEST_ASSERT_EQUAL_STRING("tst", tag);
+
+    // Strings that do not fit are left out
+    char long_name[CONFIG_ROBUSTO_LOG_DEFERRED_STRING_BYTES + 1];
+    memset(long_name, 'a', sizeof(long_name) - 1);
+    long_name[sizeof(long_name) - 1] = '\0';
+    TEST_ASSERT_TRUE(rob_log_deferred(ROB_LOG_INFO, "tst", "name=%s, %i", long_name, 3));
+    TEST_ASSERT_TRUE(rob_log_deferred_take(&level, &tag, line, sizeof(line)));
+    TEST_ASSERT_EQUAL_STRING("name=(..), 3", line);
+    TEST_ASSERT_FALSE_MESSAGE(rob_log_deferred_take(&level, &tag, line, sizeof(line)), "The ring should be empty");
+}
+#endif
+
+/**
+ * @brief Check the CRC32s against the standard check values, and that calculating in parts gives the same result
+ */
+void tst_crc32(void)
+{
+    const uint8_t check[] = "123456789";
+    // CRC-32/MPEG-2 is the messaging CRC seeded with ~0, CRC-32/ISO-HDLC the proxy one
+    TEST_ASSERT_EQUAL_HEX32(0x0376e6e7, robusto_crc32(0xFFFFFFFF, check, 9));
+    TEST_ASSERT_EQUAL_HEX32(0xcbf43926, robusto_crc32_iso_hdlc(0, check, 9));
+
+    uint8_t data[1031];
+    for (uint32_t i = 0; i < sizeof(data); i++)
+    {
+        data[i] = (uint8_t)(i * 31 + (i >> 3));
+    }
+    // Byte by byte, as the old implementation did
+    uint32_t expected = 0;
+    for (uint32_t i = 1; i < sizeof(data); i++)
+    {
+        expected = robusto_crc32(expected, data + i, 1);
+    }
+    // Unaligned start, and uneven parts going through both the eight byte and single byte paths
+    uint32_t crc = robusto_crc32(0, data + 1, 13);
+    crc = robusto_crc32(crc, data + 14, 1000);
+    crc = robusto_crc32(crc, data + 1014, sizeof(data) - 1014);
+    TEST_ASSERT_EQUAL_HEX32(expected, crc);
+    TEST_ASSERT_EQUAL_HEX32(expected, robusto_crc32(0, data + 1, sizeof(data) - 1));
+
+    uint32_t iso_hdlc = robusto_crc32_iso_hdlc(0, data + 1, 13);
+    iso_hdlc = robusto_crc32_iso_hdlc(iso_hdlc, data + 14, sizeof(data) - 14);
+    TEST_ASSERT_EQUAL_HEX32(robusto_crc32_iso_hdlc(0, data + 1, sizeof(data) - 1), iso_hdlc);
+
+    // Combining the parts gives the same as calculating it in one go, also with a seed
+    uint32_t first = robusto_crc32(0xFFFFFFFF, data, 700);
+    uint32_t second = robusto_crc32(0, data + 700, sizeof(data) - 700);
+    TEST_ASSERT_EQUAL_HEX32(robusto_crc32(0xFFFFFFFF, data, sizeof(data)), robusto_crc32_combine(first, second, sizeof(data) - 700));
+    uint32_t op = robusto_crc32_combine_gen(100);
+    uint32_t combined = 0;
+    for (uint32_t offset = 0; offset < 1000; offset += 100)
+    {
+        combined = robusto_crc32_combine_op(combined, robusto_crc32(0, data + offset, 100), op);
+    }
+    TEST_ASSERT_EQUAL_HEX32(robusto_crc32(0, data, 1000), combined);
+    TEST_ASSERT_EQUAL_HEX32(first, robusto_crc32_combine(first, 0, 0));
+}
+
+/**
+ * @brief Report the CRC32 throughput for typical message sizes, in bytes per cycle where there is a cycle counter
+ */
+void tst_crc32_benchmark(void)
+{
+#ifdef USE_NATIVE
+    static uint8_t data[4096];
+    for (uint32_t i = 0; i < sizeof(data); i++)
+    {
+        data[i] = (uint8_t)(i * 7);
+    }
+    const uint32_t sizes[] = {16, 256, 4096};
+    for (uint32_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+    {
+        // Roughly the same amount of data for all sizes
+        uint32_t rounds = (4 * 1024 * 1024) / sizes[s];
+        volatile uint32_t sink = 0;
+#if defined(__x86_64__) || defined(__i386__)
+        uint64_t start = __rdtsc();
+#else
+        uint64_t start = r_micros();
+#endif
+        for (uint32_t r = 0; r < rounds; r++)
+        {
+            sink ^= robusto_crc32(r, data, sizes[s]);
+            sink ^= robusto_crc32_iso_hdlc(r, data, sizes[s]);
+        }
+#if defined(__x86_64__) || defined(__i386__)
+        uint64_t elapsed = __rdtsc() - start;
+        const char *unit = "cycle";
+#else
+        uint64_t elapsed = r_micros() - start;
+        const char *unit = "us";
+#endif
+        ROB_LOGI("Test", "CRC32 of %4lu-byte buffers: %.2f bytes/%s (both variants)", (unsigned long)sizes[s],
+                 (double)(2ULL * rounds * sizes[s]) / (double)(elapsed > 0 ? elapsed : 1), unit);
+        (void)sink;
+    }
+#else
+    TEST_IGNORE_MESSAGE("The CRC32 benchmark only runs natively");
+#endif
+}
@@ -1,3 +1,11 @@
 #pragma once
 #include <robconfig.h>
 void tst_blink(void);
+void tst_shared_buffer(void);
+void tst_pool(void);
+void tst_pool_size_classes(void);
+#ifdef CONFIG_ROBUSTO_LOG_DEFERRED
+void tst_log_deferred(void);
+#endif
+void tst_crc32(void);
+void tst_crc32_benchmark(void);